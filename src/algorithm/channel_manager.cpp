@@ -3,13 +3,14 @@
  */
 
 #include "channel_manager.h"
+#include "../core/loop_events.h"
 
 // Global instance
 ChannelManager channelManager;
 
 // Recursive mutex for RAM cache access (race condition fix)
-// Using RECURSIVE mutex because markEventCompleted() calls deductVolume()/addDosedVolume()
-// which also take the lock - recursive mutex allows same task to take lock multiple times
+// Using RECURSIVE mutex because public setters call commitChannel()
+// which also takes the lock - recursive mutex allows same task to take lock multiple times
 static SemaphoreHandle_t _channelMutex = nullptr;
 static bool _mutexInitialized = false;
 
@@ -39,6 +40,12 @@ private:
     bool _locked;
 };
 
+// Dirty set is also updated from FRAM I/O completion callbacks
+static portMUX_TYPE _dirtyMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Callback context: slot in bits 16+, channel in bits 8-15, dirty flag in the low byte
+#define COMMIT_CONTEXT(ch, flag, slot)  ((void*)(uintptr_t)(((slot) << 16) | ((ch) << 8) | (flag)))
+
 // Static empty instances for invalid access
 ChannelConfig ChannelManager::_emptyConfig = {};
 ChannelDailyState ChannelManager::_emptyDailyState = {};
@@ -376,23 +383,19 @@ bool ChannelManager::applyPendingChanges(uint8_t channel) {
     // Clear pending flag
     _activeConfig[channel].has_pending = 0;
     _pendingConfig[channel].has_pending = 0;
+    _activeGeneration++;
+    loopEvents.signal(LOOP_EVENT_SCHEDULE);     // Scheduler rebuilds its timeline
     
-    // Update CRCs
-    _updateConfigCRC(&_activeConfig[channel]);
-    _updateConfigCRC(&_pendingConfig[channel]);
-    
-    // Save to FRAM
-    if (!framController.writeActiveConfig(channel, &_activeConfig[channel])) {
-        return false;
-    }
-    if (!framController.writePendingConfig(channel, &_pendingConfig[channel])) {
-        return false;
-    }
+    // Pointer flip: the staged slot becomes active. One record write
+    // (has_pending = 0, newer seq) - torn write leaves the old active slot
+    _configSlot[channel] ^= 1;
+    _markDirty(channel, DIRTY_ACTIVE_CONFIG);
+    bool ok = commitChannel(channel);
     
     // Recalculate
     recalculate(channel);
     
-    return true;
+    return ok;
 }
 
 bool ChannelManager::applyAllPendingChanges() {
@@ -412,9 +415,8 @@ bool ChannelManager::revertPendingChanges(uint8_t channel) {
     memcpy(&_pendingConfig[channel], &_activeConfig[channel], sizeof(ChannelConfig));
     _pendingConfig[channel].has_pending = 0;
     
-    _updateConfigCRC(&_pendingConfig[channel]);
-    
-    return framController.writePendingConfig(channel, &_pendingConfig[channel]);
+    _markDirty(channel, DIRTY_PENDING_CONFIG);
+    return commitChannel(channel);
 }
 
 // ============================================================================
@@ -433,20 +435,10 @@ bool ChannelManager::markEventCompleted(uint8_t channel, uint8_t hour, float dos
 
     _dailyState[channel].markEventCompleted(hour);
     _dailyState[channel].today_added_ml += dosed_ml;
+    _markDirty(channel, DIRTY_DAILY_STATE);
 
-    _updateDailyStateCRC(&_dailyState[channel]);
-
-    if (!framController.writeDailyState(channel, &_dailyState[channel])) {
-        return false;
-    }
-
-    // Note: deductVolume and addDosedVolume have their own locks,
-    // but we hold this lock to ensure daily state consistency
-    // Deduct from container volume
-    deductVolume(channel, dosed_ml);
-
-    // Add to dosed tracker (total since reset)
-    addDosedVolume(channel, dosed_ml);
+    // Container volume + dosed tracker (RAM only, persisted by commitChannel)
+    _applyDosedVolume(channel, dosed_ml);
 
     return true;
 }
@@ -462,13 +454,224 @@ bool ChannelManager::markEventFailed(uint8_t channel, uint8_t hour) {
     }
 
     _dailyState[channel].markEventFailed(hour);
-
-    _updateDailyStateCRC(&_dailyState[channel]);
+    _markDirty(channel, DIRTY_DAILY_STATE);
 
     Serial.printf("[CH_MGR] CH%d hour %d marked as FAILED (total failed today: %d)\n",
                   channel, hour, _dailyState[channel].failed_count);
 
-    return framController.writeDailyState(channel, &_dailyState[channel]);
+    // Error path - persist immediately (may be called outside the dose flow)
+    return commitChannel(channel);
+}
+
+bool ChannelManager::commitChannel(uint8_t channel) {
+    if (channel >= CHANNEL_COUNT) return false;
+
+    ChannelLock lock;
+    if (!lock.isLocked()) {
+        Serial.println(F("[CH_MGR] WARNING: commitChannel failed to acquire lock"));
+    }
+
+    uint8_t dirty = _takeDirty(channel);
+
+    uint32_t startUs = micros();
+    uint8_t records = 0;
+    uint16_t bytes = 0;
+    uint16_t transactions = 0;
+    uint8_t rejected = DIRTY_NONE;
+
+    // Records are copied into the I/O queue - RAM may change right after submit
+    struct Record {
+        uint8_t     flag;
+        uint8_t     slot;
+        uint16_t    address;
+        const void* data;
+        uint16_t    length;
+    };
+
+    // Config slots share one generation counter per channel
+    uint32_t configSeq = _activeConfig[channel].seq;
+    if (_pendingConfig[channel].seq > configSeq) configSeq = _pendingConfig[channel].seq;
+    if (dirty & DIRTY_ACTIVE_CONFIG) {
+        _activeConfig[channel].seq = ++configSeq;
+        _updateConfigCRC(&_activeConfig[channel]);
+    }
+    if (dirty & DIRTY_PENDING_CONFIG) {
+        _pendingConfig[channel].seq = ++configSeq;
+        _updateConfigCRC(&_pendingConfig[channel]);
+    }
+
+    // Daily state: new generation into the slot not holding the last copy
+    uint8_t dailySlot = FRAM_SLOT_A;
+    if (dirty & DIRTY_DAILY_STATE) {
+        _dailyState[channel].seq++;
+        _updateDailyStateCRC(&_dailyState[channel]);
+
+        portENTER_CRITICAL(&_dirtyMux);
+        dailySlot = _dailySlot[channel] ^ 1;
+        _dailySlot[channel] = dailySlot;
+        portEXIT_CRITICAL(&_dirtyMux);
+    }
+
+    if (dirty & DIRTY_CONTAINER)      _updateContainerVolumeCRC(&_containerVolume[channel]);
+    if (dirty & DIRTY_DOSED_TRACKER)  _updateDosedTrackerCRC(&_dosedTracker[channel]);
+
+    uint8_t activeSlot = _configSlot[channel];
+    uint8_t stagedSlot = activeSlot ^ 1;
+
+    const Record table[] = {
+        { DIRTY_ACTIVE_CONFIG,  activeSlot, (uint16_t)FRAM_ADDR_CONFIG_CH(activeSlot, channel),
+          &_activeConfig[channel],    sizeof(ChannelConfig) },
+        { DIRTY_PENDING_CONFIG, stagedSlot, (uint16_t)FRAM_ADDR_CONFIG_CH(stagedSlot, channel),
+          &_pendingConfig[channel],   sizeof(ChannelConfig) },
+        { DIRTY_DAILY_STATE,    dailySlot,  (uint16_t)FRAM_ADDR_DAILY_CH(dailySlot, channel),
+          &_dailyState[channel],      sizeof(ChannelDailyState) },
+        { DIRTY_CONTAINER,      FRAM_SLOT_A, (uint16_t)FRAM_ADDR_CONTAINER_CH(channel),
+          &_containerVolume[channel], sizeof(ContainerVolume) },
+        { DIRTY_DOSED_TRACKER,  FRAM_SLOT_A, (uint16_t)FRAM_ADDR_DOSED_TRACKER_CH(channel),
+          &_dosedTracker[channel],    sizeof(DosedTracker) }
+    };
+
+    for (uint8_t i = 0; i < sizeof(table) / sizeof(table[0]); i++) {
+        const Record& r = table[i];
+        if (!(dirty & r.flag)) continue;
+
+        if (!_submitRecord(channel, r.flag, r.slot, r.address, r.data, r.length)) {
+            rejected |= r.flag;
+        }
+        records++;
+        bytes += r.length;
+        transactions += (r.length + FRAM_I2C_WRITE_CHUNK - 1) / FRAM_I2C_WRITE_CHUNK;
+    }
+
+    _lastCommit.channel = channel;
+    _lastCommit.records = records;
+    _lastCommit.bytes = bytes;
+    _lastCommit.transactions = transactions;
+    _lastCommit.duration_us = micros() - startUs;
+
+    if (rejected != DIRTY_NONE) {
+        // Keep failed records dirty - next commit retries them
+        if (rejected & DIRTY_DAILY_STATE) {
+            portENTER_CRITICAL(&_dirtyMux);
+            _dailySlot[channel] = dailySlot ^ 1;
+            portEXIT_CRITICAL(&_dirtyMux);
+        }
+        _markDirty(channel, rejected);
+        Serial.printf("[CH_MGR] CH%d commit failed (mask 0x%02X)\n", channel, rejected);
+        return false;
+    }
+
+    return true;
+}
+
+bool ChannelManager::_submitRecord(uint8_t channel, uint8_t flag, uint8_t slot, uint16_t address,
+                                   const void* data, size_t length) {
+    return framIoWorker.submitWrite(address, data, length, FramIoPriority::NORMAL,
+                                    _onRecordWritten, COMMIT_CONTEXT(channel, flag, slot));
+}
+
+void ChannelManager::_onRecordWritten(bool success, void* context) {
+    if (success) return;
+
+    uint32_t ctx = (uint32_t)(uintptr_t)context;
+    uint8_t slot = (ctx >> 16) & 0xFF;
+    uint8_t channel = (ctx >> 8) & 0xFF;
+    uint8_t flag = ctx & 0xFF;
+
+    Serial.printf("[CH_MGR] FRAM write failed (CH%d, record 0x%02X) - will retry\n",
+                  channel, flag);
+
+    if (channel >= CHANNEL_COUNT) return;
+
+    // Daily state retry goes to the same slot - the other one holds the
+    // last good copy. Config records always target the staged/active slot.
+    if (flag == DIRTY_DAILY_STATE) {
+        portENTER_CRITICAL(&_dirtyMux);
+        channelManager._dailySlot[channel] = slot ^ 1;
+        portEXIT_CRITICAL(&_dirtyMux);
+    }
+    channelManager._markDirty(channel, flag);
+}
+
+bool ChannelManager::repairRecord(uint16_t address) {
+    ChannelLock lock;
+    if (!lock.isLocked()) return false;
+
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+        // Daily slot and dirty set also change in FRAM I/O callbacks
+        portENTER_CRITICAL(&_dirtyMux);
+        uint8_t dailySlot = _dailySlot[ch];
+        uint8_t dirty = _dirty[ch];
+        portEXIT_CRITICAL(&_dirtyMux);
+        uint8_t activeSlot = _configSlot[ch];
+
+        uint8_t flag = DIRTY_NONE;
+        uint8_t slot = FRAM_SLOT_A;
+        const void* data = nullptr;
+        size_t length = 0;
+        bool sealed = false;
+
+        if (address == FRAM_ADDR_CONTAINER_CH(ch)) {
+            flag = DIRTY_CONTAINER;
+            data = &_containerVolume[ch];
+            length = sizeof(ContainerVolume);
+            sealed = FramController::verifyRecord<FramSectionId::CONTAINER_VOLUME>(_containerVolume[ch]);
+        } else if (address == FRAM_ADDR_DOSED_TRACKER_CH(ch)) {
+            flag = DIRTY_DOSED_TRACKER;
+            data = &_dosedTracker[ch];
+            length = sizeof(DosedTracker);
+            sealed = FramController::verifyRecord<FramSectionId::DOSED_TRACKER>(_dosedTracker[ch]);
+        } else if (address == FRAM_ADDR_CONFIG_CH(activeSlot, ch)) {
+            flag = DIRTY_ACTIVE_CONFIG;
+            slot = activeSlot;
+            data = &_activeConfig[ch];
+            length = sizeof(ChannelConfig);
+            sealed = FramController::verifyRecord<FramSectionId::CONFIG_A>(_activeConfig[ch]);
+        } else if (address == FRAM_ADDR_CONFIG_CH(activeSlot ^ 1, ch) && hasPendingChanges(ch)) {
+            // Without pending the staged slot only holds an older generation
+            flag = DIRTY_PENDING_CONFIG;
+            slot = activeSlot ^ 1;
+            data = &_pendingConfig[ch];
+            length = sizeof(ChannelConfig);
+            sealed = FramController::verifyRecord<FramSectionId::CONFIG_A>(_pendingConfig[ch]);
+        } else if (address == FRAM_ADDR_DAILY_CH(dailySlot, ch)) {
+            flag = DIRTY_DAILY_STATE;
+            slot = dailySlot;
+            data = &_dailyState[ch];
+            length = sizeof(ChannelDailyState);
+            sealed = FramController::verifyRecord<FramSectionId::DAILY_STATE_A>(_dailyState[ch]);
+        } else {
+            continue;
+        }
+
+        // Dirty: RAM is ahead of FRAM and the next commit rewrites it anyway.
+        // Not sealed: RAM changed since the last commit - not what FRAM held.
+        if ((dirty & flag) || !sealed) return false;
+
+        // Same bytes as the last commit - same seq, same CRC
+        return _submitRecord(ch, flag, slot, (uint16_t)address, data, length);
+    }
+
+    return false;
+}
+
+void ChannelManager::_markDirty(uint8_t channel, uint8_t flags) {
+    portENTER_CRITICAL(&_dirtyMux);
+    _dirty[channel] |= flags;
+    portEXIT_CRITICAL(&_dirtyMux);
+}
+
+uint8_t ChannelManager::_takeDirty(uint8_t channel) {
+    portENTER_CRITICAL(&_dirtyMux);
+    uint8_t dirty = _dirty[channel];
+    _dirty[channel] = DIRTY_NONE;
+    portEXIT_CRITICAL(&_dirtyMux);
+    return dirty;
+}
+
+bool ChannelManager::isDirty(uint8_t channel) const {
+    if (channel >= CHANNEL_COUNT) return false;
+    return _dirty[channel] != DIRTY_NONE;
 }
 
 bool ChannelManager::isEventFailed(uint8_t channel, uint8_t hour) const {
@@ -485,17 +688,17 @@ bool ChannelManager::resetDailyStates() {
         Serial.println(F("[CH_MGR] WARNING: resetDailyStates failed to acquire lock"));
     }
 
+    // Channels may sit in different slots - one record per channel,
+    // each into its own older slot (torn reset keeps yesterday's state)
+    bool ok = true;
     for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
         _dailyState[i].reset();
-        _updateDailyStateCRC(&_dailyState[i]);
-
-        if (!framController.writeDailyState(i, &_dailyState[i])) {
-            return false;
-        }
+        _markDirty(i, DIRTY_DAILY_STATE);
+        if (!commitChannel(i)) ok = false;
     }
 
     recalculateAll();
-    return true;
+    return ok;
 }
 
 bool ChannelManager::isEventCompleted(uint8_t channel, uint8_t hour) const {
@@ -584,7 +787,8 @@ bool ChannelManager::setContainerCapacity(uint8_t channel, float capacity_ml) {
     
     Serial.printf("[CH_MGR] CH%d container capacity set to %.1f ml\n", channel, capacity_ml);
     
-    return framController.writeContainerVolume(channel, &_containerVolume[channel]);
+    _markDirty(channel, DIRTY_CONTAINER);
+    return commitChannel(channel);
 }
 
 bool ChannelManager::refillContainer(uint8_t channel) {
@@ -597,12 +801,12 @@ bool ChannelManager::refillContainer(uint8_t channel) {
     }
 
     _containerVolume[channel].refill();
-    _updateContainerVolumeCRC(&_containerVolume[channel]);
 
     Serial.printf("[CH_MGR] CH%d refilled to %.1f ml\n",
                   channel, _containerVolume[channel].getContainerMl());
 
-    return framController.writeContainerVolume(channel, &_containerVolume[channel]);
+    _markDirty(channel, DIRTY_CONTAINER);
+    return commitChannel(channel);
 }
 
 bool ChannelManager::deductVolume(uint8_t channel, float ml) {
@@ -617,7 +821,7 @@ bool ChannelManager::deductVolume(uint8_t channel, float ml) {
 
     float before = _containerVolume[channel].getRemainingMl();
     _containerVolume[channel].deduct(ml);
-    _updateContainerVolumeCRC(&_containerVolume[channel]);
+    _markDirty(channel, DIRTY_CONTAINER);
 
     float after = _containerVolume[channel].getRemainingMl();
 
@@ -630,7 +834,7 @@ bool ChannelManager::deductVolume(uint8_t channel, float ml) {
                       channel, after, (float)_containerVolume[channel].getRemainingPercent());
     }
 
-    return framController.writeContainerVolume(channel, &_containerVolume[channel]);
+    return commitChannel(channel);
 }
 
 bool ChannelManager::isLowVolume(uint8_t channel) const {
@@ -673,19 +877,13 @@ float ChannelManager::getDaysRemaining(uint8_t channel) const {
 bool ChannelManager::reloadContainerVolumes() {
     Serial.println(F("[CH_MGR] Loading container volumes..."));
 
-    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        if (!framController.readContainerVolume(i, &_containerVolume[i])) {
-            Serial.printf("[CH_MGR] Failed to read container volume CH%d\n", i);
-            return false;
-        }
-
-        // Validate CRC
-        uint32_t calc_crc = FramController::calculateCRC32(
-            &_containerVolume[i],
-            sizeof(ContainerVolume) - sizeof(uint32_t)
-        );
+    if (!framController.readContainerVolumes(_containerVolume)) {
+        Serial.println(F("[CH_MGR] Failed to read container volumes"));
+        return false;
+    }
 
-        if (calc_crc != _containerVolume[i].crc32) {
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        if (!FramController::verifyRecord<FramSectionId::CONTAINER_VOLUME>(_containerVolume[i])) {
             Serial.printf("[CH_MGR] CH%d container volume CRC mismatch, resetting\n", i);
             _containerVolume[i].reset();
             _updateContainerVolumeCRC(&_containerVolume[i]);
@@ -721,12 +919,32 @@ bool ChannelManager::addDosedVolume(uint8_t channel, float ml) {
     }
 
     _dosedTracker[channel].addDosed(ml);
-    _updateDosedTrackerCRC(&_dosedTracker[channel]);
+    _markDirty(channel, DIRTY_DOSED_TRACKER);
 
     Serial.printf("[CH_MGR] CH%d total dosed: %.1f ml (+%.2f ml)\n",
                   channel, _dosedTracker[channel].getTotalDosedMl(), ml);
 
-    return framController.writeDosedTracker(channel, &_dosedTracker[channel]);
+    return commitChannel(channel);
+}
+
+void ChannelManager::_applyDosedVolume(uint8_t channel, float ml) {
+    if (ml <= 0) return;
+
+    float before = _containerVolume[channel].getRemainingMl();
+    _containerVolume[channel].deduct(ml);
+    _dosedTracker[channel].addDosed(ml);
+    _markDirty(channel, DIRTY_CONTAINER | DIRTY_DOSED_TRACKER);
+
+    float after = _containerVolume[channel].getRemainingMl();
+
+    Serial.printf("[CH_MGR] CH%d volume: %.1f -> %.1f ml, total dosed: %.1f ml (+%.2f ml)\n",
+                  channel, before, after, _dosedTracker[channel].getTotalDosedMl(), ml);
+
+    // Check low volume warning
+    if (_containerVolume[channel].isLowVolume()) {
+        Serial.printf("[CH_MGR] WARNING: CH%d low volume! %.1f ml remaining (%.0f%%)\n",
+                      channel, after, (float)_containerVolume[channel].getRemainingPercent());
+    }
 }
 
 bool ChannelManager::resetDosedTracker(uint8_t channel) {
@@ -734,29 +952,23 @@ bool ChannelManager::resetDosedTracker(uint8_t channel) {
 
     float oldValue = _dosedTracker[channel].getTotalDosedMl();
     _dosedTracker[channel].reset();
-    _updateDosedTrackerCRC(&_dosedTracker[channel]);
 
     Serial.printf("[CH_MGR] CH%d dosed tracker reset (was %.1f ml)\n", channel, oldValue);
 
-    return framController.writeDosedTracker(channel, &_dosedTracker[channel]);
+    _markDirty(channel, DIRTY_DOSED_TRACKER);
+    return commitChannel(channel);
 }
 
 bool ChannelManager::reloadDosedTrackers() {
     Serial.println(F("[CH_MGR] Loading dosed trackers..."));
 
-    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        if (!framController.readDosedTracker(i, &_dosedTracker[i])) {
-            Serial.printf("[CH_MGR] Failed to read dosed tracker CH%d\n", i);
-            return false;
-        }
-
-        // Validate CRC
-        uint32_t calc_crc = FramController::calculateCRC32(
-            &_dosedTracker[i],
-            sizeof(DosedTracker) - sizeof(uint32_t)
-        );
+    if (!framController.readDosedTrackers(_dosedTracker)) {
+        Serial.println(F("[CH_MGR] Failed to read dosed trackers"));
+        return false;
+    }
 
-        if (calc_crc != _dosedTracker[i].crc32) {
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        if (!FramController::verifyRecord<FramSectionId::DOSED_TRACKER>(_dosedTracker[i])) {
             Serial.printf("[CH_MGR] CH%d dosed tracker CRC mismatch, resetting\n", i);
             _dosedTracker[i].reset();
             _updateDosedTrackerCRC(&_dosedTracker[i]);
@@ -774,49 +986,122 @@ bool ChannelManager::reloadDosedTrackers() {
 bool ChannelManager::reloadFromFRAM() {
     Serial.println(F("[CH_MGR] Loading from FRAM..."));
     
+    // One sequential read per slot section instead of one per struct
+    ChannelConfig configs[2][CHANNEL_COUNT];
+    ChannelDailyState daily[2][CHANNEL_COUNT];
+    
+    if (!framController.readConfigs(FRAM_SLOT_A, configs[FRAM_SLOT_A]) ||
+        !framController.readConfigs(FRAM_SLOT_B, configs[FRAM_SLOT_B])) {
+        Serial.println(F("[CH_MGR] Failed to read channel configs"));
+        return false;
+    }
+    
+    if (!framController.readDailyStates(FRAM_SLOT_A, daily[FRAM_SLOT_A]) ||
+        !framController.readDailyStates(FRAM_SLOT_B, daily[FRAM_SLOT_B])) {
+        Serial.println(F("[CH_MGR] Failed to read daily states"));
+        return false;
+    }
+    
     for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        if (!framController.readActiveConfig(i, &_activeConfig[i])) {
-            Serial.printf("[CH_MGR] Failed to read active CH%d\n", i);
-            return false;
-        }
+        _loadConfigSlots(i, configs[FRAM_SLOT_A][i], configs[FRAM_SLOT_B][i]);
+        _loadDailySlots(i, daily[FRAM_SLOT_A][i], daily[FRAM_SLOT_B][i]);
         
-        if (!framController.readPendingConfig(i, &_pendingConfig[i])) {
-            Serial.printf("[CH_MGR] Failed to read pending CH%d\n", i);
-            return false;
-        }
-        
-        if (!framController.readDailyState(i, &_dailyState[i])) {
-            Serial.printf("[CH_MGR] Failed to read daily CH%d\n", i);
-            return false;
-        }
+        // Store repaired records right away
+        if (isDirty(i)) commitChannel(i);
     }
+    _activeGeneration++;
+    loopEvents.signal(LOOP_EVENT_SCHEDULE);
     
     return true;
 }
 
+void ChannelManager::_loadConfigSlots(uint8_t channel, const ChannelConfig& a, const ChannelConfig& b) {
+    const ChannelConfig* slots[2] = { &a, &b };
+    bool valid[2];
+    for (uint8_t s = 0; s < 2; s++) {
+        valid[s] = FramController::verifyRecord<FramSectionId::CONFIG_A>(*slots[s]);
+    }
+    
+    // Active: newest valid committed record (tie = slot A)
+    uint8_t active = FRAM_SLOT_NONE;
+    for (uint8_t s = 0; s < 2; s++) {
+        if (!valid[s] || slots[s]->has_pending) continue;
+        if (active == FRAM_SLOT_NONE || slots[s]->seq > slots[active]->seq) active = s;
+    }
+    
+    if (active == FRAM_SLOT_NONE && !valid[FRAM_SLOT_A] && !valid[FRAM_SLOT_B]) {
+        // Image from firmware without slots: A was active, B was pending
+        Serial.printf("[CH_MGR] CH%d config: no valid slot, loading legacy layout\n", channel);
+        _activeConfig[channel] = a;
+        _activeConfig[channel].has_pending = 0;
+        _pendingConfig[channel] = b.has_pending ? b : _activeConfig[channel];
+        _activeConfig[channel].seq = 0;
+        _pendingConfig[channel].seq = 0;
+        _configSlot[channel] = FRAM_SLOT_A;
+        _markDirty(channel, DIRTY_ACTIVE_CONFIG | DIRTY_PENDING_CONFIG);
+        return;
+    }
+    
+    if (active == FRAM_SLOT_NONE) {
+        // Only a staged record survived - it is the best config we have
+        active = valid[FRAM_SLOT_A] ? FRAM_SLOT_A : FRAM_SLOT_B;
+        Serial.printf("[CH_MGR] CH%d config: active slot lost, promoting pending\n", channel);
+        _activeConfig[channel] = *slots[active];
+        _activeConfig[channel].has_pending = 0;
+        _pendingConfig[channel] = _activeConfig[channel];
+        _configSlot[channel] = active;
+        _markDirty(channel, DIRTY_ACTIVE_CONFIG);
+        return;
+    }
+    
+    _activeConfig[channel] = *slots[active];
+    _configSlot[channel] = active;
+    
+    // Pending: staged record in the other slot, not older than active
+    const ChannelConfig* other = slots[active ^ 1];
+    if (valid[active ^ 1] && other->has_pending && other->seq >= slots[active]->seq) {
+        _pendingConfig[channel] = *other;
+    } else {
+        _pendingConfig[channel] = _activeConfig[channel];
+    }
+}
+
+void ChannelManager::_loadDailySlots(uint8_t channel, const ChannelDailyState& a, const ChannelDailyState& b) {
+    uint8_t slot = FramController::newestSlot<FramSectionId::DAILY_STATE_A>(a, b);
+    
+    if (slot == FRAM_SLOT_NONE) {
+        // Firmware without slots kept only A (CRC not maintained)
+        Serial.printf("[CH_MGR] CH%d daily state: no valid slot, loading legacy layout\n", channel);
+        _dailyState[channel] = a;
+        _dailyState[channel].seq = 0;
+        _dailySlot[channel] = FRAM_SLOT_A;
+        _markDirty(channel, DIRTY_DAILY_STATE);
+        return;
+    }
+    
+    _dailyState[channel] = (slot == FRAM_SLOT_B) ? b : a;
+    _dailySlot[channel] = slot;
+}
+
 bool ChannelManager::saveToFRAM() {
+    bool ok = true;
     for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        _updateConfigCRC(&_activeConfig[i]);
-        _updateConfigCRC(&_pendingConfig[i]);
-        _updateDailyStateCRC(&_dailyState[i]);
-        
-        if (!framController.writeActiveConfig(i, &_activeConfig[i])) return false;
-        if (!framController.writePendingConfig(i, &_pendingConfig[i])) return false;
-        if (!framController.writeDailyState(i, &_dailyState[i])) return false;
+        _markDirty(i, DIRTY_ACTIVE_CONFIG | DIRTY_PENDING_CONFIG | DIRTY_DAILY_STATE);
+        if (!commitChannel(i)) ok = false;
     }
-    return true;
+    return ok;
 }
 
 bool ChannelManager::_savePendingConfig(uint8_t channel) {
     if (channel >= CHANNEL_COUNT) return false;
     
     _pendingConfig[channel].has_pending = 1;
-    _updateConfigCRC(&_pendingConfig[channel]);
     
     // Recalculate with pending values
     recalculate(channel);
     
-    return framController.writePendingConfig(channel, &_pendingConfig[channel]);
+    _markDirty(channel, DIRTY_PENDING_CONFIG);
+    return commitChannel(channel);
 }
 
 // ============================================================================
@@ -878,19 +1163,19 @@ void ChannelManager::recalculateAll() {
 // ============================================================================
 
 void ChannelManager::_updateConfigCRC(ChannelConfig* cfg) {
-    cfg->crc32 = FramController::calculateCRC32(cfg, sizeof(ChannelConfig) - sizeof(uint32_t));
+    FramController::sealRecord<FramSectionId::CONFIG_A>(cfg);
 }
 
 void ChannelManager::_updateDailyStateCRC(ChannelDailyState* state) {
-    state->crc32 = FramController::calculateCRC32(state, sizeof(ChannelDailyState) - sizeof(uint32_t));
+    FramController::sealRecord<FramSectionId::DAILY_STATE_A>(state);
 }
 
 void ChannelManager::_updateContainerVolumeCRC(ContainerVolume* volume) {
-    volume->crc32 = FramController::calculateCRC32(volume, sizeof(ContainerVolume) - sizeof(uint32_t));
+    FramController::sealRecord<FramSectionId::CONTAINER_VOLUME>(volume);
 }
 
 void ChannelManager::_updateDosedTrackerCRC(DosedTracker* tracker) {
-    tracker->crc32 = FramController::calculateCRC32(tracker, sizeof(DosedTracker) - sizeof(uint32_t));
+    FramController::sealRecord<FramSectionId::DOSED_TRACKER>(tracker);
 }
 
 // ============================================================================
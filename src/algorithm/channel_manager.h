@@ -12,6 +12,7 @@
 #include "config.h"
 #include "dosing_types.h"
 #include "fram_controller.h"
+#include "fram_io_worker.h"
 
 // ============================================================================
 // VALIDATION RESULT
@@ -23,6 +24,30 @@ struct ValidationError {
     char     message[64];
 };
 
+// ============================================================================
+// DIRTY TRACKING (rekordy zmienione w RAM, czekające na commit do FRAM)
+// ============================================================================
+
+enum ChannelDirtyFlag : uint8_t {
+    DIRTY_NONE           = 0x00,
+    DIRTY_DAILY_STATE    = 0x01,
+    DIRTY_CONTAINER      = 0x02,
+    DIRTY_DOSED_TRACKER  = 0x04,
+    DIRTY_ACTIVE_CONFIG  = 0x08,
+    DIRTY_PENDING_CONFIG = 0x10
+};
+
+/**
+ * Koszt ostatniego commitu (diagnostyka ścieżki zakończenia dawki)
+ */
+struct ChannelCommitStats {
+    uint8_t  channel;           // Kanał
+    uint8_t  records;           // Liczba zleconych rekordów
+    uint16_t bytes;             // Bajty do zapisu w FRAM
+    uint16_t transactions;      // Transakcje I2C (wykonywane przez task FRAM I/O)
+    uint32_t duration_us;       // Czas commitu po stronie wywołującego
+};
+
 // ============================================================================
 // CHANNEL MANAGER CLASS
 // ============================================================================
@@ -143,6 +168,8 @@ public:
     
     /**
      * Zastosuj pending -> active (wywoływane przy resecie dobowym)
+     * Pending leży już w drugim slocie - zastosowanie to jeden zapis
+     * rekordu (has_pending = 0, nowszy seq), który przełącza aktywny slot.
      */
     bool applyPendingChanges(uint8_t channel);
     
@@ -229,21 +256,42 @@ public:
 
     /**
      * Oznacz event jako wykonany
+     * Aktualizuje daily state, container volume i dosed tracker tylko w RAM -
+     * zapis do FRAM następuje w commitChannel().
      */
     bool markEventCompleted(uint8_t channel, uint8_t hour, float dosed_ml);
 
     /**
-     * Oznacz event jako nieudany (failed)
+     * Oznacz event jako nieudany (failed) - zapisywany od razu
      */
     bool markEventFailed(uint8_t channel, uint8_t hour);
     
+    /**
+     * Zleć zapis wszystkich zmienionych rekordów kanału do FRAM (jeden commit)
+     * CRC liczone raz na rekord, tylko dla rekordów oznaczonych jako dirty.
+     * Zapis wykonuje task FRAM I/O; rekord, którego zapis się nie powiódł,
+     * wraca do zbioru dirty i jest ponawiany przy następnym commicie.
+     */
+    bool commitChannel(uint8_t channel);
+    
+    /**
+     * Czy kanał ma niezapisane zmiany
+     */
+    bool isDirty(uint8_t channel) const;
+    
+    /**
+     * Koszt ostatniego commitu (bajty, transakcje, czas)
+     */
+    const ChannelCommitStats& getLastCommitStats() const { return _lastCommit; }
+    
     /**
      * Czy event się nie powiódł
      */
     bool isEventFailed(uint8_t channel, uint8_t hour) const;
     
     /**
-     * Reset stanów dziennych (o północy)
+     * Reset stanów dziennych (o północy) - rekord na kanał, każdy do
+     * starszego slotu A/B
      */
     bool resetDailyStates();
     
@@ -275,10 +323,18 @@ public:
      */
     uint8_t getNextEventHour(uint8_t channel, uint8_t currentHour) const;
     
+    /**
+     * Generacja aktywnej konfiguracji - rośnie przy każdej zmianie
+     * (apply pending, przeładowanie z FRAM); scheduler przebudowuje wtedy oś dnia
+     */
+    uint32_t getActiveGeneration() const { return _activeGeneration; }
+    
     // --- Utility ---
     
     /**
      * Przeładuj wszystko z FRAM
+     * Z każdej pary slotów A/B wybierany jest nowszy ważny rekord;
+     * rekordy naprawione (np. obraz sprzed slotów) są od razu zapisywane.
      */
     bool reloadFromFRAM();
     
@@ -287,6 +343,15 @@ public:
      */
     bool saveToFRAM();
     
+    /**
+     * Scrubber: nadpisz uszkodzony rekord FRAM kopią z RAM
+     * Tylko gdy kopia jest autorytatywna: rekord nie czeka na commit,
+     * jego CRC w RAM się zgadza, a adres to slot, z którego kopia pochodzi
+     * (drugi slot A/B trzyma starszą generację - nie jest naprawiany).
+     * @return true jeśli zlecono zapis
+     */
+    bool repairRecord(uint16_t address);
+    
     /**
      * Przelicz wartości dla kanału
      */
@@ -317,6 +382,16 @@ private:
     ChannelCalculated _calculated[CHANNEL_COUNT];
     ContainerVolume   _containerVolume[CHANNEL_COUNT];
     DosedTracker      _dosedTracker[CHANNEL_COUNT];
+    
+    // Dirty set (ChannelDirtyFlag per kanał)
+    uint8_t           _dirty[CHANNEL_COUNT];
+    
+    // Sloty A/B: config - slot z aktywną konfiguracją (pending w drugim),
+    // daily - slot ostatniej zleconej kopii (następna idzie do drugiego)
+    uint8_t           _configSlot[CHANNEL_COUNT];
+    uint8_t           _dailySlot[CHANNEL_COUNT];
+    ChannelCommitStats _lastCommit;
+    uint32_t          _activeGeneration;
 
     // Empty config for invalid channel access
     static ChannelConfig _emptyConfig;
@@ -325,6 +400,36 @@ private:
     static ContainerVolume _emptyContainerVolume;
     static DosedTracker _emptyDosedTracker;
     
+    /**
+     * Odejmij objętość z pojemnika i dodaj do dosed tracker (tylko RAM)
+     */
+    void _applyDosedVolume(uint8_t channel, float ml);
+    
+    /**
+     * Operacje na zbiorze dirty (wywoływane także z taska FRAM I/O)
+     */
+    void _markDirty(uint8_t channel, uint8_t flags);
+    uint8_t _takeDirty(uint8_t channel);
+    
+    /**
+     * Zleć zapis jednego rekordu (dane kopiowane do żądania)
+     */
+    bool _submitRecord(uint8_t channel, uint8_t flag, uint8_t slot, uint16_t address,
+                       const void* data, size_t length);
+    
+    /**
+     * Callback zapisu rekordu - przy błędzie przywraca flagę dirty
+     */
+    static void _onRecordWritten(bool success, void* context);
+    
+    /**
+     * Wybór rekordów z par slotów przy starcie
+     * Config: active = najnowszy ważny z has_pending = 0, pending = drugi slot
+     * jeśli ma has_pending i nie jest starszy. Daily: nowszy ważny.
+     */
+    void _loadConfigSlots(uint8_t channel, const ChannelConfig& a, const ChannelConfig& b);
+    void _loadDailySlots(uint8_t channel, const ChannelDailyState& a, const ChannelDailyState& b);
+    
     /**
      * Zapisz pending config do FRAM i oznacz jako has_pending
      */
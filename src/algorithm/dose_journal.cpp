@@ -0,0 +1,398 @@
+/**
+ * DOZOWNIK - Dose Journal Implementation
+ */
+
+#include "dose_journal.h"
+#include "rtc_controller.h"
+
+// Global instance
+DoseJournal doseJournal;
+
+// Head/index are written by loop() and read by web handlers / I/O callbacks
+static portMUX_TYPE _journalMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Max records per bulk read (bounded stack use in callers)
+#define JOURNAL_READ_BATCH      32
+
+// ============================================================================
+// INITIALIZATION
+// ============================================================================
+
+bool DoseJournal::begin() {
+    Serial.println(F("[JOURNAL] Initializing..."));
+
+    _initialized = false;
+    _writeErrors = 0;
+
+    if (!framController.isReady()) {
+        Serial.println(F("[JOURNAL] FRAM not ready"));
+        return false;
+    }
+
+    DoseJournalHeader a, b;
+    bool validA = _readHeader(FRAM_ADDR_JOURNAL_HDR_A, &a);
+    bool validB = _readHeader(FRAM_ADDR_JOURNAL_HDR_B, &b);
+
+    if (!validA && !validB) {
+        Serial.println(F("[JOURNAL] No valid header, formatting"));
+        return clear();
+    }
+
+    // Newer generation wins - the other copy is at most one append behind
+    const DoseJournalHeader& hdr = (validA && (!validB || a.seq > b.seq)) ? a : b;
+
+    if (!framController.readBytes(FRAM_ADDR_JOURNAL_INDEX, _dayIndex, sizeof(_dayIndex))) {
+        Serial.println(F("[JOURNAL] Failed to read day index"));
+        return false;
+    }
+
+    _head = hdr.head;
+    _committedHead = hdr.head;
+    _headerSeq = hdr.seq;
+    _lastDay = JOURNAL_EMPTY_DAY;
+    _initialized = true;
+
+    // Index entries written ahead of a header that never landed point past head
+    for (uint16_t i = 0; i < JOURNAL_DAY_INDEX_SLOTS; i++) {
+        if (_dayIndex[i].utc_day != JOURNAL_EMPTY_DAY && _dayIndex[i].first_seq >= _head) {
+            _dayIndex[i].utc_day = JOURNAL_EMPTY_DAY;
+        }
+    }
+
+    DoseJournalRecord last;
+    if (_head > 0 && read(_head - 1, &last)) {
+        _lastDay = getUTCDay(last.timestamp);
+    }
+
+    Serial.printf("[JOURNAL] Ready: %d records (head %lu, header %c)\n",
+                  getCount(), (unsigned long)_head, (&hdr == &a) ? 'A' : 'B');
+    return true;
+}
+
+bool DoseJournal::_readHeader(uint16_t address, DoseJournalHeader* header) {
+    if (!framController.readBytes(address, header, sizeof(DoseJournalHeader))) {
+        return false;
+    }
+    if (header->magic != JOURNAL_MAGIC) return false;
+    return FramController::verifyRecord<FramSectionId::JOURNAL_HEADER>(*header);
+}
+
+bool DoseJournal::clear() {
+    // Queued appends must not land on top of the fresh journal
+    framIoWorker.flush(1000);
+
+    DoseJournalHeader hdr;
+    hdr.magic = JOURNAL_MAGIC;
+    hdr.seq = 1;
+    hdr.head = 0;
+    FramController::sealRecord<FramSectionId::JOURNAL_HEADER>(&hdr);
+
+    bool ok = framController.fillArea(FRAM_ADDR_JOURNAL_INDEX, 0xFF, FRAM_SIZE_JOURNAL_INDEX) &&
+              framController.clearArea(FRAM_ADDR_JOURNAL_HDR_B, FRAM_SIZE_JOURNAL_HDR) &&
+              framController.writeBytes(FRAM_ADDR_JOURNAL_HDR_A, &hdr, sizeof(hdr));
+
+    if (!ok) {
+        Serial.println(F("[JOURNAL] ERROR: Format failed"));
+        _initialized = false;
+        return false;
+    }
+
+    portENTER_CRITICAL(&_journalMux);
+    memset(_dayIndex, 0xFF, sizeof(_dayIndex));
+    _head = 0;
+    _committedHead = 0;
+    _headerSeq = hdr.seq;
+    _lastDay = JOURNAL_EMPTY_DAY;
+    portEXIT_CRITICAL(&_journalMux);
+
+    _initialized = true;
+    Serial.println(F("[JOURNAL] Cleared"));
+    return true;
+}
+
+// ============================================================================
+// APPEND
+// ============================================================================
+
+bool DoseJournal::append(uint32_t timestamp, uint8_t channel, uint8_t hour,
+                         EventStatus status, uint8_t validation,
+                         float targetMl, float remainingMl, uint32_t runTimeMs) {
+    if (!_initialized) return false;
+
+    DoseJournalRecord rec;
+    rec.timestamp = timestamp;
+    rec.channel = channel;
+    rec.hour = hour;
+    rec.status = (uint8_t)status;
+    rec.validation = validation;
+    rec.target_ml = (uint16_t)(targetMl * 10.0f + 0.5f);
+    rec.remaining_ml = (uint16_t)(remainingMl * 10.0f + 0.5f);
+    uint32_t cs = runTimeMs / 10;
+    rec.run_time_cs = (cs > 0xFFFF) ? 0xFFFF : (uint16_t)cs;
+    rec.check = calculateCheck(rec);
+
+    uint32_t day = getUTCDay(timestamp);
+
+    portENTER_CRITICAL(&_journalMux);
+    uint32_t seq = _head++;
+    bool newDay = (day != _lastDay);
+    _lastDay = day;
+    uint16_t slot = day % JOURNAL_DAY_INDEX_SLOTS;
+    if (newDay) {
+        _dayIndex[slot].utc_day = day;
+        _dayIndex[slot].first_seq = seq;
+    }
+    DoseJournalDayEntry entry = _dayIndex[slot];
+    portEXIT_CRITICAL(&_journalMux);
+
+    // Order matters (single FIFO queue): record, index entry, then header
+    bool ok = framIoWorker.submitWrite(FRAM_ADDR_JOURNAL_REC(seq % JOURNAL_CAPACITY),
+                                       &rec, sizeof(rec), FramIoPriority::NORMAL,
+                                       _onRecordWritten, this);
+
+    if (newDay) {
+        ok &= framIoWorker.submitWrite(FRAM_ADDR_JOURNAL_INDEX + slot * sizeof(DoseJournalDayEntry),
+                                       &entry, sizeof(entry), FramIoPriority::NORMAL,
+                                       _onRecordWritten, this);
+    }
+
+    ok &= _writeHeader();
+    return ok;
+}
+
+bool DoseJournal::_writeHeader() {
+    DoseJournalHeader hdr;
+
+    portENTER_CRITICAL(&_journalMux);
+    hdr.seq = ++_headerSeq;
+    hdr.head = _head;
+    portEXIT_CRITICAL(&_journalMux);
+
+    hdr.magic = JOURNAL_MAGIC;
+    FramController::sealRecord<FramSectionId::JOURNAL_HEADER>(&hdr);
+
+    // Alternate copies: a torn header write always leaves the previous one intact
+    uint16_t addr = (hdr.seq & 1) ? FRAM_ADDR_JOURNAL_HDR_A : FRAM_ADDR_JOURNAL_HDR_B;
+
+    return framIoWorker.submitWrite(addr, &hdr, sizeof(hdr), FramIoPriority::NORMAL,
+                                    _onHeaderWritten, (void*)(uintptr_t)hdr.head);
+}
+
+void DoseJournal::_onHeaderWritten(bool success, void* context) {
+    if (!success) {
+        portENTER_CRITICAL(&_journalMux);
+        doseJournal._writeErrors++;
+        portEXIT_CRITICAL(&_journalMux);
+        Serial.println(F("[JOURNAL] ERROR: Header write failed"));
+        return;
+    }
+
+    // Records up to this head are now durable and visible to queries
+    uint32_t head = (uint32_t)(uintptr_t)context;
+    portENTER_CRITICAL(&_journalMux);
+    if (head > doseJournal._committedHead) {
+        doseJournal._committedHead = head;
+    }
+    portEXIT_CRITICAL(&_journalMux);
+}
+
+void DoseJournal::_onRecordWritten(bool success, void* context) {
+    if (success) return;
+
+    DoseJournal* self = static_cast<DoseJournal*>(context);
+    portENTER_CRITICAL(&_journalMux);
+    self->_writeErrors++;
+    portEXIT_CRITICAL(&_journalMux);
+    Serial.println(F("[JOURNAL] ERROR: Record write failed"));
+}
+
+bool DoseJournal::isValid(const DoseJournalRecord& record) {
+    return FramController::verifyRecord<FramSectionId::JOURNAL_RECORDS>(record);
+}
+
+uint16_t DoseJournal::calculateCheck(const DoseJournalRecord& record) {
+    return (uint16_t)FramController::recordCRC<FramSectionId::JOURNAL_RECORDS>(record);
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+uint32_t DoseJournal::getHead() const {
+    portENTER_CRITICAL(&_journalMux);
+    uint32_t head = _committedHead;
+    portEXIT_CRITICAL(&_journalMux);
+    return head;
+}
+
+uint16_t DoseJournal::getCount() const {
+    uint32_t head = getHead();
+    return (head > JOURNAL_CAPACITY) ? JOURNAL_CAPACITY : (uint16_t)head;
+}
+
+// Read `count` consecutive records starting at `seq` (max two transfers on wrap)
+static bool _readRange(uint32_t seq, uint16_t count, DoseJournalRecord* out) {
+    uint16_t slot = seq % JOURNAL_CAPACITY;
+    uint16_t first = min((uint16_t)(JOURNAL_CAPACITY - slot), count);
+
+    if (!framController.readBytes(FRAM_ADDR_JOURNAL_REC(slot), out,
+                                  first * sizeof(DoseJournalRecord))) {
+        return false;
+    }
+    if (count > first) {
+        return framController.readBytes(FRAM_ADDR_JOURNAL_REC(0), out + first,
+                                        (count - first) * sizeof(DoseJournalRecord));
+    }
+    return true;
+}
+
+bool DoseJournal::read(uint32_t seq, DoseJournalRecord* record) {
+    uint32_t head = getHead();
+    uint32_t tail = (head > JOURNAL_CAPACITY) ? head - JOURNAL_CAPACITY : 0;
+
+    // RAM head may be ahead (queued writes) - only committed records are valid
+    if (seq >= head || seq < tail) return false;
+
+    if (!_readRange(seq, 1, record)) return false;
+    return isValid(*record);
+}
+
+uint16_t DoseJournal::readLast(uint16_t count, DoseJournalRecord* records) {
+    uint32_t head = getHead();
+    uint16_t available = (head > JOURNAL_CAPACITY) ? JOURNAL_CAPACITY : (uint16_t)head;
+    if (count > available) count = available;
+    if (count == 0) return 0;
+
+    if (!_readRange(head - count, count, records)) return 0;
+
+    // Oldest-first from FRAM -> newest-first (records[i] is seq head-1-i)
+    for (uint16_t i = 0, j = count - 1; i < j; i++, j--) {
+        DoseJournalRecord tmp = records[i];
+        records[i] = records[j];
+        records[j] = tmp;
+    }
+
+    return count;
+}
+
+bool DoseJournal::findDay(uint32_t utcDay, uint32_t* firstSeq) {
+    uint32_t head = getHead();
+    uint32_t tail = (head > JOURNAL_CAPACITY) ? head - JOURNAL_CAPACITY : 0;
+    if (head == tail) return false;
+
+    portENTER_CRITICAL(&_journalMux);
+    DoseJournalDayEntry entry = _dayIndex[utcDay % JOURNAL_DAY_INDEX_SLOTS];
+    portEXIT_CRITICAL(&_journalMux);
+
+    if (entry.utc_day == utcDay && entry.first_seq < head) {
+        // Start of the day may already be overwritten by the ring
+        uint32_t seq = (entry.first_seq < tail) ? tail : entry.first_seq;
+        DoseJournalRecord rec;
+        if (read(seq, &rec) && getUTCDay(rec.timestamp) == utcDay) {
+            *firstSeq = seq;
+            return true;
+        }
+    }
+
+    return _searchDay(utcDay, tail, head, firstSeq);
+}
+
+bool DoseJournal::_searchDay(uint32_t utcDay, uint32_t tail, uint32_t head, uint32_t* firstSeq) {
+    // Lower bound on timestamp; records are appended in time order
+    uint32_t lo = tail, hi = head;
+    DoseJournalRecord rec;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (!read(mid, &rec)) return false;
+        if (getUTCDay(rec.timestamp) < utcDay) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo >= head || !read(lo, &rec) || getUTCDay(rec.timestamp) != utcDay) {
+        return false;
+    }
+
+    *firstSeq = lo;
+    return true;
+}
+
+uint16_t DoseJournal::readDay(uint32_t utcDay, DoseJournalRecord* records, uint16_t maxCount) {
+    uint32_t seq;
+    if (maxCount == 0 || !findDay(utcDay, &seq)) return 0;
+
+    uint32_t head = getHead();
+    uint16_t found = 0;
+    DoseJournalRecord batch[JOURNAL_READ_BATCH];
+
+    while (seq < head && found < maxCount) {
+        uint16_t n = (head - seq > JOURNAL_READ_BATCH) ? JOURNAL_READ_BATCH : (uint16_t)(head - seq);
+        if (!_readRange(seq, n, batch)) break;
+
+        for (uint16_t i = 0; i < n && found < maxCount; i++) {
+            if (!isValid(batch[i])) continue;               // Skip corrupt entry
+            if (getUTCDay(batch[i].timestamp) != utcDay) {  // Next day reached
+                return found;
+            }
+            records[found++] = batch[i];
+        }
+        seq += n;
+    }
+
+    return found;
+}
+
+// ============================================================================
+// DEBUG
+// ============================================================================
+
+void DoseJournal::printStatus() const {
+    uint32_t head = getHead();
+    uint16_t indexed = 0;
+    for (uint16_t i = 0; i < JOURNAL_DAY_INDEX_SLOTS; i++) {
+        if (_dayIndex[i].utc_day != JOURNAL_EMPTY_DAY) indexed++;
+    }
+
+    Serial.println(F("\n=== DOSE JOURNAL ==="));
+    Serial.printf("State:       %s\n", _initialized ? "READY" : "NOT INITIALIZED");
+    Serial.printf("Records:     %d / %d\n", getCount(), JOURNAL_CAPACITY);
+    Serial.printf("Head:        %lu (RAM %lu, header seq %lu)\n",
+                  (unsigned long)head, (unsigned long)_head, (unsigned long)_headerSeq);
+    Serial.printf("Days index:  %d / %d\n", indexed, JOURNAL_DAY_INDEX_SLOTS);
+    Serial.printf("Write errs:  %lu\n", (unsigned long)_writeErrors);
+    Serial.println(F("====================\n"));
+}
+
+void DoseJournal::printRecord(uint32_t seq, const DoseJournalRecord& record) const {
+    TimeInfo t;
+    t.fromUnixTime(record.timestamp);
+    char ts[24];
+    t.toString(ts, sizeof(ts));
+
+    if (!isValid(record)) {
+        Serial.printf("#%-6lu (corrupt)\n", (unsigned long)seq);
+        return;
+    }
+
+    Serial.printf("#%-6lu %s  CH%d %02d:00  %-6s target %6.1f ml  run %6lu ms  left %7.1f ml  val %d\n",
+                  (unsigned long)seq, ts, record.channel, record.hour,
+                  record.status == EVENT_COMPLETED ? "OK" : "FAILED",
+                  record.getTargetMl(), (unsigned long)record.getRunTimeMs(),
+                  record.getRemainingMl(), record.validation);
+}
+
+void DoseJournal::printLast(uint16_t count) {
+    DoseJournalRecord records[JOURNAL_READ_BATCH];
+    if (count > JOURNAL_READ_BATCH) count = JOURNAL_READ_BATCH;
+
+    uint32_t head = getHead();
+    uint16_t n = readLast(count, records);
+
+    Serial.printf("[JOURNAL] Last %d records (newest first):\n", n);
+    for (uint16_t i = 0; i < n; i++) {
+        printRecord(head - 1 - i, records[i]);
+    }
+}
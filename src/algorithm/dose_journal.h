@@ -0,0 +1,134 @@
+/**
+ * DOZOWNIK - Dose Journal
+ * 
+ * Dziennik dozowań w FRAM: pierścień rekordów 16B o stałym rozmiarze.
+ * Kolejność zapisu: rekord -> (wpis indeksu dnia) -> header (A/B naprzemiennie).
+ * Header zapisywany jako ostatni, więc po zaniku zasilania dziennik kończy się
+ * na ostatnim w pełni zapisanym rekordzie.
+ * 
+ * Koszt zapisu na event: 32B (40B przy pierwszym evencie dnia).
+ * Indeks dni w RAM daje O(1) "ostatnie N" i wyszukiwanie dnia.
+ */
+
+#ifndef DOSE_JOURNAL_H
+#define DOSE_JOURNAL_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "dosing_types.h"
+#include "fram_layout.h"
+#include "fram_controller.h"
+#include "fram_io_worker.h"
+
+#define JOURNAL_MAGIC           0x4A524E4C  // "JRNL"
+#define JOURNAL_EMPTY_DAY       0xFFFFFFFF
+
+// ============================================================================
+// DOSE JOURNAL CLASS
+// ============================================================================
+
+class DoseJournal {
+public:
+    /**
+     * Wczytaj headery i indeks dni; formatuje dziennik jeśli pusty
+     * @return true jeśli dziennik gotowy
+     */
+    bool begin();
+    
+    bool isReady() const { return _initialized; }
+    
+    /**
+     * Dopisz zakończone dozowanie (RAM + zlecenie zapisu do taska FRAM I/O)
+     */
+    bool append(uint32_t timestamp, uint8_t channel, uint8_t hour,
+                EventStatus status, uint8_t validation,
+                float targetMl, float remainingMl, uint32_t runTimeMs);
+    
+    // --- Zapytania (tylko rekordy potwierdzone w FRAM) ---
+    
+    /**
+     * Liczba rekordów dostępnych w dzienniku (max JOURNAL_CAPACITY)
+     */
+    uint16_t getCount() const;
+    
+    /**
+     * Numer następnego rekordu (łączna liczba zapisanych)
+     */
+    uint32_t getHead() const;
+    
+    /**
+     * Odczytaj rekord o numerze seq
+     * @return false jeśli poza pierścieniem lub błąd sumy kontrolnej
+     */
+    bool read(uint32_t seq, DoseJournalRecord* record);
+    
+    /**
+     * Ostatnie N rekordów, od najnowszego (records[i] = rekord head-1-i)
+     * Rekordy z błędną sumą kontrolną zostają na swoim miejscu - sprawdź isValid().
+     * @return liczba odczytanych rekordów
+     */
+    uint16_t readLast(uint16_t count, DoseJournalRecord* records);
+    
+    /**
+     * Znajdź pierwszy rekord dnia UTC (indeks, a gdy brak - wyszukiwanie binarne)
+     * @return true jeśli dzień jest w dzienniku
+     */
+    bool findDay(uint32_t utcDay, uint32_t* firstSeq);
+    
+    /**
+     * Rekordy z danego dnia UTC, od najstarszego
+     * @return liczba odczytanych rekordów
+     */
+    uint16_t readDay(uint32_t utcDay, DoseJournalRecord* records, uint16_t maxCount);
+    
+    /**
+     * Wyczyść dziennik (nowy header, pusty indeks)
+     */
+    bool clear();
+    
+    /**
+     * Suma kontrolna rekordu
+     */
+    static uint16_t calculateCheck(const DoseJournalRecord& record);
+    
+    static bool isValid(const DoseJournalRecord& record);
+    
+    // --- Debug ---
+    
+    void printStatus() const;
+    void printRecord(uint32_t seq, const DoseJournalRecord& record) const;
+    void printLast(uint16_t count);
+
+private:
+    bool     _initialized;
+    uint32_t _head;             // Następny numer rekordu (RAM, wyprzedza FRAM)
+    uint32_t _committedHead;    // Head potwierdzony zapisem headera
+    uint32_t _headerSeq;        // Generacja ostatniego headera
+    uint32_t _lastDay;          // Dzień UTC ostatniego rekordu
+    uint32_t _writeErrors;
+    
+    DoseJournalDayEntry _dayIndex[JOURNAL_DAY_INDEX_SLOTS];
+    
+    /**
+     * Zapisz header do starszej kopii (A/B)
+     */
+    bool _writeHeader();
+    
+    /**
+     * Wyszukiwanie binarne po timestamp (fallback gdy dzień spoza indeksu)
+     */
+    bool _searchDay(uint32_t utcDay, uint32_t tail, uint32_t head, uint32_t* firstSeq);
+    
+    bool _readHeader(uint16_t address, DoseJournalHeader* header);
+    
+    static void _onHeaderWritten(bool success, void* context);
+    static void _onRecordWritten(bool success, void* context);
+};
+
+// ============================================================================
+// GLOBAL INSTANCE
+// ============================================================================
+
+extern DoseJournal doseJournal;
+
+#endif // DOSE_JOURNAL_H
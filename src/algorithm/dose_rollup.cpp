@@ -0,0 +1,303 @@
+/**
+ * DOZOWNIK - Dose Rollups Implementation
+ */
+
+#include "dose_rollup.h"
+#include "../core/civil_date.h"
+
+// Global instance
+DoseRollup doseRollup;
+
+// Current buckets: updated by loop(), read by web handlers
+static portMUX_TYPE _rollupMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Marks a current bucket that has not been bound to a period yet
+#define ROLLUP_NO_PERIOD    0xFFFF
+
+static const char* const TABLE_NAMES[ROLLUP_TABLE_COUNT] = { "daily", "weekly", "monthly" };
+
+// ============================================================================
+// PERIODS & ADDRESSING
+// ============================================================================
+
+uint16_t DoseRollup::dayPeriod(uint32_t timestamp) {
+    return (uint16_t)getUTCDay(timestamp);
+}
+
+uint16_t DoseRollup::weekPeriod(uint32_t timestamp) {
+    // 1970-01-01 was a Thursday: +3 moves week boundaries to Monday
+    return (uint16_t)((getUTCDay(timestamp) + 3) / 7);
+}
+
+uint16_t DoseRollup::monthPeriod(uint32_t timestamp) {
+    CivilDate date = civilFromDays(getUTCDay(timestamp));
+    return (uint16_t)((date.year - 1970) * 12 + (date.month - 1));
+}
+
+uint16_t DoseRollup::_periodFor(RollupTable table, uint32_t timestamp) {
+    switch (table) {
+        case ROLLUP_DAILY:   return dayPeriod(timestamp);
+        case ROLLUP_WEEKLY:  return weekPeriod(timestamp);
+        case ROLLUP_MONTHLY: return monthPeriod(timestamp);
+        default:             return ROLLUP_NO_PERIOD;
+    }
+}
+
+uint16_t DoseRollup::_slots(RollupTable table) {
+    switch (table) {
+        case ROLLUP_DAILY:   return ROLLUP_DAILY_SLOTS;
+        case ROLLUP_WEEKLY:  return ROLLUP_WEEKLY_SLOTS;
+        default:             return ROLLUP_MONTHLY_SLOTS;
+    }
+}
+
+uint16_t DoseRollup::_address(RollupTable table, uint8_t channel, uint16_t period) {
+    static const uint16_t BASE[ROLLUP_TABLE_COUNT] = {
+        FRAM_ADDR_ROLLUP_DAILY, FRAM_ADDR_ROLLUP_WEEKLY, FRAM_ADDR_ROLLUP_MONTHLY
+    };
+    uint16_t slots = _slots(table);
+    return BASE[table] + (channel * slots + (period % slots)) * sizeof(RollupBucket);
+}
+
+uint16_t DoseRollup::calculateCheck(const RollupBucket& bucket) {
+    return (uint16_t)FramController::recordCRC<FramSectionId::ROLLUP_DAILY>(bucket);
+}
+
+bool DoseRollup::isValid(const RollupBucket& bucket) {
+    return FramController::verifyRecord<FramSectionId::ROLLUP_DAILY>(bucket);
+}
+
+// ============================================================================
+// INITIALIZATION
+// ============================================================================
+
+bool DoseRollup::begin(uint32_t timestamp) {
+    for (uint8_t t = 0; t < ROLLUP_TABLE_COUNT; t++) {
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+            memset(&_current[t][ch], 0, sizeof(RollupBucket));
+            _current[t][ch].period = ROLLUP_NO_PERIOD;
+        }
+    }
+
+    _initialized = framController.isReady();
+    if (!_initialized) return false;
+
+    // Without valid time the buckets bind lazily on the first dose / rollover
+    if (timestamp == 0) return true;
+
+    for (uint8_t t = 0; t < ROLLUP_TABLE_COUNT; t++) {
+        RollupTable table = (RollupTable)t;
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+            _ensurePeriod(table, ch, _periodFor(table, timestamp));
+        }
+    }
+
+    return true;
+}
+
+bool DoseRollup::_ensurePeriod(RollupTable table, uint8_t channel, uint16_t period) {
+    if (_current[table][channel].period == period) return false;
+
+    // Continue a bucket persisted before reboot, else start the period empty
+    RollupBucket bucket;
+    bool existing = false;
+    if (framController.readBytes(_address(table, channel, period), &bucket, sizeof(bucket))) {
+        existing = (bucket.period == period && isValid(bucket));
+    }
+
+    if (!existing) {
+        memset(&bucket, 0, sizeof(bucket));
+        bucket.period = period;
+        bucket.check = calculateCheck(bucket);
+    }
+
+    portENTER_CRITICAL(&_rollupMux);
+    _current[table][channel] = bucket;
+    portEXIT_CRITICAL(&_rollupMux);
+
+    return !existing;
+}
+
+// ============================================================================
+// UPDATES
+// ============================================================================
+
+void DoseRollup::recordDose(uint32_t timestamp, uint8_t channel, bool success,
+                            float dosedMl, uint32_t runTimeMs) {
+    if (!_initialized || channel >= CHANNEL_COUNT || timestamp == 0) return;
+
+    uint32_t mlX10 = success ? (uint32_t)(dosedMl * 10.0f + 0.5f) : 0;
+
+    for (uint8_t t = 0; t < ROLLUP_TABLE_COUNT; t++) {
+        RollupTable table = (RollupTable)t;
+        _ensurePeriod(table, channel, _periodFor(table, timestamp));
+
+        portENTER_CRITICAL(&_rollupMux);
+        RollupBucket& b = _current[t][channel];
+        if (success) {
+            if (b.ok_count < 0xFFFF) b.ok_count++;
+        } else {
+            if (b.fail_count < 0xFFFF) b.fail_count++;
+        }
+        b.total_ml += mlX10;
+        b.pump_ms += runTimeMs;
+        b.check = calculateCheck(b);
+        portEXIT_CRITICAL(&_rollupMux);
+
+        _persist(table, channel);
+    }
+}
+
+void DoseRollup::rollover(uint32_t timestamp) {
+    if (!_initialized || timestamp == 0) return;
+
+    uint8_t opened = 0;
+
+    for (uint8_t t = 0; t < ROLLUP_TABLE_COUNT; t++) {
+        RollupTable table = (RollupTable)t;
+        uint16_t period = _periodFor(table, timestamp);
+
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+            // New period replaces the slot's old contents (period % slots)
+            if (_ensurePeriod(table, ch, period)) {
+                _persist(table, ch);
+                opened++;
+            }
+        }
+    }
+
+    Serial.printf("[ROLLUP] Rollover: %d new buckets (day %u, week %u, month %u)\n",
+                  opened, dayPeriod(timestamp), weekPeriod(timestamp), monthPeriod(timestamp));
+}
+
+void DoseRollup::_persist(RollupTable table, uint8_t channel) {
+    portENTER_CRITICAL(&_rollupMux);
+    RollupBucket copy = _current[table][channel];
+    portEXIT_CRITICAL(&_rollupMux);
+
+    // Whole bucket is rewritten every time - a lost write heals on the next one
+    framIoWorker.submitWrite(_address(table, channel, copy.period), &copy, sizeof(copy),
+                             FramIoPriority::NORMAL, _onBucketWritten,
+                             (void*)(uintptr_t)((table << 8) | channel));
+}
+
+void DoseRollup::_onBucketWritten(bool success, void* context) {
+    if (success) return;
+
+    uint16_t ctx = (uint16_t)(uintptr_t)context;
+    Serial.printf("[ROLLUP] ERROR: %s bucket write failed (CH%d)\n",
+                  TABLE_NAMES[(ctx >> 8) % ROLLUP_TABLE_COUNT], ctx & 0xFF);
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+bool DoseRollup::readBucket(RollupTable table, uint8_t channel, uint16_t period, RollupBucket* bucket) {
+    if (!_initialized || channel >= CHANNEL_COUNT || table >= ROLLUP_TABLE_COUNT) return false;
+
+    portENTER_CRITICAL(&_rollupMux);
+    RollupBucket current = _current[table][channel];
+    portEXIT_CRITICAL(&_rollupMux);
+
+    // Current period: RAM copy is ahead of any queued write
+    if (current.period == period) {
+        *bucket = current;
+        return true;
+    }
+
+    if (!framController.readBytes(_address(table, channel, period), bucket, sizeof(RollupBucket))) {
+        return false;
+    }
+    return bucket->period == period && isValid(*bucket);
+}
+
+bool DoseRollup::getTotals(uint8_t channel, uint16_t days, uint32_t now, RollupTotals* totals) {
+    if (!_initialized || channel >= CHANNEL_COUNT || now == 0 || days == 0) return false;
+
+    // Finest table that covers the horizon
+    RollupTable table;
+    uint16_t count;
+    if (days <= ROLLUP_DAILY_SLOTS) {
+        table = ROLLUP_DAILY;
+        count = days;
+    } else if (days <= ROLLUP_WEEKLY_SLOTS * 7) {
+        table = ROLLUP_WEEKLY;
+        count = (days + 6) / 7;
+    } else {
+        table = ROLLUP_MONTHLY;
+        count = (days + 29) / 30;
+        if (count > ROLLUP_MONTHLY_SLOTS) count = ROLLUP_MONTHLY_SLOTS;
+    }
+
+    uint16_t slots = _slots(table);
+    uint16_t last = _periodFor(table, now);
+    uint16_t first = (last + 1 >= count) ? last + 1 - count : 0;
+
+    // Whole channel table in one transfer - cost does not depend on the horizon
+    RollupBucket buf[ROLLUP_DAILY_SLOTS];
+    if (!framController.readBytes(_address(table, channel, 0), buf, slots * sizeof(RollupBucket))) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&_rollupMux);
+    RollupBucket current = _current[table][channel];
+    portEXIT_CRITICAL(&_rollupMux);
+
+    memset(totals, 0, sizeof(RollupTotals));
+    totals->table = table;
+    totals->first_period = first;
+    totals->last_period = last;
+
+    uint32_t mlX10 = 0;
+    uint32_t pumpMs = 0;
+
+    for (uint16_t p = first; p <= last; p++) {
+        const RollupBucket* b = &buf[p % slots];
+        if (current.period == p) {
+            b = &current;
+        } else if (b->period != p || !isValid(*b)) {
+            continue;   // No doses in this period (or slot holds an older one)
+        }
+        totals->ok_count += b->ok_count;
+        totals->fail_count += b->fail_count;
+        mlX10 += b->total_ml;
+        pumpMs += b->pump_ms;
+    }
+
+    totals->total_ml = mlX10 / 10.0f;
+    totals->pump_seconds = pumpMs / 1000;
+
+    // Span actually summed (period boundaries, up to today)
+    uint16_t today = dayPeriod(now);
+    if (table == ROLLUP_DAILY) {
+        totals->covered_days = count;
+    } else if (table == ROLLUP_WEEKLY) {
+        totals->covered_days = today - ((uint32_t)first * 7 - 3) + 1;
+    } else {
+        totals->covered_days = today - daysFromCivil(1970 + first / 12, first % 12 + 1, 1) + 1;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// DEBUG
+// ============================================================================
+
+void DoseRollup::printChannel(uint8_t channel, uint32_t now) {
+    static const uint16_t HORIZONS[] = { 1, 7, 30, 90, 365 };
+
+    Serial.printf("[ROLLUP] CH%d history:\n", channel);
+    for (uint8_t i = 0; i < sizeof(HORIZONS) / sizeof(HORIZONS[0]); i++) {
+        RollupTotals t;
+        if (!getTotals(channel, HORIZONS[i], now, &t)) {
+            Serial.printf("  %3u days: n/a\n", HORIZONS[i]);
+            continue;
+        }
+        Serial.printf("  %3u days: %8.1f ml  ok %4lu  fail %3lu  pump %6lu s  (%s, %u days)\n",
+                      HORIZONS[i], t.total_ml, (unsigned long)t.ok_count,
+                      (unsigned long)t.fail_count, (unsigned long)t.pump_seconds,
+                      TABLE_NAMES[t.table], t.covered_days);
+    }
+}
@@ -0,0 +1,120 @@
+/**
+ * DOZOWNIK - Dose Rollups
+ * 
+ * Sumy dozowań per kanał w trzech rozdzielczościach: dzień, tydzień, miesiąc.
+ * Bieżące buckety trzymane w RAM i aktualizowane przy każdej dawce
+ * (3 zapisy po 16B przez task FRAM I/O). Daily reset otwiera nowe okresy.
+ * 
+ * Zapytanie o dowolny horyzont = jeden odczyt tabeli kanału (max 35 bucketów),
+ * niezależnie od liczby dozowań w tym czasie.
+ */
+
+#ifndef DOSE_ROLLUP_H
+#define DOSE_ROLLUP_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "dosing_types.h"
+#include "fram_layout.h"
+#include "fram_controller.h"
+#include "fram_io_worker.h"
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+enum RollupTable : uint8_t {
+    ROLLUP_DAILY   = 0,
+    ROLLUP_WEEKLY  = 1,
+    ROLLUP_MONTHLY = 2,
+    ROLLUP_TABLE_COUNT
+};
+
+/**
+ * Wynik zapytania o zakres (tylko RAM)
+ */
+struct RollupTotals {
+    RollupTable table;          // Użyta rozdzielczość
+    uint16_t first_period;      // Pierwszy okres w sumie
+    uint16_t last_period;       // Ostatni okres (bieżący)
+    uint16_t covered_days;      // Faktycznie objęte dni (zaokrąglone do okresu)
+    float    total_ml;
+    uint32_t ok_count;
+    uint32_t fail_count;
+    uint32_t pump_seconds;
+};
+
+// ============================================================================
+// DOSE ROLLUP CLASS
+// ============================================================================
+
+class DoseRollup {
+public:
+    /**
+     * Wczytaj bieżące buckety dla podanego czasu (0 = RTC niedostępny, leniwie później)
+     */
+    bool begin(uint32_t timestamp);
+    
+    bool isReady() const { return _initialized; }
+    
+    /**
+     * Dolicz zakończone dozowanie do bieżących bucketów (dzień/tydzień/miesiąc)
+     */
+    void recordDose(uint32_t timestamp, uint8_t channel, bool success,
+                    float dosedMl, uint32_t runTimeMs);
+    
+    /**
+     * Daily reset: otwórz (i wyzeruj w FRAM) buckety nowego okresu
+     */
+    void rollover(uint32_t timestamp);
+    
+    /**
+     * Suma z ostatnich N dni (łącznie z dzisiejszym)
+     * <= 35 dni: buckety dzienne, <= 189: tygodniowe, dalej miesięczne (max 24)
+     */
+    bool getTotals(uint8_t channel, uint16_t days, uint32_t now, RollupTotals* totals);
+    
+    /**
+     * Odczytaj bucket konkretnego okresu (false = brak danych dla okresu)
+     */
+    bool readBucket(RollupTable table, uint8_t channel, uint16_t period, RollupBucket* bucket);
+    
+    // --- Okresy ---
+    
+    static uint16_t dayPeriod(uint32_t timestamp);
+    static uint16_t weekPeriod(uint32_t timestamp);     // Tydzień od poniedziałku
+    static uint16_t monthPeriod(uint32_t timestamp);    // (rok - 1970) * 12 + miesiąc - 1
+    
+    static uint16_t calculateCheck(const RollupBucket& bucket);
+    static bool isValid(const RollupBucket& bucket);
+    
+    // --- Debug ---
+    
+    void printChannel(uint8_t channel, uint32_t now);
+
+private:
+    bool _initialized;
+    RollupBucket _current[ROLLUP_TABLE_COUNT][CHANNEL_COUNT];
+    
+    /**
+     * Upewnij się, że bieżący bucket dotyczy okresu (inaczej otwórz nowy)
+     * @return true jeśli otwarto nowy okres
+     */
+    bool _ensurePeriod(RollupTable table, uint8_t channel, uint16_t period);
+    
+    void _persist(RollupTable table, uint8_t channel);
+    
+    static uint16_t _periodFor(RollupTable table, uint32_t timestamp);
+    static uint16_t _slots(RollupTable table);
+    static uint16_t _address(RollupTable table, uint8_t channel, uint16_t period);
+    
+    static void _onBucketWritten(bool success, void* context);
+};
+
+// ============================================================================
+// GLOBAL INSTANCE
+// ============================================================================
+
+extern DoseRollup doseRollup;
+
+#endif // DOSE_ROLLUP_H
@@ -0,0 +1,304 @@
+/**
+ * DOZOWNIK - Lifetime Counters Implementation
+ */
+
+#include "lifetime_counters.h"
+
+// Global instance
+LifetimeCounters lifetimeCounters;
+
+// _values / _pending: add() from web handlers (AsyncTCP task) and loop()
+static portMUX_TYPE _counterMux = portMUX_INITIALIZER_UNLOCKED;
+
+// _baseResult (set by the I/O task callback)
+#define BASE_WRITE_NONE     0
+#define BASE_WRITE_OK       1
+#define BASE_WRITE_FAILED   2
+
+// ============================================================================
+// INITIALIZATION
+// ============================================================================
+
+LifetimeCounters::LifetimeCounters()
+    : _initialized(false), _urgent(false),
+      _seq(0), _slot(FRAM_SLOT_B), _logHead(0), _logCount(0),
+      _compactDue(false), _compacting(false),
+      _baseResult(BASE_WRITE_NONE), _deltaFailed(false),
+      _lastFlushMs(0), _lastCompactMs(0), _failedAtMs(0) {
+    memset(_values, 0, sizeof(_values));
+    memset(_pending, 0, sizeof(_pending));
+    memset(_compacted, 0, sizeof(_compacted));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool LifetimeCounters::begin() {
+    _initialized = false;
+    if (!framController.isReady()) return false;
+
+    // Both slots are contiguous - one read
+    CounterBase bases[2];
+    if (!framController.readBytes(FRAM_ADDR_COUNTER_BASE(FRAM_SLOT_A), bases, sizeof(bases))) {
+        return false;
+    }
+
+    uint64_t loaded[LIFETIME_COUNTER_SLOTS];
+    memset(loaded, 0, sizeof(loaded));
+    uint16_t replayed = 0;
+
+    uint8_t slot = FramController::newestSlot<FramSectionId::COUNTER_BASE>(bases[0], bases[1]);
+    if (slot == FRAM_SLOT_NONE) {
+        // Fresh / migrated image - generation 1 is written on the first update()
+        _seq = 0;
+        _slot = FRAM_SLOT_B;
+        _logHead = 0;
+        _compactDue = true;
+        Serial.println(F("[COUNTERS] No valid base - starting from zero"));
+    } else {
+        const CounterBase& base = bases[slot == FRAM_SLOT_B ? 1 : 0];
+        memcpy(loaded, base.values, sizeof(loaded));
+        _seq = base.seq;
+        _slot = slot;
+        _logHead = base.log_head % LIFETIME_COUNTER_LOG_SIZE;
+
+        CounterDelta log[LIFETIME_COUNTER_LOG_SIZE];
+        if (!framController.readBytes(FRAM_ADDR_COUNTER_LOG, log, sizeof(log))) return false;
+
+        // Entries of this generation run from log_head up to the first one that is
+        // not (never written, torn, or left over from an older generation)
+        while (replayed < LIFETIME_COUNTER_LOG_SIZE) {
+            const CounterDelta& entry = log[(_logHead + replayed) % LIFETIME_COUNTER_LOG_SIZE];
+            if (entry.generation != (uint8_t)_seq || entry.counter >= LIFETIME_COUNTER_SLOTS ||
+                !FramController::verifyRecord<FramSectionId::COUNTER_LOG>(entry)) {
+                break;
+            }
+            loaded[entry.counter] += entry.delta;
+            replayed++;
+        }
+
+        // Full log = reset between the last entry and its compaction
+        if (replayed == LIFETIME_COUNTER_LOG_SIZE) _compactDue = true;
+    }
+
+    _logCount = replayed;
+    _stats.replayed = replayed;
+
+    // Events counted before begin() (web requests during network init) stay pending
+    portENTER_CRITICAL(&_counterMux);
+    for (uint8_t i = 0; i < LIFETIME_COUNTER_SLOTS; i++) {
+        _values[i] = loaded[i] + _pending[i];
+    }
+    portEXIT_CRITICAL(&_counterMux);
+
+    _lastFlushMs = millis();
+    _lastCompactMs = _lastFlushMs;
+    _initialized = true;
+
+    Serial.printf("[COUNTERS] Generation %lu, %u log entries replayed\n",
+                  (unsigned long)_seq, replayed);
+    return true;
+}
+
+// ============================================================================
+// EVENTS
+// ============================================================================
+
+void LifetimeCounters::add(uint8_t counter, uint32_t delta, bool urgent) {
+    if (counter >= COUNTER_COUNT || delta == 0) return;
+
+    portENTER_CRITICAL(&_counterMux);
+    _values[counter] += delta;
+    _pending[counter] += delta;
+    if (urgent) _urgent = true;
+    portEXIT_CRITICAL(&_counterMux);
+}
+
+uint64_t LifetimeCounters::get(uint8_t counter) const {
+    if (counter >= LIFETIME_COUNTER_SLOTS) return 0;
+
+    portENTER_CRITICAL(&_counterMux);
+    uint64_t value = _values[counter];
+    portEXIT_CRITICAL(&_counterMux);
+    return value;
+}
+
+// ============================================================================
+// UPDATE (called from loop)
+// ============================================================================
+
+void LifetimeCounters::update() {
+    if (!_initialized) return;
+
+    if (_compacting) {
+        if (_baseResult == BASE_WRITE_NONE) return;
+        _finishCompaction();
+    }
+
+    if (_deltaFailed) {
+        // The next base covers the lost entry - replay would stop at it
+        _deltaFailed = false;
+        _stats.write_failures++;
+        _compactDue = true;
+    }
+
+    uint32_t now = millis();
+    if (_logCount > 0 && now - _lastCompactMs >= LIFETIME_COUNTER_COMPACT_MS) {
+        _compactDue = true;
+    }
+
+    if (_compactDue) {
+        // Entries wait for the new generation; a failed base is retried at flush pace
+        if (_failedAtMs == 0 || now - _failedAtMs >= LIFETIME_COUNTER_FLUSH_MS) {
+            _compact();
+        }
+        return;
+    }
+
+    if (_urgent || now - _lastFlushMs >= LIFETIME_COUNTER_FLUSH_MS) {
+        _append();
+    }
+}
+
+void LifetimeCounters::flush() {
+    if (!_initialized || _compacting) return;     // Queued base already holds the totals
+
+    if (!_compactDue) _append();
+    if (_compactDue) _compact();
+}
+
+// ============================================================================
+// DELTA LOG
+// ============================================================================
+
+void LifetimeCounters::_append() {
+    uint32_t pending[LIFETIME_COUNTER_SLOTS];
+
+    portENTER_CRITICAL(&_counterMux);
+    memcpy(pending, _pending, sizeof(pending));
+    _urgent = false;
+    portEXIT_CRITICAL(&_counterMux);
+
+    _lastFlushMs = millis();
+
+    for (uint8_t i = 0; i < COUNTER_COUNT; i++) {
+        if (pending[i] == 0) continue;
+
+        if (_logCount >= LIFETIME_COUNTER_LOG_SIZE) {
+            _compactDue = true;
+            return;
+        }
+
+        CounterDelta entry;
+        entry.delta = pending[i];
+        entry.counter = i;
+        entry.generation = (uint8_t)_seq;
+        FramController::sealRecord<FramSectionId::COUNTER_LOG>(&entry);
+
+        uint16_t index = (_logHead + _logCount) % LIFETIME_COUNTER_LOG_SIZE;
+        if (!framIoWorker.submitWrite(FRAM_ADDR_COUNTER_DELTA(index), &entry, sizeof(entry),
+                                      FramIoPriority::NORMAL, _onDeltaWritten, this)) {
+            return;     // Stays pending - same slot next time
+        }
+
+        _logCount++;
+        _stats.appended++;
+
+        portENTER_CRITICAL(&_counterMux);
+        _pending[i] -= pending[i];
+        portEXIT_CRITICAL(&_counterMux);
+    }
+
+    if (_logCount >= LIFETIME_COUNTER_LOG_SIZE) _compactDue = true;
+}
+
+// ============================================================================
+// COMPACTION
+// ============================================================================
+
+void LifetimeCounters::_compact() {
+    CounterBase base;
+    memset(&base, 0, sizeof(base));
+
+    // Totals include deltas not logged yet - they are dropped from _pending once written
+    portENTER_CRITICAL(&_counterMux);
+    memcpy(base.values, _values, sizeof(base.values));
+    memcpy(_compacted, _pending, sizeof(_compacted));
+    portEXIT_CRITICAL(&_counterMux);
+
+    // The new generation continues the ring behind the last logged entry
+    base.seq = _seq + 1;
+    base.log_head = (_logHead + _logCount) % LIFETIME_COUNTER_LOG_SIZE;
+    FramController::sealRecord<FramSectionId::COUNTER_BASE>(&base);
+
+    // Never over the current base - it stays valid until the new one is written
+    uint8_t slot = (_slot == FRAM_SLOT_A) ? FRAM_SLOT_B : FRAM_SLOT_A;
+
+    _compacting = true;
+    _baseResult = BASE_WRITE_NONE;
+    if (!framIoWorker.submitWrite(FRAM_ADDR_COUNTER_BASE(slot), &base, sizeof(base),
+                                  FramIoPriority::NORMAL, _onBaseWritten, this) &&
+        _baseResult == BASE_WRITE_NONE) {
+        _baseResult = BASE_WRITE_FAILED;
+    }
+}
+
+void LifetimeCounters::_finishCompaction() {
+    bool ok = (_baseResult == BASE_WRITE_OK);
+    _compacting = false;
+    _baseResult = BASE_WRITE_NONE;
+
+    if (!ok) {
+        _stats.write_failures++;
+        _failedAtMs = millis() | 1;
+        Serial.println(F("[COUNTERS] ERROR: Base write failed - will retry"));
+        return;
+    }
+
+    _seq++;
+    _slot = (_slot == FRAM_SLOT_A) ? FRAM_SLOT_B : FRAM_SLOT_A;
+    _logHead = (_logHead + _logCount) % LIFETIME_COUNTER_LOG_SIZE;
+    _logCount = 0;
+    _compactDue = false;
+    _failedAtMs = 0;
+    _lastCompactMs = millis();
+    _stats.compactions++;
+
+    portENTER_CRITICAL(&_counterMux);
+    for (uint8_t i = 0; i < LIFETIME_COUNTER_SLOTS; i++) {
+        _pending[i] -= _compacted[i];
+    }
+    portEXIT_CRITICAL(&_counterMux);
+}
+
+// ============================================================================
+// I/O CALLBACKS (FRAM I/O task context)
+// ============================================================================
+
+void LifetimeCounters::_onDeltaWritten(bool success, void* context) {
+    if (!success) static_cast<LifetimeCounters*>(context)->_deltaFailed = true;
+}
+
+void LifetimeCounters::_onBaseWritten(bool success, void* context) {
+    static_cast<LifetimeCounters*>(context)->_baseResult = success ? BASE_WRITE_OK : BASE_WRITE_FAILED;
+}
+
+// ============================================================================
+// DEBUG
+// ============================================================================
+
+void LifetimeCounters::printStatus() const {
+    Serial.printf("[COUNTERS] Generation %lu (slot %c), log %u/%u from #%u%s\n",
+                  (unsigned long)_seq, _slot == FRAM_SLOT_B ? 'B' : 'A',
+                  _logCount, (unsigned)LIFETIME_COUNTER_LOG_SIZE, _logHead,
+                  _compacting ? ", compacting" : "");
+    Serial.println(F("  CH  Activations      Pump time [s]  Validation fails"));
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+        Serial.printf("  %u   %-15llu  %13.1f  %llu\n", ch,
+                      (unsigned long long)get(COUNTER_ACTIVATIONS + ch),
+                      get(COUNTER_PUMP_MS + ch) / 1000.0,
+                      (unsigned long long)get(COUNTER_VALIDATION_FAIL + ch));
+    }
+    Serial.printf("  Web requests: %llu\n", (unsigned long long)get(COUNTER_WEB_REQUESTS));
+    Serial.printf("  Appended %lu, compactions %lu, write failures %lu, replayed at boot %u\n",
+                  (unsigned long)_stats.appended, (unsigned long)_stats.compactions,
+                  (unsigned long)_stats.write_failures, _stats.replayed);
+}
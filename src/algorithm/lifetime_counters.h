@@ -0,0 +1,139 @@
+/**
+ * DOZOWNIK - Lifetime Counters
+ *
+ * Monotoniczne liczniki życia urządzenia trwałe w FRAM: aktywacje
+ * przekaźników, czas pracy pomp, błędy walidacji GPIO, żądania HTTP.
+ *
+ * Zdarzenie zmienia tylko RAM. update() dopisuje zebrane przyrosty do
+ * dziennika jako 8-bajtowe wpisy (jeden zapis przez task FRAM I/O na
+ * licznik), a gdy dziennik się zapełni lub minie LIFETIME_COUNTER_COMPACT_MS,
+ * kompaktuje go: pełne sumy trafiają do slotu bazy A/B z wyższym seq.
+ * Przy starcie: nowsza ważna baza + jej wpisy dziennika od log_head.
+ *
+ * Wpis należy do generacji bazy (pole generation + CRC), więc kompakcja
+ * nie czyści dziennika - stare wpisy przestają pasować do nowej bazy.
+ * Przerwany zapis bazy zostawia poprzednią bazę z jej kompletnym dziennikiem.
+ */
+
+#ifndef LIFETIME_COUNTERS_H
+#define LIFETIME_COUNTERS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "fram_layout.h"
+#include "fram_controller.h"
+#include "fram_io_worker.h"
+
+// ============================================================================
+// COUNTERS
+// ============================================================================
+
+/**
+ * Indeksy w CounterBase::values (NIE ZMIENIAĆ - zapisane w FRAM)
+ * Liczniki kanałowe: pierwszy indeks grupy + numer kanału
+ */
+enum LifetimeCounter : uint8_t {
+    COUNTER_ACTIVATIONS     = 0,                        // Włączenia przekaźnika
+    COUNTER_PUMP_MS         = FRAM_MAX_CHANNELS,        // Czas pracy pompy (ms)
+    COUNTER_VALIDATION_FAIL = 2 * FRAM_MAX_CHANNELS,    // Błędy walidacji GPIO
+    COUNTER_WEB_REQUESTS    = 3 * FRAM_MAX_CHANNELS,    // Żądania HTTP
+    COUNTER_COUNT
+};
+
+static_assert(COUNTER_COUNT <= LIFETIME_COUNTER_SLOTS, "Too many lifetime counters for CounterBase!");
+
+/**
+ * Diagnostyka dziennika
+ */
+struct LifetimeCounterStats {
+    uint32_t appended;          // Wpisy dopisane do dziennika
+    uint32_t compactions;       // Zapisane bazy
+    uint32_t write_failures;    // Nieudane zapisy (wpis lub baza)
+    uint16_t replayed;          // Wpisy odtworzone przy starcie
+};
+
+// ============================================================================
+// LIFETIME COUNTERS CLASS
+// ============================================================================
+
+class LifetimeCounters {
+public:
+    LifetimeCounters();
+
+    /**
+     * Wczytaj bazę i odtwórz dziennik (po framIoWorker.begin())
+     */
+    bool begin();
+
+    bool isReady() const { return _initialized; }
+
+    /**
+     * Dolicz przyrost - z dowolnego taska, tylko RAM
+     * @param urgent false = zapis odroczony do LIFETIME_COUNTER_FLUSH_MS
+     *               (częste zdarzenia zbierane w jeden wpis)
+     */
+    void add(uint8_t counter, uint32_t delta, bool urgent = true);
+
+    /**
+     * Dopisz przyrosty / kompaktuj dziennik (wołane z loop())
+     */
+    void update();
+
+    /**
+     * Zleć zapis wszystkich przyrostów od razu (przed restartem,
+     * potem framIoWorker.flush())
+     */
+    void flush();
+
+    /**
+     * Bieżąca wartość licznika (baza + dziennik + jeszcze nie zapisane)
+     */
+    uint64_t get(uint8_t counter) const;
+
+    uint32_t getGeneration() const { return _seq; }
+    uint16_t getLogUsed() const { return _logCount; }
+    const LifetimeCounterStats& getStats() const { return _stats; }
+
+    /**
+     * Debug: wszystkie liczniki + stan dziennika
+     */
+    void printStatus() const;
+
+private:
+    bool     _initialized;
+    uint64_t _values[LIFETIME_COUNTER_SLOTS];       // Sumy łącznie z _pending
+    uint32_t _pending[LIFETIME_COUNTER_SLOTS];      // Jeszcze nie w dzienniku
+    uint32_t _compacted[LIFETIME_COUNTER_SLOTS];    // _pending ujęte w zapisywanej bazie
+    bool     _urgent;
+
+    uint32_t _seq;              // Generacja bieżącej bazy (0 = brak bazy)
+    uint8_t  _slot;             // Slot bieżącej bazy
+    uint16_t _logHead;          // Pierwszy wpis generacji
+    uint16_t _logCount;         // Wpisy generacji (w tym zlecone)
+
+    bool     _compactDue;       // Dziennik pełny / błąd zapisu / okres minął
+    bool     _compacting;       // Baza w kolejce I/O
+    volatile uint8_t _baseResult;       // Wynik zapisu bazy (callback)
+    volatile bool    _deltaFailed;      // Wpis nie zapisany (callback)
+
+    uint32_t _lastFlushMs;
+    uint32_t _lastCompactMs;    // Ostatnia udana kompakcja
+    uint32_t _failedAtMs;       // Nieudany zapis bazy (0 = brak) - ponowienie co FLUSH_MS
+
+    LifetimeCounterStats _stats;
+
+    void _append();
+    void _compact();
+    void _finishCompaction();
+
+    static void _onDeltaWritten(bool success, void* context);
+    static void _onBaseWritten(bool success, void* context);
+};
+
+// ============================================================================
+// GLOBAL INSTANCE
+// ============================================================================
+
+extern LifetimeCounters lifetimeCounters;
+
+#endif // LIFETIME_COUNTERS_H
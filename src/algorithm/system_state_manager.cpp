@@ -0,0 +1,218 @@
+/**
+ * DOZOWNIK - System State Manager Implementation
+ */
+
+#include "system_state_manager.h"
+#include <stddef.h>
+
+// Global instance
+SystemStateManager systemStateManager;
+
+// Critical section for RAM state (scheduler loop vs web handlers)
+static portMUX_TYPE _stateMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// INITIALIZATION
+// ============================================================================
+
+bool SystemStateManager::begin() {
+    Serial.println(F("[SYS_STATE] Initializing..."));
+    
+    _setDefaults();
+    _dirty = false;
+    
+    if (!framController.isReady()) {
+        Serial.println(F("[SYS_STATE] FRAM not ready - RAM only (defaults)"));
+        _initialized = false;
+        return false;
+    }
+    
+    SystemState slots[2];
+    if (!framController.readSystemState(FRAM_SLOT_A, &slots[FRAM_SLOT_A]) ||
+        !framController.readSystemState(FRAM_SLOT_B, &slots[FRAM_SLOT_B])) {
+        Serial.println(F("[SYS_STATE] ERROR: Failed to read FRAM, using defaults"));
+        _initialized = false;
+        return false;
+    }
+    
+    // Newer valid slot wins - a torn write only loses the latest flush
+    uint8_t slot = FramController::newestSlot<FramSectionId::SYSTEM_STATE_A>(slots[FRAM_SLOT_A],
+                                                                               slots[FRAM_SLOT_B]);
+    SystemState loaded;
+    
+    if (slot == FRAM_SLOT_NONE) {
+        // Older firmware never kept this CRC current (and had no slot B) -
+        // keep the slot A values, sanitize flags and store a valid record
+        Serial.println(F("[SYS_STATE] CRC mismatch - repairing record"));
+        slot = FRAM_SLOT_A;
+        loaded = slots[FRAM_SLOT_A];
+        loaded.system_enabled = loaded.system_enabled ? 1 : 0;
+        loaded.system_halted = loaded.system_halted ? 1 : 0;
+        if (loaded.active_channel >= CHANNEL_COUNT) {
+            loaded.active_channel = 255;
+        }
+        loaded.seq = 0;
+        memset(loaded._padding, 0, sizeof(loaded._padding));
+        _dirty = true;
+    } else {
+        loaded = slots[slot];
+    }
+    
+    portENTER_CRITICAL(&_stateMux);
+    _state = loaded;
+    _state.crc32 = calculateCRC(_state);
+    _slot = slot;
+    portEXIT_CRITICAL(&_stateMux);
+    
+    _initialized = true;
+    
+    if (_dirty) {
+        flush();
+    }
+    
+    Serial.printf("[SYS_STATE] Loaded: %s, boots=%lu, reset day=%lu (slot %c, seq %lu)\n",
+                  _state.system_enabled ? "ENABLED" : "DISABLED",
+                  _state.boot_count, _state.last_daily_reset_day,
+                  slot == FRAM_SLOT_B ? 'B' : 'A', (unsigned long)_state.seq);
+    return true;
+}
+
+void SystemStateManager::_setDefaults() {
+    memset(&_state, 0, sizeof(_state));
+    _slot = FRAM_SLOT_A;
+    _state.system_enabled = 1;
+    _state.active_channel = 255;
+    _state.crc32 = calculateCRC(_state);
+}
+
+// ============================================================================
+// READS
+// ============================================================================
+
+SystemState SystemStateManager::getState() const {
+    portENTER_CRITICAL(&_stateMux);
+    SystemState copy = _state;
+    portEXIT_CRITICAL(&_stateMux);
+    return copy;
+}
+
+bool SystemStateManager::isEnabled() const {
+    return _state.system_enabled != 0;
+}
+
+uint32_t SystemStateManager::getLastDailyResetDay() const {
+    return _state.last_daily_reset_day;
+}
+
+uint32_t SystemStateManager::getBootCount() const {
+    return _state.boot_count;
+}
+
+uint32_t SystemStateManager::getLastEventTimestamp() const {
+    return _state.last_event_timestamp;
+}
+
+// ============================================================================
+// MUTATIONS
+// ============================================================================
+
+void SystemStateManager::setEnabled(bool enabled) {
+    portENTER_CRITICAL(&_stateMux);
+    uint8_t value = enabled ? 1 : 0;
+    if (_state.system_enabled != value) {
+        _state.system_enabled = value;
+        _touch();
+    }
+    portEXIT_CRITICAL(&_stateMux);
+}
+
+void SystemStateManager::setLastDailyResetDay(uint32_t utcDay) {
+    portENTER_CRITICAL(&_stateMux);
+    if (_state.last_daily_reset_day != utcDay) {
+        _state.last_daily_reset_day = utcDay;
+        _touch();
+    }
+    portEXIT_CRITICAL(&_stateMux);
+}
+
+void SystemStateManager::setLastEventTimestamp(uint32_t timestamp) {
+    portENTER_CRITICAL(&_stateMux);
+    if (_state.last_event_timestamp != timestamp) {
+        _state.last_event_timestamp = timestamp;
+        _touch();
+    }
+    portEXIT_CRITICAL(&_stateMux);
+}
+
+void SystemStateManager::incrementBootCount() {
+    portENTER_CRITICAL(&_stateMux);
+    _state.boot_count++;
+    _touch();
+    portEXIT_CRITICAL(&_stateMux);
+}
+
+void SystemStateManager::_touch() {
+    _state.crc32 = calculateCRC(_state);
+    _dirty = true;
+}
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+bool SystemStateManager::flush() {
+    if (!_dirty) return true;
+    if (!_initialized) return false;
+    
+    // Snapshot under lock, write outside (I2C must not run in a critical section)
+    // New generation goes to the slot not holding the last copy
+    portENTER_CRITICAL(&_stateMux);
+    _state.seq++;
+    _state.crc32 = calculateCRC(_state);
+    uint8_t slot = _slot ^ 1;
+    _slot = slot;
+    SystemState copy = _state;
+    _dirty = false;
+    portEXIT_CRITICAL(&_stateMux);
+    
+    // Copied into the request - I2C time runs on the FRAM I/O task
+    return framIoWorker.submitWrite(FRAM_ADDR_SYSTEM_STATE_SLOT(slot), &copy, sizeof(SystemState),
+                                    FramIoPriority::NORMAL, _onFlushDone, (void*)(uintptr_t)slot);
+}
+
+void SystemStateManager::_onFlushDone(bool success, void* context) {
+    if (success) return;
+    
+    uint8_t slot = (uint8_t)(uintptr_t)context;
+    Serial.printf("[SYS_STATE] ERROR: FRAM write failed (slot %c)\n", slot == FRAM_SLOT_B ? 'B' : 'A');
+    
+    // Retry on the next persistence point - into the same slot, so the
+    // other one keeps the last good copy
+    portENTER_CRITICAL(&_stateMux);
+    systemStateManager._slot = slot ^ 1;
+    systemStateManager._dirty = true;
+    portEXIT_CRITICAL(&_stateMux);
+}
+
+uint32_t SystemStateManager::calculateCRC(const SystemState& state) {
+    return FramController::recordCRC<FramSectionId::SYSTEM_STATE_A>(state);
+}
+
+// ============================================================================
+// DEBUG
+// ============================================================================
+
+void SystemStateManager::printStatus() const {
+    SystemState s = getState();
+    
+    Serial.println(F("\n=== SYSTEM STATE ==="));
+    Serial.printf("Source:      %s\n", _initialized ? "FRAM" : "defaults (RAM only)");
+    Serial.printf("Enabled:     %s\n", s.system_enabled ? "YES" : "NO");
+    Serial.printf("Halted:      %s\n", s.system_halted ? "YES" : "NO");
+    Serial.printf("Boot count:  %lu\n", s.boot_count);
+    Serial.printf("Reset day:   %lu\n", s.last_daily_reset_day);
+    Serial.printf("Last event:  %lu\n", s.last_event_timestamp);
+    Serial.printf("Slot:        %c (seq %lu)\n", _slot == FRAM_SLOT_B ? 'B' : 'A', (unsigned long)s.seq);
+    Serial.printf("Dirty:       %s\n", _dirty ? "YES" : "NO");
+    Serial.println(F("====================\n"));
+}
@@ -0,0 +1,111 @@
+/**
+ * DOZOWNIK - System State Manager
+ * 
+ * Jedyny właściciel SystemState. Kopia w RAM jest autorytatywna -
+ * wszystkie odczyty obsługiwane z pamięci, zapis do FRAM tylko
+ * w jawnych punktach (flush) i tylko gdy stan się zmienił.
+ */
+
+#ifndef SYSTEM_STATE_MANAGER_H
+#define SYSTEM_STATE_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "dosing_types.h"
+#include "fram_controller.h"
+#include "fram_io_worker.h"
+
+// ============================================================================
+// SYSTEM STATE MANAGER CLASS
+// ============================================================================
+
+class SystemStateManager {
+public:
+    /**
+     * Inicjalizacja - jednorazowy odczyt SystemState z FRAM (nowszy ważny slot A/B)
+     * Gdy oba sloty mają błędne CRC, pola slotu A są sanityzowane,
+     * a stan zapisywany ponownie.
+     * @return true jeśli stan załadowany z FRAM
+     */
+    bool begin();
+    
+    /**
+     * Czy stan załadowany z FRAM
+     */
+    bool isReady() const { return _initialized; }
+    
+    // --- Odczyty (RAM, bez I2C) ---
+    
+    /**
+     * Kopia całego stanu (spójny snapshot)
+     */
+    SystemState getState() const;
+    
+    bool isEnabled() const;
+    uint32_t getLastDailyResetDay() const;
+    uint32_t getBootCount() const;
+    uint32_t getLastEventTimestamp() const;
+    
+    // --- Modyfikacje (RAM + CRC, zapis przy flush) ---
+    
+    void setEnabled(bool enabled);
+    void setLastDailyResetDay(uint32_t utcDay);
+    void setLastEventTimestamp(uint32_t timestamp);
+    void incrementBootCount();
+    
+    // --- Persystencja ---
+    
+    /**
+     * Czy są zmiany niezapisane do FRAM
+     */
+    bool isDirty() const { return _dirty; }
+    
+    /**
+     * Zleć zapis stanu do FRAM jeśli zmieniony (write-behind, task FRAM I/O)
+     * Zapis do slotu innego niż ostatnia kopia, z seq + 1 - przerwany zapis
+     * nie niszczy poprzedniego stanu. Błąd zapisu przywraca flagę dirty -
+     * ponowienie (do tego samego slotu) przy następnym flush.
+     * @return true jeśli zapis przyjęty (lub stan już aktualny)
+     */
+    bool flush();
+    
+    /**
+     * CRC32 rekordu - wszystkie pola poza crc32
+     */
+    static uint32_t calculateCRC(const SystemState& state);
+    
+    /**
+     * Debug print
+     */
+    void printStatus() const;
+
+private:
+    bool        _initialized;
+    bool        _dirty;
+    uint8_t     _slot;          // Slot ostatniej zleconej kopii (FRAM_SLOT_A/B)
+    SystemState _state;
+    
+    /**
+     * Ustaw domyślne wartości
+     */
+    void _setDefaults();
+    
+    /**
+     * Po każdej zmianie: przelicz CRC i oznacz jako dirty
+     * (wywoływane w sekcji krytycznej)
+     */
+    void _touch();
+    
+    /**
+     * Callback zakończenia zapisu (kontekst taska FRAM I/O)
+     */
+    static void _onFlushDone(bool success, void* context);
+};
+
+// ============================================================================
+// GLOBAL INSTANCE
+// ============================================================================
+
+extern SystemStateManager systemStateManager;
+
+#endif // SYSTEM_STATE_MANAGER_H
@@ -9,8 +9,13 @@
 #include "../config/dosing_types.h"
 #include "../hardware/relay_controller.h"
 #include "../hardware/fram_controller.h"
+#include "../hardware/fram_io_worker.h"
+#include "../hardware/fram_scrubber.h"
 #include "../hardware/rtc_controller.h"
 #include "../algorithm/channel_manager.h"
+#include "../algorithm/dose_journal.h"
+#include "../algorithm/dose_rollup.h"
+#include "../algorithm/lifetime_counters.h"
 #include "../hardware/dosing_scheduler.h"
 #include "../config/fram_layout.h"
 #include <esp_system.h>
@@ -99,6 +104,60 @@ void processSerialCommand() {
             testFRAM();
             break;
 
+        case 'q':
+        case 'Q':
+            framIoWorker.printStats();
+            break;
+
+        case 'k':
+        case 'K':
+            testCrc32();
+            break;
+
+        case 'l':
+        case 'L': {
+            framController.printSectionStats();
+            Serial.println(F("[CMD] Reset section stats? (y/n): "));
+            while (!Serial.available()) delay(10);
+            char confirm = Serial.read();
+            while (Serial.available()) Serial.read();
+
+            if (confirm == 'y' || confirm == 'Y') {
+                framController.resetSectionStats();
+                Serial.println(F("[CMD] Section stats cleared"));
+            }
+            break;
+        }
+
+        case 'u':
+        case 'U': {
+            framScrubber.printStatus();
+            Serial.println(F("[CMD] Start full scrub pass now? (y/n): "));
+            while (!Serial.available()) delay(10);
+            char confirm = Serial.read();
+            while (Serial.available()) Serial.read();
+
+            if (confirm == 'y' || confirm == 'Y') {
+                framScrubber.requestPass();
+                Serial.println(F("[CMD] Scrub pass requested"));
+            }
+            break;
+        }
+
+        case 'n':
+        case 'N':
+            lifetimeCounters.printStatus();
+            break;
+
+        case 'j':
+        case 'J':
+            doseJournal.printStatus();
+            doseJournal.printLast(20);
+            for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+                doseRollup.printChannel(ch, rtcController.getUnixTime());
+            }
+            break;
+
         case 'r':
         case 'R': {
             Serial.println(F("[CMD] Factory reset FRAM? (y/n): "));
@@ -108,6 +167,7 @@ void processSerialCommand() {
 
             if (confirm == 'y' || confirm == 'Y') {
                 Serial.println(F("[CMD] Resetting FRAM..."));
+                framIoWorker.flush(1000);  // Queued writes must not land after reset
                 if (framController.factoryReset()) {
                     Serial.println(F("[CMD] Factory reset complete"));
                 } else {
@@ -155,6 +215,8 @@ void processSerialCommand() {
         case 'X':
             Serial.println(F("[REBOOT] Restarting in 2 seconds..."));
             relayController.allOff();
+            lifetimeCounters.flush();
+            framIoWorker.flush(1000);
             delay(2000);
             ESP.restart();
             break;
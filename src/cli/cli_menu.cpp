@@ -40,12 +40,18 @@ void printMenu() {
     Serial.println(F("|  SYSTEM:                                                              |"));
     Serial.println(F("|    i     I2C scan                                                     |"));
     Serial.println(F("|    s     System info                                                  |"));
-    Serial.println(F("|    c     Config struct sizes                                          |"));
+    Serial.println(F("|    c     Config struct sizes + FRAM section map                       |"));
     Serial.println(F("|    h     This help menu                                               |"));
     Serial.println(F("|    e     Toggle emergency halt                                        |"));
     Serial.println(F("|    x     Reboot                                                       |"));
     Serial.println(F("|    f     FRAM test (read all sections)                                |"));
     Serial.println(F("|    r     Factory reset FRAM                                           |"));
+    Serial.println(F("|    q     FRAM I/O queue stats                                         |"));
+    Serial.println(F("|    l     FRAM per-section I/O stats + latency histogram               |"));
+    Serial.println(F("|    u     FRAM CRC scrubber status / start pass                        |"));
+    Serial.println(F("|    j     Dose journal (last 20 events) + history totals               |"));
+    Serial.println(F("|    n     Lifetime counters (activations, pump time, failures)         |"));
+    Serial.println(F("|    k     CRC32 self-test + backend benchmark                          |"));
     Serial.println(F("|    m     Channel Manager test menu                                    |"));
     Serial.println(F("|    w     RTC test menu (time/date)                                    |"));
     Serial.println(F("|    d     Dosing scheduler test menu                                   |"));
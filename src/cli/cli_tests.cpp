@@ -8,9 +8,14 @@
 #include "../config/fram_layout.h"
 #include "../hardware/relay_controller.h"
 #include "../hardware/fram_controller.h"
+#include "../hardware/fram_io_worker.h"
+#include "../hardware/fram_migration.h"
+#include "../hardware/fram_backup.h"
 #include "../hardware/rtc_controller.h"
 #include "../algorithm/channel_manager.h"
+#include "../algorithm/dose_journal.h"
 #include "../hardware/dosing_scheduler.h"
+#include "../crypto/crc32.h"
 #include <Wire.h>
 
 // External references from main
@@ -43,7 +48,7 @@ void testTimedPump(uint8_t channel, uint32_t duration_ms) {
             lastPrint = millis();
             Serial.printf("[TEST] CH%d: %lu ms / %lu ms\n",
                           channel,
-                          relayController.getActiveRuntime(),
+                          relayController.getRuntime(channel),
                           duration_ms);
         }
 
@@ -87,6 +92,52 @@ void i2cScan() {
 // ============================================================================
 // FRAM TESTS
 // ============================================================================
+
+// Blok testowy do pomiaru przepustowości (wolny obszar FRAM)
+#define FRAM_BENCH_BLOCK_SIZE   1024
+
+/**
+ * Pomiar przepustowości FRAM przy zadanym zegarze I2C
+ * Nieniszczący: odczytany blok jest zapisywany z powrotem w to samo miejsce.
+ * UWAGA: DS3231M obsługuje max 400 kHz - przy 1 MHz na magistrali mogą być
+ * tylko transfery FRAM: kolejka I/O opróżniona, magistrala zablokowana
+ * (task I/O i scrubber czekają), RTC wstrzymany - jego I2C idzie tylko
+ * z loop(), czyli z tego taska (przerwanie SQW nie używa I2C).
+ */
+static void measureFramThroughput(uint32_t clockHz) {
+    static uint8_t block[FRAM_BENCH_BLOCK_SIZE];
+    const uint16_t addr = FRAM_ADDR_RESERVED;
+
+    // Queued writes first - nothing may land in the scratch block mid-measurement
+    if (!framIoWorker.flush(1000) || !framController.lockBus()) {
+        Serial.printf("  %4lu kHz: SKIPPED (FRAM busy)\n", clockHz / 1000);
+        return;
+    }
+
+    Wire.setClock(clockHz);
+
+    uint32_t t0 = micros();
+    bool readOk = framController.readBytesDirect(addr, block, sizeof(block));
+    uint32_t readUs = micros() - t0;
+
+    t0 = micros();
+    bool writeOk = readOk && framController.writeBytes(addr, block, sizeof(block));
+    uint32_t writeUs = micros() - t0;
+
+    Wire.setClock(I2C_FREQUENCY);
+    framController.unlockBus();
+
+    if (!readOk || !writeOk) {
+        Serial.printf("  %4lu kHz: FAILED (read %s, write %s)\n", clockHz / 1000,
+                      readOk ? "OK" : "FAIL", writeOk ? "OK" : "FAIL");
+        return;
+    }
+
+    Serial.printf("  %4lu kHz: read %lu B/s (%lu us), write %lu B/s (%lu us)\n",
+                  clockHz / 1000,
+                  (uint32_t)((uint64_t)sizeof(block) * 1000000ULL / max(readUs, (uint32_t)1)), readUs,
+                  (uint32_t)((uint64_t)sizeof(block) * 1000000ULL / max(writeUs, (uint32_t)1)), writeUs);
+}
 void testFRAM() {
     Serial.println(F("\n[FRAM TEST] Starting FRAM tests...\n"));
 
@@ -110,22 +161,32 @@ void testFRAM() {
     // Test 2: Read channel configs
     Serial.println(F("\n--- Test 2: Channel Configs ---"));
     for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        ChannelConfig cfg;
-        if (framController.readActiveConfig(i, &cfg)) {
-            Serial.printf("  CH%d: events=0x%06X days=0x%02X dose=%.1f rate=%.2f\n",
-                          i, cfg.events_bitmask, cfg.days_bitmask,
-                          cfg.daily_dose_ml, cfg.dosing_rate);
+        for (uint8_t slot = FRAM_SLOT_A; slot <= FRAM_SLOT_B; slot++) {
+            ChannelConfig cfg;
+            if (framController.readConfig(slot, i, &cfg)) {
+                Serial.printf("  CH%d/%c: events=0x%06X days=0x%02X dose=%.1f rate=%.2f seq=%lu%s%s\n",
+                              i, slot == FRAM_SLOT_B ? 'B' : 'A',
+                              cfg.events_bitmask, cfg.days_bitmask,
+                              cfg.daily_dose_ml, cfg.dosing_rate, (unsigned long)cfg.seq,
+                              cfg.has_pending ? " PENDING" : "",
+                              FramController::verifyRecord<FramSectionId::CONFIG_A>(cfg) ? "" : " (CRC BAD)");
+            }
         }
     }
 
     // Test 3: Read system state
     Serial.println(F("\n--- Test 3: System State ---"));
-    SystemState sys;
-    if (framController.readSystemState(&sys)) {
-        Serial.printf("  Enabled: %d\n", sys.system_enabled);
-        Serial.printf("  Halted:  %d\n", sys.system_halted);
-        Serial.printf("  Active:  %d\n", sys.active_channel);
-        Serial.printf("  Boots:   %lu\n", sys.boot_count);
+    for (uint8_t slot = FRAM_SLOT_A; slot <= FRAM_SLOT_B; slot++) {
+        SystemState sys;
+        if (framController.readSystemState(slot, &sys)) {
+            Serial.printf("  Slot %c: seq=%lu %s\n", slot == FRAM_SLOT_B ? 'B' : 'A',
+                          (unsigned long)sys.seq,
+                          FramController::verifyRecord<FramSectionId::SYSTEM_STATE_A>(sys) ? "OK" : "CRC BAD");
+            Serial.printf("    Enabled: %d\n", sys.system_enabled);
+            Serial.printf("    Halted:  %d\n", sys.system_halted);
+            Serial.printf("    Active:  %d\n", sys.active_channel);
+            Serial.printf("    Boots:   %lu\n", sys.boot_count);
+        }
     }
 
     // Test 4: Write/Read test
@@ -139,7 +200,8 @@ void testFRAM() {
     if (framController.writeBytes(testAddr, testData, sizeof(testData))) {
         Serial.println(F("  Write OK"));
 
-        if (framController.readBytes(testAddr, readBack, sizeof(readBack))) {
+        // From the chip itself - the mirror would return what was just written
+        if (framController.readBytesDirect(testAddr, readBack, sizeof(readBack))) {
             bool match = memcmp(testData, readBack, sizeof(testData)) == 0;
             Serial.printf("  Read OK, data %s\n", match ? "MATCHES" : "MISMATCH!");
 
@@ -159,6 +221,66 @@ void testFRAM() {
     Serial.println(F("\n--- Test 5: Header Dump ---"));
     framController.dumpSection(FRAM_ADDR_HEADER, 32);
 
+    // Test 6: Boot load - per-struct reads vs bulk section reads
+    Serial.println(F("\n--- Test 6: Boot Load Timing ---"));
+    {
+        static ChannelConfig active[CHANNEL_COUNT];
+        static ChannelConfig pending[CHANNEL_COUNT];
+        static ChannelDailyState daily[CHANNEL_COUNT];
+        static ContainerVolume volumes[CHANNEL_COUNT];
+        static DosedTracker trackers[CHANNEL_COUNT];
+
+        // Per-struct (previous ChannelManager load path)
+        framController.resetIoStats();
+        uint32_t t0 = micros();
+        bool okPerStruct = true;
+        for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+            okPerStruct &= framController.readConfig(FRAM_SLOT_A, i, &active[i]);
+            okPerStruct &= framController.readConfig(FRAM_SLOT_B, i, &pending[i]);
+            okPerStruct &= framController.readDailyState(FRAM_SLOT_A, i, &daily[i]);
+            okPerStruct &= framController.readContainerVolume(i, &volumes[i]);
+            okPerStruct &= framController.readDosedTracker(i, &trackers[i]);
+        }
+        uint32_t perStructUs = micros() - t0;
+        FramIoStats perStruct = framController.getIoStats();
+
+        // Bulk (one sequential read per section)
+        framController.resetIoStats();
+        t0 = micros();
+        bool okBulk = framController.readConfigs(FRAM_SLOT_A, active) &&
+                      framController.readConfigs(FRAM_SLOT_B, pending) &&
+                      framController.readDailyStates(FRAM_SLOT_A, daily) &&
+                      framController.readContainerVolumes(volumes) &&
+                      framController.readDosedTrackers(trackers);
+        uint32_t bulkUs = micros() - t0;
+        FramIoStats bulk = framController.getIoStats();
+
+        Serial.printf("  Per-struct: %s, %lu transactions, %lu B, %lu from mirror, %lu us\n",
+                      okPerStruct ? "OK" : "FAIL",
+                      perStruct.transactions, perStruct.bytes_read, perStruct.mirror_reads, perStructUs);
+        Serial.printf("  Bulk:       %s, %lu transactions, %lu B, %lu from mirror, %lu us\n",
+                      okBulk ? "OK" : "FAIL",
+                      bulk.transactions, bulk.bytes_read, bulk.mirror_reads, bulkUs);
+    }
+
+    // Test 7: Write throughput
+    Serial.println(F("\n--- Test 7: Throughput ---"));
+    Serial.printf("  Write chunk: %d B, factoryReset clear: %d transactions\n",
+                  FRAM_I2C_WRITE_CHUNK,
+                  (FRAM_SIZE_BYTES + FRAM_I2C_WRITE_CHUNK - 1) / FRAM_I2C_WRITE_CHUNK);
+    measureFramThroughput(400000);    // Fast-mode
+    measureFramThroughput(1000000);   // Fast-mode Plus (MB85RC256V max)
+
+    // Test 8: PSRAM mirror vs chip
+    Serial.println(F("\n--- Test 8: PSRAM Mirror ---"));
+    if (framController.isMirrorActive()) {
+        uint32_t t0 = micros();
+        uint16_t divergent = framController.checkMirror();
+        Serial.printf("  Full check: %u divergent pages, %lu ms\n",
+                      divergent, (micros() - t0) / 1000);
+    }
+    framController.printMirrorStatus();
+
     Serial.println(F("\n[FRAM TEST] Complete\n"));
 
     Serial.println(F("\n--- Container Volume CH0 ---"));
@@ -257,8 +379,12 @@ void testChannelManager() {
 
                     Serial.printf("Simulating dose of %.2f ml on CH%d at hour 12\n", dose, ch);
 
-                    if (channelManager.markEventCompleted(ch, 12, dose)) {
+                    if (channelManager.markEventCompleted(ch, 12, dose) &&
+                        channelManager.commitChannel(ch)) {
+                        const ChannelCommitStats& cost = channelManager.getLastCommitStats();
                         Serial.println(F("Event marked complete!"));
+                        Serial.printf("Commit: %d records, %d B, %d transactions, %lu us\n",
+                                      cost.records, cost.bytes, cost.transactions, cost.duration_us);
                         channelManager.printChannelInfo(ch);
                     } else {
                         Serial.println(F("Failed!"));
@@ -384,6 +510,30 @@ void testRTC() {
 // ============================================================================
 // SCHEDULER TESTS
 // ============================================================================
+
+/**
+ * Po dawce z menu: ostatni wpis dziennika musi mieć wynik walidacji cyklu
+ * (udana dawka z walidacją -> OK, nie PENDING)
+ */
+static void checkJournalEntry(uint8_t channel, bool failed) {
+    framIoWorker.flush(1000);
+
+    DoseJournalRecord record;
+    if (doseJournal.readLast(1, &record) != 1 || !DoseJournal::isValid(record) ||
+        record.channel != channel) {
+        Serial.println(F("  Journal: FAIL - no entry for this dose"));
+        return;
+    }
+
+    GpioValidationResult expected = relayController.getLastValidationResult(channel);
+    bool ok = record.status == (failed ? EVENT_FAILED : EVENT_COMPLETED) &&
+              record.validation == (uint8_t)expected &&
+              (failed || !GPIO_VALIDATION_DEFAULT || expected == GpioValidationResult::OK);
+
+    Serial.printf("  Journal: status %d, validation %d (expected %d) - %s\n",
+                  record.status, record.validation, (int)expected, ok ? "OK" : "FAIL");
+}
+
 void testScheduler() {
     Serial.println(F("\n[SCHED TEST] Scheduler Test Menu"));
     Serial.println(F("  1 - Print scheduler status"));
@@ -439,18 +589,20 @@ void testScheduler() {
 
                             if (state == SchedulerState::VALIDATING) {
                                 Serial.println(F("  Validating GPIO..."));
-                            } else if (relayController.isAnyOn()) {
+                            } else if (relayController.isChannelBusy(ch)) {
                                 Serial.printf("  Pump running: %lu ms\n",
-                                              relayController.getActiveRuntime());
+                                              relayController.getRuntime(ch));
                             }
                             delay(100);  // Faster update for validation
                         }
 
-                        if (dosingScheduler.getCurrentEvent().failed) {
+                        bool failed = dosingScheduler.getCurrentEvent().failed;
+                        if (failed) {
                             Serial.println(F("Dose FAILED!"));
                         } else {
                             Serial.println(F("Dose complete!"));
                         }
+                        checkJournalEntry(ch, failed);
                     } else {
                         Serial.println(F("Failed to start dose"));
                     }
@@ -600,6 +752,107 @@ void measureGpioTiming(uint8_t channel) {
     Serial.println();
 }
 
+// ============================================================================
+// CRC32 ENGINE TEST
+// ============================================================================
+
+// FRAM records with a trailing CRC32 over all preceding bytes
+struct StoredCrcRecord {
+    uint16_t addr;
+    uint8_t size;
+};
+
+static uint8_t collectStoredCrcRecords(StoredCrcRecord* out) {
+    uint8_t n = 0;
+    out[n++] = { FRAM_ADDR_HEADER, sizeof(FramHeader) };
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+        out[n++] = { (uint16_t)FRAM_ADDR_CONTAINER_CH(ch), sizeof(ContainerVolume) };
+        out[n++] = { (uint16_t)FRAM_ADDR_DOSED_TRACKER_CH(ch), sizeof(DosedTracker) };
+    }
+    out[n++] = { FRAM_ADDR_JOURNAL_HDR_A, sizeof(DoseJournalHeader) };
+    out[n++] = { FRAM_ADDR_JOURNAL_HDR_B, sizeof(DoseJournalHeader) };
+    return n;
+}
+
+void testCrc32() {
+    Serial.printf("[CRC32] Active backend: %s\n", Crc32::backendName(Crc32::getBackend()));
+
+    // 1. Golden vectors + cross-check against the reference loop
+    bool ok = Crc32::selfTest(true);
+    Serial.printf("[CRC32] Self-test: %s\n", ok ? "PASS" : "FAIL");
+
+    // 2. Records already stored in FRAM: every backend agrees, old ones match legacy
+    if (framController.isReady()) {
+        StoredCrcRecord records[3 + 2 * CHANNEL_COUNT];
+        uint8_t count = collectStoredCrcRecords(records);
+
+        uint8_t current[CRC32_BACKEND_COUNT] = {};
+        uint8_t legacy = 0;
+        uint8_t accepted = 0;
+        uint8_t disagree = 0;
+
+        for (uint8_t r = 0; r < count; r++) {
+            uint8_t buf[32];
+            if (!framController.readBytes(records[r].addr, buf, records[r].size)) continue;
+
+            size_t len = records[r].size - sizeof(uint32_t);
+            uint32_t stored;
+            memcpy(&stored, buf + len, sizeof(stored));
+
+            uint32_t reference = Crc32::extendWith(Crc32Backend::BYTEWISE, 0, buf, len);
+            for (uint8_t b = 0; b < CRC32_BACKEND_COUNT; b++) {
+                Crc32Backend backend = (Crc32Backend)b;
+                if (!Crc32::isAvailable(backend)) continue;
+                uint32_t crc = Crc32::extendWith(backend, 0, buf, len);
+                if (crc != reference) disagree++;
+                if (crc == stored) current[b]++;
+            }
+            if (Crc32::computeLegacy(buf, len) == stored) legacy++;
+            if (Crc32::matches(buf, len, stored)) accepted++;
+        }
+
+        for (uint8_t b = 0; b < CRC32_BACKEND_COUNT; b++) {
+            if (!Crc32::isAvailable((Crc32Backend)b)) continue;
+            Serial.printf("[CRC32] %-8s: %u/%u stored CRCs match\n",
+                          Crc32::backendName((Crc32Backend)b), current[b], count);
+        }
+        Serial.printf("[CRC32] legacy  : %u/%u stored CRCs match\n", legacy, count);
+        Serial.printf("[CRC32] Accepted: %u/%u, backend disagreements: %u\n",
+                      accepted, count, disagree);
+    }
+    Serial.printf("[CRC32] Legacy-only matches since boot: %lu\n",
+                  (unsigned long)Crc32::getLegacyMatches());
+
+    // 3. Throughput: a typical record and a 1 KB block
+    static uint8_t block[1024];
+    for (uint16_t i = 0; i < sizeof(block); i++) {
+        block[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    static const uint16_t SIZES[] = { 32, 1024 };
+    const uint16_t ROUNDS = 200;
+
+    Serial.println(F("[CRC32] Benchmark (average per call):"));
+    for (uint8_t b = 0; b < CRC32_BACKEND_COUNT; b++) {
+        Crc32Backend backend = (Crc32Backend)b;
+        if (!Crc32::isAvailable(backend)) continue;
+
+        Serial.printf("  %-8s:", Crc32::backendName(backend));
+        for (uint8_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+            volatile uint32_t sink = 0;
+            uint32_t start = micros();
+            for (uint16_t r = 0; r < ROUNDS; r++) {
+                sink = Crc32::extendWith(backend, sink, block, SIZES[s]);
+            }
+            float us = (micros() - start) / (float)ROUNDS;
+            Serial.printf("  %4u B %7.2f us (%5.1f MB/s)", SIZES[s], us,
+                          us > 0 ? SIZES[s] / us : 0.0f);
+        }
+        Serial.println();
+    }
+    Serial.println();
+}
+
 // ============================================================================
 // CONFIG STRUCT SIZES
 // ============================================================================
@@ -616,4 +869,10 @@ void printChannelConfigSize() {
     Serial.printf ("|  RelayState:          %3d bytes         |\n", sizeof(RelayState));
     Serial.println(F("+-----------------------------------------+"));
     Serial.println();
+
+    framController.printLayout();
+    Serial.println();
+    framMigration.printStatus();
+    framBackup.printStatus();
+    Serial.println();
 }
@@ -44,6 +44,11 @@ void testScheduler();
  */
 void measureGpioTiming(uint8_t channel);
 
+/**
+ * Test CRC32 - self-test, zgodność z FRAM, benchmark backendów
+ */
+void testCrc32();
+
 /**
  * Wyświetl rozmiary struktur config
  */
@@ -74,15 +74,72 @@ static const uint8_t VALIDATE_PINS[4] = {
 #define FRAM_I2C_ADDRESS    0x50
 #define RTC_I2C_ADDRESS     0x68
 
+// Podstawa czasu RTC - cache + interpolacja esp_timer (rtc_controller.h)
+#define RTC_TIMEBASE_REFRESH_MS     1000    // Min. odstęp odczytów czasu z DS3231 (bez SQW)
+
+// Wyjście SQW DS3231 (1 Hz, open-drain) - zbocze opadające = nowa sekunda
+#define RTC_SQW_PIN                 10      // GPIO10 (pull-up wewnętrzny)
+#define RTC_SQW_VERIFY_MS           60000   // Kontrolny odczyt czasu przy działającym SQW
+#define RTC_SQW_TIMEOUT_MS          1500    // Brak zbocza dłużej = powrót do odczytów co sekundę
+
+// Dyscyplina dryfu - rejestr aging offset DS3231 z historii offsetów NTP
+#define RTC_AGING_PPM_PER_LSB       0.1f    // Zmiana częstotliwości na LSB (+ = wolniej)
+#define RTC_DRIFT_MIN_BASELINE_S    21600   // Min. baza pomiaru przed korektą aging (6 h)
+#define RTC_DRIFT_TARGET_MS         50      // Dopuszczalny błąd narastający między synchronizacjami
+#define RTC_DRIFT_FLOOR_PPM         0.05f   // Dolna granica zakładanego dryfu (interwał NTP)
+#define RTC_DRIFT_HISTORY           8       // Zapamiętane synchronizacje (telemetria)
+
+// ============================================================================
+// FRAM I/O WORKER (asynchroniczny zapis/odczyt FRAM)
+// ============================================================================
+#define FRAM_IO_TASK_STACK          4096    // Stos taska I/O (bajty)
+#define FRAM_IO_TASK_PRIORITY       2       // Powyżej loop() (1)
+#define FRAM_IO_QUEUE_SAFETY        4       // Kolejka zapisów bezpieczeństwa
+#define FRAM_IO_QUEUE_NORMAL        16      // Kolejka zapisów konfiguracji/stanu
+#define FRAM_IO_MAX_PAYLOAD         192     // Maks. dane w żądaniu (6 × ChannelConfig)
+#define FRAM_IO_SUBMIT_TIMEOUT_MS   50      // Czekanie na miejsce w kolejce
+#define FRAM_IO_WAIT_MAX_MS         1000    // Max czekanie na kolejkę (miejsce / opróżnienie), potem błąd zapisu
+#define FRAM_BUS_LOCK_TIMEOUT_MS    200     // Czekanie na wyłączny dostęp do FRAM
+
+// Lustro całej FRAM w PSRAM (odczyty bez I2C, zapis write-through)
+#ifdef BOARD_HAS_PSRAM
+#define FRAM_MIRROR_ENABLED         1
+#else
+#define FRAM_MIRROR_ENABLED         0
+#endif
+#define FRAM_MIRROR_PAGE_SIZE       64      // Granulacja bitmapy dirty (bajty)
+
+// Scrubber - weryfikacja CRC wszystkich sekcji w tle (z loop())
+#define FRAM_SCRUB_BUDGET_US        2000    // Maks. czas scrubbera w jednym przebiegu loop()
+                                            // (porównanie strony lustra z układem ~1.6 ms @ 400 kHz)
+#define FRAM_SCRUB_PASS_INTERVAL_MS 60000   // Przerwa między pełnymi przebiegami
+#define FRAM_SCRUB_LOG_PER_PASS     4       // Logowane błędy na przebieg
+
+// Liczniki życia urządzenia - dziennik przyrostów w FRAM (lifetime_counters.h)
+#define LIFETIME_COUNTER_FLUSH_MS   10000   // Max opóźnienie zapisu zdarzeń częstych (HTTP)
+#define LIFETIME_COUNTER_COMPACT_MS 3600000 // Kompakcja dziennika najpóźniej co godzinę
+
 // ============================================================================
 // TIMING CONSTANTS
 // ============================================================================
+// Sen loop() między przebiegami (loop_events.h)
+#define LOOP_ACTIVE_PERIOD_MS       10      // Pompa / walidacja / scrubber / przycisk w toku
+#if ENABLE_CLI
+#define LOOP_IDLE_PERIOD_MS         100     // Spoczynek - odpytywanie Serial (CLI)
+#else
+#define LOOP_IDLE_PERIOD_MS         10000   // Spoczynek (liczniki, NTP); max WDT_TIMEOUT_SECONDS / 2
+#endif
+
+// Budzenie schedulera (jednorazowy esp_timer na następny event / reset dobowy)
+#define SCHED_WAKE_MAX_MS           600000  // Najdłuższy sen schedulera (zapas na skoki zegara)
+#define SCHED_WAKE_MARGIN_US        2000    // Budzenie tuż po granicy sekundy
+
 // Harmonogram eventów
 #define EVENTS_PER_DAY              23      // Godziny 01:00-23:00
 #define FIRST_EVENT_HOUR            1       // Pierwsza godzina eventów
 #define LAST_EVENT_HOUR             23      // Ostatnia godzina eventów
 #define RESERVED_HOUR               0       // 00:xx zarezerwowane 
-#define WDT_TIMEOUT_SECONDS         30
+#define WDT_TIMEOUT_SECONDS         30      // Task WDT loop() - ustawiany w setup() (SDK: 5 s)
 
 // Offsety czasowe kanałów (w minutach)
 #define CHANNEL_OFFSET_MINUTES      15      // CH0=:00, CH1=:10, CH2=:20...
@@ -100,6 +157,20 @@ static const uint8_t VALIDATE_PINS[4] = {
 #define CALIBRATION_DURATION_SEC    30      // Czas kalibracji pompy
 #define CALIBRATION_DURATION_MS     (CALIBRATION_DURATION_SEC * 1000UL)
 
+// Współbieżność pomp (RelayController): kilka kanałów naraz w ramach budżetu
+// prądowego zasilacza. 1 = jedna pompa naraz (tryb szeregowy jak dotąd).
+#define RELAY_MAX_CONCURRENT        1       // Maks. liczba pomp pracujących jednocześnie
+#define RELAY_CURRENT_BUDGET_MA     1500    // Budżet prądowy zasilacza pomp [mA]
+
+// Pobór prądu pompy na kanał [mA] (ustalony, z inrush - do budżetu)
+// static const uint16_t PUMP_CURRENT_MA[6] = {
+//     500, 500, 500, 500, 500, 500
+// };
+
+static const uint16_t PUMP_CURRENT_MA[4] = {
+    500, 500, 500, 500
+};
+
 // // ============================================================================
 // // GPIO VALIDATION
 // // ============================================================================
@@ -201,10 +272,14 @@ extern bool pumpGlobalEnabled;      // Globalne włączenie pomp
 #define NTP_GMT_OFFSET_SEC      0                   // RTC stores UTC
 #define NTP_DAYLIGHT_OFFSET_SEC 0                   // No DST for UTC
 
-// Sync settings
-#define NTP_SYNC_TIMEOUT_MS     20000               // 20 seconds max wait
-#define NTP_SYNC_RETRY_DELAY_MS 500                 // Delay between retries
-#define NTP_RESYNC_INTERVAL_MS  3600000             // Resync every 1 hour
+// Sync settings (incremental SNTP client in rtc_controller.cpp)
+#define NTP_LOCAL_PORT          2390                // Local UDP port for requests
+#define NTP_SAMPLES_PER_SERVER  2                   // Requests per server - best of 6 by round trip
+#define NTP_REQUEST_TIMEOUT_MS  1000                // Max wait for one response
+#define NTP_APPLY_THRESHOLD_MS  20                  // Smaller offsets leave the RTC untouched
+#define NTP_APPLY_WINDOW_US     20000               // RTC written within this after a second boundary
+#define NTP_RESYNC_INTERVAL_MS  3600000             // Resync every 1 hour (until drift is known)
+#define NTP_RESYNC_MAX_INTERVAL_MS 86400000         // Longest interval with a disciplined RTC
 #define NTP_MIN_VALID_YEAR      2024                // Timestamp sanity check
 
 // Popcount (liczba ustawionych bitów)
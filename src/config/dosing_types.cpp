@@ -3,6 +3,7 @@
  */
 
 #include "dosing_types.h"
+#include "../core/civil_date.h"
 
 // ============================================================================
 // STRING CONVERSIONS
@@ -39,10 +40,8 @@ const char* errorTypeToString(CriticalErrorType error) {
 // ============================================================================
 
 uint8_t getDayOfWeek(uint32_t unixTimestamp) {
-    // Unix epoch (1970-01-01) was Thursday
     // 0 = Monday, 6 = Sunday (ISO 8601)
-    uint32_t days = unixTimestamp / 86400UL;
-    return (days + 3) % 7;
+    return weekdayFromDays(getUTCDay(unixTimestamp));
 }
 
 uint8_t getHourUTC(uint32_t unixTimestamp) {
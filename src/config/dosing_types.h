@@ -84,7 +84,8 @@ enum PumpState : uint8_t {
 
 /**
  * Konfiguracja pojedynczego kanału
- * Przechowywana w FRAM - dwie kopie: active i pending
+ * Przechowywana w FRAM w dwóch slotach (A/B) na kanał: active to nowszy
+ * rekord z has_pending = 0, pending to rekord w drugim slocie z has_pending = 1
  */
 struct ChannelConfig {
     // === Parametry użytkownika (12 bajtów) ===
@@ -104,8 +105,9 @@ struct ChannelConfig {
     // === Checksum (4 bajty) ===
     uint32_t crc32;             // CRC32 dla walidacji danych
     
-    // === Padding do 32 bajtów ===
-    uint8_t  _padding[8];
+    // === Slot A/B (8 bajtów) ===
+    uint32_t seq;               // Generacja rekordu (wspólna dla obu slotów kanału)
+    uint8_t  _padding[4];
     
     // ------------------------------------------
     // Metody pomocnicze (inline)
@@ -170,7 +172,7 @@ struct ChannelDailyState {
     uint8_t  failed_count;      // Liczba failed dziś [NOWE]
     uint8_t  _reserved[2];      // Padding
     uint32_t crc32;             // CRC32
-    uint8_t  _padding[4];
+    uint32_t seq;               // Generacja rekordu (slot A/B, wyższa = nowsza)
     
     // ------------------------------------------
     // Metody pomocnicze
@@ -240,7 +242,8 @@ struct SystemState {
     uint8_t  _reserved[3];          // Padding
     uint32_t last_event_timestamp;  // Unix timestamp ostatniego eventu
     uint32_t crc32;                 // CRC32
-    uint8_t  _padding[8];           // Padding do 32 bajtów
+    uint32_t seq;                   // Generacja rekordu (slot A/B, wyższa = nowsza)
+    uint8_t  _padding[4];           // Padding do 32 bajtów
 };
 
 #pragma pack(pop)
@@ -360,13 +363,6 @@ static_assert(sizeof(CriticalErrorState) == 32, "CriticalErrorState must be 32 b
 
 #pragma pack(push, 1)
 
-// ============================================================================
-// CONTAINER VOLUME (pojemność pojemnika per kanał)
-// Rozmiar: 8 bajtów (packed)
-// ============================================================================
-
-#pragma pack(push, 1)
-
 /**
  * Pojemność i pozostała ilość płynu w pojemniku
  * Przechowywana w FRAM per kanał
@@ -478,6 +474,84 @@ struct DosedTracker {
 
 static_assert(sizeof(DosedTracker) == 8, "DosedTracker must be 8 bytes");
 
+// ============================================================================
+// DOSE JOURNAL (historia dozowań w FRAM)
+// Rekord: 16 bajtów (packed)
+// ============================================================================
+
+#pragma pack(push, 1)
+
+/**
+ * Pojedynczy wpis dziennika dozowań (append-only, pierścień)
+ * Objętości jako uint16_t × 10 (0.1ml precision), czas pracy w 10 ms
+ */
+struct DoseJournalRecord {
+    uint32_t timestamp;         // Unix timestamp zakończenia dawki
+    uint8_t  channel;           // Kanał (0-5)
+    uint8_t  hour;              // Godzina eventu
+    uint8_t  status;            // EventStatus (COMPLETED / FAILED)
+    uint8_t  validation;        // GpioValidationResult z RelayController
+    uint16_t target_ml;         // Planowana dawka × 10
+    uint16_t remaining_ml;      // Pozostało w pojemniku × 10 (po dawce)
+    uint16_t run_time_cs;       // Faktyczny czas pracy pompy × 10 ms
+    uint16_t check;             // Młodsze 16 bitów CRC32 pól powyżej
+    
+    inline float getTargetMl() const { return target_ml / 10.0f; }
+    inline float getRemainingMl() const { return remaining_ml / 10.0f; }
+    inline uint32_t getRunTimeMs() const { return run_time_cs * 10UL; }
+};
+
+/**
+ * Header dziennika - dwie kopie (A/B), zapisywany PO rekordzie
+ * head = liczba wszystkich zapisanych rekordów (monotoniczny)
+ */
+struct DoseJournalHeader {
+    uint32_t magic;             // JOURNAL_MAGIC
+    uint32_t seq;               // Generacja headera (wyższa = nowsza)
+    uint32_t head;              // Numer następnego rekordu
+    uint32_t crc32;             // CRC32 pól powyżej
+};
+
+/**
+ * Wpis indeksu dni: pierwszy rekord danego dnia UTC
+ */
+struct DoseJournalDayEntry {
+    uint32_t utc_day;           // Dzień UTC (0xFFFFFFFF = pusty)
+    uint32_t first_seq;         // Numer pierwszego rekordu tego dnia
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(DoseJournalRecord) == 16, "DoseJournalRecord must be 16 bytes");
+static_assert(sizeof(DoseJournalHeader) == 16, "DoseJournalHeader must be 16 bytes");
+static_assert(sizeof(DoseJournalDayEntry) == 8, "DoseJournalDayEntry must be 8 bytes");
+
+// ============================================================================
+// ROLLUP BUCKET (suma za dzień / tydzień / miesiąc)
+// Rozmiar: 16 bajtów (packed)
+// ============================================================================
+
+#pragma pack(push, 1)
+
+/**
+ * Zagregowane dozowania kanału w jednym okresie
+ * Bucket ważny tylko gdy period == szukany okres i check się zgadza
+ */
+struct RollupBucket {
+    uint16_t period;            // Dzień UTC / tydzień / miesiąc (od epoch)
+    uint16_t ok_count;          // Udane dozowania
+    uint16_t fail_count;        // Nieudane dozowania
+    uint32_t total_ml;          // Suma dozowana × 10
+    uint32_t pump_ms;           // Łączny czas pracy pompy (ms)
+    uint16_t check;             // Młodsze 16 bitów CRC32 pól powyżej
+    
+    inline float getTotalMl() const { return total_ml / 10.0f; }
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(RollupBucket) == 16, "RollupBucket must be 16 bytes");
+
 // ============================================================================
 // UTILITY FUNCTIONS (deklaracje)
 // ============================================================================
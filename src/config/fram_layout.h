@@ -24,35 +24,56 @@
 // MAGIC NUMBERS & VERSION
 // ============================================================================
 #define FRAM_MAGIC_NUMBER       0x444F5A41  // "DOZA" in ASCII
-#define FRAM_LAYOUT_VERSION     7           // v7: Added DosedTracker
+#define FRAM_LAYOUT_VERSION     9           // v9: liczniki życia (migracja: fram_migration.cpp)
 
 // ============================================================================
-// FRAM MEMORY LAYOUT v6 - CORRECTED
+// FRAM MEMORY LAYOUT v9
 // MB85RC256V: 32KB (32,768 bytes = 0x8000)
 // ============================================================================
+// Adresy i rozmiary wylicza tablica sekcji (FRAM_SECTIONS) w czasie
+// kompilacji. Poniższa mapa to dokumentacja - zgodność z nią wymuszają
+// static_assert na końcu pliku (przesunięcie sekcji = utrata danych).
+//
 // Section             | Address    | Size      | Description
 // --------------------|------------|-----------|--------------------------------
 // HEADER              | 0x0000     | 32 B      | Magic, version, checksum
 // CREDENTIALS         | 0x0020     | 1024 B    | Encrypted WiFi credentials
-// SYSTEM_STATE        | 0x0420     | 32 B      | Global system state
-// ACTIVE_CONFIG       | 0x0440     | 192 B     | Active config (6 × 32B max)
-// PENDING_CONFIG      | 0x0500     | 192 B     | Pending config (6 × 32B max)
-// DAILY_STATE         | 0x05C0     | 144 B     | Daily state (6 × 24B max)
+// SYSTEM_STATE_A      | 0x0420     | 32 B      | Global system state, slot A
+// CONFIG_A            | 0x0440     | 192 B     | Channel config slot A (6 × 32B)
+// CONFIG_B            | 0x0500     | 192 B     | Channel config slot B (6 × 32B)
+// DAILY_STATE_A       | 0x05C0     | 144 B     | Daily state slot A (6 × 24B)
 // CRITICAL_ERROR      | 0x0650     | 32 B      | Critical error state
 // AUTH_DATA           | 0x0670     | 64 B      | Admin password hash
 // SESSION_DATA        | 0x06B0     | 128 B     | Session data
 // CONTAINER_VOLUME    | 0x0730     | 48 B      | Container volumes (6 × 8B)
 // DOSED_TRACKER       | 0x0760     | 48 B      | Dosed since reset (6 × 8B)
-// (free)              | 0x0790     | 112 B     | Reserved for future use
-// RESERVED            | 0x0800     | 30,720 B  | Future expansion (~30KB free)
+// FREE_SPACE          | 0x0790     | 112 B     | Reserved for future use
+// JOURNAL_HEADER      | 0x0800     | 32 B      | Dose journal headers A/B
+// JOURNAL_INDEX       | 0x0820     | 1,024 B   | Day index (128 × 8B)
+// JOURNAL_RECORDS     | 0x0C20     | 16,384 B  | Dose records (1024 × 16B)
+// ROLLUP_DAILY        | 0x4C20     | 3,360 B   | Daily buckets (6 × 35 × 16B)
+// ROLLUP_WEEKLY       | 0x5940     | 2,592 B   | Weekly buckets (6 × 27 × 16B)
+// ROLLUP_MONTHLY      | 0x6360     | 2,304 B   | Monthly buckets (6 × 24 × 16B)
+// SYSTEM_STATE_B      | 0x6C60     | 32 B      | Global system state, slot B
+// DAILY_STATE_B       | 0x6C80     | 144 B     | Daily state slot B (6 × 24B)
+// COUNTER_BASE        | 0x6D10     | 344 B     | Lifetime counters base A/B (2 × 172B)
+// COUNTER_LOG         | 0x6E70     | 384 B     | Counter delta log (48 × 8B)
+// RESERVED            | 0x6FF0     | 4,112 B   | Future expansion (~4KB free),
+//                     |            |           | last 1 KB = migration scratch
 // (end of FRAM)       | 0x8000     |           |
 // ============================================================================
 
-// ----------------------------------------------------------------------------
-// HEADER (0x0000 - 0x001F)
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_HEADER            0x0000
-#define FRAM_SIZE_HEADER            32
+// Sekcje kanałowe zawsze rezerwują miejsce na 6 kanałów
+#define FRAM_MAX_CHANNELS               6
+
+// Liczniki życia: miejsca w bazie i pojemność dziennika przyrostów
+// (dziennik < 256 wpisów - generacja we wpisie ma 8 bitów)
+#define LIFETIME_COUNTER_SLOTS          20
+#define LIFETIME_COUNTER_LOG_SIZE       48
+
+// ============================================================================
+// RECORD TYPES
+// ============================================================================
 
 #pragma pack(push, 1)
 
@@ -67,73 +88,9 @@ struct FramHeader {
     uint32_t header_crc;        // CRC32 headera
 };
 
-#pragma pack(pop)
-
-static_assert(sizeof(FramHeader) == FRAM_SIZE_HEADER, "FramHeader size mismatch");
-
-// ----------------------------------------------------------------------------
-// CREDENTIALS SECTION (0x0020 - 0x041F)
-// Kompatybilne z projektem DOLEWKA - NIE ZMIENIAĆ ROZMIARU!
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_CREDENTIALS       0x0020
-#define FRAM_SIZE_CREDENTIALS       1024
-
-// Struktura credentials zdefiniowana w fram_encryption.h
-
-// ----------------------------------------------------------------------------
-// SYSTEM STATE (0x0420 - 0x043F)
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_SYSTEM_STATE      0x0420
-#define FRAM_SIZE_SYSTEM_STATE      32
-
-// Używa struct SystemState z dosing_types.h
-
-// ----------------------------------------------------------------------------
-// ACTIVE CONFIG (0x0440 - 0x04FF)
-// Obecnie działająca konfiguracja kanałów
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_ACTIVE_CONFIG     0x0440
-#define FRAM_SIZE_ACTIVE_CONFIG     (CHANNEL_COUNT * sizeof(ChannelConfig))
-
-// Makro do obliczenia adresu kanału
-#define FRAM_ADDR_ACTIVE_CH(n)      (FRAM_ADDR_ACTIVE_CONFIG + ((n) * sizeof(ChannelConfig)))
-
-// ----------------------------------------------------------------------------
-// PENDING CONFIG (0x0500 - 0x05BF)
-// Konfiguracja oczekująca na aktywację (od następnej doby)
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_PENDING_CONFIG    0x0500
-#define FRAM_SIZE_PENDING_CONFIG    (CHANNEL_COUNT * sizeof(ChannelConfig))
-
-#define FRAM_ADDR_PENDING_CH(n)     (FRAM_ADDR_PENDING_CONFIG + ((n) * sizeof(ChannelConfig)))
-
-// ----------------------------------------------------------------------------
-// DAILY STATE (0x05C0 - 0x064F)
-// Stan dzienny kanałów - resetowany o północy
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_DAILY_STATE       0x05C0
-#define FRAM_SIZE_DAILY_STATE_MAX   (6 * sizeof(ChannelDailyState))  // Zawsze rezerwuj na 6 kanałów
-#define FRAM_SIZE_DAILY_STATE       (CHANNEL_COUNT * sizeof(ChannelDailyState))
-
-#define FRAM_ADDR_DAILY_CH(n)       (FRAM_ADDR_DAILY_STATE + ((n) * sizeof(ChannelDailyState)))
-
-// ----------------------------------------------------------------------------
-// CRITICAL ERROR STATE (0x0650 - 0x066F)
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_CRITICAL_ERROR    0x0650
-#define FRAM_SIZE_CRITICAL_ERROR    32
-
-// Używa struct CriticalErrorState z dosing_types.h (32 bajty)
-
-// ----------------------------------------------------------------------------
-// AUTH DATA (0x0670 - 0x06AF)
-// Hash hasła administratora + salt
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_AUTH_DATA         0x0670
-#define FRAM_SIZE_AUTH_DATA         64
-
-#pragma pack(push, 1)
-
+/**
+ * Hash hasła administratora + salt
+ */
 struct AuthData {
     uint8_t  password_hash[32];     // SHA-256 hash
     uint8_t  salt[16];              // Random salt
@@ -143,55 +100,339 @@ struct AuthData {
     uint32_t crc32;                 // CRC32
 };
 
+/**
+ * Liczniki życia urządzenia - stan skompaktowany (dwie kopie A/B)
+ * Wpisy dziennika generacji seq zaczynają się od log_head.
+ */
+struct CounterBase {
+    uint32_t seq;                   // Generacja (wyższa = nowsza)
+    uint16_t log_head;              // Pierwszy wpis dziennika tej generacji
+    uint16_t _reserved;
+    uint64_t values[LIFETIME_COUNTER_SLOTS];
+    uint32_t crc32;                 // CRC32
+};
+
+/**
+ * Przyrost licznika w dzienniku (pierścień, dopisywany za poprzednim)
+ */
+struct CounterDelta {
+    uint32_t delta;                 // Przyrost
+    uint8_t  counter;               // Indeks w CounterBase::values
+    uint8_t  generation;            // Młodsze 8 bitów seq bazy
+    uint16_t check;                 // Młodsze 16 bitów CRC32 pól powyżej
+};
+
+/**
+ * Surowy blok bajtów - sekcje bez struktury rekordu
+ * (credentials: struktura w fram_encryption.h, kompatybilna z DOLEWKA)
+ */
+template <uint16_t N>
+struct FramBlob {
+    uint8_t bytes[N];
+};
+
 #pragma pack(pop)
 
-static_assert(sizeof(AuthData) == FRAM_SIZE_AUTH_DATA, "AuthData size mismatch");
-
-// ----------------------------------------------------------------------------
-// SESSION DATA (0x06B0 - 0x072F)
-// Dane sesji (persistence między restartami)
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_SESSION_DATA      0x06B0
-#define FRAM_SIZE_SESSION_DATA      128
-
-// ----------------------------------------------------------------------------
-// CONTAINER VOLUME (0x0730 - 0x075F)
-// Pojemność i pozostała ilość płynu w pojemnikach (6 kanałów × 8B)
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_CONTAINER_VOLUME      0x0730
-#define FRAM_SIZE_CONTAINER_VOLUME      48      // 6 kanałów × 8B
-
-#define FRAM_ADDR_CONTAINER_CH(n)       (FRAM_ADDR_CONTAINER_VOLUME + ((n) * 8))
-
-// ----------------------------------------------------------------------------
-// DOSED TRACKER (0x0760 - 0x078F)
-// Suma dozowana od ostatniego resetu (6 kanałów × 8B)
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_DOSED_TRACKER         0x0760
-#define FRAM_SIZE_DOSED_TRACKER         48      // 6 kanałów × 8B
-
-#define FRAM_ADDR_DOSED_TRACKER_CH(n)   (FRAM_ADDR_DOSED_TRACKER + ((n) * 8))
-
-// ----------------------------------------------------------------------------
-// FREE SPACE (0x0790 - 0x07FF)
-// Zarezerwowane na przyszłość (112B)
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_FREE_SPACE            0x0790
-#define FRAM_SIZE_FREE_SPACE            112
-
-// ----------------------------------------------------------------------------
-// RESERVED (0x0800 - 0x7FFF)
-// Daily Log removed - free space (~30KB) for future use
-// ----------------------------------------------------------------------------
-#define FRAM_ADDR_RESERVED              0x0800
-#define FRAM_SIZE_RESERVED              (FRAM_SIZE_BYTES - FRAM_ADDR_RESERVED)  // ~30KB
+static_assert(sizeof(FramHeader) == 32, "FramHeader size mismatch");
+static_assert(sizeof(AuthData) == 64, "AuthData size mismatch");
+static_assert(sizeof(CounterBase) == 172, "CounterBase size mismatch");
+static_assert(sizeof(CounterDelta) == 8, "CounterDelta size mismatch");
+
+// Parametry dziennika dozowania i rollupów (rozmiary sekcji)
+#define JOURNAL_DAY_INDEX_SLOTS         128     // Dni w indeksie (slot = dzień % 128)
+#define JOURNAL_CAPACITY                1024    // Rekordów w pierścieniu
+
+#define ROLLUP_MAX_CHANNELS             FRAM_MAX_CHANNELS
+#define ROLLUP_DAILY_SLOTS              35      // 5 tygodni
+#define ROLLUP_WEEKLY_SLOTS             27      // ~6 miesięcy
+#define ROLLUP_MONTHLY_SLOTS            24      // 2 lata
+
+// ============================================================================
+// SECTION TABLE
+// ============================================================================
+// Kolejność = kolejność w pamięci. Każda sekcja zaczyna się na pierwszej
+// granicy FRAM_PAGE_SIZE za poprzednią. Nowe sekcje dopisuj przed RESERVED.
+//
+// Sekcje *_A / *_B to pary slotów: rekord z polem seq zapisywany jest
+// zawsze do slotu nie zawierającego ostatniej kopii, przy starcie wygrywa
+// nowsza ważna kopia - przerwany zapis nie niszczy poprzedniego stanu.
+//
+//   SECTION(id, typ rekordu, liczba rekordów, pole CRC)
+//   PLAIN  (id, typ rekordu, liczba rekordów)             - bez CRC
+//
+// Dziennik i rollupy: sumy kontrolne liczone w swoich modułach
+// (pole check = młodsze 16 bitów CRC32).
+
+#define FRAM_SECTIONS(SECTION, PLAIN)                                                       \
+    SECTION(HEADER,           FramHeader,           1,                        header_crc)   \
+    PLAIN  (CREDENTIALS,      FramBlob<1024>,       1)                                      \
+    SECTION(SYSTEM_STATE_A,   SystemState,          1,                        crc32)        \
+    SECTION(CONFIG_A,         ChannelConfig,        FRAM_MAX_CHANNELS,        crc32)        \
+    SECTION(CONFIG_B,         ChannelConfig,        FRAM_MAX_CHANNELS,        crc32)        \
+    SECTION(DAILY_STATE_A,    ChannelDailyState,    FRAM_MAX_CHANNELS,        crc32)        \
+    SECTION(CRITICAL_ERROR,   CriticalErrorState,   1,                        crc32)        \
+    SECTION(AUTH_DATA,        AuthData,             1,                        crc32)        \
+    PLAIN  (SESSION_DATA,     FramBlob<128>,        1)                                      \
+    SECTION(CONTAINER_VOLUME, ContainerVolume,      FRAM_MAX_CHANNELS,        crc32)        \
+    SECTION(DOSED_TRACKER,    DosedTracker,         FRAM_MAX_CHANNELS,        crc32)        \
+    PLAIN  (FREE_SPACE,       FramBlob<112>,        1)                                      \
+    SECTION(JOURNAL_HEADER,   DoseJournalHeader,    2,                        crc32)        \
+    PLAIN  (JOURNAL_INDEX,    DoseJournalDayEntry,  JOURNAL_DAY_INDEX_SLOTS)                \
+    SECTION(JOURNAL_RECORDS,  DoseJournalRecord,    JOURNAL_CAPACITY,         check)        \
+    SECTION(ROLLUP_DAILY,     RollupBucket,         FRAM_MAX_CHANNELS * ROLLUP_DAILY_SLOTS,   check) \
+    SECTION(ROLLUP_WEEKLY,    RollupBucket,         FRAM_MAX_CHANNELS * ROLLUP_WEEKLY_SLOTS,  check) \
+    SECTION(ROLLUP_MONTHLY,   RollupBucket,         FRAM_MAX_CHANNELS * ROLLUP_MONTHLY_SLOTS, check) \
+    SECTION(SYSTEM_STATE_B,   SystemState,          1,                        crc32)        \
+    SECTION(DAILY_STATE_B,    ChannelDailyState,    FRAM_MAX_CHANNELS,        crc32)        \
+    SECTION(COUNTER_BASE,     CounterBase,          2,                        crc32)        \
+    SECTION(COUNTER_LOG,      CounterDelta,         LIFETIME_COUNTER_LOG_SIZE, check)       \
+    PLAIN  (RESERVED,         FramBlob<FRAM_SIZE_BYTES - FRAM_SECTION_START(RESERVED)>, 1)
+
+#define FRAM_SECTION_ENUM(id, ...)      id,
+
+enum class FramSectionId : uint8_t {
+    FRAM_SECTIONS(FRAM_SECTION_ENUM, FRAM_SECTION_ENUM)
+    COUNT
+};
+
+#define FRAM_SECTION_COUNT              ((uint8_t)FramSectionId::COUNT)
+#define FRAM_NO_CRC                     0xFFFF
+
+/**
+ * Deklaracja sekcji: typ rekordu, liczba rekordów, położenie pola CRC
+ */
+template <FramSectionId Id> struct FramSectionDecl;
+
+#define FRAM_SECTION_DECL(id, type, records, crcField)                              \
+    template <> struct FramSectionDecl<FramSectionId::id> {                         \
+        typedef type Record;                                                        \
+        static constexpr uint16_t count() { return records; }                       \
+        static constexpr uint16_t crcOffset() { return offsetof(type, crcField); }  \
+        static constexpr uint8_t crcSize() { return sizeof(type::crcField); }       \
+    };
+
+#define FRAM_PLAIN_DECL(id, type, records)                                          \
+    template <> struct FramSectionDecl<FramSectionId::id> {                         \
+        typedef type Record;                                                        \
+        static constexpr uint16_t count() { return records; }                       \
+        static constexpr uint16_t crcOffset() { return FRAM_NO_CRC; }               \
+        static constexpr uint8_t crcSize() { return 0; }                            \
+    };
+
+constexpr uint32_t framAlignUp(uint32_t value, uint32_t align) {
+    return (value + align - 1) / align * align;
+}
+
+template <FramSectionId Id> struct FramSection;
+
+/** Koniec poprzedniej sekcji (0 dla pierwszej) */
+template <uint8_t Index>
+struct FramSectionStart {
+    static constexpr uint32_t value() { return FramSection<(FramSectionId)(Index - 1)>::end(); }
+};
+
+template <>
+struct FramSectionStart<0> {
+    static constexpr uint32_t value() { return 0; }
+};
+
+/**
+ * Sekcja FRAM - wszystko liczone w czasie kompilacji
+ */
+template <FramSectionId Id>
+struct FramSection {
+    typedef FramSectionDecl<Id> Decl;
+    typedef typename Decl::Record Record;
+
+    static constexpr uint16_t count()       { return Decl::count(); }
+    static constexpr uint16_t recordSize()  { return sizeof(Record); }
+    static constexpr uint32_t size()        { return (uint32_t)Decl::count() * sizeof(Record); }
+    static constexpr uint16_t address()     { return framAlignUp(FramSectionStart<(uint8_t)Id>::value(), FRAM_PAGE_SIZE); }
+    static constexpr uint32_t end()         { return address() + size(); }
+
+    static constexpr uint16_t recordAddress(uint16_t index) {
+        return address() + index * sizeof(Record);
+    }
+
+    static constexpr bool hasCrc()          { return Decl::crcOffset() != FRAM_NO_CRC; }
+    static constexpr uint16_t crcOffset()   { return Decl::crcOffset(); }
+    static constexpr uint8_t crcSize()      { return Decl::crcSize(); }
+};
+
+#define FRAM_SECTION_START(id)          FramSectionStart<(uint8_t)FramSectionId::id>::value()
+#define FRAM_SECTION_ADDR(id)           FramSection<FramSectionId::id>::address()
+#define FRAM_SECTION_SIZE(id)           FramSection<FramSectionId::id>::size()
+#define FRAM_SECTION_END(id)            FramSection<FramSectionId::id>::end()
+#define FRAM_RECORD_ADDR(id, n)         FramSection<FramSectionId::id>::recordAddress(n)
+
+FRAM_SECTIONS(FRAM_SECTION_DECL, FRAM_PLAIN_DECL)
+
+/**
+ * Opis sekcji w czasie działania (debug, statystyki, narzędzia)
+ */
+struct FramSectionInfo {
+    const char* name;
+    uint16_t address;
+    uint16_t recordSize;
+    uint16_t count;
+    uint16_t crcOffset;         // FRAM_NO_CRC jeśli brak
+    uint8_t  crcSize;
+    uint32_t size;
+};
+
+// Definicja tablicy: FRAM_SECTIONS(FRAM_SECTION_INFO_ENTRY, FRAM_SECTION_INFO_ENTRY)
+#define FRAM_SECTION_INFO_ENTRY(id, type, records, ...)                     \
+    { #id, FRAM_SECTION_ADDR(id), sizeof(type), records,                    \
+      FramSection<FramSectionId::id>::crcOffset(),                          \
+      FramSection<FramSectionId::id>::crcSize(), FRAM_SECTION_SIZE(id) },
+
+extern const FramSectionInfo FRAM_SECTION_INFO[FRAM_SECTION_COUNT];
+
+// ============================================================================
+// SECTION ADDRESSES
+// ============================================================================
+
+// Header
+#define FRAM_ADDR_HEADER                FRAM_SECTION_ADDR(HEADER)
+#define FRAM_SIZE_HEADER                FRAM_SECTION_SIZE(HEADER)
+
+// Credentials - kompatybilne z projektem DOLEWKA, NIE ZMIENIAĆ ROZMIARU!
+#define FRAM_ADDR_CREDENTIALS           FRAM_SECTION_ADDR(CREDENTIALS)
+#define FRAM_SIZE_CREDENTIALS           FRAM_SECTION_SIZE(CREDENTIALS)
+
+// Pary slotów A/B (zapis naprzemienny, ważny rekord z wyższym seq)
+#define FRAM_SLOT_A                     0
+#define FRAM_SLOT_B                     1
+#define FRAM_SLOT_NONE                  0xFF
+
+// System state (struct SystemState z dosing_types.h)
+#define FRAM_ADDR_SYSTEM_STATE_A        FRAM_SECTION_ADDR(SYSTEM_STATE_A)
+#define FRAM_ADDR_SYSTEM_STATE_B        FRAM_SECTION_ADDR(SYSTEM_STATE_B)
+#define FRAM_SIZE_SYSTEM_STATE          sizeof(SystemState)
+#define FRAM_ADDR_SYSTEM_STATE_SLOT(s)  ((s) == FRAM_SLOT_B ? FRAM_ADDR_SYSTEM_STATE_B : FRAM_ADDR_SYSTEM_STATE_A)
+
+// Channel config - active i pending w slotach A/B (rola wynika z seq i has_pending)
+#define FRAM_ADDR_CONFIG_A              FRAM_SECTION_ADDR(CONFIG_A)
+#define FRAM_ADDR_CONFIG_B              FRAM_SECTION_ADDR(CONFIG_B)
+#define FRAM_SIZE_CONFIG_SLOT           FRAM_SECTION_SIZE(CONFIG_A)
+#define FRAM_ADDR_CONFIG_CH(s, n)       ((s) == FRAM_SLOT_B ? FRAM_RECORD_ADDR(CONFIG_B, n) : FRAM_RECORD_ADDR(CONFIG_A, n))
+
+// Daily state - resetowany o północy
+#define FRAM_ADDR_DAILY_STATE_A         FRAM_SECTION_ADDR(DAILY_STATE_A)
+#define FRAM_ADDR_DAILY_STATE_B         FRAM_SECTION_ADDR(DAILY_STATE_B)
+#define FRAM_SIZE_DAILY_STATE           FRAM_SECTION_SIZE(DAILY_STATE_A)
+#define FRAM_ADDR_DAILY_CH(s, n)        ((s) == FRAM_SLOT_B ? FRAM_RECORD_ADDR(DAILY_STATE_B, n) : FRAM_RECORD_ADDR(DAILY_STATE_A, n))
+
+// Critical error (struct CriticalErrorState z dosing_types.h)
+#define FRAM_ADDR_CRITICAL_ERROR        FRAM_SECTION_ADDR(CRITICAL_ERROR)
+#define FRAM_SIZE_CRITICAL_ERROR        FRAM_SECTION_SIZE(CRITICAL_ERROR)
+
+// Auth data - hash hasła administratora + salt
+#define FRAM_ADDR_AUTH_DATA             FRAM_SECTION_ADDR(AUTH_DATA)
+#define FRAM_SIZE_AUTH_DATA             FRAM_SECTION_SIZE(AUTH_DATA)
+
+// Session data (persistence między restartami)
+#define FRAM_ADDR_SESSION_DATA          FRAM_SECTION_ADDR(SESSION_DATA)
+#define FRAM_SIZE_SESSION_DATA          FRAM_SECTION_SIZE(SESSION_DATA)
+
+// Container volume - pojemność i pozostała ilość płynu
+#define FRAM_ADDR_CONTAINER_VOLUME      FRAM_SECTION_ADDR(CONTAINER_VOLUME)
+#define FRAM_SIZE_CONTAINER_VOLUME      FRAM_SECTION_SIZE(CONTAINER_VOLUME)
+#define FRAM_ADDR_CONTAINER_CH(n)       FRAM_RECORD_ADDR(CONTAINER_VOLUME, n)
+
+// Dosed tracker - suma dozowana od ostatniego resetu
+#define FRAM_ADDR_DOSED_TRACKER         FRAM_SECTION_ADDR(DOSED_TRACKER)
+#define FRAM_SIZE_DOSED_TRACKER         FRAM_SECTION_SIZE(DOSED_TRACKER)
+#define FRAM_ADDR_DOSED_TRACKER_CH(n)   FRAM_RECORD_ADDR(DOSED_TRACKER, n)
+
+// Free space
+#define FRAM_ADDR_FREE_SPACE            FRAM_SECTION_ADDR(FREE_SPACE)
+#define FRAM_SIZE_FREE_SPACE            FRAM_SECTION_SIZE(FREE_SPACE)
+
+// Dose journal - pierścień rekordów + indeks dni
+// Dwie kopie headera (A/B) - zapis naprzemienny, ważna kopia z wyższym seq
+#define FRAM_ADDR_DOSE_JOURNAL          FRAM_SECTION_ADDR(JOURNAL_HEADER)
+#define FRAM_ADDR_JOURNAL_HDR_A         FRAM_RECORD_ADDR(JOURNAL_HEADER, 0)
+#define FRAM_ADDR_JOURNAL_HDR_B         FRAM_RECORD_ADDR(JOURNAL_HEADER, 1)
+#define FRAM_SIZE_JOURNAL_HDR           sizeof(DoseJournalHeader)
+#define FRAM_ADDR_JOURNAL_INDEX         FRAM_SECTION_ADDR(JOURNAL_INDEX)
+#define FRAM_SIZE_JOURNAL_INDEX         FRAM_SECTION_SIZE(JOURNAL_INDEX)
+#define FRAM_ADDR_JOURNAL_RECORDS       FRAM_SECTION_ADDR(JOURNAL_RECORDS)
+#define FRAM_SIZE_JOURNAL_RECORDS       FRAM_SECTION_SIZE(JOURNAL_RECORDS)
+#define FRAM_ADDR_JOURNAL_REC(n)        FRAM_RECORD_ADDR(JOURNAL_RECORDS, n)
+#define FRAM_SIZE_DOSE_JOURNAL          (FRAM_SECTION_END(JOURNAL_RECORDS) - FRAM_ADDR_DOSE_JOURNAL)
+
+// Rollups - bucket w slocie (okres % liczba slotów), kanały kolejno
+#define FRAM_ADDR_ROLLUP_DAILY          FRAM_SECTION_ADDR(ROLLUP_DAILY)
+#define FRAM_SIZE_ROLLUP_DAILY          FRAM_SECTION_SIZE(ROLLUP_DAILY)
+#define FRAM_ADDR_ROLLUP_WEEKLY         FRAM_SECTION_ADDR(ROLLUP_WEEKLY)
+#define FRAM_SIZE_ROLLUP_WEEKLY         FRAM_SECTION_SIZE(ROLLUP_WEEKLY)
+#define FRAM_ADDR_ROLLUP_MONTHLY        FRAM_SECTION_ADDR(ROLLUP_MONTHLY)
+#define FRAM_SIZE_ROLLUP_MONTHLY        FRAM_SECTION_SIZE(ROLLUP_MONTHLY)
+
+// Lifetime counters - baza A/B + dziennik przyrostów (lifetime_counters.h)
+#define FRAM_ADDR_COUNTER_BASE(s)       FRAM_RECORD_ADDR(COUNTER_BASE, (s) == FRAM_SLOT_B ? 1 : 0)
+#define FRAM_ADDR_COUNTER_LOG           FRAM_SECTION_ADDR(COUNTER_LOG)
+#define FRAM_ADDR_COUNTER_DELTA(n)      FRAM_RECORD_ADDR(COUNTER_LOG, n)
+#define FRAM_SIZE_COUNTERS              (FRAM_SECTION_END(COUNTER_LOG) - FRAM_SECTION_ADDR(COUNTER_BASE))
+
+// Reserved - wolne miejsce do końca FRAM
+#define FRAM_ADDR_RESERVED              FRAM_SECTION_ADDR(RESERVED)
+#define FRAM_SIZE_RESERVED              FRAM_SECTION_SIZE(RESERVED)
 
 // ============================================================================
 // COMPILE-TIME VALIDATION
 // ============================================================================
 
-static_assert(FRAM_ADDR_RESERVED + FRAM_SIZE_RESERVED == FRAM_SIZE_BYTES,
-              "Reserved section calculation error!");
+/** Sprawdzenie każdej sekcji (rekurencyjnie po tablicy) */
+template <uint8_t Index>
+struct FramLayoutCheck {
+    typedef FramSection<(FramSectionId)Index> S;
+
+    static_assert(S::count() > 0, "FRAM section without records!");
+    static_assert(S::end() <= FRAM_SIZE_BYTES, "FRAM section beyond end of chip!");
+    static_assert(S::address() % FRAM_PAGE_SIZE == 0, "FRAM section not page aligned!");
+    static_assert(!S::hasCrc() || S::crcSize() == 2 || S::crcSize() == 4,
+                  "CRC field must be 16 or 32 bit!");
+    static_assert(!S::hasCrc() || S::crcOffset() + S::crcSize() <= S::recordSize(),
+                  "CRC field outside record!");
+
+    static constexpr bool ok() { return FramLayoutCheck<Index + 1>::ok(); }
+};
+
+template <>
+struct FramLayoutCheck<FRAM_SECTION_COUNT> {
+    static constexpr bool ok() { return true; }
+};
+
+static_assert(FramLayoutCheck<0>::ok(), "FRAM layout check failed!");
+static_assert(FRAM_SECTION_END(RESERVED) == FRAM_SIZE_BYTES, "Layout must end at end of FRAM!");
+static_assert(CHANNEL_COUNT <= FRAM_MAX_CHANNELS, "Channel sections sized for max 6 channels!");
+
+// Adresy danych już zapisanych w urządzeniach - zmiana wymaga migracji
+static_assert(FRAM_ADDR_HEADER           == 0x0000, "HEADER moved!");
+static_assert(FRAM_ADDR_CREDENTIALS      == 0x0020, "CREDENTIALS moved!");
+static_assert(FRAM_SIZE_CREDENTIALS      == 1024,   "CREDENTIALS must stay DOLEWKA compatible!");
+static_assert(FRAM_ADDR_SYSTEM_STATE_A   == 0x0420, "SYSTEM_STATE_A moved!");
+static_assert(FRAM_ADDR_CONFIG_A         == 0x0440, "CONFIG_A moved!");
+static_assert(FRAM_ADDR_CONFIG_B         == 0x0500, "CONFIG_B moved!");
+static_assert(FRAM_ADDR_DAILY_STATE_A    == 0x05C0, "DAILY_STATE_A moved!");
+static_assert(FRAM_ADDR_CRITICAL_ERROR   == 0x0650, "CRITICAL_ERROR moved!");
+static_assert(FRAM_ADDR_AUTH_DATA        == 0x0670, "AUTH_DATA moved!");
+static_assert(FRAM_ADDR_SESSION_DATA     == 0x06B0, "SESSION_DATA moved!");
+static_assert(FRAM_ADDR_CONTAINER_VOLUME == 0x0730, "CONTAINER_VOLUME moved!");
+static_assert(FRAM_ADDR_DOSED_TRACKER    == 0x0760, "DOSED_TRACKER moved!");
+static_assert(FRAM_ADDR_DOSE_JOURNAL     == 0x0800, "DOSE_JOURNAL moved!");
+static_assert(FRAM_ADDR_JOURNAL_RECORDS  == 0x0C20, "JOURNAL_RECORDS moved!");
+static_assert(FRAM_ADDR_ROLLUP_DAILY     == 0x4C20, "ROLLUP_DAILY moved!");
+static_assert(FRAM_ADDR_ROLLUP_WEEKLY    == 0x5940, "ROLLUP_WEEKLY moved!");
+static_assert(FRAM_ADDR_ROLLUP_MONTHLY   == 0x6360, "ROLLUP_MONTHLY moved!");
+static_assert(FRAM_ADDR_SYSTEM_STATE_B   == 0x6C60, "SYSTEM_STATE_B moved!");
+static_assert(FRAM_ADDR_DAILY_STATE_B    == 0x6C80, "DAILY_STATE_B moved!");
+static_assert(FRAM_SECTION_ADDR(COUNTER_BASE) == 0x6D10, "COUNTER_BASE moved!");
+static_assert(FRAM_ADDR_COUNTER_LOG      == 0x6E70, "COUNTER_LOG moved!");
+static_assert(FRAM_ADDR_RESERVED         == 0x6FF0, "RESERVED moved!");
+static_assert(LIFETIME_COUNTER_LOG_SIZE < 256, "Counter log generation tag is 8 bit!");
 
 // ============================================================================
 // FRAM OPERATIONS (deklaracje)
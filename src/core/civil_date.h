@@ -0,0 +1,124 @@
+/**
+ * DOZOWNIK - Civil Date
+ *
+ * Wspólne jądro konwersji data cywilna <-> dzień epoki (dni od 1970-01-01),
+ * algorytm H. Hinnanta (days_from_civil / civil_from_days): O(1), bez pętli
+ * po latach i miesiącach, bez tablic. Kalendarz gregoriański proleptyczny,
+ * arytmetyka bez znaku - poprawne od 0000-03-01 do 2^32 dni po epoce,
+ * dla dat przed 1970 wynik się zawija (nie używamy).
+ *
+ * Funkcje są constexpr (C++11 - jedno wyrażenie), tanie na tyle, że
+ * scheduler i RTC liczą je co tick bez cache.
+ */
+
+#ifndef CIVIL_DATE_H
+#define CIVIL_DATE_H
+
+#include <stdint.h>
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+#define CIVIL_EPOCH_SHIFT       719468UL    // 0000-03-01 -> 1970-01-01 [dni]
+#define CIVIL_DAYS_PER_ERA      146097UL    // 400 lat
+
+/**
+ * Data cywilna (bez czasu)
+ */
+struct CivilDate {
+    uint16_t year;
+    uint8_t  month;     // 1-12
+    uint8_t  day;       // 1-31
+};
+
+// ============================================================================
+// DETAIL (rok liczony od marca - luty na końcu roku)
+// ============================================================================
+
+// Day of the March-based year: Mar=0 ... Feb=11
+constexpr uint32_t _civilDayOfYear(uint32_t month, uint32_t day) {
+    return (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+}
+
+constexpr uint32_t _civilDayOfEra(uint32_t yearOfEra, uint32_t dayOfYear) {
+    return yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+}
+
+constexpr uint32_t _civilDays(uint32_t marchYear, uint32_t month, uint32_t day) {
+    return (marchYear / 400) * CIVIL_DAYS_PER_ERA
+         + _civilDayOfEra(marchYear % 400, _civilDayOfYear(month, day))
+         - CIVIL_EPOCH_SHIFT;
+}
+
+constexpr CivilDate _civilFromMarchMonth(uint32_t marchYear, uint32_t dayOfYear, uint32_t mp) {
+    return CivilDate{
+        (uint16_t)(marchYear + (mp >= 10 ? 1 : 0)),
+        (uint8_t)(mp < 10 ? mp + 3 : mp - 9),
+        (uint8_t)(dayOfYear - (153 * mp + 2) / 5 + 1)
+    };
+}
+
+constexpr CivilDate _civilFromDayOfYear(uint32_t marchYear, uint32_t dayOfYear) {
+    return _civilFromMarchMonth(marchYear, dayOfYear, (5 * dayOfYear + 2) / 153);
+}
+
+constexpr CivilDate _civilFromYearOfEra(uint32_t era, uint32_t dayOfEra, uint32_t yearOfEra) {
+    return _civilFromDayOfYear(era * 400 + yearOfEra,
+                               dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100));
+}
+
+constexpr CivilDate _civilFromDayOfEra(uint32_t era, uint32_t dayOfEra) {
+    return _civilFromYearOfEra(era, dayOfEra,
+        (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365);
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+/**
+ * Dzień epoki (dni od 1970-01-01) z daty cywilnej
+ */
+constexpr uint32_t daysFromCivil(uint16_t year, uint8_t month, uint8_t day) {
+    return _civilDays((uint32_t)year - (month <= 2 ? 1 : 0), month, day);
+}
+
+/**
+ * Data cywilna z dnia epoki
+ */
+constexpr CivilDate civilFromDays(uint32_t days) {
+    return _civilFromDayOfEra((days + CIVIL_EPOCH_SHIFT) / CIVIL_DAYS_PER_ERA,
+                              (days + CIVIL_EPOCH_SHIFT) % CIVIL_DAYS_PER_ERA);
+}
+
+/**
+ * Dzień tygodnia z dnia epoki: 0=poniedziałek, 6=niedziela (ISO 8601)
+ * (1970-01-01 był czwartkiem)
+ */
+constexpr uint8_t weekdayFromDays(uint32_t days) {
+    return (uint8_t)((days + 3) % 7);
+}
+
+constexpr bool isLeapYear(uint16_t year) {
+    return (year % 4 == 0) && (year % 100 != 0 || year % 400 == 0);
+}
+
+/**
+ * Liczba dni w miesiącu (month 1-12)
+ */
+constexpr uint8_t daysInMonth(uint16_t year, uint8_t month) {
+    return month == 2 ? (isLeapYear(year) ? 29 : 28)
+                      : (uint8_t)(30 + ((month + (month >> 3)) & 1));
+}
+
+// Spot checks evaluated by the compiler
+static_assert(daysFromCivil(1970, 1, 1) == 0, "civil epoch");
+static_assert(daysFromCivil(2000, 3, 1) == 11017, "civil leap century");
+static_assert(civilFromDays(11016).day == 29, "civil Feb 29 2000");
+static_assert(weekdayFromDays(daysFromCivil(2000, 1, 1)) == 5, "civil weekday (Sat)");
+static_assert(daysInMonth(2100, 2) == 28 && daysInMonth(2024, 2) == 29 &&
+              daysInMonth(2024, 7) == 31 && daysInMonth(2024, 8) == 31 &&
+              daysInMonth(2024, 9) == 30 && daysInMonth(2024, 12) == 31, "civil month length");
+
+#endif // CIVIL_DATE_H
@@ -0,0 +1,73 @@
+/**
+ * DOZOWNIK - Loop Events Implementation
+ */
+
+#include "loop_events.h"
+#include <esp_timer.h>
+
+// Global instance
+LoopEvents loopEvents;
+
+// Direct task notification: a timer or interrupt wakes loop() without going
+// through the timer daemon task (xEventGroupSetBitsFromISR) - keeps wakeup jitter low
+
+bool LoopEvents::begin() {
+    _task = xTaskGetCurrentTaskHandle();
+    resetStats();
+
+    // Drop anything left in the notification value
+    xTaskNotifyWait(0, UINT32_MAX, nullptr, 0);
+    return _task != nullptr;
+}
+
+void LoopEvents::signal(uint32_t bits) {
+    if (_task == nullptr) return;
+    xTaskNotify(_task, bits, eSetBits);
+}
+
+void IRAM_ATTR LoopEvents::signalFromISR(uint32_t bits) {
+    if (_task == nullptr) return;
+
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(_task, bits, eSetBits, &woken);
+    if (woken == pdTRUE) portYIELD_FROM_ISR();
+}
+
+uint32_t LoopEvents::wait(uint32_t timeoutMs) {
+    if (_task == nullptr) {
+        delay(timeoutMs);
+        return 0;
+    }
+
+    uint32_t bits = 0;
+    _stats.waits++;
+    _stats.awake_us += esp_timer_get_time() - _wokeUs;
+    BaseType_t got = xTaskNotifyWait(0, UINT32_MAX, &bits, pdMS_TO_TICKS(timeoutMs));
+    _wokeUs = esp_timer_get_time();
+
+    if (got != pdTRUE) {
+        _stats.timeouts++;
+        return 0;
+    }
+
+    if (bits & LOOP_EVENT_SCHEDULE) _stats.scheduled++;
+    return bits;
+}
+
+float LoopEvents::getLoadPercent() const {
+    int64_t elapsed = esp_timer_get_time() - _stats.since_us;
+    if (elapsed <= 0) return 0;
+    return (float)_stats.awake_us * 100.0f / (float)elapsed;
+}
+
+uint32_t LoopEvents::getWakeupsPerHour() const {
+    int64_t elapsed = esp_timer_get_time() - _stats.since_us;
+    if (elapsed <= 0) return 0;
+    return (uint32_t)((uint64_t)_stats.waits * 3600000000ULL / (uint64_t)elapsed);
+}
+
+void LoopEvents::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+    _stats.since_us = esp_timer_get_time();
+    _wokeUs = _stats.since_us;
+}
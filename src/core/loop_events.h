@@ -0,0 +1,90 @@
+/**
+ * DOZOWNIK - Loop Events
+ *
+ * Budzenie loop() zdarzeniami zamiast stałego delay(10).
+ * loop() śpi na powiadomieniu taska (bity zdarzeń) z limitem czasu:
+ * krótkim gdy coś wymaga częstej obsługi (pompa, walidacja GPIO,
+ * scrubber, przycisk), długim w spoczynku. Scheduler budzi loop()
+ * jednorazowym esp_timer dokładnie na następny event / reset dobowy.
+ */
+
+#ifndef LOOP_EVENTS_H
+#define LOOP_EVENTS_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// EVENT BITS
+// ============================================================================
+
+#define LOOP_EVENT_SCHEDULE (1UL << 0)  // Termin schedulera (timer) lub zmiana konfiguracji
+#define LOOP_EVENT_WAKE     (1UL << 1)  // Praca do zrobienia (np. przekaźnik z taska web)
+
+/**
+ * Statystyki budzenia loop()
+ */
+struct LoopEventStats {
+    uint32_t waits;         // Wywołania wait()
+    uint32_t timeouts;      // Obudzenia bez zdarzenia (limit czasu)
+    uint32_t scheduled;     // Obudzenia przez LOOP_EVENT_SCHEDULE
+    uint64_t awake_us;      // Czas pracy loop() między obudzeniem a kolejnym wait()
+    int64_t  since_us;      // esp_timer_get_time() przy begin() / resetStats()
+};
+
+// ============================================================================
+// LOOP EVENTS CLASS
+// ============================================================================
+
+class LoopEvents {
+public:
+    /**
+     * Zapamiętaj task loop() (wołaj z setup() - ten sam task co loop())
+     */
+    bool begin();
+
+    /**
+     * Ustaw bity zdarzeń i obudź loop() (z dowolnego taska)
+     */
+    void signal(uint32_t bits);
+
+    /**
+     * Jak signal(), z przerwania (IRAM)
+     */
+    void signalFromISR(uint32_t bits);
+
+    /**
+     * Śpij do zdarzenia lub limitu czasu (tylko z loop())
+     * @return bity zdarzeń (0 = limit czasu); bity są kasowane
+     */
+    uint32_t wait(uint32_t timeoutMs);
+
+    const LoopEventStats& getStats() const { return _stats; }
+    
+    /**
+     * Obciążenie CPU przez loop() od begin() / resetStats() [%]
+     */
+    float getLoadPercent() const;
+    
+    /**
+     * Obudzenia loop() na godzinę od begin() / resetStats()
+     */
+    uint32_t getWakeupsPerHour() const;
+    
+    /**
+     * Wyzeruj statystyki (początek pomiaru)
+     */
+    void resetStats();
+
+private:
+    TaskHandle_t _task;         // nullptr przed begin() - wait() = delay()
+    LoopEventStats _stats;
+    int64_t _wokeUs;            // Koniec ostatniego wait()
+};
+
+// ============================================================================
+// GLOBAL INSTANCE
+// ============================================================================
+
+extern LoopEvents loopEvents;
+
+#endif // LOOP_EVENTS_H
@@ -0,0 +1,325 @@
+/**
+ * DOZOWNIK - CRC32 Engine Implementation
+ */
+
+#include "crc32.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <rom/crc.h>
+#define CRC32_HAS_ROM   1
+#else
+#define CRC32_HAS_ROM   0
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "CRC32 slice-by-8 assumes a little-endian target"
+#endif
+
+#define CRC32_POLY      0xEDB88320UL
+
+// Reference table for the bytewise backend (polynomial 0xEDB88320)
+// NOTE: the table this replaces had entry 245 as 0xCDD706B3 (typo).
+// Records written with it are still accepted via Crc32::matches().
+#define CRC32_LEGACY_INDEX      245
+#define CRC32_LEGACY_ENTRY      0xCDD706B3UL
+
+static const uint32_t crc32_table[256] PROGMEM = {
+    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
+    0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+    0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
+    0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
+    0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+    0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+    0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
+    0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+    0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
+    0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
+    0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+    0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
+    0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
+    0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+    0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
+    0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+    0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+    0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
+    0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
+    0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+    0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
+    0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
+    0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+    0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
+    0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
+    0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+    0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+    0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
+    0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+    0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
+    0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
+    0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+    0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+};
+
+// Slice-by-8 tables: built once in DRAM (8 KB), table 0 equals crc32_table
+static DRAM_ATTR uint32_t _slice[8][256];
+static volatile bool _tablesReady = false;
+
+static volatile Crc32Backend _backend = Crc32Backend::SLICE8;
+static bool _begun = false;
+static volatile uint32_t _legacyMatches = 0;
+
+static const char* const BACKEND_NAMES[CRC32_BACKEND_COUNT] = { "rom", "slice8", "bytewise" };
+
+// ============================================================================
+// BACKENDS
+// ============================================================================
+// All backends take and return the raw (pre/post-inverted) register state.
+
+static uint32_t _crcBytewise(uint32_t crc, const uint8_t* p, size_t length) {
+    while (length--) {
+        crc = pgm_read_dword(&crc32_table[(crc ^ *p++) & 0xFF]) ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// Byte loop with the historical table entry - verification of old records only
+static uint32_t _crcLegacy(uint32_t crc, const uint8_t* p, size_t length) {
+    while (length--) {
+        uint8_t index = (crc ^ *p++) & 0xFF;
+        uint32_t entry = (index == CRC32_LEGACY_INDEX) ? CRC32_LEGACY_ENTRY
+                                                       : pgm_read_dword(&crc32_table[index]);
+        crc = entry ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void _buildTables() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (uint8_t k = 0; k < 8; k++) {
+            c = (c & 1) ? (c >> 1) ^ CRC32_POLY : (c >> 1);
+        }
+        _slice[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (uint8_t s = 1; s < 8; s++) {
+            uint32_t prev = _slice[s - 1][i];
+            _slice[s][i] = (prev >> 8) ^ _slice[0][prev & 0xFF];
+        }
+    }
+    _tablesReady = true;
+}
+
+static uint32_t _crcSlice8(uint32_t crc, const uint8_t* p, size_t length) {
+    if (!_tablesReady) _buildTables();
+
+    // Head: align to a word boundary
+    while (length && ((uintptr_t)p & 3)) {
+        crc = _slice[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        length--;
+    }
+
+    // Body: 8 bytes per step, two aligned word loads
+    while (length >= 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = _slice[7][lo & 0xFF] ^ _slice[6][(lo >> 8) & 0xFF] ^
+              _slice[5][(lo >> 16) & 0xFF] ^ _slice[4][lo >> 24] ^
+              _slice[3][hi & 0xFF] ^ _slice[2][(hi >> 8) & 0xFF] ^
+              _slice[1][(hi >> 16) & 0xFF] ^ _slice[0][hi >> 24];
+        p += 8;
+        length -= 8;
+    }
+
+    // Tail
+    while (length--) {
+        crc = _slice[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// ============================================================================
+// INITIALIZATION & BACKEND SELECTION
+// ============================================================================
+
+void Crc32::begin() {
+    if (_begun) return;
+    _begun = true;
+
+    if (!_tablesReady) _buildTables();
+
+    // ROM routine is preferred, but only if it agrees with the reference
+    Crc32Backend preferred = Crc32Backend::SLICE8;
+    if (isAvailable(Crc32Backend::ROM)) {
+        static const char check[] = "123456789";
+        if (extendWith(Crc32Backend::ROM, 0, check, 9) == 0xCBF43926UL) {
+            preferred = Crc32Backend::ROM;
+        } else {
+            Serial.println(F("[CRC32] WARNING: ROM crc32_le mismatch, using slice8"));
+        }
+    }
+    _backend = preferred;
+}
+
+bool Crc32::isAvailable(Crc32Backend backend) {
+    switch (backend) {
+        case Crc32Backend::ROM:      return CRC32_HAS_ROM;
+        case Crc32Backend::SLICE8:   return true;
+        case Crc32Backend::BYTEWISE: return true;
+        default:                     return false;
+    }
+}
+
+bool Crc32::setBackend(Crc32Backend backend) {
+    if (!isAvailable(backend)) return false;
+    if (!_tablesReady) _buildTables();
+    _begun = true;
+    _backend = backend;
+    return true;
+}
+
+Crc32Backend Crc32::getBackend() {
+    return _backend;
+}
+
+const char* Crc32::backendName(Crc32Backend backend) {
+    uint8_t i = (uint8_t)backend;
+    return (i < CRC32_BACKEND_COUNT) ? BACKEND_NAMES[i] : "?";
+}
+
+// ============================================================================
+// COMPUTATION
+// ============================================================================
+
+uint32_t Crc32::extendWith(Crc32Backend backend, uint32_t crc, const void* data, size_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+
+    switch (backend) {
+#if CRC32_HAS_ROM
+        case Crc32Backend::ROM:
+            // ROM routine inverts on entry/exit itself (zlib semantics)
+            return crc32_le(crc, p, length);
+#endif
+        case Crc32Backend::BYTEWISE:
+            return _crcBytewise(crc ^ 0xFFFFFFFFUL, p, length) ^ 0xFFFFFFFFUL;
+        default:
+            return _crcSlice8(crc ^ 0xFFFFFFFFUL, p, length) ^ 0xFFFFFFFFUL;
+    }
+}
+
+uint32_t Crc32::extend(uint32_t crc, const void* data, size_t length) {
+    if (!_begun) begin();
+    return extendWith(_backend, crc, data, length);
+}
+
+uint32_t Crc32::compute(const void* data, size_t length) {
+    return extend(0, data, length);
+}
+
+uint32_t Crc32::computeLegacy(const void* data, size_t length) {
+    return _crcLegacy(0xFFFFFFFFUL, (const uint8_t*)data, length) ^ 0xFFFFFFFFUL;
+}
+
+bool Crc32::matches(const void* data, size_t length, uint32_t stored, uint32_t mask) {
+    if (((compute(data, length) ^ stored) & mask) == 0) return true;
+
+    // Slow path only on mismatch: record may predate the table fix
+    if (((computeLegacy(data, length) ^ stored) & mask) == 0) {
+        _legacyMatches++;
+        return true;
+    }
+    return false;
+}
+
+uint32_t Crc32::getLegacyMatches() {
+    return _legacyMatches;
+}
+
+// ============================================================================
+// SELF-TEST
+// ============================================================================
+
+bool Crc32::selfTest(bool verbose) {
+    // Pattern buffer: (i*31+7) & 0xFF, golden values from zlib.crc32()
+    uint8_t pattern[256];
+    for (uint16_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    struct Golden {
+        const void* data;
+        size_t length;
+        uint32_t crc;
+    };
+    const Golden golden[] = {
+        { "123456789", 9,   0xCBF43926UL },
+        { "",          0,   0x00000000UL },
+        { pattern,     13,  0xB64E57ACUL },
+        { pattern,     256, 0x0CE9D363UL },
+    };
+
+    bool allOk = true;
+
+    // Legacy variant must reproduce CRCs already stored in FRAM
+    static const uint8_t legacyHit = 0x0A;     // (0xFF ^ 0x0A) selects entry 245
+    uint16_t legacyFailures = 0;
+    if (computeLegacy(pattern, 256) != 0x0A1A481AUL) legacyFailures++;
+    if (computeLegacy(pattern, 13) != 0xB64E57ACUL) legacyFailures++;
+    if (computeLegacy(&legacyHit, 1) != 0x32D706B3UL) legacyFailures++;
+    if (computeLegacy("123456789", 9) != 0xCBF43926UL) legacyFailures++;
+    if (verbose) {
+        Serial.printf("[CRC32] %-8s: %s (%u failures)\n",
+                      "legacy", legacyFailures ? "FAIL" : "OK", legacyFailures);
+    }
+    if (legacyFailures) allOk = false;
+
+    for (uint8_t b = 0; b < CRC32_BACKEND_COUNT; b++) {
+        Crc32Backend backend = (Crc32Backend)b;
+        if (!isAvailable(backend)) {
+            if (verbose) Serial.printf("[CRC32] %-8s: not available\n", backendName(backend));
+            continue;
+        }
+
+        uint16_t failures = 0;
+
+        for (uint8_t g = 0; g < sizeof(golden) / sizeof(golden[0]); g++) {
+            if (extendWith(backend, 0, golden[g].data, golden[g].length) != golden[g].crc) {
+                failures++;
+            }
+        }
+
+        // Every length/alignment combination against the reference loop
+        for (uint8_t offset = 0; offset < 8; offset++) {
+            for (uint8_t len = 0; len <= 64; len++) {
+                uint32_t ref = _crcBytewise(0xFFFFFFFFUL, pattern + offset, len) ^ 0xFFFFFFFFUL;
+                if (extendWith(backend, 0, pattern + offset, len) != ref) failures++;
+            }
+        }
+
+        // Incremental: any split point gives the one-shot result
+        for (uint16_t split = 0; split <= sizeof(pattern); split += 17) {
+            uint32_t crc = extendWith(backend, 0, pattern, split);
+            crc = extendWith(backend, crc, pattern + split, sizeof(pattern) - split);
+            if (crc != 0x0CE9D363UL) failures++;
+        }
+
+        if (verbose) {
+            Serial.printf("[CRC32] %-8s: %s (%u failures)\n",
+                          backendName(backend), failures ? "FAIL" : "OK", failures);
+        }
+        if (failures) allOk = false;
+    }
+
+    return allOk;
+}
@@ -0,0 +1,94 @@
+/**
+ * DOZOWNIK - CRC32 Engine
+ *
+ * CRC-32 (IEEE 802.3, poly 0xEDB88320) z wymiennym backendem:
+ *   ROM      - crc32_le z ROM ESP32 (domyślny na urządzeniu)
+ *   SLICE8   - slice-by-8, tablice 8x256 w DRAM
+ *   BYTEWISE - klasyczna pętla bajtowa (tablica PROGMEM, referencja)
+ *
+ * Wszystkie backendy dają identyczny wynik, zgodny z zlib crc32().
+ *
+ * Poprzednia tablica miała błędny wpis 245 - ok. 10% rekordów zapisanych
+ * starszym firmware ma sumę "legacy". Weryfikacja przez matches()
+ * akceptuje oba warianty; każdy nowy zapis ma już poprawne CRC.
+ */
+
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <Arduino.h>
+
+enum class Crc32Backend : uint8_t {
+    ROM      = 0,
+    SLICE8   = 1,
+    BYTEWISE = 2
+};
+
+#define CRC32_BACKEND_COUNT     3
+
+class Crc32 {
+public:
+    Crc32() : _crc(0) {}
+
+    // --- Incremental API ---
+
+    /** Zacznij od nowa (CRC pustego bloku = 0) */
+    void reset() { _crc = 0; }
+
+    /** Dołącz kolejny fragment danych */
+    void update(const void* data, size_t length) { _crc = extend(_crc, data, length); }
+
+    /** CRC wszystkich dotychczasowych fragmentów */
+    uint32_t value() const { return _crc; }
+
+    // --- One-shot API ---
+
+    /**
+     * Przygotuj tablice i wybierz backend (self-test ROM vs referencja).
+     * Bezpieczne do wielokrotnego wywołania; compute() woła je leniwie.
+     */
+    static void begin();
+
+    /** CRC32 bloku danych aktywnym backendem */
+    static uint32_t compute(const void* data, size_t length);
+
+    /**
+     * Kontynuuj CRC (semantyka zlib): extend(extend(0, a), b) == compute(a+b)
+     */
+    static uint32_t extend(uint32_t crc, const void* data, size_t length);
+
+    /** CRC32 starą tablicą (wpis 245) - tylko do weryfikacji starych rekordów */
+    static uint32_t computeLegacy(const void* data, size_t length);
+
+    /**
+     * Sprawdź zapisaną sumę (aktualny wariant, przy niezgodności legacy)
+     * @param mask Maska dla sum skróconych (np. 0xFFFF dla 16-bit check)
+     */
+    static bool matches(const void* data, size_t length, uint32_t stored,
+                        uint32_t mask = 0xFFFFFFFFUL);
+
+    /** Ile rekordów przeszło weryfikację tylko wariantem legacy */
+    static uint32_t getLegacyMatches();
+
+    /** extend() wybranym backendem (testy, benchmark) */
+    static uint32_t extendWith(Crc32Backend backend, uint32_t crc, const void* data, size_t length);
+
+    // --- Backend selection ---
+
+    static bool setBackend(Crc32Backend backend);
+    static Crc32Backend getBackend();
+    static bool isAvailable(Crc32Backend backend);
+    static const char* backendName(Crc32Backend backend);
+
+    /**
+     * Golden vectors + zgodność wszystkich backendów z referencją
+     * (długości 0..64, przesunięcia 0..7, podział inkrementalny).
+     * @return true jeśli wszystkie dostępne backendy przeszły
+     */
+    static bool selfTest(bool verbose = false);
+
+private:
+    uint32_t _crc;
+};
+
+#endif // CRC32_H
@@ -3,6 +3,8 @@
  */
 
 #include "dosing_scheduler.h"
+#include "../core/civil_date.h"
+#include "../core/loop_events.h"
 
 // Global instance
 DosingScheduler dosingScheduler;
@@ -10,6 +12,18 @@ DosingScheduler dosingScheduler;
 // Critical section spinlock for scheduler state (race condition fix)
 static portMUX_TYPE _schedulerMux = portMUX_INITIALIZER_UNLOCKED;
 
+// Reset days stored before the epoch-day kernel: year*366 + month*31 + day
+// (>= 732032 from 2000 on, while epoch days stay below 47500 until 2099)
+#define LEGACY_RESET_DAY_MIN    (2000UL * 366)
+
+// Timeline order = hour-major, channel-minor generation order; the cursor
+// entry is the only one that can be due (windows stay inside their slot)
+static_assert((CHANNEL_COUNT - 1) * CHANNEL_OFFSET_MINUTES * 60 + EVENT_WINDOW_SECONDS <= 3600,
+              "channel windows must fit in their hour");
+static_assert(EVENT_WINDOW_SECONDS <= CHANNEL_OFFSET_MINUTES * 60,
+              "channel windows must not overlap");
+static_assert(SCHED_TIMELINE_MAX <= 255, "timeline cursor is uint8_t");
+
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
@@ -25,23 +39,33 @@ bool DosingScheduler::begin() {
     _lastCheckTime = 0;
     _lastUpdateTime = 0;
     _lastHour = 255;
+    
+    _timelineCount = 0;
+    _timelineCursor = 0;
+    _timelineDay = UINT32_MAX;
+    _timelineGeneration = 0;
+    _timelineLastSec = 0;
+    
+    // One-shot wake for the next timeline entry / daily reset (loop() sleeps between)
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = _onWakeTimer;
+    timerArgs.arg = this;
+    timerArgs.name = "sched_wake";
+    if (esp_timer_create(&timerArgs, &_wakeTimer) != ESP_OK) {
+        _wakeTimer = nullptr;
+        Serial.println(F("[SCHED] WARNING: Wake timer unavailable - loop timeout pacing"));
+    }
+    _wakeAtMs = millis();
+    _wakeCount = 0;
     _lastDay = 255;
     _todayEventCount = 0;
     
-    // Load state from FRAM
-    SystemState sysState;
-    if (framController.readSystemState(&sysState)) {
-        _enabled = (sysState.system_enabled != 0);
-        Serial.printf("[SCHED] Loaded state from FRAM: %s\n", _enabled ? "ENABLED" : "DISABLED");
-        
-        // Increment boot count
-        sysState.boot_count++;
-        framController.writeSystemState(&sysState);
-        Serial.printf("[SCHED] Boot count: %lu\n", sysState.boot_count);
-    } else {
-        Serial.println(F("[SCHED] Failed to load FRAM state, defaulting to ENABLED"));
-        _enabled = true;
-    }
+    // State comes from the RAM owner (loaded once from FRAM)
+    _enabled = systemStateManager.isEnabled();
+    Serial.printf("[SCHED] System state: %s\n", _enabled ? "ENABLED" : "DISABLED");
+    
+    systemStateManager.incrementBootCount();
+    Serial.printf("[SCHED] Boot count: %lu\n", systemStateManager.getBootCount());
     
     // Get current time
     if (rtcController.isReady() && rtcController.isTimeValid()) {
@@ -49,26 +73,23 @@ bool DosingScheduler::begin() {
         _lastHour = 255;
         _lastDay = now.day;
         
-        // Calculate current UTC day (simple: year*366 + month*31 + day)
-        uint32_t currentUtcDay = (uint32_t)now.year * 366 + (uint32_t)now.month * 31 + now.day;
+        uint32_t currentUtcDay = daysFromCivil(now.year, now.month, now.day);
+        _migrateLegacyResetDay(now, currentUtcDay);
         
         // Check if daily reset needed (different day than last reset)
-        if (framController.readSystemState(&sysState)) {
-            if (sysState.last_daily_reset_day != currentUtcDay) {
-                Serial.println(F("[SCHED] New day detected - performing startup daily reset"));
-                _performDailyReset();
-                
-                // Save new reset day
-                sysState.last_daily_reset_day = currentUtcDay;
-                framController.writeSystemState(&sysState);
-            } else {
-                Serial.println(F("[SCHED] Same day - no reset needed"));
-            }
+        if (systemStateManager.getLastDailyResetDay() != currentUtcDay) {
+            Serial.println(F("[SCHED] New day detected - performing startup daily reset"));
+            _performDailyReset();   // Saves reset day
+        } else {
+            Serial.println(F("[SCHED] Same day - no reset needed"));
         }
     } else {
         Serial.println(F("[SCHED] WARNING: RTC not ready, cannot check daily reset"));
     }
     
+    // Persistence point: boot count (+ reset day)
+    systemStateManager.flush();
+    
     // Set initial state based on enabled
     if (_enabled) {
         _state = SchedulerState::IDLE;
@@ -84,22 +105,33 @@ bool DosingScheduler::begin() {
 // MAIN UPDATE LOOP
 // ============================================================================
 
-void DosingScheduler::update() {
+void DosingScheduler::update(bool wakeTick) {
     if (!_initialized) return;
     
     uint32_t now = millis();
     
-// Rate limit updates (every 1 second)
-    if (now - _lastUpdateTime < 1000) {
+    // Full pass when the wake timer fired (or something changed); the millis()
+    // deadline only matters if the timer is missing or its event got lost
+    bool due = wakeTick || (int32_t)(now - _wakeAtMs) >= 0;
+    if (!due) {
         // But always check dosing/validation progress if active
-        if (_state == SchedulerState::VALIDATING || 
-            _state == SchedulerState::DOSING || 
-            _state == SchedulerState::WAITING_PUMP) {
+        if (isDosingActive()) {
             _checkDosingProgress();
         }
         return;
     }
     _lastUpdateTime = now;
+    _wakeCount++;
+    
+    _runPass();
+    _armWake();
+}
+
+void DosingScheduler::_runPass() {
+    // Keep the timeline cursor current even while disabled or dosing
+    if (rtcController.isReady() && rtcController.isTimeValid()) {
+        _refreshTimeline(rtcController.getTime());
+    }
     
     // Skip if disabled
     if (!_enabled) {
@@ -170,14 +202,12 @@ void DosingScheduler::setEnabled(bool enabled) {
     if (_enabled == enabled) return;
     
     _enabled = enabled;
+    loopEvents.signal(LOOP_EVENT_SCHEDULE);     // Re-arm from loop()
     
     // Save to FRAM
-    SystemState sysState;
-    if (framController.readSystemState(&sysState)) {
-        sysState.system_enabled = enabled ? 1 : 0;
-        if (framController.writeSystemState(&sysState)) {
-            Serial.printf("[SCHED] State saved to FRAM: %s\n", enabled ? "ENABLED" : "DISABLED");
-        }
+    systemStateManager.setEnabled(enabled);
+    if (systemStateManager.flush()) {
+        Serial.printf("[SCHED] State saved to FRAM: %s\n", enabled ? "ENABLED" : "DISABLED");
     }
     
     if (enabled) {
@@ -214,14 +244,11 @@ bool DosingScheduler::_checkDailyReset() {
         return false;  // Nie godzina 0 = nie robimy resetu
     }
     
-    // Sprawdź czy dzień się zmienił względem FRAM (nie tylko RAM!)
-    uint32_t currentUtcDay = (uint32_t)now.year * 366 + (uint32_t)now.month * 31 + now.day;
+    // Sprawdź czy dzień się zmienił (SystemState w RAM jest autorytatywny)
+    uint32_t currentUtcDay = daysFromCivil(now.year, now.month, now.day);
     
-    SystemState sysState;
-    if (framController.readSystemState(&sysState)) {
-        if (sysState.last_daily_reset_day == currentUtcDay) {
-            return false;  // Już robiliśmy reset dziś
-        }
+    if (systemStateManager.getLastDailyResetDay() == currentUtcDay) {
+        return false;  // Już robiliśmy reset dziś
     }
     
     // Aktualizuj też _lastDay dla spójności
@@ -230,6 +257,18 @@ bool DosingScheduler::_checkDailyReset() {
     return true;
 }
 
+void DosingScheduler::_migrateLegacyResetDay(const TimeInfo& now, uint32_t currentUtcDay) {
+    uint32_t stored = systemStateManager.getLastDailyResetDay();
+    if (stored < LEGACY_RESET_DAY_MIN) return;
+    
+    uint32_t legacyToday = (uint32_t)now.year * 366 + (uint32_t)now.month * 31 + now.day;
+    if (stored != legacyToday) return;  // Older day - the normal check resets
+    
+    // Reset already done today under the old encoding - keep today's states
+    systemStateManager.setLastDailyResetDay(currentUtcDay);
+    Serial.printf("[SCHED] Reset day migrated: %lu -> %lu\n", stored, currentUtcDay);
+}
+
 bool DosingScheduler::_performDailyReset() {
     TimeInfo now = rtcController.getTime();
     Serial.printf("[SCHED] _performDailyReset called at %02d:%02d UTC!\n", now.hour, now.minute);
@@ -237,13 +276,9 @@ bool DosingScheduler::_performDailyReset() {
     Serial.println(F("[SCHED] === DAILY RESET ==="));
     
     // Sprawdź czy to pierwszy reset tego dnia
-    uint32_t currentUtcDay = (uint32_t)now.year * 366 + (uint32_t)now.month * 31 + now.day;
+    uint32_t currentUtcDay = daysFromCivil(now.year, now.month, now.day);
     
-    SystemState sysState;
-    bool isFirstResetToday = true;
-    if (framController.readSystemState(&sysState)) {
-        isFirstResetToday = (sysState.last_daily_reset_day != currentUtcDay);
-    }
+    bool isFirstResetToday = (systemStateManager.getLastDailyResetDay() != currentUtcDay);
 
     _lastDay = now.day;
     _todayEventCount = 0;
@@ -262,10 +297,12 @@ bool DosingScheduler::_performDailyReset() {
         Serial.println(F("[SCHED] Already reset today - skipping daily states reset"));
     }
     
-    // Save reset day to FRAM
-    if (framController.readSystemState(&sysState)) {
-        sysState.last_daily_reset_day = currentUtcDay;
-        framController.writeSystemState(&sysState);
+    // Open new history buckets (day, and week/month on boundaries)
+    doseRollup.rollover(rtcController.getUnixTime());
+    
+    // Save reset day to FRAM (persistence point)
+    systemStateManager.setLastDailyResetDay(currentUtcDay);
+    if (systemStateManager.flush()) {
         Serial.printf("[SCHED] Reset day saved: %lu\n", currentUtcDay);
     }
     
@@ -310,30 +347,146 @@ void DosingScheduler::_checkSchedule() {
         Serial.printf("[SCHED] New hour %02d (day %d)\n", now.hour, now.dayOfWeek);
     }
     
-    uint8_t currentMinute = now.minute;
+    // Windows do not overlap - only the cursor entry can be due
+    if (_timelineCursor >= _timelineCount) return;
     
-    // Find events to execute
-    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
-        uint8_t channelOffset = ch * CHANNEL_OFFSET_MINUTES;
-        
-        // Check if we're in the window for this channel (:00-:04, :10-:14, etc.)
-        if (currentMinute >= channelOffset && currentMinute < channelOffset + 5) {
-            // Check if this channel should execute (includes "not completed" check)
-            if (channelManager.shouldExecuteEvent(ch, now.hour, now.dayOfWeek)) {
-                Serial.printf("[SCHED] Event due: CH%d at %02d:%02d (now %02d:%02d)\n", 
-                              ch, now.hour, channelOffset, now.hour, currentMinute);
-                
-                if (_startDosing(ch, now.hour)) {
-                    return; // One at a time
-                }
-            }
+    const ScheduleEntry& entry = _timeline[_timelineCursor];
+    uint32_t nowSec = now.hour * 3600UL + now.minute * 60UL + now.second;
+    if (nowSec < entry.second_of_day) return;
+    
+    // Check if this channel should execute (includes "not completed" check)
+    if (channelManager.shouldExecuteEvent(entry.channel, entry.hour, now.dayOfWeek)) {
+        Serial.printf("[SCHED] Event due: CH%d at %02d:%02d (now %02d:%02d)\n", 
+                      entry.channel, entry.hour, entry.channel * CHANNEL_OFFSET_MINUTES,
+                      now.hour, now.minute);
+        _startDosing(entry.channel, entry.hour);
+    }
+}
+
+// ============================================================================
+// DAILY TIMELINE
+// ============================================================================
+
+void DosingScheduler::_refreshTimeline(const TimeInfo& now) {
+    uint32_t utcDay = daysFromCivil(now.year, now.month, now.day);
+    uint32_t nowSec = now.hour * 3600UL + now.minute * 60UL + now.second;
+    
+    if (utcDay != _timelineDay || channelManager.getActiveGeneration() != _timelineGeneration) {
+        _rebuildTimeline(utcDay, now.dayOfWeek);
+        _seekTimeline(nowSec);
+    } else if (nowSec < _timelineLastSec) {
+        _seekTimeline(nowSec);  // Clock stepped back (NTP, setTime)
+    }
+    _timelineLastSec = nowSec;
+    
+    // Drop entries whose window has closed
+    while (_timelineCursor < _timelineCount &&
+           nowSec >= _timeline[_timelineCursor].second_of_day + EVENT_WINDOW_SECONDS) {
+        _timelineCursor++;
+    }
+}
+
+void DosingScheduler::_rebuildTimeline(uint32_t utcDay, uint8_t dayOfWeek) {
+    // Readers (status polls) never index past the count
+    _timelineCount = 0;
+    
+    uint8_t count = 0;
+    for (uint8_t h = FIRST_EVENT_HOUR; h <= LAST_EVENT_HOUR; h++) {
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+            const ChannelConfig& cfg = channelManager.getActiveConfig(ch);
+            if (!cfg.enabled || !cfg.isDayEnabled(dayOfWeek) || !cfg.isEventEnabled(h)) continue;
+            
+            ScheduleEntry& entry = _timeline[count++];
+            entry.second_of_day = h * 3600UL + ch * CHANNEL_OFFSET_MINUTES * 60UL;
+            entry.channel = ch;
+            entry.hour = h;
+        }
+    }
+    
+    _timelineCursor = 0;
+    _timelineCount = count;
+    _timelineDay = utcDay;
+    _timelineGeneration = channelManager.getActiveGeneration();
+    
+    Serial.printf("[SCHED] Timeline: %d events (day %lu, dow %d)\n", count, utcDay, dayOfWeek);
+}
+
+void DosingScheduler::_seekTimeline(uint32_t secondOfDay) {
+    // First entry whose window has not closed
+    uint8_t lo = 0;
+    uint8_t hi = _timelineCount;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (_timeline[mid].second_of_day + EVENT_WINDOW_SECONDS <= secondOfDay) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+    _timelineCursor = lo;
+}
+
+// ============================================================================
+// WAKE TIMER
+// ============================================================================
+
+void DosingScheduler::_onWakeTimer(void* arg) {
+    // esp_timer task context - plain task notification
+    loopEvents.signal(LOOP_EVENT_SCHEDULE);
+}
+
+uint32_t DosingScheduler::_nextWakeSecond(uint32_t nowSec, uint8_t dayOfWeek) const {
+    uint8_t next = _timelineCursor;
+    
+    if (next < _timelineCount && _timeline[next].second_of_day <= nowSec) {
+        // Window open and the event still has to run (pump busy) - retry next second
+        const ScheduleEntry& open = _timeline[next];
+        if (channelManager.shouldExecuteEvent(open.channel, open.hour, dayOfWeek)) {
+            return nowSec + 1;
+        }
+        next++;
+    }
+    
+    // Window start even if the event looks done now - a pass there is cheap
+    if (next < _timelineCount) {
+        return _timeline[next].second_of_day;
+    }
+    
+    // Nothing left today: daily reset (timeline for the new day is built then)
+    uint32_t resetSec = DAILY_RESET_HOUR * 3600UL;
+    return nowSec < resetSec ? resetSec : 86400UL + resetSec;
+}
+
+void DosingScheduler::_armWake() {
+    uint64_t delayUs = (uint64_t)SCHED_WAKE_MAX_MS * 1000ULL;
+    
+    if (_enabled && !systemHalted && rtcController.isReady() && rtcController.isTimeValid()) {
+        uint64_t nowUs = rtcController.getUnixTimeUs();
+        uint32_t unixNow = (uint32_t)(nowUs / 1000000ULL);
+        uint32_t nowSec = unixNow % 86400UL;
+        uint32_t target = _nextWakeSecond(nowSec, weekdayFromDays(unixNow / 86400UL));
+        
+        // Just past the boundary of the target second on the timebase clock
+        uint64_t untilUs = (uint64_t)(target - nowSec) * 1000000ULL
+                         - (nowUs % 1000000ULL) + SCHED_WAKE_MARGIN_US;
+        if (untilUs < delayUs) delayUs = untilUs;
+    }
+    
+    // Fallback deadline a little after the timer - normally the timer wins
+    _wakeAtMs = millis() + (uint32_t)(delayUs / 1000ULL) + 1;
+    
+    if (_wakeTimer != nullptr) {
+        esp_timer_stop(_wakeTimer);     // ESP_ERR_INVALID_STATE when not running - fine
+        esp_timer_start_once(_wakeTimer, delayUs);
+    }
 }
 
 void DosingScheduler::syncTimeState() {
     if (!rtcController.isReady()) return;
     
+    // The armed wake was computed on the old clock
+    loopEvents.signal(LOOP_EVENT_SCHEDULE);
+    
     TimeInfo now = rtcController.getTime();
     
     uint8_t oldDay = _lastDay;
@@ -362,9 +515,12 @@ uint8_t DosingScheduler::_findNextEvent(uint8_t hour, uint8_t dayOfWeek) {
 bool DosingScheduler::_startDosing(uint8_t channel, uint8_t hour) {
     if (channel >= CHANNEL_COUNT) return false;
     
-    // Check if pump already running
-    if (relayController.isAnyOn()) {
-        Serial.println(F("[SCHED] Pump busy, skipping"));
+    // Check the pump can start now (this channel idle, free slot and current budget).
+    // Busy is not a failure - the event stays pending and is retried while its window is open
+    RelayResult admit = relayController.canAdmit(channel);
+    if (admit != RelayResult::OK) {
+        Serial.printf("[SCHED] CH%d pump busy (%s), skipping\n",
+                      channel, RelayController::resultToString(admit));
         return false;
     }
     
@@ -398,7 +554,14 @@ bool DosingScheduler::_startDosing(uint8_t channel, uint8_t hour) {
     if (res != RelayResult::OK) {
         Serial.printf("[SCHED] Failed to start pump: %s\n", 
                       RelayController::resultToString(res));
-        _currentEvent.failed = true;
+        // Lost a race for the slot / budget (web handler) - retry like busy above
+        bool busy = (res == RelayResult::ERROR_MUTEX_LOCKED ||
+                     res == RelayResult::ERROR_POWER_BUDGET ||
+                     res == RelayResult::ERROR_ALREADY_ON);
+        portENTER_CRITICAL(&_schedulerMux);
+        _currentEvent.failed = !busy;
+        _currentEvent.channel = 255;    // No event in progress
+        portEXIT_CRITICAL(&_schedulerMux);
         return false;
     }
     
@@ -418,7 +581,7 @@ void DosingScheduler::_checkDosingProgress() {
     
     // === GPIO validation is now handled by RelayController internally ===
     // Check RelayController's validation state
-    GpioValidationResult valResult = relayController.getValidationResult();
+    GpioValidationResult valResult = relayController.getValidationResult(_currentEvent.channel);
     
     // Handle validation failure from RelayController
     if (valResult == GpioValidationResult::FAILED_PRE ||
@@ -433,7 +596,7 @@ void DosingScheduler::_checkDosingProgress() {
     }
     
     // Check if validation passed and pump is running
-    if (relayController.isPumpRunning()) {
+    if (relayController.isPumpRunning(_currentEvent.channel)) {
         _currentEvent.gpio_validated = true;
         _state = SchedulerState::DOSING;
     }
@@ -441,7 +604,7 @@ void DosingScheduler::_checkDosingProgress() {
     // === Handle dosing state ===
     // Check if pump still running
     if (!relayController.isChannelOn(_currentEvent.channel) && 
-        !relayController.isValidating()) {
+        !relayController.isValidating(_currentEvent.channel)) {
         // Pump stopped (timeout or completed)
         _completeDosing(true);
         return;
@@ -461,6 +624,10 @@ void DosingScheduler::_completeDosing(bool success) {
     portEXIT_CRITICAL(&_schedulerMux);
 
     uint32_t actualDuration = millis() - startTime;
+    uint32_t timestamp = rtcController.getUnixTime();
+
+    // RAM only - persisted with the next SystemState flush
+    systemStateManager.setLastEventTimestamp(timestamp);
 
     Serial.printf("[SCHED] CH%d complete: %s, %lu ms\n",
                   channel,
@@ -479,6 +646,21 @@ void DosingScheduler::_completeDosing(bool success) {
         }
     }
 
+    // Single commit of everything the dose touched (daily state, volume, tracker)
+    if (channelManager.isDirty(channel)) {
+        channelManager.commitChannel(channel);
+        const ChannelCommitStats& cost = channelManager.getLastCommitStats();
+        Serial.printf("[SCHED] CH%d commit: %d records, %d B, %d transactions, %lu us\n",
+                      channel, cost.records, cost.bytes, cost.transactions, cost.duration_us);
+    }
+
+    // History entry (volume after deduction)
+    doseJournal.append(timestamp, channel, hour,
+                       success ? EVENT_COMPLETED : EVENT_FAILED,
+                       (uint8_t)relayController.getLastValidationResult(channel),
+                       targetMl, channelManager.getRemainingVolume(channel), actualDuration);
+    doseRollup.recordDose(timestamp, channel, success, targetMl, actualDuration);
+
     // Update event state - atomic
     portENTER_CRITICAL(&_schedulerMux);
     if (success) {
@@ -509,8 +691,9 @@ bool DosingScheduler::triggerManualDose(uint8_t channel) {
         return false;
     }
     
-    if (relayController.isAnyOn()) {
-        Serial.println(F("[SCHED] Cannot trigger - pump busy"));
+    // One tracked event at a time; the pump itself is checked in _startDosing()
+    if (isDosingActive()) {
+        Serial.println(F("[SCHED] Cannot trigger - dose in progress"));
         return false;
     }
     
@@ -536,21 +719,15 @@ uint32_t DosingScheduler::getSecondsToNextEvent() const {
     if (!rtcController.isReady()) return 0;
     
     TimeInfo now = rtcController.getTime();
+    uint32_t nowSec = now.hour * 3600UL + now.minute * 60UL + now.second;
     
-    // Find next event
-    for (uint8_t h = now.hour; h <= LAST_EVENT_HOUR; h++) {
-        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
-            if (channelManager.shouldExecuteEvent(ch, h, now.dayOfWeek)) {
-                uint8_t eventMinute = ch * CHANNEL_OFFSET_MINUTES;
-                
-                // Calculate seconds
-                int32_t targetSec = h * 3600 + eventMinute * 60;
-                int32_t nowSec = now.hour * 3600 + now.minute * 60 + now.second;
-                
-                if (targetSec > nowSec) {
-                    return targetSec - nowSec;
-                }
-            }
+    // Next window ahead of the cursor; skips only events already done/failed
+    for (uint8_t i = _timelineCursor; i < _timelineCount; i++) {
+        const ScheduleEntry& entry = _timeline[i];
+        if (entry.second_of_day <= nowSec) continue;
+        
+        if (channelManager.shouldExecuteEvent(entry.channel, entry.hour, now.dayOfWeek)) {
+            return entry.second_of_day - nowSec;
         }
     }
     
@@ -566,6 +743,10 @@ void DosingScheduler::printStatus() const {
     Serial.printf("  State: %s\n", stateToString(_state));
     Serial.printf("  Enabled: %s\n", _enabled ? "YES" : "NO");
     Serial.printf("  Today events: %d\n", _todayEventCount);
+    Serial.printf("  Timeline: %d events, cursor %d\n", _timelineCount, _timelineCursor);
+    Serial.printf("  Wakeups: %lu, next in %ld ms\n", _wakeCount, (long)(int32_t)(_wakeAtMs - millis()));
+    Serial.printf("  Loop: %lu wakeups/h, CPU %.3f%%\n",
+                  loopEvents.getWakeupsPerHour(), loopEvents.getLoadPercent());
     Serial.printf("  Last check: %lu ms ago\n", millis() - _lastCheckTime);
     
     if (_currentEvent.channel < CHANNEL_COUNT) {
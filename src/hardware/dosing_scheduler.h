@@ -9,13 +9,16 @@
 #define DOSING_SCHEDULER_H
 
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "config.h"
 #include "dosing_types.h"
 #include "channel_manager.h"
 #include "relay_controller.h"
 #include "rtc_controller.h"
 #include "fram_controller.h"
-
+#include "system_state_manager.h"
+#include "dose_journal.h"
+#include "dose_rollup.h"
 
 // ============================================================================
 // SCHEDULER STATE
@@ -48,6 +51,21 @@ struct DosingEvent {
     bool     validation_started;
 };
 
+// ============================================================================
+// DAILY TIMELINE
+// ============================================================================
+
+/**
+ * Pozycja osi czasu dnia: okno eventu kanału (posortowane po second_of_day)
+ */
+struct ScheduleEntry {
+    uint32_t second_of_day;     // Początek okna (UTC)
+    uint8_t  channel;
+    uint8_t  hour;
+};
+
+#define SCHED_TIMELINE_MAX  ((LAST_EVENT_HOUR - FIRST_EVENT_HOUR + 1) * CHANNEL_COUNT)
+
 // ============================================================================
 // DOSING SCHEDULER CLASS
 // ============================================================================
@@ -61,8 +79,12 @@ public:
     
     /**
      * Główna pętla - wywołuj w loop()
+     * Pełny przebieg tylko gdy minął termin (timer: następny event, okno
+     * w toku, reset dobowy; zmiana konfiguracji / czasu), poza tym tylko
+     * postęp dozowania.
+     * @param wakeTick true = LOOP_EVENT_SCHEDULE (timer lub sygnał zmiany)
      */
-    void update();
+    void update(bool wakeTick = false);
     
     /**
      * Czy scheduler aktywny
@@ -85,6 +107,15 @@ public:
      */
     SchedulerState getState() const { return _state; }
     
+    /**
+     * Czy dozowanie w toku (postęp sprawdzany w każdym przebiegu loop())
+     */
+    bool isDosingActive() const {
+        return _state == SchedulerState::VALIDATING ||
+               _state == SchedulerState::DOSING ||
+               _state == SchedulerState::WAITING_PUMP;
+    }
+    
     /**
      * Pobierz aktualny event (jeśli dozowanie w trakcie)
      * WARNING: Not thread-safe, use getEventSnapshot() for multi-context access
@@ -132,6 +163,16 @@ public:
      */
     uint16_t getTodayEventCount() const { return _todayEventCount; }
     
+    /**
+     * Liczba eventów na dzisiejszej osi czasu (aktywna konfiguracja)
+     */
+    uint8_t getTimelineCount() const { return _timelineCount; }
+    
+    /**
+     * Pełne przebiegi schedulera od startu (obudzenia przez timer / zmianę)
+     */
+    uint32_t getWakeCount() const { return _wakeCount; }
+    
     // --- Debug ---
     
     void printStatus() const;
@@ -151,6 +192,20 @@ private:
     uint8_t  _lastDay;
     uint16_t _todayEventCount;
     
+    // Oś czasu dnia: budowana z aktywnej konfiguracji i dnia tygodnia,
+    // tick czyta tylko pozycję kursora (koszt niezależny od liczby kanałów)
+    ScheduleEntry _timeline[SCHED_TIMELINE_MAX];
+    uint8_t  _timelineCount;
+    uint8_t  _timelineCursor;       // Pierwsza pozycja, której okno nie minęło
+    uint32_t _timelineDay;          // Dzień epoki osi (UINT32_MAX = do zbudowania)
+    uint32_t _timelineGeneration;   // channelManager.getActiveGeneration() przy budowie
+    uint32_t _timelineLastSec;      // Sekunda dnia ostatniego odświeżenia (cofnięcie zegara)
+    
+    // Budzenie: jednorazowy esp_timer -> LOOP_EVENT_SCHEDULE
+    esp_timer_handle_t _wakeTimer;  // nullptr = tylko termin millis()
+    uint32_t _wakeAtMs;             // millis() terminu (zapas, gdy timer nie zadziała)
+    uint32_t _wakeCount;
+    
     /**
      * Sprawdź czy trzeba wykonać daily reset
      */
@@ -161,6 +216,47 @@ private:
      */
     bool _performDailyReset();
     
+    /**
+     * Przelicz dzień resetu zapisany w starym formacie (year*366 + month*31 + day)
+     * na dzień epoki - bez tego aktualizacja firmware wymusiłaby drugi reset dnia
+     */
+    void _migrateLegacyResetDay(const TimeInfo& now, uint32_t currentUtcDay);
+    
+    /**
+     * Pełny przebieg maszyny stanów (reset dobowy, harmonogram, postęp)
+     */
+    void _runPass();
+    
+    /**
+     * Uzbrój timer na następny termin (event, ponowienie w oknie, reset dobowy)
+     */
+    void _armWake();
+    
+    /**
+     * Sekunda dnia następnego terminu (może być >= 86400 - jutro)
+     */
+    uint32_t _nextWakeSecond(uint32_t nowSec, uint8_t dayOfWeek) const;
+    
+    /**
+     * Callback esp_timer (task esp_timer)
+     */
+    static void _onWakeTimer(void* arg);
+    
+    /**
+     * Przebuduj oś po zmianie dnia / konfiguracji, przesuń kursor do bieżącej sekundy
+     */
+    void _refreshTimeline(const TimeInfo& now);
+    
+    /**
+     * Zbuduj oś dnia z aktywnej konfiguracji
+     */
+    void _rebuildTimeline(uint32_t utcDay, uint8_t dayOfWeek);
+    
+    /**
+     * Ustaw kursor na pierwszej pozycji, której okno trwa lub jest przed nami
+     */
+    void _seekTimeline(uint32_t secondOfDay);
+    
     /**
      * Sprawdź harmonogram i uruchom eventy
      */
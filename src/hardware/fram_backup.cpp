@@ -0,0 +1,479 @@
+/**
+ * DOZOWNIK - FRAM Backup / Restore Implementation
+ */
+
+#include "fram_backup.h"
+#include <stddef.h>
+
+// Global instance
+FramBackup framBackup;
+
+// Copy / verify buffer (stack) - larger than any restorable record
+#define RESTORE_COPY_CHUNK      64
+
+// ============================================================================
+// BACKUP STREAM
+// ============================================================================
+
+FramBackupStream::FramBackupStream(uint32_t sectionMask, uint32_t created)
+    : _mask(((sectionMask | FRAM_BACKUP_ALWAYS) & ~FRAM_PRIVATE_SECTIONS) & FRAM_SECTION_MASK_ALL),
+      _created(created), _dataLength(0), _count(0), _next(0) {
+
+    for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+        if (!(_mask & (1UL << i))) continue;
+        _dataLength += FRAM_SECTION_INFO[i].size;
+        _count++;
+    }
+
+    _length = _headerBytes() + _dataLength + sizeof(uint32_t);
+}
+
+size_t FramBackupStream::_headerBytes() const {
+    return sizeof(FramBackupHeader) + (size_t)_count * sizeof(FramBackupEntry);
+}
+
+void FramBackupStream::_makeHeader(FramBackupHeader* header) const {
+    memset(header, 0, sizeof(*header));
+    header->magic = FRAM_BACKUP_MAGIC;
+    header->format = FRAM_BACKUP_FORMAT;
+    header->layout_version = FRAM_LAYOUT_VERSION;
+    header->section_mask = _mask;
+    header->data_length = _dataLength;
+    header->created = _created;
+    header->section_count = _count;
+    header->crc32 = Crc32::compute(header, offsetof(FramBackupHeader, crc32));
+}
+
+void FramBackupStream::_makeEntry(uint8_t n, FramBackupEntry* entry) const {
+    memset(entry, 0, sizeof(*entry));
+
+    for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+        if (!(_mask & (1UL << i))) continue;
+        if (n-- == 0) {
+            entry->section = i;
+            entry->address = FRAM_SECTION_INFO[i].address;
+            entry->length = FRAM_SECTION_INFO[i].size;
+            return;
+        }
+    }
+}
+
+size_t FramBackupStream::read(uint8_t* buffer, size_t maxLen, size_t index) {
+    // The file CRC is built on the fly - only a sequential stream can be served
+    if (index != _next || index >= _length || maxLen == 0) return 0;
+
+    size_t headerBytes = _headerBytes();
+    size_t n = 0;
+
+    if (index < sizeof(FramBackupHeader)) {
+        FramBackupHeader header;
+        _makeHeader(&header);
+        n = min(maxLen, sizeof(header) - index);
+        memcpy(buffer, (const uint8_t*)&header + index, n);
+
+    } else if (index < headerBytes) {
+        size_t pos = index - sizeof(FramBackupHeader);
+        size_t offset = pos % sizeof(FramBackupEntry);
+        FramBackupEntry entry;
+        _makeEntry(pos / sizeof(FramBackupEntry), &entry);
+        n = min(maxLen, sizeof(entry) - offset);
+        memcpy(buffer, (const uint8_t*)&entry + offset, n);
+
+    } else if (index < headerBytes + _dataLength) {
+        // Section data straight from FRAM into the response buffer
+        uint32_t pos = index - headerBytes;
+        for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+            if (!(_mask & (1UL << i))) continue;
+
+            const FramSectionInfo& s = FRAM_SECTION_INFO[i];
+            if (pos < s.size) {
+                n = min(maxLen, (size_t)(s.size - pos));
+                n = min(n, (size_t)FRAM_BACKUP_CHUNK);
+                if (!framController.readBytes(s.address + pos, buffer, n)) {
+                    Serial.printf("[BACKUP] Read error in %s - stream aborted\n", s.name);
+                    return 0;
+                }
+                break;
+            }
+            pos -= s.size;
+        }
+
+    } else {
+        // Trailer - CRC of everything sent so far
+        uint32_t crc = _crc.value();
+        size_t offset = index - headerBytes - _dataLength;
+        n = min(maxLen, sizeof(crc) - offset);
+        memcpy(buffer, (const uint8_t*)&crc + offset, n);
+        _next += n;
+        return n;
+    }
+
+    _crc.update(buffer, n);
+    _next += n;
+    return n;
+}
+
+// ============================================================================
+// SECTION SELECTION
+// ============================================================================
+
+// A/B records: the loaders pick the slot with the higher seq, so a restored
+// half with a lower seq than its live partner would be silently ignored
+static const FramSectionId AB_PAIRS[][2] = {
+    { FramSectionId::SYSTEM_STATE_A, FramSectionId::SYSTEM_STATE_B },
+    { FramSectionId::CONFIG_A,       FramSectionId::CONFIG_B       },
+    { FramSectionId::DAILY_STATE_A,  FramSectionId::DAILY_STATE_B  },
+};
+
+// Partner halves missing from the mask
+static uint32_t _missingPairHalves(uint32_t mask) {
+    uint32_t missing = 0;
+    for (size_t i = 0; i < sizeof(AB_PAIRS) / sizeof(AB_PAIRS[0]); i++) {
+        uint32_t a = 1UL << (uint8_t)AB_PAIRS[i][0];
+        uint32_t b = 1UL << (uint8_t)AB_PAIRS[i][1];
+        if ((mask & a) && !(mask & b)) missing |= b;
+        if ((mask & b) && !(mask & a)) missing |= a;
+    }
+    return missing;
+}
+
+uint32_t FramBackup::parseSections(const char* list) {
+    if (list == nullptr || *list == '\0' || strcmp(list, "config") == 0) {
+        return FRAM_RESTORABLE_SECTIONS | FRAM_BACKUP_ALWAYS;
+    }
+    if (strcmp(list, "all") == 0) {
+        return FRAM_SECTION_MASK_ALL & ~FRAM_PRIVATE_SECTIONS;
+    }
+
+    uint32_t mask = FRAM_BACKUP_ALWAYS;
+    const char* p = list;
+
+    while (*p) {
+        const char* end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+
+        uint8_t found = FRAM_SECTION_COUNT;
+        for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+            const char* name = FRAM_SECTION_INFO[i].name;
+            if (strlen(name) == len && strncasecmp(name, p, len) == 0) {
+                found = i;
+                break;
+            }
+        }
+
+        if (found == FRAM_SECTION_COUNT || (FRAM_PRIVATE_SECTIONS & (1UL << found))) {
+            return 0;
+        }
+
+        mask |= 1UL << found;
+        if (!end) break;
+        p = end + 1;
+    }
+
+    return mask | _missingPairHalves(mask);
+}
+
+// ============================================================================
+// RESTORE - UPLOAD
+// ============================================================================
+
+FramBackup::FramBackup()
+    : _owner(nullptr), _result(RESTORE_OK), _total(0), _received(0),
+      _errorSection(FRAM_SECTION_COUNT) {
+}
+
+FramRestoreResult FramBackup::beginRestore(const void* owner, size_t total) {
+    _owner = owner;
+    _total = total;
+    _received = 0;
+    _errorSection = FRAM_SECTION_COUNT;
+
+    if (total > FRAM_SIZE_RESTORE_STAGING) {
+        _result = RESTORE_TOO_LARGE;
+    } else if (total < sizeof(FramBackupHeader) + sizeof(FramBackupEntry) + sizeof(uint32_t)) {
+        _result = RESTORE_BAD_FILE;
+    } else if (!framController.clearArea(FRAM_ADDR_RESTORE_STATE, sizeof(FramRestoreState))) {
+        // A committed but not yet applied restore must not survive new staging
+        _result = RESTORE_IO_ERROR;
+    } else {
+        _result = RESTORE_OK;
+        Serial.printf("[RESTORE] Receiving %u B\n", (unsigned)total);
+    }
+
+    return _result;
+}
+
+FramRestoreResult FramBackup::writeRestore(const void* owner, const uint8_t* data,
+                                           size_t len, size_t index) {
+    if (owner == nullptr || owner != _owner) return RESTORE_BUSY;
+    if (_result != RESTORE_OK) return _result;
+
+    if (index != _received || index + len > _total) {
+        _result = RESTORE_BAD_FILE;
+    } else if (!framController.writeBytes(FRAM_ADDR_RESTORE_STAGING + index, data, len)) {
+        // Straight into FRAM - the upload is never held in RAM
+        _result = RESTORE_IO_ERROR;
+    } else {
+        _received += len;
+    }
+
+    return _result;
+}
+
+FramRestoreResult FramBackup::finishRestore(const void* owner, uint32_t timestamp) {
+    if (owner == nullptr || owner != _owner) return RESTORE_BUSY;
+    _owner = nullptr;
+
+    if (_result == RESTORE_OK && _received != _total) _result = RESTORE_BAD_FILE;
+
+    uint32_t fileCrc = 0;
+    uint32_t mask = 0;
+    if (_result == RESTORE_OK) _result = _verifyStaged(_total, &fileCrc, &mask);
+
+    if (_result != RESTORE_OK) {
+        Serial.printf("[RESTORE] Rejected: %s\n", resultToString(_result));
+        return _result;
+    }
+
+    FramRestoreState state;
+    memset(&state, 0, sizeof(state));
+    state.magic = FRAM_RESTORE_MAGIC;
+    state.file_length = _total;
+    state.file_crc = fileCrc;
+    state.section_mask = mask;
+    state.staged_at = timestamp;
+    state.crc32 = Crc32::compute(&state, offsetof(FramRestoreState, crc32));
+
+    if (!framController.writeBytes(FRAM_ADDR_RESTORE_STATE, &state, sizeof(state))) {
+        return RESTORE_IO_ERROR;
+    }
+
+    Serial.printf("[RESTORE] Staged %u B (sections 0x%06lX) - applied on next boot\n",
+                  (unsigned)_total, (unsigned long)mask);
+    return RESTORE_OK;
+}
+
+// ============================================================================
+// RESTORE - VERIFICATION
+// ============================================================================
+
+bool FramBackup::_stagedCrc(size_t length, uint32_t* crc) {
+    uint8_t buf[RESTORE_COPY_CHUNK];
+    uint16_t address = FRAM_ADDR_RESTORE_STAGING;
+    size_t remaining = length;
+    Crc32 sum;
+
+    while (remaining > 0) {
+        size_t chunk = min(remaining, sizeof(buf));
+        if (!framController.readBytes(address, buf, chunk)) return false;
+        sum.update(buf, chunk);
+        address += chunk;
+        remaining -= chunk;
+    }
+
+    *crc = sum.value();
+    return true;
+}
+
+FramRestoreResult FramBackup::_verifyStaged(size_t length, uint32_t* fileCrc, uint32_t* mask) {
+    FramBackupHeader header;
+    if (!framController.readBytes(FRAM_ADDR_RESTORE_STAGING, &header, sizeof(header))) {
+        return RESTORE_IO_ERROR;
+    }
+
+    if (header.magic != FRAM_BACKUP_MAGIC || header.format != FRAM_BACKUP_FORMAT ||
+        Crc32::compute(&header, offsetof(FramBackupHeader, crc32)) != header.crc32) {
+        return RESTORE_BAD_FILE;
+    }
+    if (header.layout_version != FRAM_LAYOUT_VERSION) return RESTORE_BAD_LAYOUT;
+
+    size_t headerBytes = sizeof(header) + (size_t)header.section_count * sizeof(FramBackupEntry);
+    if (headerBytes + header.data_length + sizeof(uint32_t) != length ||
+        popcount32(header.section_mask) != header.section_count ||
+        !(header.section_mask & FRAM_BACKUP_ALWAYS)) {
+        return RESTORE_BAD_FILE;
+    }
+
+    uint32_t foreign = header.section_mask & ~(FRAM_RESTORABLE_SECTIONS | FRAM_BACKUP_ALWAYS);
+    if (foreign) {
+        for (_errorSection = 0; !(foreign & (1UL << _errorSection)); _errorSection++) {}
+        return RESTORE_NOT_RESTORABLE;
+    }
+
+    uint32_t split = _missingPairHalves(header.section_mask);
+    if (split) {
+        for (_errorSection = 0; !(split & (1UL << _errorSection)); _errorSection++) {}
+        return RESTORE_SPLIT_PAIR;
+    }
+
+    // Whole file first - the directory below is only trusted after this
+    uint32_t stored = 0;
+    if (!_stagedCrc(length - sizeof(stored), fileCrc) ||
+        !framController.readBytes(FRAM_ADDR_RESTORE_STAGING + length - sizeof(stored),
+                                  &stored, sizeof(stored))) {
+        return RESTORE_IO_ERROR;
+    }
+    if (*fileCrc != stored) return RESTORE_BAD_FILE;
+
+    // Directory must match this firmware's layout, record by record CRC
+    uint16_t dataAddress = FRAM_ADDR_RESTORE_STAGING + headerBytes;
+    uint32_t dataTotal = 0;
+    int16_t lastSection = -1;
+
+    for (uint8_t n = 0; n < header.section_count; n++) {
+        FramBackupEntry entry;
+        if (!framController.readBytes(FRAM_ADDR_RESTORE_STAGING + sizeof(header) + n * sizeof(entry),
+                                      &entry, sizeof(entry))) {
+            return RESTORE_IO_ERROR;
+        }
+
+        if (entry.section >= FRAM_SECTION_COUNT || entry.section <= lastSection ||
+            !(header.section_mask & (1UL << entry.section))) {
+            return RESTORE_BAD_FILE;
+        }
+        lastSection = entry.section;
+        _errorSection = entry.section;
+
+        const FramSectionInfo& s = FRAM_SECTION_INFO[entry.section];
+        if (entry.address != s.address || entry.length != s.size ||
+            s.crcOffset == FRAM_NO_CRC || s.recordSize > RESTORE_COPY_CHUNK) {
+            return RESTORE_BAD_LAYOUT;
+        }
+
+        for (uint16_t r = 0; r < s.count; r++) {
+            uint8_t rec[RESTORE_COPY_CHUNK];
+            if (!framController.readBytes(dataAddress + r * s.recordSize, rec, s.recordSize)) {
+                return RESTORE_IO_ERROR;
+            }
+
+            // Cleared slot (e.g. unused B copy) is part of a valid image
+            bool empty = true;
+            for (uint16_t i = 0; i < s.recordSize && empty; i++) empty = (rec[i] == 0);
+            if (empty && entry.section != (uint8_t)FramSectionId::HEADER) continue;
+
+            if (!FramController::verifySectionRecord(entry.section, rec)) {
+                return RESTORE_BAD_RECORD;
+            }
+        }
+
+        if (entry.section == (uint8_t)FramSectionId::HEADER) {
+            FramHeader source;
+            if (!framController.readBytes(dataAddress, &source, sizeof(source))) {
+                return RESTORE_IO_ERROR;
+            }
+            if (source.magic != FRAM_MAGIC_NUMBER || source.layout_version != FRAM_LAYOUT_VERSION) {
+                return RESTORE_BAD_LAYOUT;
+            }
+        }
+
+        dataAddress += entry.length;
+        dataTotal += entry.length;
+    }
+
+    _errorSection = FRAM_SECTION_COUNT;
+    if (dataTotal != header.data_length) return RESTORE_BAD_FILE;
+
+    *mask = header.section_mask;
+    return RESTORE_OK;
+}
+
+bool FramBackup::_readState(FramRestoreState* state) {
+    if (!framController.readBytes(FRAM_ADDR_RESTORE_STATE, state, sizeof(FramRestoreState))) {
+        return false;
+    }
+    if (state->magic != FRAM_RESTORE_MAGIC) return false;
+    return Crc32::compute(state, offsetof(FramRestoreState, crc32)) == state->crc32;
+}
+
+// ============================================================================
+// RESTORE - APPLY (boot)
+// ============================================================================
+
+bool FramBackup::applyPendingRestore() {
+    FramRestoreState state;
+    if (!_readState(&state)) return false;
+
+    // Staged file was verified before commit - re-check it has not rotted since
+    uint32_t crc = 0;
+    if (state.file_length > FRAM_SIZE_RESTORE_STAGING ||
+        !_stagedCrc(state.file_length - sizeof(uint32_t), &crc) || crc != state.file_crc) {
+        Serial.println(F("[RESTORE] Staged backup corrupt - discarded"));
+        framController.clearArea(FRAM_ADDR_RESTORE_STATE, sizeof(FramRestoreState));
+        return false;
+    }
+
+    FramBackupHeader header;
+    if (!framController.readBytes(FRAM_ADDR_RESTORE_STAGING, &header, sizeof(header))) return false;
+
+    uint16_t dataAddress = FRAM_ADDR_RESTORE_STAGING + sizeof(header) +
+                           header.section_count * sizeof(FramBackupEntry);
+    uint8_t applied = 0;
+
+    // Idempotent copy - an interrupted run simply starts over on next boot
+    for (uint8_t n = 0; n < header.section_count; n++) {
+        FramBackupEntry entry;
+        if (!framController.readBytes(FRAM_ADDR_RESTORE_STAGING + sizeof(header) + n * sizeof(entry),
+                                      &entry, sizeof(entry))) {
+            return false;
+        }
+
+        if (entry.section != (uint8_t)FramSectionId::HEADER) {
+            uint8_t buf[RESTORE_COPY_CHUNK];
+            for (uint32_t offset = 0; offset < entry.length; offset += sizeof(buf)) {
+                size_t chunk = min((size_t)(entry.length - offset), sizeof(buf));
+                if (!framController.readBytes(dataAddress + offset, buf, chunk) ||
+                    !framController.writeBytes(entry.address + offset, buf, chunk)) {
+                    Serial.println(F("[RESTORE] ERROR: Copy failed, retry on next boot"));
+                    return false;
+                }
+            }
+            Serial.printf("[RESTORE]   %s (%lu B)\n", FRAM_SECTION_INFO[entry.section].name,
+                          (unsigned long)entry.length);
+            applied++;
+        }
+
+        dataAddress += entry.length;
+    }
+
+    if (!framController.clearArea(FRAM_ADDR_RESTORE_STATE, sizeof(FramRestoreState))) {
+        return false;
+    }
+
+    Serial.printf("[RESTORE] Applied %d sections from backup staged at %lu\n",
+                  applied, (unsigned long)state.staged_at);
+    return true;
+}
+
+// ============================================================================
+// DEBUG
+// ============================================================================
+
+const char* FramBackup::resultToString(FramRestoreResult result) {
+    switch (result) {
+        case RESTORE_OK:                return "OK";
+        case RESTORE_BUSY:              return "Another restore in progress";
+        case RESTORE_TOO_LARGE:         return "Backup too large to restore";
+        case RESTORE_IO_ERROR:          return "FRAM I/O error";
+        case RESTORE_BAD_FILE:          return "Invalid backup file";
+        case RESTORE_BAD_LAYOUT:        return "Backup from a different FRAM layout";
+        case RESTORE_NOT_RESTORABLE:    return "Section cannot be restored";
+        case RESTORE_BAD_RECORD:        return "Record CRC error";
+        case RESTORE_SPLIT_PAIR:        return "A/B pair must be restored together";
+        default:                        return "Unknown";
+    }
+}
+
+void FramBackup::printStatus() {
+    Serial.printf("[RESTORE] Staging 0x%04X, %u B max (config set %u B)\n",
+                  FRAM_ADDR_RESTORE_STAGING, (unsigned)FRAM_SIZE_RESTORE_STAGING,
+                  (unsigned)FramBackupStream(FRAM_RESTORABLE_SECTIONS, 0).length());
+
+    FramRestoreState state;
+    if (_readState(&state)) {
+        Serial.printf("  Pending restore: %lu B, sections 0x%06lX, staged at %lu\n",
+                      (unsigned long)state.file_length, (unsigned long)state.section_mask,
+                      (unsigned long)state.staged_at);
+    } else {
+        Serial.println(F("  Pending restore: none"));
+    }
+}
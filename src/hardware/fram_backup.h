@@ -0,0 +1,253 @@
+/**
+ * DOZOWNIK - FRAM Backup / Restore
+ *
+ * Kopia zapasowa wybranych sekcji FRAM jako plik binarny:
+ *
+ *   FramBackupHeader (32 B)
+ *   FramBackupEntry  (8 B) × liczba sekcji   - w kolejności układu
+ *   dane sekcji                              - bajty FRAM 1:1
+ *   CRC32 (4 B)                              - wszystkiego powyżej
+ *
+ * Pobieranie: FramBackupStream generuje plik kawałkami wprost do bufora
+ * odpowiedzi HTTP - bez kopii 32 kB w RAM.
+ *
+ * Przywracanie: plik trafia kawałkami do obszaru roboczego w RESERVED.
+ * Po odebraniu całości weryfikowane są: CRC pliku, zgodność katalogu
+ * z bieżącym układem i CRC każdego rekordu. Dopiero wtedy zapisywany
+ * jest rekord zatwierdzenia, a sekcje kopiowane są na miejsce przy
+ * następnym starcie - przed odczytem przez jakikolwiek moduł. Przerwane
+ * kopiowanie jest powtarzane, więc przywrócenie jest jedną transakcją.
+ */
+
+#ifndef FRAM_BACKUP_H
+#define FRAM_BACKUP_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "fram_layout.h"
+#include "fram_controller.h"
+#include "fram_migration.h"
+#include "../crypto/crc32.h"
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+#define FRAM_BACKUP_MAGIC           0x4B425A44  // "DZBK" in ASCII
+#define FRAM_BACKUP_FORMAT          1
+#define FRAM_BACKUP_CHUNK           128         // Max bajtów na jeden odczyt FRAM
+
+#define FRAM_RESTORE_MAGIC          0x52545352  // "RSTR" in ASCII
+
+// Obszar przywracania: koniec RESERVED tuż przed obszarem migracji
+// (początek RESERVED to scratch testów CLI)
+#define FRAM_RESTORE_AREA_SIZE      2048
+#define FRAM_ADDR_RESTORE_STATE     (FRAM_ADDR_MIGRATION_STATE - FRAM_RESTORE_AREA_SIZE)
+#define FRAM_ADDR_RESTORE_STAGING   (FRAM_ADDR_RESTORE_STATE + sizeof(FramRestoreState))
+#define FRAM_SIZE_RESTORE_STAGING   (FRAM_RESTORE_AREA_SIZE - sizeof(FramRestoreState))
+
+#define FRAM_SECTION_BIT(id)        (1UL << (uint8_t)FramSectionId::id)
+
+// HEADER jest w każdej kopii (identyfikuje układ), nigdy nie jest przywracany
+#define FRAM_BACKUP_ALWAYS          FRAM_SECTION_BIT(HEADER)
+
+// Sekcje, które można przywrócić (konfiguracja, kalibracja, stan)
+#define FRAM_RESTORABLE_SECTIONS    (FRAM_SECTION_BIT(SYSTEM_STATE_A)   | \
+                                     FRAM_SECTION_BIT(CONFIG_A)         | \
+                                     FRAM_SECTION_BIT(CONFIG_B)         | \
+                                     FRAM_SECTION_BIT(DAILY_STATE_A)    | \
+                                     FRAM_SECTION_BIT(CRITICAL_ERROR)   | \
+                                     FRAM_SECTION_BIT(CONTAINER_VOLUME) | \
+                                     FRAM_SECTION_BIT(DOSED_TRACKER)    | \
+                                     FRAM_SECTION_BIT(SYSTEM_STATE_B)   | \
+                                     FRAM_SECTION_BIT(DAILY_STATE_B))
+
+// Nigdy nie eksportowane: sekrety urządzenia i obszary robocze
+#define FRAM_PRIVATE_SECTIONS       (FRAM_SECTION_BIT(CREDENTIALS)      | \
+                                     FRAM_SECTION_BIT(AUTH_DATA)        | \
+                                     FRAM_SECTION_BIT(SESSION_DATA)     | \
+                                     FRAM_SECTION_BIT(FREE_SPACE)       | \
+                                     FRAM_SECTION_BIT(RESERVED))
+
+#define FRAM_SECTION_MASK_ALL       ((1UL << FRAM_SECTION_COUNT) - 1)
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+#pragma pack(push, 1)
+
+/**
+ * Nagłówek pliku kopii
+ */
+struct FramBackupHeader {
+    uint32_t magic;             // FRAM_BACKUP_MAGIC
+    uint16_t format;            // FRAM_BACKUP_FORMAT
+    uint16_t layout_version;    // FRAM_LAYOUT_VERSION źródła
+    uint32_t section_mask;      // Bit = FramSectionId
+    uint32_t data_length;       // Suma długości sekcji
+    uint32_t created;           // Unix timestamp utworzenia
+    uint8_t  section_count;     // Liczba wpisów katalogu
+    uint8_t  _reserved[7];
+    uint32_t crc32;             // CRC32 nagłówka (bez tego pola)
+};
+
+/**
+ * Wpis katalogu - jedna sekcja
+ */
+struct FramBackupEntry {
+    uint8_t  section;           // FramSectionId
+    uint8_t  _reserved;
+    uint16_t address;           // Adres w FRAM
+    uint32_t length;            // Bajty danych
+};
+
+/**
+ * Rekord zatwierdzenia przywracania (początek obszaru przywracania)
+ */
+struct FramRestoreState {
+    uint32_t magic;             // FRAM_RESTORE_MAGIC
+    uint32_t file_length;       // Bajty pliku w obszarze roboczym
+    uint32_t file_crc;          // CRC32 pliku (bez końcowego CRC)
+    uint32_t section_mask;
+    uint32_t staged_at;         // Unix timestamp przyjęcia pliku
+    uint8_t  _reserved[8];
+    uint32_t crc32;             // CRC32 rekordu (bez tego pola)
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(FramBackupHeader) == 32, "FramBackupHeader must be 32 bytes");
+static_assert(sizeof(FramBackupEntry) == 8, "FramBackupEntry must be 8 bytes");
+static_assert(sizeof(FramRestoreState) == 32, "FramRestoreState must be 32 bytes");
+static_assert(FRAM_SECTION_COUNT <= 32, "Section mask is 32 bit!");
+static_assert(FRAM_ADDR_RESTORE_STATE >= FRAM_ADDR_RESERVED + 64,
+              "Restore area must stay inside RESERVED, behind the CLI scratch!");
+
+// Pełny zestaw przywracalny musi mieścić się w obszarze roboczym
+#define FRAM_RESTORE_SET_LENGTH     (FRAM_SIZE_HEADER + 2 * FRAM_SIZE_SYSTEM_STATE +      \
+                                     2 * FRAM_SIZE_CONFIG_SLOT + 2 * FRAM_SIZE_DAILY_STATE + \
+                                     FRAM_SIZE_CRITICAL_ERROR + FRAM_SIZE_CONTAINER_VOLUME + \
+                                     FRAM_SIZE_DOSED_TRACKER)
+
+// Katalog: HEADER + 9 sekcji przywracalnych
+static_assert(sizeof(FramBackupHeader) + 10 * sizeof(FramBackupEntry) + FRAM_RESTORE_SET_LENGTH +
+              sizeof(uint32_t) <= FRAM_SIZE_RESTORE_STAGING,
+              "Restorable sections do not fit the restore staging area!");
+
+// ============================================================================
+// BACKUP STREAM
+// ============================================================================
+
+/**
+ * Generator pliku kopii dla odpowiedzi HTTP (wywoływany kolejnymi kawałkami).
+ * Sekcje czytane są w trakcie wysyłki - zapis w międzyczasie (np. dziennik)
+ * może trafić do kopii częściowo; CRC rekordów pokaże niespójność.
+ */
+class FramBackupStream {
+public:
+    FramBackupStream(uint32_t sectionMask, uint32_t created);
+
+    /** Całkowita długość pliku (Content-Length) */
+    size_t length() const { return _length; }
+
+    /**
+     * Wypełnij bufor od pozycji index (kolejne wywołania, rosnący index)
+     * @return bajty w buforze, 0 = koniec lub błąd odczytu
+     */
+    size_t read(uint8_t* buffer, size_t maxLen, size_t index);
+
+private:
+    uint32_t _mask;
+    uint32_t _created;
+    uint32_t _dataLength;
+    uint8_t  _count;
+    size_t   _length;
+    size_t   _next;             // Oczekiwany index (strumień jest sekwencyjny)
+    Crc32    _crc;
+
+    size_t _headerBytes() const;
+    void _makeHeader(FramBackupHeader* header) const;
+    void _makeEntry(uint8_t n, FramBackupEntry* entry) const;
+};
+
+// ============================================================================
+// FRAM BACKUP CLASS (restore)
+// ============================================================================
+
+enum FramRestoreResult : uint8_t {
+    RESTORE_OK = 0,
+    RESTORE_BUSY,               // Inny upload w toku
+    RESTORE_TOO_LARGE,          // Nie mieści się w obszarze roboczym
+    RESTORE_IO_ERROR,
+    RESTORE_BAD_FILE,           // Nagłówek, katalog lub CRC pliku
+    RESTORE_BAD_LAYOUT,         // Inna wersja układu lub adresy sekcji
+    RESTORE_NOT_RESTORABLE,     // Sekcja spoza FRAM_RESTORABLE_SECTIONS
+    RESTORE_BAD_RECORD,         // Rekord z błędnym CRC
+    RESTORE_SPLIT_PAIR          // Tylko jedna połówka pary A/B
+};
+
+class FramBackup {
+public:
+    FramBackup();
+
+    /**
+     * Maska sekcji z listy nazw ("CONFIG_A,CONFIG_B") lub zestawu:
+     * "config" = sekcje przywracalne, "all" = wszystko poza prywatnymi.
+     * HEADER dodawany zawsze, pary A/B zawsze w całości (CONFIG_A -> + CONFIG_B).
+     * @return maska lub 0 gdy nazwa nieznana / sekcja prywatna
+     */
+    static uint32_t parseSections(const char* list);
+
+    /**
+     * Rozpocznij przyjmowanie pliku (poprzedni niedokończony upload przepada)
+     * Błąd zapamiętywany jest do finishRestore() tego samego uploadu.
+     * @param owner Identyfikator uploadu (np. wskaźnik żądania)
+     */
+    FramRestoreResult beginRestore(const void* owner, size_t total);
+
+    /**
+     * Kolejny kawałek pliku - zapisywany wprost do obszaru roboczego
+     */
+    FramRestoreResult writeRestore(const void* owner, const uint8_t* data, size_t len, size_t index);
+
+    /**
+     * Zweryfikuj odebrany plik i zatwierdź (zastosowanie przy restarcie)
+     */
+    FramRestoreResult finishRestore(const void* owner, uint32_t timestamp);
+
+    /**
+     * Start: skopiuj zatwierdzone sekcje na miejsce (wołane z FramController::begin)
+     * @return true jeśli sekcje zostały przywrócone
+     */
+    bool applyPendingRestore();
+
+    /** Ostatni błąd: sekcja, której dotyczy (FRAM_SECTION_COUNT = brak) */
+    uint8_t getErrorSection() const { return _errorSection; }
+
+    static const char* resultToString(FramRestoreResult result);
+
+    /**
+     * Debug: stan obszaru przywracania
+     */
+    void printStatus();
+
+private:
+    const void* _owner;         // Upload w toku (nullptr = brak)
+    FramRestoreResult _result;  // Pierwszy błąd uploadu
+    size_t      _total;
+    size_t      _received;
+    uint8_t     _errorSection;
+
+    FramRestoreResult _verifyStaged(size_t length, uint32_t* fileCrc, uint32_t* mask);
+    bool _stagedCrc(size_t length, uint32_t* crc);
+    bool _readState(FramRestoreState* state);
+};
+
+// ============================================================================
+// GLOBAL INSTANCE
+// ============================================================================
+
+extern FramBackup framBackup;
+
+#endif // FRAM_BACKUP_H
@@ -4,55 +4,16 @@
  */
 
 #include "fram_controller.h"
+#include "fram_migration.h"
+#include "fram_backup.h"
+#include "../crypto/crc32.h"
 
 // Global instance
 FramController framController;
 
-// CRC32 lookup table (polynomial 0xEDB88320)
-static const uint32_t crc32_table[256] PROGMEM = {
-    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
-    0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
-    0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
-    0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
-    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
-    0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
-    0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
-    0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
-    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
-    0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
-    0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
-    0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
-    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
-    0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
-    0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
-    0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
-    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
-    0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
-    0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
-    0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
-    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
-    0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
-    0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
-    0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
-    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
-    0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
-    0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
-    0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
-    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
-    0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
-    0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
-    0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
-    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
-    0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
-    0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
-    0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
-    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
-    0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
-    0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
-    0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
-    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD706B3,
-    0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
-    0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+// Runtime copy of the section table
+const FramSectionInfo FRAM_SECTION_INFO[FRAM_SECTION_COUNT] = {
+    FRAM_SECTIONS(FRAM_SECTION_INFO_ENTRY, FRAM_SECTION_INFO_ENTRY)
 };
 
 // ============================================================================
@@ -60,15 +21,92 @@ static const uint32_t crc32_table[256] PROGMEM = {
 // ============================================================================
 
 uint32_t FramController::calculateCRC32(const void* data, size_t length) {
-    const uint8_t* bytes = (const uint8_t*)data;
-    uint32_t crc = 0xFFFFFFFF;
-    
-    for (size_t i = 0; i < length; i++) {
-        uint8_t index = (crc ^ bytes[i]) & 0xFF;
-        crc = pgm_read_dword(&crc32_table[index]) ^ (crc >> 8);
+    return Crc32::compute(data, length);
+}
+
+bool FramController::verifyCRC32(const void* data, size_t length, uint32_t stored) {
+    return Crc32::matches(data, length, stored);
+}
+
+uint32_t calculateCRC32(const void* data, size_t length) {
+    return Crc32::compute(data, length);
+}
+
+bool validateCRC32(const void* data, size_t length, uint32_t expected_crc) {
+    return Crc32::matches(data, length, expected_crc);
+}
+
+// ============================================================================
+// RECORD CRC (field position from the section table)
+// ============================================================================
+
+uint32_t FramController::_recordCRC(const void* record, size_t size, uint16_t crcOffset, uint8_t crcSize) {
+    const uint8_t* p = (const uint8_t*)record;
+    Crc32 crc;
+    crc.update(p, crcOffset);
+    crc.update(p + crcOffset + crcSize, size - crcOffset - crcSize);
+    return crc.value();
+}
+
+void FramController::_sealRecord(void* record, size_t size, uint16_t crcOffset, uint8_t crcSize) {
+    uint32_t crc = _recordCRC(record, size, crcOffset, crcSize);
+    memcpy((uint8_t*)record + crcOffset, &crc, crcSize);    // 16-bit fields keep the low half
+}
+
+bool FramController::_verifyRecord(const void* record, size_t size, uint16_t crcOffset, uint8_t crcSize) {
+    uint32_t stored = 0;
+    memcpy(&stored, (const uint8_t*)record + crcOffset, crcSize);
+    uint32_t mask = (crcSize >= 4) ? 0xFFFFFFFFUL : ((1UL << (crcSize * 8)) - 1);
+
+    if (((_recordCRC(record, size, crcOffset, crcSize) ^ stored) & mask) == 0) return true;
+
+    // Sealed before the section table: CRC over the bytes in front of the field
+    return Crc32::matches(record, crcOffset, stored, mask);
+}
+
+bool FramController::verifySectionRecord(uint8_t section, const void* record) {
+    if (section >= FRAM_SECTION_COUNT) return false;
+    const FramSectionInfo& s = FRAM_SECTION_INFO[section];
+    if (s.crcOffset == FRAM_NO_CRC) return false;
+    return _verifyRecord(record, s.recordSize, s.crcOffset, s.crcSize);
+}
+
+// ============================================================================
+// BUS LOCK
+// ============================================================================
+
+// Scoped bus lock for low-level I/O. Before begin() (no mutex yet) it is a no-op.
+class FramBusGuard {
+public:
+    explicit FramBusGuard(FramController& fram) : _fram(fram) {
+        _locked = _fram.lockBus();
     }
-    
-    return crc ^ 0xFFFFFFFF;
+    ~FramBusGuard() {
+        if (_locked) _fram.unlockBus();
+    }
+    bool ok() const { return _locked; }
+private:
+    FramController& _fram;
+    bool _locked;
+};
+
+bool FramController::lockBus(uint32_t timeoutMs) {
+    if (_busMutex == nullptr) return true;
+    if (xSemaphoreTakeRecursive(_busMutex, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) {
+        Serial.println(F("[FRAM] ERROR: Bus lock timeout!"));
+        return false;
+    }
+    return true;
+}
+
+bool FramController::tryLockBus() {
+    if (_busMutex == nullptr) return true;
+    return xSemaphoreTakeRecursive(_busMutex, 0) == pdTRUE;
+}
+
+void FramController::unlockBus() {
+    if (_busMutex == nullptr) return;
+    xSemaphoreGiveRecursive(_busMutex);
 }
 
 // ============================================================================
@@ -78,6 +116,15 @@ uint32_t FramController::calculateCRC32(const void* data, size_t length) {
 bool FramController::begin() {
     Serial.println(F("[FRAM] Initializing..."));
     
+    // Created once - begin() may be called again on I2C recovery
+    if (_busMutex == nullptr) {
+        _busMutex = xSemaphoreCreateRecursiveMutex();
+    }
+
+    // Every record validation below goes through the CRC engine
+    Crc32::begin();
+    Serial.printf("[FRAM] CRC32 backend: %s\n", Crc32::backendName(Crc32::getBackend()));
+    
     // Check if FRAM is present
     if (!probe()) {
         Serial.println(F("[FRAM] ERROR: FRAM not found on I2C!"));
@@ -87,10 +134,23 @@ bool FramController::begin() {
     
     Serial.println(F("[FRAM] FRAM detected at 0x50"));
     
+    // Header check, migration and restore below already read from PSRAM
+    _loadMirror();
+    
     // Try to read and validate header
     if (validateHeader()) {
         Serial.println(F("[FRAM] Valid header found"));
         _initialized = true;
+        
+        // Restore committed over HTTP - applied before any module reads FRAM
+        framBackup.applyPendingRestore();
+        return true;
+    }
+    
+    // Older layout - migrate in place instead of formatting
+    if (framMigration.run()) {
+        Serial.println(F("[FRAM] Layout migrated"));
+        _initialized = true;
         return true;
     }
     
@@ -134,8 +194,7 @@ bool FramController::validateHeader() {
     }
     
     // Verify CRC (exclude crc field itself)
-    uint32_t calc_crc = calculateCRC32(&header, sizeof(FramHeader) - sizeof(uint32_t));
-    if (calc_crc != header.header_crc) {
+    if (!verifyRecord<FramSectionId::HEADER>(header)) {
         Serial.println(F("[FRAM] Header CRC mismatch"));
         return false;
     }
@@ -156,40 +215,39 @@ bool FramController::_initializeEmpty() {
     header.flags = 0;
     
     // Calculate CRC
-    header.header_crc = calculateCRC32(&header, sizeof(FramHeader) - sizeof(uint32_t));
+    sealRecord<FramSectionId::HEADER>(&header);
     
     if (!writeHeader(&header)) {
         return false;
     }
     
-    // Initialize empty channel configs
+    // Initialize empty channel configs (whole section per transaction)
     ChannelConfig emptyConfig;
     memset(&emptyConfig, 0, sizeof(emptyConfig));
     emptyConfig.dosing_rate = DEFAULT_DOSING_RATE;
-    emptyConfig.crc32 = calculateCRC32(&emptyConfig, sizeof(ChannelConfig) - sizeof(uint32_t));
+    sealRecord<FramSectionId::CONFIG_A>(&emptyConfig);
     
+    ChannelConfig configs[CHANNEL_COUNT];
     for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        if (!writeActiveConfig(i, &emptyConfig)) return false;
-        if (!writePendingConfig(i, &emptyConfig)) return false;
+        configs[i] = emptyConfig;
     }
     
-    // Initialize empty daily states
-    ChannelDailyState emptyState;
-    memset(&emptyState, 0, sizeof(emptyState));
-    emptyState.crc32 = calculateCRC32(&emptyState, sizeof(ChannelDailyState) - sizeof(uint32_t));
+    // Same generation in both slots - A wins the tie, nothing pending
+    if (!writeConfigs(FRAM_SLOT_A, configs)) return false;
+    if (!writeConfigs(FRAM_SLOT_B, configs)) return false;
     
-    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        if (!writeDailyState(i, &emptyState)) return false;
-    }
+    // Initialize empty daily states
+    if (!resetAllDailyStates()) return false;
     
     // Initialize system state
     SystemState sysState;
     memset(&sysState, 0, sizeof(sysState));
     sysState.system_enabled = 1;
     sysState.active_channel = 255;
-    sysState.crc32 = calculateCRC32(&sysState, sizeof(SystemState) - sizeof(uint32_t));
+    sealRecord<FramSectionId::SYSTEM_STATE_A>(&sysState);
     
-    if (!writeSystemState(&sysState)) return false;
+    if (!writeSystemState(FRAM_SLOT_A, &sysState)) return false;
+    if (!clearArea(FRAM_ADDR_SYSTEM_STATE_B, FRAM_SIZE_SYSTEM_STATE)) return false;
     
     // Clear error state
     // if (!clearErrorState()) return false;
@@ -200,6 +258,15 @@ bool FramController::_initializeEmpty() {
     // Initialize dosed trackers
     if (!initializeDosedTrackers()) return false;
 
+    // Invalidate dose journal headers - journal reformats itself on begin()
+    if (!clearArea(FRAM_SECTION_ADDR(JOURNAL_HEADER), FRAM_SECTION_SIZE(JOURNAL_HEADER))) return false;
+
+    // Drop rollup history (all three tables are contiguous)
+    if (!clearArea(FRAM_ADDR_ROLLUP_DAILY, FRAM_SECTION_END(ROLLUP_MONTHLY) - FRAM_ADDR_ROLLUP_DAILY)) return false;
+
+    // Lifetime counters start from zero (base + delta log are contiguous)
+    if (!clearArea(FRAM_SECTION_ADDR(COUNTER_BASE), FRAM_SIZE_COUNTERS)) return false;
+
     return true;
 }
 
@@ -213,88 +280,173 @@ bool FramController::readBytes(uint16_t address, void* buffer, size_t length) {
         return false;
     }
     
-    uint8_t* buf = (uint8_t*)buffer;
+    // The lock also keeps the copy consistent with a concurrent write-through
+    FramBusGuard guard(*this);
+    if (!guard.ok()) return false;
+    
+    if (_mirrorClean(address, length)) {
+        memcpy(buffer, _mirror + address, length);
+        _stats.mirror_reads++;
+        _stats.mirror_bytes += length;
+        _sectionStats[sectionAt(address)].mirror_reads++;
+        return true;
+    }
+    
+    return _readBus(address, (uint8_t*)buffer, length);
+}
+
+bool FramController::readBytesDirect(uint16_t address, void* buffer, size_t length) {
+    if (address + length > FRAM_SIZE_BYTES) {
+        Serial.println(F("[FRAM] Read out of bounds!"));
+        return false;
+    }
+    
+    FramBusGuard guard(*this);
+    if (!guard.ok()) return false;
+    
+    return _readBus(address, (uint8_t*)buffer, length);
+}
+
+bool FramController::writeBytes(uint16_t address, const void* data, size_t length) {
+    if (address + length > FRAM_SIZE_BYTES) {
+        Serial.println(F("[FRAM] Write out of bounds!"));
+        return false;
+    }
+    
+    FramBusGuard guard(*this);
+    if (!guard.ok()) return false;
     
+    return _writeBus(address, (const uint8_t*)data, 0, length);
+}
+
+bool FramController::fillArea(uint16_t address, uint8_t value, size_t length) {
+    if (address + length > FRAM_SIZE_BYTES) {
+        Serial.println(F("[FRAM] Fill out of bounds!"));
+        return false;
+    }
+    
+    FramBusGuard guard(*this);
+    if (!guard.ok()) return false;
+    
+    return _writeBus(address, nullptr, value, length);
+}
+
+bool FramController::_readBus(uint16_t address, uint8_t* buffer, size_t length) {
+    // Address latch + current-address reads must not interleave with other FRAM I/O
+    uint32_t startUs = micros();
+    uint8_t retries = 0;
+    bool ok = _readOnce(address, buffer, length);
+    while (!ok && retries < FRAM_IO_MAX_RETRIES) {
+        retries++;
+        ok = _readOnce(address, buffer, length);
+    }
+    
+    _recordOp(address, length, false, ok, retries, micros() - startUs);
+    return ok;
+}
+
+bool FramController::_writeBus(uint16_t address, const uint8_t* data, uint8_t fill, size_t length) {
+    // Rewriting the same bytes is harmless - a retry restarts the whole transfer
+    uint32_t startUs = micros();
+    uint8_t retries = 0;
+    bool ok = _writeOnce(address, data, fill, length);
+    while (!ok && retries < FRAM_IO_MAX_RETRIES) {
+        retries++;
+        ok = _writeOnce(address, data, fill, length);
+    }
+    
+    _recordOp(address, length, true, ok, retries, micros() - startUs);
+    
+    if (_mirrorActive) {
+        if (ok) {
+            // Write-through: mirror follows only what the chip acknowledged
+            if (data) {
+                memcpy(_mirror + address, data, length);
+            } else {
+                memset(_mirror + address, fill, length);
+            }
+            // Fully rewritten pages are known again
+            _setMirrorDirty(address, length, false);
+        } else {
+            // Some chunks may have landed - chip content unknown until checkMirror()
+            _mirrorStats.write_failures++;
+            _setMirrorDirty(address, length, true);
+        }
+    }
+    
+    return ok;
+}
+
+bool FramController::_readOnce(uint16_t address, uint8_t* buf, size_t length) {
+    // Address phase - sent once for the whole transfer
     Wire.beginTransmission(FRAM_I2C_ADDRESS);
     Wire.write((uint8_t)(address >> 8));    // MSB
     Wire.write((uint8_t)(address & 0xFF));  // LSB
+    _stats.transactions++;
     
     if (Wire.endTransmission() != 0) {
         return false;
     }
     
-    // Read in chunks (Wire buffer is limited)
+    // Clock out consecutive chunks (Wire buffer is limited). The MB85RC256V
+    // keeps its address latch after each read, so no address re-send needed.
     size_t remaining = length;
     while (remaining > 0) {
-        size_t chunk = min(remaining, (size_t)32);
+        size_t chunk = min(remaining, (size_t)FRAM_I2C_READ_CHUNK);
+        
+        size_t received = Wire.requestFrom((uint8_t)FRAM_I2C_ADDRESS, (uint8_t)chunk);
+        _stats.transactions++;
         
-        Wire.requestFrom((uint8_t)FRAM_I2C_ADDRESS, (uint8_t)chunk);
+        if (received != chunk) {
+            return false;
+        }
         
-        for (size_t i = 0; i < chunk && Wire.available(); i++) {
+        for (size_t i = 0; i < chunk; i++) {
             *buf++ = Wire.read();
         }
         
         remaining -= chunk;
-        
-        if (remaining > 0) {
-            // Set address for next chunk
-            address += chunk;
-            Wire.beginTransmission(FRAM_I2C_ADDRESS);
-            Wire.write((uint8_t)(address >> 8));
-            Wire.write((uint8_t)(address & 0xFF));
-            Wire.endTransmission();
-        }
     }
     
+    _stats.bytes_read += length;
     return true;
 }
 
-bool FramController::writeBytes(uint16_t address, const void* data, size_t length) {
-    if (address + length > FRAM_SIZE_BYTES) {
-        Serial.println(F("[FRAM] Write out of bounds!"));
-        return false;
-    }
-    
-    const uint8_t* buf = (const uint8_t*)data;
-    
-    // Write in chunks (Wire buffer is limited to 32 bytes including address)
+bool FramController::_writeOnce(uint16_t address, const uint8_t* data, uint8_t fill, size_t length) {
+    // Write in the largest chunks the Wire buffer allows (2 bytes go to address).
+    // FRAM has no page buffer / write delay, so chunk size is only a driver limit.
+    // Fill bytes are generated straight into the Wire buffer.
     size_t remaining = length;
     while (remaining > 0) {
-        size_t chunk = min(remaining, (size_t)30);  // 30 data + 2 address
+        size_t chunk = min(remaining, (size_t)FRAM_I2C_WRITE_CHUNK);
         
         Wire.beginTransmission(FRAM_I2C_ADDRESS);
         Wire.write((uint8_t)(address >> 8));
         Wire.write((uint8_t)(address & 0xFF));
-        
-        for (size_t i = 0; i < chunk; i++) {
-            Wire.write(*buf++);
+        if (data) {
+            Wire.write(data, chunk);
+            data += chunk;
+        } else {
+            for (size_t i = 0; i < chunk; i++) {
+                Wire.write(fill);
+            }
         }
         
+        _stats.transactions++;
         if (Wire.endTransmission() != 0) {
             return false;
         }
         
         address += chunk;
         remaining -= chunk;
+        _stats.bytes_written += chunk;
     }
     
     return true;
 }
 
 bool FramController::clearArea(uint16_t address, size_t length) {
-    uint8_t zeros[32];
-    memset(zeros, 0, sizeof(zeros));
-    
-    while (length > 0) {
-        size_t chunk = min(length, sizeof(zeros));
-        if (!writeBytes(address, zeros, chunk)) {
-            return false;
-        }
-        address += chunk;
-        length -= chunk;
-    }
-    
-    return true;
+    return fillArea(address, 0x00, length);
 }
 
 // ============================================================================
@@ -302,91 +454,114 @@ bool FramController::clearArea(uint16_t address, size_t length) {
 // ============================================================================
 
 bool FramController::readHeader(FramHeader* header) {
-    return readBytes(FRAM_ADDR_HEADER, header, sizeof(FramHeader));
+    return readRecord<FramSectionId::HEADER>(0, header);
 }
 
 bool FramController::writeHeader(const FramHeader* header) {
-    return writeBytes(FRAM_ADDR_HEADER, header, sizeof(FramHeader));
+    return writeRecord<FramSectionId::HEADER>(0, header);
 }
 
 // ============================================================================
-// CHANNEL CONFIG (ACTIVE)
+// BULK SECTION LOADERS
 // ============================================================================
 
-bool FramController::readActiveConfig(uint8_t channel, ChannelConfig* config) {
-    if (channel >= CHANNEL_COUNT) return false;
-    
-    uint16_t addr = FRAM_ADDR_ACTIVE_CH(channel);
-    return readBytes(addr, config, sizeof(ChannelConfig));
+bool FramController::readConfigs(uint8_t slot, ChannelConfig* configs) {
+    if (slot == FRAM_SLOT_B) return readRecords<FramSectionId::CONFIG_B>(0, CHANNEL_COUNT, configs);
+    return readRecords<FramSectionId::CONFIG_A>(0, CHANNEL_COUNT, configs);
 }
 
-bool FramController::writeActiveConfig(uint8_t channel, const ChannelConfig* config) {
-    if (channel >= CHANNEL_COUNT) return false;
-    
-    uint16_t addr = FRAM_ADDR_ACTIVE_CH(channel);
-    return writeBytes(addr, config, sizeof(ChannelConfig));
+bool FramController::readDailyStates(uint8_t slot, ChannelDailyState* states) {
+    if (slot == FRAM_SLOT_B) return readRecords<FramSectionId::DAILY_STATE_B>(0, CHANNEL_COUNT, states);
+    return readRecords<FramSectionId::DAILY_STATE_A>(0, CHANNEL_COUNT, states);
+}
+
+bool FramController::readContainerVolumes(ContainerVolume* volumes) {
+    return readRecords<FramSectionId::CONTAINER_VOLUME>(0, CHANNEL_COUNT, volumes);
+}
+
+bool FramController::readDosedTrackers(DosedTracker* trackers) {
+    return readRecords<FramSectionId::DOSED_TRACKER>(0, CHANNEL_COUNT, trackers);
 }
 
 // ============================================================================
-// CHANNEL CONFIG (PENDING)
+// BULK SECTION WRITERS
 // ============================================================================
 
-bool FramController::readPendingConfig(uint8_t channel, ChannelConfig* config) {
+bool FramController::writeConfigs(uint8_t slot, const ChannelConfig* configs) {
+    if (slot == FRAM_SLOT_B) return writeRecords<FramSectionId::CONFIG_B>(0, CHANNEL_COUNT, configs);
+    return writeRecords<FramSectionId::CONFIG_A>(0, CHANNEL_COUNT, configs);
+}
+
+bool FramController::writeDailyStates(uint8_t slot, const ChannelDailyState* states) {
+    if (slot == FRAM_SLOT_B) return writeRecords<FramSectionId::DAILY_STATE_B>(0, CHANNEL_COUNT, states);
+    return writeRecords<FramSectionId::DAILY_STATE_A>(0, CHANNEL_COUNT, states);
+}
+
+bool FramController::writeContainerVolumes(const ContainerVolume* volumes) {
+    return writeRecords<FramSectionId::CONTAINER_VOLUME>(0, CHANNEL_COUNT, volumes);
+}
+
+bool FramController::writeDosedTrackers(const DosedTracker* trackers) {
+    return writeRecords<FramSectionId::DOSED_TRACKER>(0, CHANNEL_COUNT, trackers);
+}
+
+// ============================================================================
+// CHANNEL CONFIG (SLOTS A/B)
+// ============================================================================
+
+bool FramController::readConfig(uint8_t slot, uint8_t channel, ChannelConfig* config) {
     if (channel >= CHANNEL_COUNT) return false;
-    
-    uint16_t addr = FRAM_ADDR_PENDING_CH(channel);
-    return readBytes(addr, config, sizeof(ChannelConfig));
+
+    return readBytes(FRAM_ADDR_CONFIG_CH(slot, channel), config, sizeof(ChannelConfig));
 }
 
-bool FramController::writePendingConfig(uint8_t channel, const ChannelConfig* config) {
+bool FramController::writeConfig(uint8_t slot, uint8_t channel, const ChannelConfig* config) {
     if (channel >= CHANNEL_COUNT) return false;
-    
-    uint16_t addr = FRAM_ADDR_PENDING_CH(channel);
-    return writeBytes(addr, config, sizeof(ChannelConfig));
+
+    return writeBytes(FRAM_ADDR_CONFIG_CH(slot, channel), config, sizeof(ChannelConfig));
 }
 
 // ============================================================================
-// DAILY STATE
+// DAILY STATE (SLOTS A/B)
 // ============================================================================
 
-bool FramController::readDailyState(uint8_t channel, ChannelDailyState* state) {
+bool FramController::readDailyState(uint8_t slot, uint8_t channel, ChannelDailyState* state) {
     if (channel >= CHANNEL_COUNT) return false;
-    
-    uint16_t addr = FRAM_ADDR_DAILY_CH(channel);
-    return readBytes(addr, state, sizeof(ChannelDailyState));
+
+    return readBytes(FRAM_ADDR_DAILY_CH(slot, channel), state, sizeof(ChannelDailyState));
 }
 
-bool FramController::writeDailyState(uint8_t channel, const ChannelDailyState* state) {
+bool FramController::writeDailyState(uint8_t slot, uint8_t channel, const ChannelDailyState* state) {
     if (channel >= CHANNEL_COUNT) return false;
-    
-    uint16_t addr = FRAM_ADDR_DAILY_CH(channel);
-    return writeBytes(addr, state, sizeof(ChannelDailyState));
+
+    return writeBytes(FRAM_ADDR_DAILY_CH(slot, channel), state, sizeof(ChannelDailyState));
 }
 
 bool FramController::resetAllDailyStates() {
     ChannelDailyState emptyState;
     memset(&emptyState, 0, sizeof(emptyState));
-    emptyState.crc32 = calculateCRC32(&emptyState, sizeof(ChannelDailyState) - sizeof(uint32_t));
+    sealRecord<FramSectionId::DAILY_STATE_A>(&emptyState);
     
+    ChannelDailyState states[CHANNEL_COUNT];
     for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        if (!writeDailyState(i, &emptyState)) {
-            return false;
-        }
+        states[i] = emptyState;
     }
     
-    return true;
+    // Slot A holds the only valid copy - a stale B must not win on boot
+    if (!writeDailyStates(FRAM_SLOT_A, states)) return false;
+    return clearArea(FRAM_ADDR_DAILY_STATE_B, FRAM_SIZE_DAILY_STATE);
 }
 
 // ============================================================================
-// SYSTEM STATE
+// SYSTEM STATE (SLOTS A/B)
 // ============================================================================
 
-bool FramController::readSystemState(SystemState* state) {
-    return readBytes(FRAM_ADDR_SYSTEM_STATE, state, sizeof(SystemState));
+bool FramController::readSystemState(uint8_t slot, SystemState* state) {
+    return readBytes(FRAM_ADDR_SYSTEM_STATE_SLOT(slot), state, sizeof(SystemState));
 }
 
-bool FramController::writeSystemState(const SystemState* state) {
-    return writeBytes(FRAM_ADDR_SYSTEM_STATE, state, sizeof(SystemState));
+bool FramController::writeSystemState(uint8_t slot, const SystemState* state) {
+    return writeBytes(FRAM_ADDR_SYSTEM_STATE_SLOT(slot), state, sizeof(SystemState));
 }
 
 // // ============================================================================
@@ -428,10 +603,294 @@ bool FramController::factoryReset() {
     return _initializeEmpty();
 }
 
+// ============================================================================
+// SECTION STATISTICS
+// ============================================================================
+
+uint8_t FramController::sectionAt(uint16_t address) {
+    // Sections are sorted by address - last one starting at or before it
+    uint8_t lo = 0;
+    uint8_t hi = FRAM_SECTION_COUNT - 1;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi + 1) / 2;
+        if (FRAM_SECTION_INFO[mid].address <= address) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+uint8_t FramController::latencyBucket(uint32_t us) {
+    uint8_t bucket = 0;
+    uint32_t limit = 32;
+    while (us >= limit && bucket < FRAM_LATENCY_BUCKETS - 1) {
+        limit <<= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+uint32_t FramController::latencyBucketLimit(uint8_t bucket) {
+    if (bucket >= FRAM_LATENCY_BUCKETS - 1) return 0;
+    return 32UL << bucket;
+}
+
+void FramController::_recordOp(uint16_t address, size_t length, bool write, bool ok,
+                               uint8_t retries, uint32_t us) {
+    FramSectionStats& st = _sectionStats[sectionAt(address)];
+    
+    if (write) {
+        st.writes++;
+        if (ok) st.bytes_written += length;
+        st.write_hist[latencyBucket(us)]++;
+    } else {
+        st.reads++;
+        if (ok) st.bytes_read += length;
+        st.read_hist[latencyBucket(us)]++;
+    }
+    
+    if (!ok) st.failures++;
+    st.retries += retries;
+    st.total_us += us;
+    if (us > st.max_us) st.max_us = us;
+    
+    if (retries > 0) {
+        Serial.printf("[FRAM] %s 0x%04X (%u B) %s after %d retries\n",
+                      write ? "Write" : "Read", address, (unsigned)length,
+                      ok ? "recovered" : "FAILED", retries);
+    }
+}
+
+bool FramController::getSectionStats(uint8_t section, FramSectionStats* stats) {
+    if (section >= FRAM_SECTION_COUNT) return false;
+    
+    // Counters are updated under the bus lock
+    if (!lockBus()) return false;
+    *stats = _sectionStats[section];
+    unlockBus();
+    return true;
+}
+
+void FramController::resetSectionStats() {
+    if (!lockBus()) return;
+    memset(_sectionStats, 0, sizeof(_sectionStats));
+    unlockBus();
+}
+
+void FramController::printSectionStats() {
+    Serial.println(F("[FRAM] Section I/O stats:"));
+    Serial.println(F("  Section              Reads  Writes   B read  B written  Fail  Retry   Avg us   Max us"));
+    
+    FramSectionStats total;
+    memset(&total, 0, sizeof(total));
+    
+    for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+        FramSectionStats st;
+        if (!getSectionStats(i, &st)) return;
+        
+        // Mirror-only sections have no bus time to show
+        total.mirror_reads += st.mirror_reads;
+        uint32_t ops = st.reads + st.writes;
+        if (ops == 0) continue;
+        
+        Serial.printf("  %-17s  %7lu %7lu %8lu %10lu %5lu %6lu %8lu %8lu\n",
+                      FRAM_SECTION_INFO[i].name,
+                      (unsigned long)st.reads, (unsigned long)st.writes,
+                      (unsigned long)st.bytes_read, (unsigned long)st.bytes_written,
+                      (unsigned long)st.failures, (unsigned long)st.retries,
+                      (unsigned long)(st.total_us / ops), (unsigned long)st.max_us);
+        
+        total.reads += st.reads;
+        total.writes += st.writes;
+        total.total_us += st.total_us;
+        for (uint8_t b = 0; b < FRAM_LATENCY_BUCKETS; b++) {
+            total.read_hist[b] += st.read_hist[b];
+            total.write_hist[b] += st.write_hist[b];
+        }
+    }
+    
+    Serial.printf("  Total: %lu reads, %lu writes, %lu ms on the bus, %lu reads from mirror\n",
+                  (unsigned long)total.reads, (unsigned long)total.writes,
+                  (unsigned long)(total.total_us / 1000), (unsigned long)total.mirror_reads);
+    
+    Serial.println(F("  Latency        Reads    Writes"));
+    for (uint8_t b = 0; b < FRAM_LATENCY_BUCKETS; b++) {
+        uint32_t limit = latencyBucketLimit(b);
+        if (limit) {
+            Serial.printf("  < %6lu us  %7lu   %7lu\n", (unsigned long)limit,
+                          (unsigned long)total.read_hist[b], (unsigned long)total.write_hist[b]);
+        } else {
+            Serial.printf("  >=%6lu us  %7lu   %7lu\n", (unsigned long)latencyBucketLimit(b - 1),
+                          (unsigned long)total.read_hist[b], (unsigned long)total.write_hist[b]);
+        }
+    }
+}
+
+// ============================================================================
+// PSRAM MIRROR
+// ============================================================================
+
+void FramController::_loadMirror() {
+#if FRAM_MIRROR_ENABLED
+    FramBusGuard guard(*this);
+    if (!guard.ok()) return;
+    
+    _mirrorActive = false;
+    
+    // Allocated once - begin() may be called again on I2C recovery
+    if (_mirror == nullptr && psramFound()) {
+        _mirror = (uint8_t*)ps_malloc(FRAM_SIZE_BYTES);
+    }
+    if (_mirror == nullptr) {
+        Serial.println(F("[FRAM] Mirror: no PSRAM, reads go over I2C"));
+        return;
+    }
+    
+    // One sequential read of the whole chip
+    uint32_t startUs = micros();
+    if (!_readBus(0, _mirror, FRAM_SIZE_BYTES)) {
+        Serial.println(F("[FRAM] Mirror: load FAILED, reads go over I2C"));
+        return;
+    }
+    
+    memset(_mirrorDirty, 0, sizeof(_mirrorDirty));
+    _mirrorStats.dirty_pages = 0;
+    _mirrorStats.load_us = micros() - startUs;
+    _mirrorActive = true;
+    
+    Serial.printf("[FRAM] Mirror: %u B loaded into PSRAM in %lu ms\n",
+                  (unsigned)FRAM_SIZE_BYTES, (unsigned long)(_mirrorStats.load_us / 1000));
+#endif
+}
+
+bool FramController::_mirrorClean(uint16_t address, size_t length) const {
+    if (!_mirrorActive) return false;
+    if (_mirrorStats.dirty_pages == 0) return true;
+    
+    uint16_t last = FRAM_MIRROR_PAGE(address + length - 1);
+    for (uint16_t p = FRAM_MIRROR_PAGE(address); p <= last; p++) {
+        if (_mirrorDirty[p / 32] & (1UL << (p % 32))) return false;
+    }
+    return true;
+}
+
+void FramController::_setMirrorDirty(uint16_t address, size_t length, bool dirty) {
+    if (length == 0) return;
+    
+    uint16_t first = FRAM_MIRROR_PAGE(address);
+    uint16_t last = FRAM_MIRROR_PAGE(address + length - 1);
+    
+    if (!dirty) {
+        // Only pages the range covers completely are known to match
+        if (address % FRAM_MIRROR_PAGE_SIZE) first++;
+        if ((address + length) % FRAM_MIRROR_PAGE_SIZE) {
+            if (last == 0) return;
+            last--;
+        }
+        if (_mirrorStats.dirty_pages == 0) return;
+    }
+    
+    for (uint16_t p = first; p <= last && p < FRAM_MIRROR_PAGES; p++) {
+        uint32_t bit = 1UL << (p % 32);
+        bool wasDirty = (_mirrorDirty[p / 32] & bit) != 0;
+        if (dirty && !wasDirty) {
+            _mirrorDirty[p / 32] |= bit;
+            _mirrorStats.dirty_pages++;
+        } else if (!dirty && wasDirty) {
+            _mirrorDirty[p / 32] &= ~bit;
+            _mirrorStats.dirty_pages--;
+        }
+    }
+}
+
+uint16_t FramController::checkMirror(uint16_t firstPage, uint16_t pageCount) {
+    if (!_mirrorActive || firstPage >= FRAM_MIRROR_PAGES) return 0;
+    if (pageCount > FRAM_MIRROR_PAGES - firstPage) {
+        pageCount = FRAM_MIRROR_PAGES - firstPage;
+    }
+    
+    uint8_t page[FRAM_MIRROR_PAGE_SIZE];
+    uint16_t divergent = 0;
+    
+    for (uint16_t p = firstPage; p < firstPage + pageCount; p++) {
+        // Per page, so queued writes are not held off for the whole pass
+        FramBusGuard guard(*this);
+        if (!guard.ok()) return divergent;
+        
+        uint16_t address = p * FRAM_MIRROR_PAGE_SIZE;
+        if (!_readBus(address, page, sizeof(page))) continue;   // Stays as it was
+        
+        _mirrorStats.pages_checked++;
+        bool wasDirty = (_mirrorDirty[p / 32] & (1UL << (p % 32))) != 0;
+        
+        if (memcmp(page, _mirror + address, sizeof(page)) != 0) {
+            // The chip is authoritative
+            memcpy(_mirror + address, page, sizeof(page));
+            divergent++;
+            _mirrorStats.divergent_pages++;
+            Serial.printf("[FRAM] Mirror diverged at 0x%04X (%s)%s\n", address,
+                          FRAM_SECTION_INFO[sectionAt(address)].name,
+                          wasDirty ? " after failed write" : "");
+        }
+        
+        _setMirrorDirty(address, sizeof(page), false);
+    }
+    
+    if (firstPage + pageCount == FRAM_MIRROR_PAGES) _mirrorStats.checks++;
+    return divergent;
+}
+
+bool FramController::getMirrorStats(FramMirrorStats* stats) {
+    if (!lockBus()) return false;
+    *stats = _mirrorStats;
+    stats->active = _mirrorActive;
+    unlockBus();
+    return true;
+}
+
+void FramController::printMirrorStatus() {
+    FramMirrorStats ms;
+    if (!getMirrorStats(&ms)) return;
+    
+    if (!ms.active) {
+        Serial.println(F("[FRAM] Mirror: inactive (all reads over I2C)"));
+        return;
+    }
+    
+    Serial.printf("[FRAM] Mirror: %u B in PSRAM, %u B pages, loaded in %lu ms\n",
+                  (unsigned)FRAM_SIZE_BYTES, (unsigned)FRAM_MIRROR_PAGE_SIZE,
+                  (unsigned long)(ms.load_us / 1000));
+    Serial.printf("  Reads from mirror: %lu (%lu B), over I2C: %lu B\n",
+                  (unsigned long)_stats.mirror_reads, (unsigned long)_stats.mirror_bytes,
+                  (unsigned long)_stats.bytes_read);
+    Serial.printf("  Dirty pages: %u, failed writes: %lu\n",
+                  ms.dirty_pages, (unsigned long)ms.write_failures);
+    Serial.printf("  Full checks: %lu, pages checked: %lu, divergent: %lu\n",
+                  (unsigned long)ms.checks, (unsigned long)ms.pages_checked,
+                  (unsigned long)ms.divergent_pages);
+}
+
 // ============================================================================
 // DEBUG
 // ============================================================================
 
+void FramController::printLayout() const {
+    Serial.println(F("[FRAM] Section table:"));
+    Serial.println(F("  Section            Address   Size    Record x Count   CRC"));
+    for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+        const FramSectionInfo& s = FRAM_SECTION_INFO[i];
+        Serial.printf("  %-17s  0x%04X  %6lu  %5u x %-5u    ",
+                      s.name, s.address, (unsigned long)s.size, s.recordSize, s.count);
+        if (s.crcOffset == FRAM_NO_CRC) {
+            Serial.println(F("-"));
+        } else {
+            Serial.printf("@%u/%u\n", s.crcOffset, s.crcSize * 8);
+        }
+    }
+}
+
 void FramController::dumpSection(uint16_t address, size_t length) {
     Serial.printf("[FRAM] Dump 0x%04X - 0x%04X:\n", address, address + length - 1);
     
@@ -474,27 +933,28 @@ void FramController::dumpSection(uint16_t address, size_t length) {
 
 bool FramController::readContainerVolume(uint8_t channel, ContainerVolume* volume) {
     if (channel >= CHANNEL_COUNT) return false;
-    
-    uint16_t addr = FRAM_ADDR_CONTAINER_CH(channel);
-    return readBytes(addr, volume, sizeof(ContainerVolume));
+
+    return readRecord<FramSectionId::CONTAINER_VOLUME>(channel, volume);
 }
 
 bool FramController::writeContainerVolume(uint8_t channel, const ContainerVolume* volume) {
     if (channel >= CHANNEL_COUNT) return false;
-    
-    uint16_t addr = FRAM_ADDR_CONTAINER_CH(channel);
-    return writeBytes(addr, volume, sizeof(ContainerVolume));
+
+    return writeRecord<FramSectionId::CONTAINER_VOLUME>(channel, volume);
 }
 
 bool FramController::initializeContainerVolumes() {
     ContainerVolume emptyVolume;
     emptyVolume.reset();
-    emptyVolume.crc32 = calculateCRC32(&emptyVolume, sizeof(ContainerVolume) - sizeof(uint32_t));
+    sealRecord<FramSectionId::CONTAINER_VOLUME>(&emptyVolume);
 
+    ContainerVolume volumes[CHANNEL_COUNT];
     for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        if (!writeContainerVolume(i, &emptyVolume)) {
-            return false;
-        }
+        volumes[i] = emptyVolume;
+    }
+
+    if (!writeContainerVolumes(volumes)) {
+        return false;
     }
 
     Serial.println(F("[FRAM] Container volumes initialized"));
@@ -508,15 +968,13 @@ bool FramController::initializeContainerVolumes() {
 bool FramController::readDosedTracker(uint8_t channel, DosedTracker* tracker) {
     if (channel >= CHANNEL_COUNT) return false;
 
-    uint16_t addr = FRAM_ADDR_DOSED_TRACKER_CH(channel);
-    return readBytes(addr, tracker, sizeof(DosedTracker));
+    return readRecord<FramSectionId::DOSED_TRACKER>(channel, tracker);
 }
 
 bool FramController::writeDosedTracker(uint8_t channel, const DosedTracker* tracker) {
     if (channel >= CHANNEL_COUNT) return false;
 
-    uint16_t addr = FRAM_ADDR_DOSED_TRACKER_CH(channel);
-    return writeBytes(addr, tracker, sizeof(DosedTracker));
+    return writeRecord<FramSectionId::DOSED_TRACKER>(channel, tracker);
 }
 
 bool FramController::resetDosedTracker(uint8_t channel) {
@@ -524,7 +982,7 @@ bool FramController::resetDosedTracker(uint8_t channel) {
 
     DosedTracker tracker;
     tracker.reset();
-    tracker.crc32 = calculateCRC32(&tracker, sizeof(DosedTracker) - sizeof(uint32_t));
+    sealRecord<FramSectionId::DOSED_TRACKER>(&tracker);
 
     return writeDosedTracker(channel, &tracker);
 }
@@ -532,12 +990,15 @@ bool FramController::resetDosedTracker(uint8_t channel) {
 bool FramController::initializeDosedTrackers() {
     DosedTracker emptyTracker;
     emptyTracker.reset();
-    emptyTracker.crc32 = calculateCRC32(&emptyTracker, sizeof(DosedTracker) - sizeof(uint32_t));
+    sealRecord<FramSectionId::DOSED_TRACKER>(&emptyTracker);
 
+    DosedTracker trackers[CHANNEL_COUNT];
     for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
-        if (!writeDosedTracker(i, &emptyTracker)) {
-            return false;
-        }
+        trackers[i] = emptyTracker;
+    }
+
+    if (!writeDosedTrackers(trackers)) {
+        return false;
     }
 
     Serial.println(F("[FRAM] Dosed trackers initialized"));
@@ -15,6 +15,84 @@
 #include "dosing_types.h"
 #include "fram_layout.h"
 
+// ============================================================================
+// I2C TRANSFER PARAMETERS
+// ============================================================================
+
+// Maksymalny transfer pojedynczej transakcji (bufor Wire)
+#ifdef I2C_BUFFER_LENGTH
+#define FRAM_I2C_READ_CHUNK     I2C_BUFFER_LENGTH
+#else
+#define FRAM_I2C_READ_CHUNK     32
+#endif
+
+// Zapis: bufor Wire minus 2 bajty adresu
+#define FRAM_I2C_WRITE_CHUNK    (FRAM_I2C_READ_CHUNK - 2)
+
+// ============================================================================
+// PSRAM MIRROR
+// ============================================================================
+
+// Strona lustra = jednostka śledzenia rozbieżności (bitmapa dirty)
+#define FRAM_MIRROR_PAGES       (FRAM_SIZE_BYTES / FRAM_MIRROR_PAGE_SIZE)
+#define FRAM_MIRROR_PAGE(addr)  ((uint16_t)((addr) / FRAM_MIRROR_PAGE_SIZE))
+
+static_assert(FRAM_SIZE_BYTES % FRAM_MIRROR_PAGE_SIZE == 0, "Mirror page must divide FRAM size!");
+static_assert(FRAM_MIRROR_PAGES % 32 == 0, "Dirty bitmap is stored in 32-bit words!");
+
+// ============================================================================
+// I/O STATISTICS
+// ============================================================================
+
+/**
+ * Liczniki ruchu I2C do FRAM (diagnostyka wydajności)
+ */
+struct FramIoStats {
+    uint32_t transactions;      // Transakcje I2C (faza adresu + każdy chunk)
+    uint32_t bytes_read;        // Bajty odczytane
+    uint32_t bytes_written;     // Bajty zapisane
+    uint32_t mirror_reads;      // Odczyty obsłużone z lustra PSRAM
+    uint32_t mirror_bytes;      // Bajty skopiowane z lustra
+};
+
+/**
+ * Stan lustra FRAM w PSRAM
+ */
+struct FramMirrorStats {
+    bool     active;            // Lustro załadowane, odczyty z PSRAM
+    uint16_t dirty_pages;       // Strony niezgodne / niepewne (odczyt przez I2C)
+    uint32_t load_us;           // Czas ładowania przy starcie
+    uint32_t checks;            // Pełne porównania z FRAM
+    uint32_t pages_checked;
+    uint32_t divergent_pages;   // Strony różne od FRAM (suma)
+    uint32_t write_failures;    // Nieudane zapisy - strony oznaczone dirty
+};
+
+// Ponowienia operacji po błędzie I2C (cała operacja od początku)
+#define FRAM_IO_MAX_RETRIES     2
+
+// Histogram czasu operacji: kubełek n = [16 << n, 32 << n) us,
+// pierwszy od 0, ostatni otwarty (>= 32 ms)
+#define FRAM_LATENCY_BUCKETS    12
+
+/**
+ * Statystyki operacji na sekcji FRAM (adres początkowy operacji)
+ * Czas liczony od przejęcia szyny, łącznie z ponowieniami.
+ */
+struct FramSectionStats {
+    uint32_t reads;                             // Operacje odczytu
+    uint32_t writes;                            // Operacje zapisu / wypełnienia
+    uint32_t bytes_read;
+    uint32_t bytes_written;
+    uint32_t mirror_reads;                      // Odczyty z lustra (bez szyny, poza czasem)
+    uint32_t failures;                          // Operacje nieudane po ponowieniach
+    uint32_t retries;                           // Ponowienia (także udane)
+    uint32_t max_us;                            // Najdłuższa operacja
+    uint64_t total_us;                          // Suma czasu operacji
+    uint32_t read_hist[FRAM_LATENCY_BUCKETS];
+    uint32_t write_hist[FRAM_LATENCY_BUCKETS];
+};
+
 // ============================================================================
 // FRAM CONTROLLER CLASS
 // ============================================================================
@@ -41,45 +119,155 @@ public:
     
     /**
      * Odczytaj bajty z FRAM
+     * Z lustra PSRAM, gdy aktywne i zakres nie obejmuje stron dirty.
+     * W przeciwnym razie jak readBytesDirect().
      */
     bool readBytes(uint16_t address, void* buffer, size_t length);
     
     /**
-     * Zapisz bajty do FRAM
+     * Odczytaj bajty z układu (zawsze przez I2C, z pominięciem lustra)
+     * Odczyt sekwencyjny: adres wysyłany raz, dalej chip sam inkrementuje
+     * wewnętrzny licznik adresu - kolejne chunki to "current address read".
+     */
+    bool readBytesDirect(uint16_t address, void* buffer, size_t length);
+    
+    /**
+     * Zapisz bajty do FRAM (write-through: po udanym zapisie także lustro)
      */
     bool writeBytes(uint16_t address, const void* data, size_t length);
     
+    /**
+     * Wypełnij obszar FRAM stałą wartością
+     * Bajty generowane wprost do bufora Wire - bez bufora w RAM.
+     */
+    bool fillArea(uint16_t address, uint8_t value, size_t length);
+    
     /**
      * Wyzeruj obszar FRAM
      */
     bool clearArea(uint16_t address, size_t length);
     
+    // --- Typowane rekordy sekcji (adres liczony w czasie kompilacji) ---
+    
+    /**
+     * Odczytaj rekord sekcji, np. readRecord<FramSectionId::CONFIG_A>(ch, &cfg)
+     */
+    template <FramSectionId Id>
+    bool readRecord(uint16_t index, typename FramSection<Id>::Record* record) {
+        if (index >= FramSection<Id>::count()) return false;
+        return readBytes(FramSection<Id>::recordAddress(index), record, sizeof(*record));
+    }
+    
+    template <FramSectionId Id>
+    bool writeRecord(uint16_t index, const typename FramSection<Id>::Record* record) {
+        if (index >= FramSection<Id>::count()) return false;
+        return writeBytes(FramSection<Id>::recordAddress(index), record, sizeof(*record));
+    }
+    
+    /**
+     * Odczytaj kolejne rekordy sekcji jedną transakcją
+     */
+    template <FramSectionId Id>
+    bool readRecords(uint16_t first, uint16_t count, typename FramSection<Id>::Record* records) {
+        if ((uint32_t)first + count > FramSection<Id>::count()) return false;
+        return readBytes(FramSection<Id>::recordAddress(first), records,
+                         count * sizeof(typename FramSection<Id>::Record));
+    }
+    
+    template <FramSectionId Id>
+    bool writeRecords(uint16_t first, uint16_t count, const typename FramSection<Id>::Record* records) {
+        if ((uint32_t)first + count > FramSection<Id>::count()) return false;
+        return writeBytes(FramSection<Id>::recordAddress(first), records,
+                          count * sizeof(typename FramSection<Id>::Record));
+    }
+    
+    /**
+     * CRC rekordu: wszystkie bajty poza polem CRC (pozycja z tablicy sekcji)
+     */
+    template <FramSectionId Id>
+    static uint32_t recordCRC(const typename FramSection<Id>::Record& record) {
+        static_assert(FramSection<Id>::hasCrc(), "Section has no CRC field");
+        return _recordCRC(&record, sizeof(record), FramSection<Id>::crcOffset(), FramSection<Id>::crcSize());
+    }
+    
+    /**
+     * Wpisz CRC do rekordu
+     */
+    template <FramSectionId Id>
+    static void sealRecord(typename FramSection<Id>::Record* record) {
+        static_assert(FramSection<Id>::hasCrc(), "Section has no CRC field");
+        _sealRecord(record, sizeof(*record), FramSection<Id>::crcOffset(), FramSection<Id>::crcSize());
+    }
+    
+    /**
+     * Sprawdź CRC rekordu (akceptuje też CRC liczone tylko z bajtów przed polem)
+     */
+    template <FramSectionId Id>
+    static bool verifyRecord(const typename FramSection<Id>::Record& record) {
+        static_assert(FramSection<Id>::hasCrc(), "Section has no CRC field");
+        return _verifyRecord(&record, sizeof(record), FramSection<Id>::crcOffset(), FramSection<Id>::crcSize());
+    }
+    
+    /**
+     * Sprawdź CRC rekordu sekcji znanej dopiero w czasie działania
+     * @param section Indeks w FRAM_SECTION_INFO (sekcja musi mieć pole CRC)
+     */
+    static bool verifySectionRecord(uint8_t section, const void* record);
+    
+    /**
+     * Nowsza ważna kopia z pary slotów A/B (wyższe seq, remis = A)
+     * @return FRAM_SLOT_A, FRAM_SLOT_B lub FRAM_SLOT_NONE gdy obie uszkodzone
+     */
+    template <FramSectionId Id>
+    static uint8_t newestSlot(const typename FramSection<Id>::Record& a,
+                              const typename FramSection<Id>::Record& b) {
+        bool validA = verifyRecord<Id>(a);
+        bool validB = verifyRecord<Id>(b);
+        if (!validA && !validB) return FRAM_SLOT_NONE;
+        if (validA && (!validB || a.seq >= b.seq)) return FRAM_SLOT_A;
+        return FRAM_SLOT_B;
+    }
+    
+    /**
+     * Wypisz tablicę sekcji (adresy, rozmiary, pola CRC)
+     */
+    void printLayout() const;
+    
     // --- Header ---
     
     bool readHeader(FramHeader* header);
     bool writeHeader(const FramHeader* header);
     bool validateHeader();
     
-    // --- Channel Config (Active) ---
+    // --- Bulk section loaders (CHANNEL_COUNT rekordów, jedna transakcja) ---
+    
+    bool readConfigs(uint8_t slot, ChannelConfig* configs);
+    bool readDailyStates(uint8_t slot, ChannelDailyState* states);
+    bool readContainerVolumes(ContainerVolume* volumes);
+    bool readDosedTrackers(DosedTracker* trackers);
     
-    bool readActiveConfig(uint8_t channel, ChannelConfig* config);
-    bool writeActiveConfig(uint8_t channel, const ChannelConfig* config);
+    // --- Bulk section writers ---
     
-    // --- Channel Config (Pending) ---
+    bool writeConfigs(uint8_t slot, const ChannelConfig* configs);
+    bool writeDailyStates(uint8_t slot, const ChannelDailyState* states);
+    bool writeContainerVolumes(const ContainerVolume* volumes);
+    bool writeDosedTrackers(const DosedTracker* trackers);
     
-    bool readPendingConfig(uint8_t channel, ChannelConfig* config);
-    bool writePendingConfig(uint8_t channel, const ChannelConfig* config);
+    // --- Channel Config (slot FRAM_SLOT_A / FRAM_SLOT_B) ---
     
-    // --- Daily State ---
+    bool readConfig(uint8_t slot, uint8_t channel, ChannelConfig* config);
+    bool writeConfig(uint8_t slot, uint8_t channel, const ChannelConfig* config);
     
-    bool readDailyState(uint8_t channel, ChannelDailyState* state);
-    bool writeDailyState(uint8_t channel, const ChannelDailyState* state);
+    // --- Daily State (slot A/B) ---
+    
+    bool readDailyState(uint8_t slot, uint8_t channel, ChannelDailyState* state);
+    bool writeDailyState(uint8_t slot, uint8_t channel, const ChannelDailyState* state);
     bool resetAllDailyStates();
     
-    // --- System State ---
+    // --- System State (slot A/B) ---
     
-    bool readSystemState(SystemState* state);
-    bool writeSystemState(const SystemState* state);
+    bool readSystemState(uint8_t slot, SystemState* state);
+    bool writeSystemState(uint8_t slot, const SystemState* state);
 
     // --- Container Volume ---
 
@@ -112,14 +300,122 @@ public:
      * Oblicz CRC32
      */
     static uint32_t calculateCRC32(const void* data, size_t length);
+    
+    /**
+     * Sprawdź zapisane CRC32 (akceptuje też sumy ze starej tablicy)
+     */
+    static bool verifyCRC32(const void* data, size_t length, uint32_t stored);
+    
+    // --- Statystyki I/O ---
+    
+    const FramIoStats& getIoStats() const { return _stats; }
+    void resetIoStats() { memset(&_stats, 0, sizeof(_stats)); }
+    
+    /**
+     * Spójna kopia statystyk sekcji (indeks jak w FRAM_SECTION_INFO)
+     */
+    bool getSectionStats(uint8_t section, FramSectionStats* stats);
+    void resetSectionStats();
+    
+    /**
+     * Tabela statystyk sekcji + histogramy do Serial
+     */
+    void printSectionStats();
+    
+    /**
+     * Sekcja zawierająca adres (bajty wyrównania należą do poprzedniej)
+     */
+    static uint8_t sectionAt(uint16_t address);
+    
+    /**
+     * Kubełek histogramu dla czasu / górna granica kubełka (0 = otwarty)
+     */
+    static uint8_t latencyBucket(uint32_t us);
+    static uint32_t latencyBucketLimit(uint8_t bucket);
+    
+    // --- Lustro PSRAM ---
+    
+    bool isMirrorActive() const { return _mirrorActive; }
+    
+    /**
+     * Porównaj strony lustra z układem, rozbieżne nadpisz danymi z FRAM
+     * Blokada szyny brana osobno dla każdej strony.
+     * @return liczba stron różnych od FRAM (strony dirty liczone tylko gdy różne)
+     */
+    uint16_t checkMirror(uint16_t firstPage = 0, uint16_t pageCount = FRAM_MIRROR_PAGES);
+    
+    /**
+     * Spójna kopia stanu lustra
+     */
+    bool getMirrorStats(FramMirrorStats* stats);
+    
+    void printMirrorStatus();
+    
+    // --- Wyłączny dostęp do FRAM ---
+    
+    /**
+     * Zablokuj FRAM dla bieżącego taska (rekurencyjnie).
+     * Operacje low-level blokują same; lock zewnętrzny potrzebny tylko
+     * gdy kilka operacji ma się wykonać bez przeplotu z taskiem I/O.
+     */
+    bool lockBus(uint32_t timeoutMs = FRAM_BUS_LOCK_TIMEOUT_MS);
+    void unlockBus();
+    
+    /**
+     * Zablokuj FRAM tylko jeśli wolna (zadania w tle - bez czekania i logu)
+     */
+    bool tryLockBus();
 
 private:
     bool _initialized;
+    FramIoStats _stats;
+    FramSectionStats _sectionStats[FRAM_SECTION_COUNT];
+    SemaphoreHandle_t _busMutex;
+    
+    uint8_t* _mirror;                               // FRAM_SIZE_BYTES w PSRAM (nullptr = brak)
+    bool     _mirrorActive;
+    uint32_t _mirrorDirty[FRAM_MIRROR_PAGES / 32];  // Bit = strona niezgodna z FRAM
+    FramMirrorStats _mirrorStats;
+    
+    /**
+     * Odczyt przez I2C z ponowieniami i statystyką (pod blokadą szyny)
+     */
+    bool _readBus(uint16_t address, uint8_t* buffer, size_t length);
+    
+    /**
+     * Zapis / wypełnienie przez I2C z ponowieniami i aktualizacją lustra
+     */
+    bool _writeBus(uint16_t address, const uint8_t* data, uint8_t fill, size_t length);
+    
+    /**
+     * Przydziel lustro (raz) i wczytaj całą FRAM jednym odczytem sekwencyjnym
+     */
+    void _loadMirror();
+    
+    bool _mirrorClean(uint16_t address, size_t length) const;
+    void _setMirrorDirty(uint16_t address, size_t length, bool dirty);
+    
+    /**
+     * Jedna próba transferu (wywołujący trzyma blokadę szyny)
+     * Zapis: data == nullptr wypełnia obszar wartością fill.
+     */
+    bool _readOnce(uint16_t address, uint8_t* buffer, size_t length);
+    bool _writeOnce(uint16_t address, const uint8_t* data, uint8_t fill, size_t length);
+    
+    /**
+     * Zapisz wynik operacji w statystykach sekcji (pod blokadą szyny)
+     */
+    void _recordOp(uint16_t address, size_t length, bool write, bool ok,
+                   uint8_t retries, uint32_t us);
     
     /**
      * Inicjalizuj FRAM z pustym headerem
      */
     bool _initializeEmpty();
+    
+    static uint32_t _recordCRC(const void* record, size_t size, uint16_t crcOffset, uint8_t crcSize);
+    static void _sealRecord(void* record, size_t size, uint16_t crcOffset, uint8_t crcSize);
+    static bool _verifyRecord(const void* record, size_t size, uint16_t crcOffset, uint8_t crcSize);
 };
 
 // ============================================================================
@@ -0,0 +1,345 @@
+/**
+ * DOZOWNIK - FRAM I/O Worker Implementation
+ */
+
+#include "fram_io_worker.h"
+
+// Global instance
+FramIoWorker framIoWorker;
+
+// Stats and outstanding counter are touched by producers and the I/O task
+static portMUX_TYPE _ioMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Largest runtime write (bulk section) must fit a single request
+static_assert(FRAM_IO_MAX_PAYLOAD >= CHANNEL_COUNT * sizeof(ChannelConfig),
+              "FRAM_IO_MAX_PAYLOAD too small for bulk config write");
+
+// ============================================================================
+// INITIALIZATION
+// ============================================================================
+
+bool FramIoWorker::begin() {
+    if (_running) return true;
+    
+    Serial.println(F("[FRAM_IO] Starting I/O task..."));
+    
+    _queueSafety = xQueueCreate(FRAM_IO_QUEUE_SAFETY, sizeof(FramIoRequest));
+    _queueNormal = xQueueCreate(FRAM_IO_QUEUE_NORMAL, sizeof(FramIoRequest));
+    
+    if (_queueSafety == nullptr || _queueNormal == nullptr) {
+        Serial.println(F("[FRAM_IO] ERROR: Queue allocation failed"));
+        return false;
+    }
+    
+    if (xTaskCreate(_taskEntry, "fram_io", FRAM_IO_TASK_STACK, this,
+                    FRAM_IO_TASK_PRIORITY, &_task) != pdPASS) {
+        Serial.println(F("[FRAM_IO] ERROR: Task creation failed"));
+        return false;
+    }
+    
+    _running = true;
+    Serial.printf("[FRAM_IO] Running (queues: safety=%d, normal=%d, payload=%dB)\n",
+                  FRAM_IO_QUEUE_SAFETY, FRAM_IO_QUEUE_NORMAL, FRAM_IO_MAX_PAYLOAD);
+    return true;
+}
+
+// ============================================================================
+// SUBMISSION
+// ============================================================================
+
+bool FramIoWorker::submitWrite(uint16_t address, const void* data, size_t length,
+                               FramIoPriority priority,
+                               FramIoCallback callback, void* context) {
+    if (length == 0 || data == nullptr) return false;
+    
+    FramIoRequest req;
+    req.op = FramIoOp::WRITE;
+    req.priority = priority;
+    req.address = address;
+    req.length = (uint16_t)length;
+    req.readBuffer = nullptr;
+    req.callback = callback;
+    req.context = context;
+    
+    if (length > FRAM_IO_MAX_PAYLOAD) {
+        // Oversized (init / maintenance paths) - no copy, run in caller context.
+        // Drain first: a queued write to the same area must not land after this one
+        if (!_drainForSync()) {
+            _timedOut(req, "drain");
+            return false;
+        }
+        bool ok = framController.writeBytes(address, data, length);
+        portENTER_CRITICAL(&_ioMux);
+        _stats.syncFallbacks++;
+        if (!ok) _stats.failed++;
+        portEXIT_CRITICAL(&_ioMux);
+        if (callback) callback(ok, context);
+        return ok;
+    }
+    
+    memcpy(req.data, data, length);
+    return _enqueue(req);
+}
+
+bool FramIoWorker::submitRead(uint16_t address, void* buffer, size_t length,
+                              FramIoCallback callback, void* context,
+                              FramIoPriority priority) {
+    if (length == 0 || buffer == nullptr) return false;
+    
+    FramIoRequest req;
+    req.op = FramIoOp::READ;
+    req.priority = priority;
+    req.address = address;
+    req.length = (uint16_t)length;
+    req.readBuffer = buffer;
+    req.callback = callback;
+    req.context = context;
+    
+    return _enqueue(req);
+}
+
+bool FramIoWorker::submitFlush(FramIoCallback callback, void* context) {
+    FramIoRequest req;
+    req.op = FramIoOp::FLUSH;
+    req.priority = FramIoPriority::NORMAL;
+    req.address = 0;
+    req.length = 0;
+    req.readBuffer = nullptr;
+    req.callback = callback;
+    req.context = context;
+    
+    return _enqueue(req);
+}
+
+bool FramIoWorker::flush(uint32_t timeoutMs) {
+    if (!_running) return true;
+    
+    // Called from a completion callback - waiting would deadlock the I/O task
+    if (xTaskGetCurrentTaskHandle() == _task) {
+        return _outstanding == 0;
+    }
+    
+    uint32_t start = millis();
+    while (_outstanding > 0) {
+        if (millis() - start >= timeoutMs) {
+            Serial.printf("[FRAM_IO] Flush timeout (%lu outstanding)\n", (unsigned long)_outstanding);
+            return false;
+        }
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+bool FramIoWorker::_drainForSync() {
+    if (!_running || xTaskGetCurrentTaskHandle() == _task) return true;
+    
+    // Writing before the queue is empty breaks FIFO order - on timeout the
+    // write is dropped (failed), never run early
+    uint32_t start = millis();
+    while (_outstanding > 0) {
+        if (millis() - start >= FRAM_IO_WAIT_MAX_MS) return false;
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+void FramIoWorker::_timedOut(const FramIoRequest& req, const char* what) {
+    portENTER_CRITICAL(&_ioMux);
+    _stats.timeouts++;
+    _stats.failed++;
+    portEXIT_CRITICAL(&_ioMux);
+    Serial.printf("[FRAM_IO] ERROR: %s timeout after %d ms, 0x%04X (%d B) failed\n",
+                  what, FRAM_IO_WAIT_MAX_MS, req.address, req.length);
+    if (req.callback) req.callback(false, req.context);
+}
+
+bool FramIoWorker::_enqueue(FramIoRequest& req) {
+    bool queued = false;
+    
+    if (_running) {
+        req.enqueuedUs = micros();
+        QueueHandle_t q = (req.priority == FramIoPriority::SAFETY) ? _queueSafety : _queueNormal;
+        
+        portENTER_CRITICAL(&_ioMux);
+        _outstanding++;
+        portEXIT_CRITICAL(&_ioMux);
+        
+        // Queue full: wait for room instead of running the request now - a
+        // synchronous write would overtake older queued writes (FIFO order is
+        // relied on by the journal, counters and A/B records).
+        // The I/O task itself cannot wait for its own queue (callback context).
+        // Bounded by FRAM_IO_WAIT_MAX_MS: a stalled I/O task fails the request
+        // instead of hanging the caller (web handler, loop()).
+        bool selfSubmit = (xTaskGetCurrentTaskHandle() == _task);
+        bool warned = false;
+        uint32_t start = millis();
+        while (!queued) {
+            if (xQueueSend(q, &req, selfSubmit ? 0 : pdMS_TO_TICKS(FRAM_IO_SUBMIT_TIMEOUT_MS)) == pdTRUE) {
+                queued = true;
+                break;
+            }
+            if (selfSubmit) break;
+            if (millis() - start >= FRAM_IO_WAIT_MAX_MS) {
+                portENTER_CRITICAL(&_ioMux);
+                _outstanding--;
+                portEXIT_CRITICAL(&_ioMux);
+                _timedOut(req, "queue");
+                return false;
+            }
+            if (!warned) {
+                warned = true;
+                portENTER_CRITICAL(&_ioMux);
+                _stats.fullWaits++;
+                portEXIT_CRITICAL(&_ioMux);
+                Serial.println(F("[FRAM_IO] WARNING: Queue full, waiting for room"));
+            }
+            xTaskNotifyGive(_task);
+        }
+        
+        if (queued) {
+            portENTER_CRITICAL(&_ioMux);
+            _stats.submitted++;
+            portEXIT_CRITICAL(&_ioMux);
+            _updateDepth();
+            xTaskNotifyGive(_task);
+        } else {
+            portENTER_CRITICAL(&_ioMux);
+            _outstanding--;
+            portEXIT_CRITICAL(&_ioMux);
+            Serial.println(F("[FRAM_IO] WARNING: Queue full in I/O task, executing synchronously"));
+        }
+    }
+    
+    if (queued) return true;
+    
+    // No task (early boot / start failure) - nothing queued to overtake,
+    // pay the I2C time in caller context
+    if (req.op == FramIoOp::FLUSH) {
+        bool drained = flush(FRAM_IO_SUBMIT_TIMEOUT_MS);
+        if (req.callback) req.callback(drained, req.context);
+        return drained;
+    }
+    
+    bool ok = _execute(req);
+    portENTER_CRITICAL(&_ioMux);
+    _stats.syncFallbacks++;
+    if (!ok) _stats.failed++;
+    portEXIT_CRITICAL(&_ioMux);
+    
+    if (req.callback) req.callback(ok, req.context);
+    return ok;
+}
+
+// ============================================================================
+// I/O TASK
+// ============================================================================
+
+void FramIoWorker::_taskEntry(void* arg) {
+    static_cast<FramIoWorker*>(arg)->_run();
+}
+
+void FramIoWorker::_run() {
+    FramIoRequest req;
+    
+    for (;;) {
+        // Sleep until a producer notifies (any number of submits -> one wakeup)
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        for (;;) {
+            // Safety queue always first - re-checked before every normal request
+            if (xQueueReceive(_queueSafety, &req, 0) != pdTRUE &&
+                xQueueReceive(_queueNormal, &req, 0) != pdTRUE) {
+                break;
+            }
+            
+            uint32_t startUs = micros();
+            uint32_t waitUs = startUs - req.enqueuedUs;
+            bool ok = (req.op == FramIoOp::FLUSH) ? true : _execute(req);
+            uint32_t serviceUs = micros() - startUs;
+            
+            portENTER_CRITICAL(&_ioMux);
+            _stats.completed++;
+            if (!ok) _stats.failed++;
+            _stats.lastServiceUs = serviceUs;
+            _stats.totalServiceUs += serviceUs;
+            if (serviceUs > _stats.maxServiceUs) _stats.maxServiceUs = serviceUs;
+            if (waitUs > _stats.maxWaitUs) _stats.maxWaitUs = waitUs;
+            portEXIT_CRITICAL(&_ioMux);
+            
+            _updateDepth();
+            
+            if (req.callback) req.callback(ok, req.context);
+            
+            // Decrement after the callback - flush() waiters see finished work
+            portENTER_CRITICAL(&_ioMux);
+            _outstanding--;
+            portEXIT_CRITICAL(&_ioMux);
+        }
+    }
+}
+
+bool FramIoWorker::_execute(const FramIoRequest& req) {
+    switch (req.op) {
+        case FramIoOp::READ:
+            return framController.readBytes(req.address, req.readBuffer, req.length);
+        case FramIoOp::WRITE:
+            return framController.writeBytes(req.address, req.data, req.length);
+        case FramIoOp::FLUSH:
+            return true;
+    }
+    return false;
+}
+
+void FramIoWorker::_updateDepth() {
+    uint8_t safety = (uint8_t)uxQueueMessagesWaiting(_queueSafety);
+    uint8_t normal = (uint8_t)uxQueueMessagesWaiting(_queueNormal);
+    
+    portENTER_CRITICAL(&_ioMux);
+    _stats.depthSafety = safety;
+    _stats.depthNormal = normal;
+    if (safety > _stats.maxDepthSafety) _stats.maxDepthSafety = safety;
+    if (normal > _stats.maxDepthNormal) _stats.maxDepthNormal = normal;
+    portEXIT_CRITICAL(&_ioMux);
+}
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+FramIoWorkerStats FramIoWorker::getStats() const {
+    FramIoWorkerStats copy;
+    portENTER_CRITICAL(&_ioMux);
+    copy = _stats;
+    portEXIT_CRITICAL(&_ioMux);
+    return copy;
+}
+
+void FramIoWorker::resetStats() {
+    portENTER_CRITICAL(&_ioMux);
+    uint8_t safety = _stats.depthSafety;
+    uint8_t normal = _stats.depthNormal;
+    memset(&_stats, 0, sizeof(_stats));
+    _stats.depthSafety = safety;
+    _stats.depthNormal = normal;
+    portEXIT_CRITICAL(&_ioMux);
+}
+
+void FramIoWorker::printStats() const {
+    FramIoWorkerStats s = getStats();
+    
+    Serial.println(F("\n=== FRAM I/O WORKER ==="));
+    Serial.printf("Task:          %s\n", _running ? "RUNNING" : "STOPPED (sync mode)");
+    Serial.printf("Queue depth:   safety %d/%d (max %d), normal %d/%d (max %d)\n",
+                  s.depthSafety, FRAM_IO_QUEUE_SAFETY, s.maxDepthSafety,
+                  s.depthNormal, FRAM_IO_QUEUE_NORMAL, s.maxDepthNormal);
+    Serial.printf("Outstanding:   %lu\n", (unsigned long)_outstanding);
+    Serial.printf("Requests:      submitted %lu, completed %lu, failed %lu, sync %lu, full waits %lu, timeouts %lu\n",
+                  (unsigned long)s.submitted, (unsigned long)s.completed,
+                  (unsigned long)s.failed, (unsigned long)s.syncFallbacks,
+                  (unsigned long)s.fullWaits, (unsigned long)s.timeouts);
+    Serial.printf("Service time:  last %lu us, max %lu us, avg %lu us\n",
+                  (unsigned long)s.lastServiceUs, (unsigned long)s.maxServiceUs,
+                  (unsigned long)(s.completed ? s.totalServiceUs / s.completed : 0));
+    Serial.printf("Queue wait:    max %lu us\n", (unsigned long)s.maxWaitUs);
+    Serial.println(F("=======================\n"));
+}
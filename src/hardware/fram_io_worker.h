@@ -0,0 +1,159 @@
+/**
+ * DOZOWNIK - FRAM I/O Worker
+ * 
+ * Dedykowany task FreeRTOS wykonujący operacje FRAM w tle.
+ * Żądania read/write/flush trafiają do dwóch ograniczonych kolejek:
+ * SAFETY (obsługiwana zawsze jako pierwsza) i NORMAL (konfiguracja, stan).
+ * Zakończenie sygnalizowane callbackiem wywoływanym w kontekście taska I/O.
+ * 
+ * Dane zapisu są kopiowane do żądania - wywołujący może od razu
+ * modyfikować swój bufor. Kolejność w obrębie jednej kolejki zachowana (FIFO).
+ */
+
+#ifndef FRAM_IO_WORKER_H
+#define FRAM_IO_WORKER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "fram_controller.h"
+
+// ============================================================================
+// REQUEST TYPES
+// ============================================================================
+
+enum class FramIoOp : uint8_t {
+    READ,               // Odczyt do bufora wywołującego
+    WRITE,              // Zapis (dane skopiowane do żądania)
+    FLUSH               // Znacznik - callback po obsłużeniu wcześniejszych żądań
+};
+
+enum class FramIoPriority : uint8_t {
+    SAFETY,             // Błędy krytyczne - wyprzedzają wszystko
+    NORMAL              // Konfiguracja, stan dzienny, SystemState
+};
+
+/**
+ * Callback zakończenia (kontekst taska I/O - musi być krótki!)
+ */
+typedef void (*FramIoCallback)(bool success, void* context);
+
+/**
+ * Żądanie w kolejce
+ */
+struct FramIoRequest {
+    FramIoOp       op;
+    FramIoPriority priority;
+    uint16_t       address;
+    uint16_t       length;
+    void*          readBuffer;      // READ: bufor docelowy (własność wywołującego)
+    FramIoCallback callback;
+    void*          context;
+    uint32_t       enqueuedUs;      // micros() w chwili przyjęcia
+    uint8_t        data[FRAM_IO_MAX_PAYLOAD];
+};
+
+/**
+ * Statystyki kolejki (diagnostyka)
+ */
+struct FramIoWorkerStats {
+    uint32_t submitted;         // Przyjęte żądania
+    uint32_t completed;         // Obsłużone żądania
+    uint32_t failed;            // Żądania zakończone błędem I2C
+    uint32_t syncFallbacks;     // Wykonane synchronicznie (brak taska / dane > FRAM_IO_MAX_PAYLOAD)
+    uint32_t fullWaits;         // Zgłoszenia czekające na miejsce w pełnej kolejce
+    uint32_t timeouts;          // Odrzucone po FRAM_IO_WAIT_MAX_MS (task I/O stoi)
+    uint8_t  depthSafety;       // Aktualna głębokość kolejek
+    uint8_t  depthNormal;
+    uint8_t  maxDepthSafety;    // Maksymalna zaobserwowana głębokość
+    uint8_t  maxDepthNormal;
+    uint32_t lastServiceUs;     // Czas wykonania ostatniego żądania
+    uint32_t maxServiceUs;
+    uint32_t totalServiceUs;
+    uint32_t maxWaitUs;         // Najdłuższy czas oczekiwania w kolejce
+};
+
+// ============================================================================
+// FRAM I/O WORKER CLASS
+// ============================================================================
+
+class FramIoWorker {
+public:
+    /**
+     * Utwórz kolejki i task I/O (po framController.begin())
+     * @return true jeśli task uruchomiony
+     */
+    bool begin();
+    
+    /**
+     * Czy task I/O działa
+     */
+    bool isRunning() const { return _running; }
+    
+    /**
+     * Zleć zapis (dane kopiowane do żądania).
+     * Przy pełnej kolejce czeka na miejsce (kolejność FIFO zachowana).
+     * Bez działającego taska lub dla danych dłuższych niż FRAM_IO_MAX_PAYLOAD
+     * zapis wykonywany synchronicznie - po opróżnieniu kolejki.
+     * Oba oczekiwania trwają najwyżej FRAM_IO_WAIT_MAX_MS - potem callback(false).
+     * @return true jeśli przyjęte (lub wykonane synchronicznie z sukcesem)
+     */
+    bool submitWrite(uint16_t address, const void* data, size_t length,
+                     FramIoPriority priority = FramIoPriority::NORMAL,
+                     FramIoCallback callback = nullptr, void* context = nullptr);
+    
+    /**
+     * Zleć odczyt do bufora wywołującego (musi żyć do wywołania callbacku)
+     */
+    bool submitRead(uint16_t address, void* buffer, size_t length,
+                    FramIoCallback callback, void* context = nullptr,
+                    FramIoPriority priority = FramIoPriority::NORMAL);
+    
+    /**
+     * Zleć znacznik flush - callback po obsłużeniu wszystkich wcześniejszych żądań
+     */
+    bool submitFlush(FramIoCallback callback, void* context = nullptr);
+    
+    /**
+     * Czekaj aż kolejki się opróżnią (blokujące, z timeoutem)
+     * @return true jeśli wszystkie żądania obsłużone
+     */
+    bool flush(uint32_t timeoutMs);
+    
+    /**
+     * Statystyki (kopia)
+     */
+    FramIoWorkerStats getStats() const;
+    
+    void resetStats();
+    
+    /**
+     * Debug print
+     */
+    void printStats() const;
+
+private:
+    bool          _running;
+    QueueHandle_t _queueSafety;
+    QueueHandle_t _queueNormal;
+    TaskHandle_t  _task;
+    
+    volatile uint32_t _outstanding;     // Przyjęte, jeszcze nie obsłużone
+    FramIoWorkerStats _stats;
+    
+    static void _taskEntry(void* arg);
+    void _run();
+    
+    bool _enqueue(FramIoRequest& req);
+    void _timedOut(const FramIoRequest& req, const char* what);
+    bool _drainForSync();               // Czekaj na pustą kolejkę przed zapisem synchronicznym
+    bool _execute(const FramIoRequest& req);
+    void _updateDepth();
+};
+
+// ============================================================================
+// GLOBAL INSTANCE
+// ============================================================================
+
+extern FramIoWorker framIoWorker;
+
+#endif // FRAM_IO_WORKER_H
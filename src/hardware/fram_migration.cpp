@@ -0,0 +1,377 @@
+/**
+ * DOZOWNIK - FRAM Layout Migration Implementation
+ */
+
+#include "fram_migration.h"
+#include "../crypto/crc32.h"
+#include <stddef.h>
+
+// Global instance
+FramMigration framMigration;
+
+// Copy buffer for backup / CRC passes (stack, boot-time only)
+#define MIGRATION_COPY_CHUNK    64
+
+// ============================================================================
+// OLD LAYOUTS
+// ============================================================================
+// Addresses are frozen per version - steps must not follow later changes
+// of fram_layout.h.
+//
+// v6: as v7, but 0x0760.. was still FREE_SPACE (no DosedTracker)
+// v7: single copies of system state, active/pending config and daily state
+// v8: A/B slots (seq) for system state, channel config and daily state
+// v9: lifetime counters (base A/B + delta log) at the start of former RESERVED
+
+#define V7_ADDR_SYSTEM_STATE        0x0420
+#define V7_ADDR_ACTIVE_CONFIG       0x0440
+#define V7_ADDR_PENDING_CONFIG      0x0500
+#define V7_ADDR_DAILY_STATE         0x05C0
+#define V7_ADDR_DOSED_TRACKER       0x0760
+
+#define V8_ADDR_SYSTEM_STATE_B      0x6C60
+#define V8_ADDR_DAILY_STATE_B       0x6C80
+
+#define V9_ADDR_COUNTERS            0x6D10
+#define V9_SIZE_COUNTERS            0x02E0      // Base A/B, log up to 0x6FF0
+
+#define V7_SIZE_CONFIG              (FRAM_MAX_CHANNELS * sizeof(ChannelConfig))
+#define V7_SIZE_DAILY_STATE         (FRAM_MAX_CHANNELS * sizeof(ChannelDailyState))
+
+// ============================================================================
+// STEPS
+// ============================================================================
+
+// v6 -> v7: DosedTracker section in former free space
+static bool _migrateV6(FramMigration& m) {
+    DosedTracker tracker;
+    memset(&tracker, 0, sizeof(tracker));
+    FramController::sealRecord<FramSectionId::DOSED_TRACKER>(&tracker);
+
+    for (uint8_t i = 0; i < FRAM_MAX_CHANNELS; i++) {
+        if (!m.write(V7_ADDR_DOSED_TRACKER + i * sizeof(DosedTracker), &tracker, sizeof(tracker))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// v7 -> v8: seal single copies as generation 1 of their A/B slot pair
+static bool _migrateV7(FramMigration& m) {
+    for (uint8_t i = 0; i < FRAM_MAX_CHANNELS; i++) {
+        ChannelConfig active, pending;
+        if (!m.readSource(V7_ADDR_ACTIVE_CONFIG + i * sizeof(ChannelConfig), &active, sizeof(active)) ||
+            !m.readSource(V7_ADDR_PENDING_CONFIG + i * sizeof(ChannelConfig), &pending, sizeof(pending))) {
+            return false;
+        }
+
+        // Slot A = active; slot B = staged edit, or an older copy of active
+        active.has_pending = 0;
+        active.seq = 1;
+        memset(active._padding, 0, sizeof(active._padding));
+
+        if (pending.has_pending) {
+            pending.has_pending = 1;
+            pending.seq = 2;
+            memset(pending._padding, 0, sizeof(pending._padding));
+        } else {
+            pending = active;
+            pending.seq = 0;
+        }
+
+        FramController::sealRecord<FramSectionId::CONFIG_A>(&active);
+        FramController::sealRecord<FramSectionId::CONFIG_B>(&pending);
+
+        if (!m.write(V7_ADDR_ACTIVE_CONFIG + i * sizeof(ChannelConfig), &active, sizeof(active)) ||
+            !m.write(V7_ADDR_PENDING_CONFIG + i * sizeof(ChannelConfig), &pending, sizeof(pending))) {
+            return false;
+        }
+    }
+
+    for (uint8_t i = 0; i < FRAM_MAX_CHANNELS; i++) {
+        ChannelDailyState daily;
+        uint16_t address = V7_ADDR_DAILY_STATE + i * sizeof(ChannelDailyState);
+        if (!m.readSource(address, &daily, sizeof(daily))) return false;
+
+        daily.seq = 1;
+        FramController::sealRecord<FramSectionId::DAILY_STATE_A>(&daily);
+        if (!m.write(address, &daily, sizeof(daily))) return false;
+    }
+
+    SystemState state;
+    if (!m.readSource(V7_ADDR_SYSTEM_STATE, &state, sizeof(state))) return false;
+
+    state.system_enabled = state.system_enabled ? 1 : 0;
+    state.system_halted = state.system_halted ? 1 : 0;
+    if (state.active_channel >= CHANNEL_COUNT) state.active_channel = 255;
+    state.seq = 1;
+    memset(state._padding, 0, sizeof(state._padding));
+    FramController::sealRecord<FramSectionId::SYSTEM_STATE_A>(&state);
+    if (!m.write(V7_ADDR_SYSTEM_STATE, &state, sizeof(state))) return false;
+
+    // Slot B was RESERVED in v7 (CLI scratch) - must not win on boot
+    return m.clear(V8_ADDR_SYSTEM_STATE_B, sizeof(SystemState)) &&
+           m.clear(V8_ADDR_DAILY_STATE_B, V7_SIZE_DAILY_STATE);
+}
+
+// v8 -> v9: counter sections were RESERVED (CLI scratch) - start empty
+static bool _migrateV8(FramMigration& m) {
+    return m.clear(V9_ADDR_COUNTERS, V9_SIZE_COUNTERS);
+}
+
+static const FramMigrationRange V7_BACKUP[] = {
+    { V7_ADDR_SYSTEM_STATE,   sizeof(SystemState) },
+    { V7_ADDR_ACTIVE_CONFIG,  V7_SIZE_CONFIG },
+    { V7_ADDR_PENDING_CONFIG, V7_SIZE_CONFIG },
+    { V7_ADDR_DAILY_STATE,    V7_SIZE_DAILY_STATE }
+};
+
+static_assert(sizeof(SystemState) + 2 * V7_SIZE_CONFIG + V7_SIZE_DAILY_STATE <= FRAM_SIZE_MIGRATION_BACKUP,
+              "v7 backup does not fit the migration scratch area!");
+
+#define MIGRATION_RANGES(r)     r, sizeof(r) / sizeof(r[0])
+
+static const FramMigrationStep STEPS[] = {
+    { 6, "DosedTracker section",            nullptr, 0,                   _migrateV6 },
+    { 7, "A/B slots for config/daily/state", MIGRATION_RANGES(V7_BACKUP), _migrateV7 },
+    { 8, "Lifetime counter sections",       nullptr, 0,                   _migrateV8 },
+};
+
+#define STEP_COUNT  (sizeof(STEPS) / sizeof(STEPS[0]))
+
+static_assert(V9_ADDR_COUNTERS + V9_SIZE_COUNTERS == FRAM_SECTION_END(COUNTER_LOG),
+              "v9 counter sections changed - frozen migration addresses!");
+static_assert(FRAM_LAYOUT_VERSION == 9, "New layout version needs a migration step!");
+
+// ============================================================================
+// ENGINE
+// ============================================================================
+
+const FramMigrationStep* FramMigration::_findStep(uint16_t from) {
+    for (uint8_t i = 0; i < STEP_COUNT; i++) {
+        if (STEPS[i].from == from) return &STEPS[i];
+    }
+    return nullptr;
+}
+
+bool FramMigration::canMigrate(uint16_t version) {
+    while (version < FRAM_LAYOUT_VERSION) {
+        if (!_findStep(version)) return false;
+        version++;
+    }
+    return version == FRAM_LAYOUT_VERSION;
+}
+
+bool FramMigration::run() {
+    FramHeader header;
+    if (!framController.readHeader(&header)) return false;
+
+    if (header.magic != FRAM_MAGIC_NUMBER) return false;
+    if (!FramController::verifyRecord<FramSectionId::HEADER>(header) && !_repairHeader(&header)) {
+        return false;
+    }
+
+    if (header.layout_version == FRAM_LAYOUT_VERSION) return true;
+
+    if (header.layout_version < FRAM_MIGRATION_MIN_VERSION || !canMigrate(header.layout_version)) {
+        Serial.printf("[MIGRATE] No migration path v%d -> v%d\n",
+                      header.layout_version, FRAM_LAYOUT_VERSION);
+        return false;
+    }
+
+    Serial.printf("[MIGRATE] Layout v%d -> v%d\n", header.layout_version, FRAM_LAYOUT_VERSION);
+    uint32_t startMs = millis();
+
+    while (header.layout_version < FRAM_LAYOUT_VERSION) {
+        const FramMigrationStep* step = _findStep(header.layout_version);
+        if (!_runStep(*step)) {
+            Serial.printf("[MIGRATE] ERROR: step v%d failed\n", step->from);
+            return false;
+        }
+
+        // Step done - only now the image claims the new version
+        header.layout_version = step->from + 1;
+        FramController::sealRecord<FramSectionId::HEADER>(&header);
+        if (!framController.writeHeader(&header)) return false;
+
+        // State record is only trusted for from == header version, so a
+        // stale APPLY after this point is harmless; clear it anyway
+        _writeState(*step, MIGRATION_PHASE_IDLE, 0, 0);
+    }
+
+    Serial.printf("[MIGRATE] Done in %lu ms\n", millis() - startMs);
+    return true;
+}
+
+bool FramMigration::_repairHeader(FramHeader* header) {
+    // Power lost while a finished step rewrote the header: only layout_version
+    // and the CRC differ between the old and the new copy, so a torn header
+    // is the old one with the step's from version. The step runs again from
+    // its backup - the state record still says APPLY.
+    FramMigrationState state;
+    if (!_readState(&state) || state.phase != MIGRATION_PHASE_APPLY) return false;
+    if (header->layout_version != state.from_version &&
+        header->layout_version != state.to_version) {
+        return false;
+    }
+    if (state.from_version < FRAM_MIGRATION_MIN_VERSION || !canMigrate(state.from_version)) {
+        return false;
+    }
+
+    Serial.printf("[MIGRATE] Header torn during v%d -> v%d, restoring v%d\n",
+                  state.from_version, state.to_version, state.from_version);
+    header->layout_version = state.from_version;
+    FramController::sealRecord<FramSectionId::HEADER>(header);
+    return framController.writeHeader(header);
+}
+
+bool FramMigration::_runStep(const FramMigrationStep& step) {
+    FramMigrationState state;
+    bool resume = _readState(&state) &&
+                  state.phase == MIGRATION_PHASE_APPLY &&
+                  state.from_version == step.from &&
+                  _backupValid(state);
+
+    if (resume) {
+        // Interrupted apply: live data may be half written, backup is intact
+        Serial.printf("[MIGRATE] Resuming v%d -> v%d (%s)\n", step.from, step.from + 1, step.name);
+    } else {
+        Serial.printf("[MIGRATE] v%d -> v%d: %s\n", step.from, step.from + 1, step.name);
+
+        // Live data is untouched until the state says APPLY
+        uint32_t length = 0;
+        uint32_t crc = 0;
+        if (!_writeState(step, MIGRATION_PHASE_BACKUP, 0, 0)) return false;
+        if (!_backup(step, &length, &crc)) return false;
+        if (!_writeState(step, MIGRATION_PHASE_APPLY, length, crc)) return false;
+    }
+
+    _step = &step;
+    bool ok = step.apply(*this);
+    _step = nullptr;
+    return ok;
+}
+
+bool FramMigration::_backup(const FramMigrationStep& step, uint32_t* length, uint32_t* crc) {
+    uint8_t buf[MIGRATION_COPY_CHUNK];
+    uint16_t dst = FRAM_ADDR_MIGRATION_BACKUP;
+    Crc32 sum;
+
+    for (uint8_t r = 0; r < step.backupCount; r++) {
+        uint16_t src = step.backup[r].address;
+        uint16_t remaining = step.backup[r].length;
+
+        while (remaining > 0) {
+            uint16_t chunk = remaining < sizeof(buf) ? remaining : sizeof(buf);
+            if (!framController.readBytes(src, buf, chunk)) return false;
+            if (!framController.writeBytes(dst, buf, chunk)) return false;
+            sum.update(buf, chunk);
+            src += chunk;
+            dst += chunk;
+            remaining -= chunk;
+        }
+    }
+
+    *length = dst - FRAM_ADDR_MIGRATION_BACKUP;
+    *crc = sum.value();
+    return true;
+}
+
+bool FramMigration::_backupValid(const FramMigrationState& state) {
+    if (state.backup_length > FRAM_SIZE_MIGRATION_BACKUP) return false;
+
+    uint8_t buf[MIGRATION_COPY_CHUNK];
+    uint16_t address = FRAM_ADDR_MIGRATION_BACKUP;
+    uint32_t remaining = state.backup_length;
+    Crc32 sum;
+
+    while (remaining > 0) {
+        uint16_t chunk = remaining < sizeof(buf) ? remaining : sizeof(buf);
+        if (!framController.readBytes(address, buf, chunk)) return false;
+        sum.update(buf, chunk);
+        address += chunk;
+        remaining -= chunk;
+    }
+
+    return sum.value() == state.backup_crc;
+}
+
+// ============================================================================
+// STEP API
+// ============================================================================
+
+bool FramMigration::readSource(uint16_t address, void* data, size_t length) {
+    if (_step) {
+        // Backed-up ranges lie back to back in the scratch area
+        uint16_t offset = 0;
+        for (uint8_t r = 0; r < _step->backupCount; r++) {
+            const FramMigrationRange& range = _step->backup[r];
+            if (address >= range.address && address + length <= (uint32_t)range.address + range.length) {
+                return framController.readBytes(FRAM_ADDR_MIGRATION_BACKUP + offset + (address - range.address),
+                                                data, length);
+            }
+            offset += range.length;
+        }
+    }
+    return framController.readBytes(address, data, length);
+}
+
+bool FramMigration::write(uint16_t address, const void* data, size_t length) {
+    return framController.writeBytes(address, data, length);
+}
+
+bool FramMigration::clear(uint16_t address, size_t length) {
+    return framController.clearArea(address, length);
+}
+
+// ============================================================================
+// STATE RECORD
+// ============================================================================
+
+bool FramMigration::_readState(FramMigrationState* state) {
+    if (!framController.readBytes(FRAM_ADDR_MIGRATION_STATE, state, sizeof(FramMigrationState))) {
+        return false;
+    }
+    if (state->magic != FRAM_MIGRATION_MAGIC) return false;
+    return Crc32::compute(state, offsetof(FramMigrationState, crc32)) == state->crc32;
+}
+
+bool FramMigration::_writeState(const FramMigrationStep& step, FramMigrationPhase phase,
+                                uint32_t length, uint32_t crc) {
+    FramMigrationState state;
+    memset(&state, 0, sizeof(state));
+    state.magic = FRAM_MIGRATION_MAGIC;
+    state.from_version = step.from;
+    state.to_version = step.from + 1;
+    state.phase = phase;
+    state.backup_length = length;
+    state.backup_crc = crc;
+    state.crc32 = Crc32::compute(&state, offsetof(FramMigrationState, crc32));
+
+    return framController.writeBytes(FRAM_ADDR_MIGRATION_STATE, &state, sizeof(state));
+}
+
+// ============================================================================
+// DEBUG
+// ============================================================================
+
+void FramMigration::printStatus() {
+    static const char* const PHASES[] = { "IDLE", "BACKUP", "APPLY" };
+
+    Serial.printf("[MIGRATE] Layout v%d, migrates from v%d:\n",
+                  FRAM_LAYOUT_VERSION, FRAM_MIGRATION_MIN_VERSION);
+    for (uint8_t i = 0; i < STEP_COUNT; i++) {
+        Serial.printf("  v%d -> v%d  %s (backup %d ranges)\n",
+                      STEPS[i].from, STEPS[i].from + 1, STEPS[i].name, STEPS[i].backupCount);
+    }
+
+    FramMigrationState state;
+    if (_readState(&state)) {
+        Serial.printf("  Last run: v%d -> v%d, phase %s, backup %lu B\n",
+                      state.from_version, state.to_version,
+                      PHASES[state.phase <= MIGRATION_PHASE_APPLY ? state.phase : 0],
+                      (unsigned long)state.backup_length);
+    } else {
+        Serial.println(F("  Last run: none"));
+    }
+}
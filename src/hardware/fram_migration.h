@@ -0,0 +1,147 @@
+/**
+ * DOZOWNIK - FRAM Layout Migration
+ *
+ * Zmiana FRAM_LAYOUT_VERSION nie formatuje już FRAM. Przy starcie obraz
+ * w starszej wersji przechodzi łańcuch kroków vN -> vN+1, każdy
+ * przekształca sekcje w miejscu. Kalibracja, harmonogramy i objętości
+ * zostają zachowane.
+ *
+ * Odporność na zanik zasilania: przed zmianą danych krok kopiuje
+ * przepisywane sekcje do obszaru roboczego na końcu FRAM i zapisuje
+ * rekord stanu (faza APPLY + CRC kopii). Krok czyta wyłącznie z kopii,
+ * więc przerwany krok jest po restarcie powtarzany od początku.
+ * Header z nową wersją zapisywany jest dopiero po zakończeniu kroku;
+ * header rozerwany w tym zapisie odtwarzany jest z rekordu stanu.
+ */
+
+#ifndef FRAM_MIGRATION_H
+#define FRAM_MIGRATION_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "fram_layout.h"
+#include "fram_controller.h"
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+#define FRAM_MIGRATION_MAGIC            0x5247494D  // "MIGR" in ASCII
+#define FRAM_MIGRATION_MIN_VERSION      6           // Starsze obrazy są formatowane
+
+// Stały adres na końcu FRAM - poza danymi każdej obsługiwanej wersji
+#define FRAM_MIGRATION_SCRATCH_SIZE     1024
+#define FRAM_ADDR_MIGRATION_STATE       (FRAM_SIZE_BYTES - FRAM_MIGRATION_SCRATCH_SIZE)
+#define FRAM_ADDR_MIGRATION_BACKUP      (FRAM_ADDR_MIGRATION_STATE + sizeof(FramMigrationState))
+#define FRAM_SIZE_MIGRATION_BACKUP      (FRAM_MIGRATION_SCRATCH_SIZE - sizeof(FramMigrationState))
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+enum FramMigrationPhase : uint8_t {
+    MIGRATION_PHASE_IDLE   = 0,     // Brak migracji w toku
+    MIGRATION_PHASE_BACKUP = 1,     // Kopia w trakcie - dane nietknięte
+    MIGRATION_PHASE_APPLY  = 2      // Kopia kompletna - krok można powtórzyć
+};
+
+#pragma pack(push, 1)
+
+/**
+ * Rekord stanu migracji (początek obszaru roboczego)
+ */
+struct FramMigrationState {
+    uint32_t magic;             // FRAM_MIGRATION_MAGIC
+    uint16_t from_version;      // Wersja przed krokiem
+    uint16_t to_version;        // Wersja po kroku
+    uint8_t  phase;             // FramMigrationPhase
+    uint8_t  _reserved[3];
+    uint32_t backup_length;     // Bajty kopii w obszarze roboczym
+    uint32_t backup_crc;        // CRC32 kopii
+    uint8_t  _reserved2[8];
+    uint32_t crc32;             // CRC32 rekordu (bez tego pola)
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(FramMigrationState) == 32, "FramMigrationState must be 32 bytes");
+static_assert(FRAM_ADDR_MIGRATION_STATE >= FRAM_ADDR_RESERVED,
+              "Migration scratch must stay inside RESERVED!");
+
+class FramMigration;
+
+/**
+ * Zakres adresów starego układu kopiowany przed krokiem
+ */
+struct FramMigrationRange {
+    uint16_t address;
+    uint16_t length;
+};
+
+/**
+ * Krok migracji from -> from + 1
+ */
+struct FramMigrationStep {
+    uint16_t                  from;
+    const char*               name;
+    const FramMigrationRange* backup;       // Sekcje czytane przez apply()
+    uint8_t                   backupCount;
+    bool (*apply)(FramMigration& migration);
+};
+
+// ============================================================================
+// FRAM MIGRATION CLASS
+// ============================================================================
+
+class FramMigration {
+public:
+    /**
+     * Doprowadź obraz do FRAM_LAYOUT_VERSION (wznawia przerwany krok)
+     * Wymaga poprawnego headera (magic + CRC) w obsługiwanej wersji
+     * albo headera rozerwanego przez zanik zasilania w trakcie migracji.
+     * @return true jeśli FRAM jest w bieżącej wersji
+     */
+    bool run();
+
+    /**
+     * Czy istnieje łańcuch kroków z danej wersji do bieżącej
+     */
+    static bool canMigrate(uint16_t version);
+
+    // --- API dla kroków ---
+
+    /**
+     * Odczyt danych starego układu - z kopii, jeśli zakres był kopiowany
+     */
+    bool readSource(uint16_t address, void* data, size_t length);
+
+    bool write(uint16_t address, const void* data, size_t length);
+    bool clear(uint16_t address, size_t length);
+
+    /**
+     * Debug: obsługiwane wersje i rekord stanu
+     */
+    void printStatus();
+
+private:
+    const FramMigrationStep* _step;     // Krok w toku (readSource)
+
+    static const FramMigrationStep* _findStep(uint16_t from);
+
+    bool _repairHeader(FramHeader* header);
+    bool _runStep(const FramMigrationStep& step);
+    bool _backup(const FramMigrationStep& step, uint32_t* length, uint32_t* crc);
+    bool _backupValid(const FramMigrationState& state);
+
+    bool _readState(FramMigrationState* state);
+    bool _writeState(const FramMigrationStep& step, FramMigrationPhase phase,
+                     uint32_t length, uint32_t crc);
+};
+
+// ============================================================================
+// GLOBAL INSTANCE
+// ============================================================================
+
+extern FramMigration framMigration;
+
+#endif // FRAM_MIGRATION_H
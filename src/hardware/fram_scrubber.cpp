@@ -0,0 +1,313 @@
+/**
+ * DOZOWNIK - FRAM Scrubber Implementation
+ */
+
+#include "fram_scrubber.h"
+#include "channel_manager.h"
+
+// Global instance
+FramScrubber framScrubber;
+
+// Every record with a CRC field must fit the on-stack record buffer
+#define FRAM_SCRUB_SIZE_CHECK(id, type, ...) \
+    static_assert(sizeof(type) <= FRAM_SCRUB_MAX_RECORD, "Section " #id " record too large for the scrubber!");
+#define FRAM_SCRUB_SIZE_SKIP(id, ...)
+
+FRAM_SECTIONS(FRAM_SCRUB_SIZE_CHECK, FRAM_SCRUB_SIZE_SKIP)
+
+// ============================================================================
+// INITIALIZATION
+// ============================================================================
+
+FramScrubber::FramScrubber()
+    : _phase(PHASE_IDLE), _section(0), _record(0), _page(0),
+      _passStartMs(0), _idleSinceMs(0), _passRequested(false), _passErrors(0),
+      _recordUs(0), _pageUs(0),
+      _repairAddress(0), _repairSection(FRAM_SECTION_COUNT) {
+    memset(&_stats, 0, sizeof(_stats));
+    memset(_sectionErrors, 0, sizeof(_sectionErrors));
+    _stats.last_error_section = FRAM_SECTION_COUNT;
+}
+
+bool FramScrubber::begin() {
+    uint8_t sections = 0;
+    uint16_t records = 0;
+    for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+        if (FRAM_SECTION_INFO[i].crcOffset == FRAM_NO_CRC) continue;
+        sections++;
+        records += FRAM_SECTION_INFO[i].count;
+    }
+    _stats.total_records = records;
+
+    // First pass right away - journal and rollups are not verified at boot
+    _passRequested = true;
+
+    Serial.printf("[SCRUB] %u records in %u sections, budget %u us per loop\n",
+                  records, sections, (unsigned)FRAM_SCRUB_BUDGET_US);
+    return true;
+}
+
+void FramScrubber::requestPass() {
+    _passRequested = true;
+}
+
+uint16_t FramScrubber::getSectionErrors(uint8_t section) const {
+    if (section >= FRAM_SECTION_COUNT) return 0;
+    return _sectionErrors[section];
+}
+
+void FramScrubber::resetStats() {
+    uint16_t total = _stats.total_records;
+    memset(&_stats, 0, sizeof(_stats));
+    memset(_sectionErrors, 0, sizeof(_sectionErrors));
+    _stats.total_records = total;
+    _stats.last_error_section = FRAM_SECTION_COUNT;
+}
+
+// ============================================================================
+// UPDATE (called from loop)
+// ============================================================================
+
+void FramScrubber::update() {
+    if (!framController.isReady()) return;
+
+    if (_phase == PHASE_IDLE) {
+        if (!_passRequested && millis() - _idleSinceMs < FRAM_SCRUB_PASS_INTERVAL_MS) return;
+
+        _passRequested = false;
+        _phase = PHASE_RECORDS;
+        _section = 0;
+        _record = 0;
+        _page = 0;
+        _passErrors = 0;
+        _passStartMs = millis();
+        _stats.pass_records = 0;
+        _seekSection();
+    }
+
+    // A unit that cannot fit is skipped; the estimate decays so a one-off
+    // spike (bus retry) does not stop scrubbing for good
+    uint32_t* unitUs = (_phase == PHASE_CHIP) ? &_pageUs : &_recordUs;
+    if (*unitUs > FRAM_SCRUB_BUDGET_US) {
+        *unitUs -= *unitUs / 8;
+        _stats.over_budget++;
+        return;
+    }
+
+    // Never wait for the bus - queued writes and web requests come first
+    if (!framController.tryLockBus()) {
+        _stats.deferred++;
+        return;
+    }
+
+    uint32_t startUs = micros();
+    while (true) {
+        Phase phase = _phase;
+        uint32_t unitStart = micros();
+        bool more = (phase == PHASE_CHIP) ? _checkPage() : _checkRecord();
+        _trackCost(phase == PHASE_CHIP ? &_pageUs : &_recordUs, micros() - unitStart);
+
+        if (!more || _phase == PHASE_IDLE) break;
+
+        // Start the next unit only if it is expected to fit
+        uint32_t next = (_phase == PHASE_CHIP) ? _pageUs : _recordUs;
+        if (micros() - startUs + next > FRAM_SCRUB_BUDGET_US) break;
+    }
+    framController.unlockBus();
+
+    uint32_t sliceUs = micros() - startUs;
+    _stats.slices++;
+    if (sliceUs > _stats.max_slice_us) _stats.max_slice_us = sliceUs;
+
+    // Outside the FRAM lock - ChannelManager takes its own lock first
+    if (_repairSection != FRAM_SECTION_COUNT) {
+        _repair();
+    }
+}
+
+// ============================================================================
+// RECORD PHASE
+// ============================================================================
+
+bool FramScrubber::_seekSection() {
+    while (_section < FRAM_SECTION_COUNT && FRAM_SECTION_INFO[_section].crcOffset == FRAM_NO_CRC) {
+        _section++;
+    }
+    return _section < FRAM_SECTION_COUNT;
+}
+
+bool FramScrubber::_isEmpty(const uint8_t* data, size_t length) {
+    // Never written or cleared (unused B slot, free journal/rollup slot)
+    if (data[0] != 0x00 && data[0] != 0xFF) return false;
+    for (size_t i = 1; i < length; i++) {
+        if (data[i] != data[0]) return false;
+    }
+    return true;
+}
+
+bool FramScrubber::_checkRecord() {
+    const FramSectionInfo& s = FRAM_SECTION_INFO[_section];
+    uint16_t address = s.address + _record * s.recordSize;
+    uint8_t rec[FRAM_SCRUB_MAX_RECORD];
+    bool failed = false;
+
+    // Read errors are already counted in the FRAM section stats - just move on
+    if (framController.readBytes(address, rec, s.recordSize)) {
+        _stats.records_checked++;
+        _stats.bytes_checked += s.recordSize;
+
+        if (_isEmpty(rec, s.recordSize)) {
+            _stats.empty_records++;
+        } else if (!FramController::verifySectionRecord(_section, rec)) {
+            // Read came from the mirror - the chip decides
+            if (framController.isMirrorActive() &&
+                framController.readBytesDirect(address, rec, s.recordSize) &&
+                (_isEmpty(rec, s.recordSize) || FramController::verifySectionRecord(_section, rec))) {
+                uint16_t first = FRAM_MIRROR_PAGE(address);
+                framController.checkMirror(first, FRAM_MIRROR_PAGE(address + s.recordSize - 1) - first + 1);
+                _stats.mirror_fixes++;
+            } else {
+                failed = true;
+                _stats.crc_errors++;
+                _sectionErrors[_section]++;
+                _stats.last_error_address = address;
+                _stats.last_error_section = _section;
+                _repairAddress = address;
+                _repairSection = _section;
+
+                if (_passErrors < FRAM_SCRUB_LOG_PER_PASS) {
+                    Serial.printf("[SCRUB] CRC error at 0x%04X (%s #%u)\n",
+                                  address, s.name, _record);
+                }
+                if (_passErrors < 255) _passErrors++;
+            }
+        }
+    }
+
+    _stats.pass_records++;
+
+    if (++_record >= s.count) {
+        _record = 0;
+        _section++;
+        if (!_seekSection()) {
+            // Records done - with a mirror, compare it against the chip
+            if (framController.isMirrorActive()) {
+                _phase = PHASE_CHIP;
+                _page = 0;
+            } else {
+                _finishPass();
+            }
+            return false;
+        }
+    }
+
+    // Stop the slice so the repair runs before anything else is touched
+    return !failed;
+}
+
+// ============================================================================
+// CHIP PHASE (mirror vs MB85RC256V)
+// ============================================================================
+
+bool FramScrubber::_checkPage() {
+    // A divergent page is taken from the chip - next record pass then sees
+    // real corruption through the mirror and repairs it
+    framController.checkMirror(_page, 1);
+    _stats.chip_pages++;
+
+    if (++_page >= FRAM_MIRROR_PAGES) {
+        _finishPass();
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// PASS / REPAIR
+// ============================================================================
+
+void FramScrubber::_finishPass() {
+    _phase = PHASE_IDLE;
+    _idleSinceMs = millis();
+    _stats.passes++;
+    _stats.last_pass_ms = _idleSinceMs - _passStartMs;
+
+    if (_passErrors > 0) {
+        Serial.printf("[SCRUB] Pass %lu: %u CRC error(s) in %lu ms\n",
+                      (unsigned long)_stats.passes, _passErrors,
+                      (unsigned long)_stats.last_pass_ms);
+    }
+}
+
+void FramScrubber::_repair() {
+    uint16_t address = _repairAddress;
+    uint8_t section = _repairSection;
+    _repairSection = FRAM_SECTION_COUNT;
+
+    bool log = _passErrors <= FRAM_SCRUB_LOG_PER_PASS;
+
+    if (channelManager.isReady() && channelManager.repairRecord(address)) {
+        _stats.repaired++;
+        if (log) {
+            Serial.printf("[SCRUB] 0x%04X (%s) restored from RAM copy\n",
+                          address, FRAM_SECTION_INFO[section].name);
+        }
+    } else {
+        _stats.unrepaired++;
+        if (log) {
+            Serial.printf("[SCRUB] 0x%04X (%s) has no authoritative copy - left to its owner\n",
+                          address, FRAM_SECTION_INFO[section].name);
+        }
+    }
+}
+
+void FramScrubber::_trackCost(uint32_t* estimate, uint32_t measured) {
+    if (measured >= *estimate) {
+        *estimate = measured;
+    } else {
+        *estimate -= (*estimate - measured) / 8;
+    }
+}
+
+// ============================================================================
+// DEBUG
+// ============================================================================
+
+void FramScrubber::printStatus() const {
+    if (_phase == PHASE_IDLE) {
+        uint32_t idle = millis() - _idleSinceMs;
+        uint32_t wait = (_passRequested || idle >= FRAM_SCRUB_PASS_INTERVAL_MS) ? 0
+                        : FRAM_SCRUB_PASS_INTERVAL_MS - idle;
+        Serial.printf("[SCRUB] Idle, next pass in %lu s\n", (unsigned long)(wait / 1000));
+    } else if (_phase == PHASE_RECORDS) {
+        Serial.printf("[SCRUB] Pass %lu: records %u/%u (%s)\n",
+                      (unsigned long)_stats.passes + 1, _stats.pass_records,
+                      _stats.total_records, FRAM_SECTION_INFO[_section].name);
+    } else {
+        Serial.printf("[SCRUB] Pass %lu: chip check page %u/%u\n",
+                      (unsigned long)_stats.passes + 1, _page, (unsigned)FRAM_MIRROR_PAGES);
+    }
+
+    Serial.printf("  Budget %u us, cost: record %lu us, page %lu us, max slice %lu us\n",
+                  (unsigned)FRAM_SCRUB_BUDGET_US, (unsigned long)_recordUs,
+                  (unsigned long)_pageUs, (unsigned long)_stats.max_slice_us);
+    Serial.printf("  Passes %lu (last %lu ms), records %lu (%lu B), empty %lu, chip pages %lu\n",
+                  (unsigned long)_stats.passes, (unsigned long)_stats.last_pass_ms,
+                  (unsigned long)_stats.records_checked, (unsigned long)_stats.bytes_checked,
+                  (unsigned long)_stats.empty_records, (unsigned long)_stats.chip_pages);
+    Serial.printf("  CRC errors %lu, repaired %lu, unrepaired %lu, mirror fixes %lu\n",
+                  (unsigned long)_stats.crc_errors, (unsigned long)_stats.repaired,
+                  (unsigned long)_stats.unrepaired, (unsigned long)_stats.mirror_fixes);
+    Serial.printf("  Slices %lu, deferred (FRAM busy) %lu, over budget %lu\n",
+                  (unsigned long)_stats.slices, (unsigned long)_stats.deferred,
+                  (unsigned long)_stats.over_budget);
+
+    if (_stats.last_error_section < FRAM_SECTION_COUNT) {
+        Serial.printf("  Last error: 0x%04X (%s)\n", _stats.last_error_address,
+                      FRAM_SECTION_INFO[_stats.last_error_section].name);
+        for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+            if (_sectionErrors[i] == 0) continue;
+            Serial.printf("    %-17s %u\n", FRAM_SECTION_INFO[i].name, _sectionErrors[i]);
+        }
+    }
+}
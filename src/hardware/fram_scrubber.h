@@ -0,0 +1,155 @@
+/**
+ * DOZOWNIK - FRAM Scrubber
+ *
+ * Weryfikacja CRC wszystkich rekordów FRAM w tle, po kawałku na każdy
+ * przebieg loop(). Czas na przebieg ograniczony budżetem: kolejny rekord
+ * jest sprawdzany tylko jeśli jego szacowany koszt mieści się w reszcie
+ * budżetu - scrubber nie wydłuża pętli o więcej niż FRAM_SCRUB_BUDGET_US.
+ * Wyjątek: rekord droższy niż cały budżet (odczyt I2C bez lustra przy
+ * bardzo małym budżecie) wykonywany jest co kilka pętli - licznik over_budget.
+ *
+ * Przy aktywnym lustrze PSRAM rekordy czytane są z lustra; błąd jest
+ * potwierdzany odczytem z układu, a po przebiegu rekordów lustro jest
+ * porównywane z układem strona po stronie.
+ *
+ * Uszkodzony rekord jest naprawiany z kopii w RAM (ChannelManager), jeśli
+ * ta jest autorytatywna. Pozostałe (dziennik, rollupy, nagłówek) są tylko
+ * zgłaszane - ich moduły mają własną obsługę błędnych rekordów.
+ */
+
+#ifndef FRAM_SCRUBBER_H
+#define FRAM_SCRUBBER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "fram_layout.h"
+#include "fram_controller.h"
+
+// Największy rekord z CRC (sprawdzane w fram_scrubber.cpp)
+#define FRAM_SCRUB_MAX_RECORD       192
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+/**
+ * Pokrycie i błędy scrubbera
+ */
+struct FramScrubStats {
+    uint32_t passes;            // Zakończone pełne przebiegi
+    uint32_t records_checked;
+    uint32_t bytes_checked;
+    uint32_t empty_records;     // Puste (same 0x00 / 0xFF) - nie sprawdzane
+    uint32_t crc_errors;        // Rekordy z błędnym CRC w układzie
+    uint32_t repaired;          // Naprawione z kopii RAM
+    uint32_t unrepaired;        // Bez autorytatywnej kopii
+    uint32_t mirror_fixes;      // Błąd tylko w lustrze - poprawione z układu
+    uint32_t chip_pages;        // Strony lustra porównane z układem
+    uint32_t slices;            // Wywołania update() z pracą
+    uint32_t deferred;          // Pominięte - FRAM zajęta przez inny task
+    uint32_t over_budget;       // Pominięte - rekord nie mieścił się w budżecie
+    uint32_t max_slice_us;      // Najdłuższy kawałek
+    uint32_t last_pass_ms;      // Czas trwania ostatniego pełnego przebiegu
+    uint16_t total_records;     // Rekordów z CRC w układzie
+    uint16_t pass_records;      // Postęp bieżącego przebiegu
+    uint16_t last_error_address;
+    uint8_t  last_error_section;    // FRAM_SECTION_COUNT = brak
+};
+
+// ============================================================================
+// FRAM SCRUBBER CLASS
+// ============================================================================
+
+class FramScrubber {
+public:
+    FramScrubber();
+
+    /**
+     * Policz rekordy do sprawdzania i zaplanuj pierwszy przebieg
+     */
+    bool begin();
+
+    /**
+     * Kawałek pracy w ramach budżetu (wołane z loop())
+     */
+    void update();
+
+    /**
+     * Rozpocznij kolejny przebieg bez czekania na FRAM_SCRUB_PASS_INTERVAL_MS
+     */
+    void requestPass();
+
+    /** Czy przebieg jest w toku */
+    bool isScrubbing() const { return _phase != PHASE_IDLE; }
+
+    const FramScrubStats& getStats() const { return _stats; }
+
+    /** Błędy CRC w sekcji od startu (indeks jak w FRAM_SECTION_INFO) */
+    uint16_t getSectionErrors(uint8_t section) const;
+
+    void resetStats();
+
+    /**
+     * Debug: pokrycie, błędy, koszt
+     */
+    void printStatus() const;
+
+private:
+    enum Phase : uint8_t {
+        PHASE_IDLE,
+        PHASE_RECORDS,          // Rekordy z CRC, sekcja po sekcji
+        PHASE_CHIP              // Lustro vs układ, strona po stronie
+    };
+
+    Phase    _phase;
+    uint8_t  _section;          // Kursor: sekcja
+    uint16_t _record;           //         rekord w sekcji
+    uint16_t _page;             //         strona lustra (PHASE_CHIP)
+    uint32_t _passStartMs;
+    uint32_t _idleSinceMs;
+    bool     _passRequested;
+    uint8_t  _passErrors;       // Do limitu logów na przebieg
+
+    uint32_t _recordUs;         // Szacowany koszt jednego rekordu
+    uint32_t _pageUs;           // Szacowany koszt strony lustra
+
+    uint16_t _repairAddress;    // Rekord do naprawy po zwolnieniu FRAM
+    uint8_t  _repairSection;    // FRAM_SECTION_COUNT = brak
+
+    FramScrubStats _stats;
+    uint16_t _sectionErrors[FRAM_SECTION_COUNT];
+
+    /**
+     * Jeden rekord (wywołujący trzyma blokadę FRAM)
+     * @return false gdy kawałek ma się zakończyć (błąd do naprawy, koniec fazy)
+     */
+    bool _checkRecord();
+
+    /**
+     * Jedna strona lustra vs układ
+     */
+    bool _checkPage();
+
+    /**
+     * Kursor na najbliższą sekcję z CRC od bieżącej (false = koniec rekordów)
+     */
+    bool _seekSection();
+
+    void _finishPass();
+    void _repair();
+
+    static bool _isEmpty(const uint8_t* data, size_t length);
+
+    /**
+     * Koszt jednostki: rośnie od razu, maleje powoli (wygładzanie)
+     */
+    static void _trackCost(uint32_t* estimate, uint32_t measured);
+};
+
+// ============================================================================
+// GLOBAL INSTANCE
+// ============================================================================
+
+extern FramScrubber framScrubber;
+
+#endif // FRAM_SCRUBBER_H
@@ -11,13 +11,20 @@
 #include "dosing_types.h"
 #include "channel_manager.h"
 #include "dosing_scheduler.h"
+#include "lifetime_counters.h"
+#include "../core/loop_events.h"
 
 // Global instance
 RelayController relayController;
 
-// Critical section spinlock for pump mutex (TOCTOU protection)
+// Critical section spinlock for pump admission (TOCTOU protection)
 static portMUX_TYPE _pumpMutex = portMUX_INITIALIZER_UNLOCKED;
 
+static_assert(RELAY_MAX_CONCURRENT >= 1 && RELAY_MAX_CONCURRENT <= CHANNEL_COUNT,
+              "RELAY_MAX_CONCURRENT must be 1..CHANNEL_COUNT");
+static_assert(sizeof(PUMP_CURRENT_MA) / sizeof(PUMP_CURRENT_MA[0]) >= CHANNEL_COUNT,
+              "PUMP_CURRENT_MA needs an entry per channel");
+
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
@@ -45,16 +52,20 @@ void RelayController::begin() {
         Serial.printf("        CH%d -> Validate GPIO%d\n", i, VALIDATE_PINS[i]);
     }
     
-    _activeChannel = 255;
-    _activeMaxDuration = 0;
-    _validationState = GpioValidationState::IDLE;
-    _validationEnabled = false;
-    _stateStartTime = 0;
-    _lastGpioReading = -1;
-    _pumpStartTime = 0;
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        _runs[i].state = GpioValidationState::IDLE;
+        _runs[i].validate = false;
+        _runs[i].reserved = false;
+        _runs[i].state_start_ms = 0;
+        _runs[i].pump_start_ms = 0;
+        _runs[i].max_duration_ms = 0;
+        _runs[i].last_gpio = -1;
+        _runs[i].last_result = GpioValidationResult::PENDING;
+    }
     _initialized = true;
     
-    Serial.println(F("[RELAY] Controller ready"));
+    Serial.printf("[RELAY] Controller ready (max %d concurrent, budget %d mA)\n",
+                  RELAY_MAX_CONCURRENT, RELAY_CURRENT_BUDGET_MA);
 }
 
 // ============================================================================
@@ -64,24 +75,26 @@ void RelayController::begin() {
 void RelayController::update() {
     if (!_initialized) return;
     
-    // Aktualizuj maszynę stanów walidacji
-    _updateValidation();
-    
-    // Sprawdź timeout tylko gdy pompa pracuje
-    if (_validationState == GpioValidationState::RUNNING) {
-        _checkTimeout();
+    // Each channel runs its own validation FSM
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+        _updateValidation(ch);
+        
+        // Sprawdź timeout tylko gdy pompa pracuje
+        if (_runs[ch].state == GpioValidationState::RUNNING) {
+            _checkTimeout(ch);
+        }
     }
 }
 
-void RelayController::_checkTimeout() {
-    if (_activeChannel >= CHANNEL_COUNT) return;
-    if (_activeMaxDuration == 0) return;
+void RelayController::_checkTimeout(uint8_t channel) {
+    const RelayRun& run = _runs[channel];
+    if (!run.reserved || run.max_duration_ms == 0) return;
     
-    uint32_t runtime = millis() - _pumpStartTime;
+    uint32_t runtime = millis() - run.pump_start_ms;
     
-    if (runtime >= _activeMaxDuration) {
-        Serial.printf("[RELAY] CH%d TIMEOUT after %lu ms\n", _activeChannel, runtime);
-        turnOff(_activeChannel);
+    if (runtime >= run.max_duration_ms) {
+        Serial.printf("[RELAY] CH%d TIMEOUT after %lu ms\n", channel, runtime);
+        turnOff(channel);
     }
 }
 
@@ -108,46 +121,55 @@ RelayResult RelayController::turnOn(uint8_t channel, uint32_t max_duration_ms, b
         return RelayResult::ERROR_SYSTEM_HALTED;
     }
 
-    // === ATOMIC CHECK-AND-SET for pump mutex (TOCTOU fix) ===
+    // === ATOMIC ADMISSION (TOCTOU fix) ===
+    // Slot count and current budget are checked and reserved in one step
+    RelayRun& run = _runs[channel];
+    uint8_t activeCount;
+    uint16_t activeCurrent;
     portENTER_CRITICAL(&_pumpMutex);
 
-    // Check mutex - inside critical section
-    if (_activeChannel < CHANNEL_COUNT && _activeChannel != channel) {
-        portEXIT_CRITICAL(&_pumpMutex);
-        Serial.printf("[RELAY] ERROR: CH%d blocked, CH%d is active\n", channel, _activeChannel);
-        return RelayResult::ERROR_MUTEX_LOCKED;
-    }
-
-    // Check if already on - inside critical section
-    if (_channels[channel].is_on) {
+    RelayResult admit = _admission(channel, &activeCount, &activeCurrent);
+    if (admit != RelayResult::OK) {
         portEXIT_CRITICAL(&_pumpMutex);
-        return RelayResult::ERROR_ALREADY_ON;
+        if (admit == RelayResult::ERROR_MUTEX_LOCKED) {
+            Serial.printf("[RELAY] ERROR: CH%d blocked, %d pump(s) active\n", channel, activeCount);
+        } else if (admit == RelayResult::ERROR_POWER_BUDGET) {
+            Serial.printf("[RELAY] ERROR: CH%d blocked, %d + %d mA over budget %d mA\n",
+                          channel, activeCurrent, PUMP_CURRENT_MA[channel], RELAY_CURRENT_BUDGET_MA);
+        }
+        return admit;
     }
 
-    // Set parameters - atomically with check above
-    _activeMaxDuration = (max_duration_ms > 0) ? max_duration_ms : MAX_PUMP_DURATION_MS;
-    _activeChannel = channel;
+    run.reserved = true;
+    run.validate = validate;
+    run.max_duration_ms = (max_duration_ms > 0) ? max_duration_ms : MAX_PUMP_DURATION_MS;
+    run.pump_start_ms = 0;
+    run.last_result = GpioValidationResult::PENDING;
 
     portEXIT_CRITICAL(&_pumpMutex);
-    _validationEnabled = validate;
     
-    Serial.printf("[RELAY] CH%d starting (max %lu ms, validation: %s)\n", 
-                  channel, _activeMaxDuration, validate ? "ON" : "OFF");
+    Serial.printf("[RELAY] CH%d starting (max %lu ms, validation: %s, %d/%d active)\n", 
+                  channel, run.max_duration_ms, validate ? "ON" : "OFF",
+                  activeCount + 1, RELAY_MAX_CONCURRENT);
     
-    if (_validationEnabled) {
+    if (run.validate) {
         // Rozpocznij sekwencję z PRE-CHECK
-        _startPreCheck();
+        _startPreCheck(channel);
     } else {
         // Bez walidacji - włącz od razu
         _setRelay(channel, true);
         _channels[channel].is_on = true;
         _channels[channel].on_since_ms = millis();
         _channels[channel].activation_count++;
-        _pumpStartTime = millis();
-        _validationState = GpioValidationState::RUNNING;
+        lifetimeCounters.add(COUNTER_ACTIVATIONS + channel, 1);
+        run.pump_start_ms = millis();
+        _transitionTo(channel, GpioValidationState::RUNNING);
         Serial.printf("[RELAY] CH%d ON (no validation)\n", channel);
     }
     
+    // Caller may be a web handler - loop() must switch to the active period now
+    loopEvents.signal(LOOP_EVENT_WAKE);
+    
     return RelayResult::OK;
 }
 
@@ -167,16 +189,18 @@ RelayResult RelayController::turnOffWithDuration(uint8_t channel, uint32_t* actu
         return RelayResult::ERROR_INVALID_CHANNEL;
     }
     
+    RelayRun& run = _runs[channel];
+    
     // Check if already off
-    if (!_channels[channel].is_on && _validationState == GpioValidationState::IDLE) {
+    if (!_channels[channel].is_on && !run.reserved) {
         if (actual_duration_ms) *actual_duration_ms = 0;
         return RelayResult::ERROR_ALREADY_OFF;
     }
     
     // Calculate duration
     uint32_t duration = 0;
-    if (_pumpStartTime > 0) {
-        duration = millis() - _pumpStartTime;
+    if (run.pump_start_ms > 0) {
+        duration = millis() - run.pump_start_ms;
     }
     if (actual_duration_ms) *actual_duration_ms = duration;
     
@@ -187,18 +211,19 @@ RelayResult RelayController::turnOffWithDuration(uint8_t channel, uint32_t* actu
     
     // Aktualizuj statystyki
     _channels[channel].total_on_time_ms += duration;
+    lifetimeCounters.add(COUNTER_PUMP_MS + channel, duration);
     
-    if (_validationEnabled) {
+    if (run.validate) {
         // Rozpocznij POST-CHECK
-        Serial.println(F("[GPIO_VAL] Starting POST-CHECK..."));
-        _transitionTo(GpioValidationState::POST_CHECK_DELAY);
+        Serial.printf("[GPIO_VAL] CH%d starting POST-CHECK...\n", channel);
+        _transitionTo(channel, GpioValidationState::POST_CHECK_DELAY);
     } else {
         // Bez walidacji - zakończ od razu
         _channels[channel].is_on = false;
-        _activeChannel = 255;
-        _activeMaxDuration = 0;
-        _validationState = GpioValidationState::IDLE;
-        _pumpStartTime = 0;
+        portENTER_CRITICAL(&_pumpMutex);
+        _release(channel);
+        run.state = GpioValidationState::IDLE;
+        portEXIT_CRITICAL(&_pumpMutex);
     }
     
     return RelayResult::OK;
@@ -220,21 +245,19 @@ void RelayController::forceOffImmediate(uint8_t channel) {
     portENTER_CRITICAL(&_pumpMutex);
 
     // Wyczyść stan
+    uint32_t duration = 0;
     if (_channels[channel].is_on) {
-        uint32_t duration = millis() - _channels[channel].on_since_ms;
+        duration = millis() - _channels[channel].on_since_ms;
         _channels[channel].total_on_time_ms += duration;
     }
     _channels[channel].is_on = false;
 
-    if (_activeChannel == channel) {
-        _activeChannel = 255;
-        _activeMaxDuration = 0;
-    }
-
-    _validationState = GpioValidationState::IDLE;
-    _pumpStartTime = 0;
+    _release(channel);
+    _runs[channel].state = GpioValidationState::IDLE;
 
     portEXIT_CRITICAL(&_pumpMutex);
+
+    lifetimeCounters.add(COUNTER_PUMP_MS + channel, duration);
 }
 
 // ============================================================================
@@ -250,14 +273,15 @@ void RelayController::allOff() {
         if (_channels[i].is_on) {
             uint32_t duration = millis() - _channels[i].on_since_ms;
             _channels[i].total_on_time_ms += duration;
+            lifetimeCounters.add(COUNTER_PUMP_MS + i, duration);
             _channels[i].is_on = false;
         }
+        
+        portENTER_CRITICAL(&_pumpMutex);
+        _release(i);
+        _runs[i].state = GpioValidationState::IDLE;
+        portEXIT_CRITICAL(&_pumpMutex);
     }
-    
-    _activeChannel = 255;
-    _activeMaxDuration = 0;
-    _validationState = GpioValidationState::IDLE;
-    _pumpStartTime = 0;
 }
 
 void RelayController::emergencyStop() {
@@ -270,50 +294,50 @@ void RelayController::emergencyStop() {
 // GPIO VALIDATION STATE MACHINE
 // ============================================================================
 
-void RelayController::_updateValidation() {
-    switch (_validationState) {
+void RelayController::_updateValidation(uint8_t channel) {
+    switch (_runs[channel].state) {
         case GpioValidationState::IDLE:
             // Nic do roboty
             break;
             
         case GpioValidationState::PRE_CHECK_START:
-            _handlePreCheckDebounce();
+            _handlePreCheckDebounce(channel);
             break;
             
         case GpioValidationState::PRE_CHECK_DEBOUNCE:
-            _handlePreCheckDebounce();
+            _handlePreCheckDebounce(channel);
             break;
             
         case GpioValidationState::PRE_CHECK_VERIFY:
-            _handlePreCheckVerify();
+            _handlePreCheckVerify(channel);
             break;
             
         case GpioValidationState::RELAY_ON_DELAY:
-            _handleRelayOnDelay();
+            _handleRelayOnDelay(channel);
             break;
             
         case GpioValidationState::RUN_CHECK_DEBOUNCE:
-            _handleRunCheckDebounce();
+            _handleRunCheckDebounce(channel);
             break;
             
         case GpioValidationState::RUN_CHECK_VERIFY:
-            _handleRunCheckVerify();
+            _handleRunCheckVerify(channel);
             break;
             
         case GpioValidationState::RUNNING:
-            _handleRunning();
+            _handleRunning(channel);
             break;
             
         case GpioValidationState::POST_CHECK_DELAY:
-            _handlePostCheckDelay();
+            _handlePostCheckDelay(channel);
             break;
             
         case GpioValidationState::POST_CHECK_DEBOUNCE:
-            _handlePostCheckDebounce();
+            _handlePostCheckDebounce(channel);
             break;
             
         case GpioValidationState::POST_CHECK_VERIFY:
-            _handlePostCheckVerify();
+            _handlePostCheckVerify(channel);
             break;
             
         case GpioValidationState::VALIDATION_OK:
@@ -329,42 +353,45 @@ void RelayController::_updateValidation() {
 // PRE-CHECK: Sprawdź LOW przed włączeniem przekaźnika
 // ============================================================================
 
-void RelayController::_startPreCheck() {
-    Serial.printf("[GPIO_VAL] CH%d PRE-CHECK starting...\n", _activeChannel);
-    _transitionTo(GpioValidationState::PRE_CHECK_DEBOUNCE);
+void RelayController::_startPreCheck(uint8_t channel) {
+    Serial.printf("[GPIO_VAL] CH%d PRE-CHECK starting...\n", channel);
+    _transitionTo(channel, GpioValidationState::PRE_CHECK_DEBOUNCE);
 }
 
-void RelayController::_handlePreCheckDebounce() {
-    if (millis() - _stateStartTime >= GPIO_DEBOUNCE_MS) {
-        _transitionTo(GpioValidationState::PRE_CHECK_VERIFY);
+void RelayController::_handlePreCheckDebounce(uint8_t channel) {
+    if (millis() - _runs[channel].state_start_ms >= GPIO_DEBOUNCE_MS) {
+        _transitionTo(channel, GpioValidationState::PRE_CHECK_VERIFY);
     }
 }
 
-void RelayController::_handlePreCheckVerify() {
-    _lastGpioReading = digitalRead(VALIDATE_PINS[_activeChannel]);
+void RelayController::_handlePreCheckVerify(uint8_t channel) {
+    int gpio = digitalRead(VALIDATE_PINS[channel]);
+    _runs[channel].last_gpio = gpio;
     
     Serial.printf("[GPIO_VAL] CH%d PRE-CHECK: GPIO=%d (expected %d)\n",
-                  _activeChannel, _lastGpioReading, GPIO_STATE_IDLE);
+                  channel, gpio, GPIO_STATE_IDLE);
     
-    if (_lastGpioReading == GPIO_STATE_IDLE) {
+    if (gpio == GPIO_STATE_IDLE) {
         // OK - przewód podłączony, przekaźnik OFF
-        Serial.printf("[GPIO_VAL] CH%d PRE-CHECK OK\n", _activeChannel);
+        Serial.printf("[GPIO_VAL] CH%d PRE-CHECK OK\n", channel);
         
         // Włącz przekaźnik
-        _setRelay(_activeChannel, true);
-        _channels[_activeChannel].is_on = true;
-        _channels[_activeChannel].on_since_ms = millis();
-        _channels[_activeChannel].activation_count++;
+        _setRelay(channel, true);
+        _channels[channel].is_on = true;
+        _channels[channel].on_since_ms = millis();
+        _channels[channel].activation_count++;
+        lifetimeCounters.add(COUNTER_ACTIVATIONS + channel, 1);
         
-        Serial.printf("[RELAY] CH%d ON\n", _activeChannel);
+        Serial.printf("[RELAY] CH%d ON\n", channel);
         
         // Przejdź do RUN-CHECK
-        _transitionTo(GpioValidationState::RELAY_ON_DELAY);
+        _transitionTo(channel, GpioValidationState::RELAY_ON_DELAY);
         
     } else {
         // FAIL - przewód urwany lub przekaźnik już włączony!
-        Serial.printf("[GPIO_VAL] CH%d PRE-CHECK FAILED! Wire disconnected?\n", _activeChannel);
+        Serial.printf("[GPIO_VAL] CH%d PRE-CHECK FAILED! Wire disconnected?\n", channel);
         _validationFailed(
+            channel,
             GpioValidationState::VALIDATION_FAILED_PRE,
             ERROR_GPIO_PRE_CHECK_FAILED,
             PHASE_PRE
@@ -376,39 +403,41 @@ void RelayController::_handlePreCheckVerify() {
 // RUN-CHECK: Sprawdź HIGH po włączeniu przekaźnika
 // ============================================================================
 
-void RelayController::_handleRelayOnDelay() {
-    if (millis() - _stateStartTime >= GPIO_CHECK_DELAY_MS) {
-        Serial.printf("[GPIO_VAL] CH%d RUN-CHECK starting debounce...\n", _activeChannel);
-        _transitionTo(GpioValidationState::RUN_CHECK_DEBOUNCE);
+void RelayController::_handleRelayOnDelay(uint8_t channel) {
+    if (millis() - _runs[channel].state_start_ms >= GPIO_CHECK_DELAY_MS) {
+        Serial.printf("[GPIO_VAL] CH%d RUN-CHECK starting debounce...\n", channel);
+        _transitionTo(channel, GpioValidationState::RUN_CHECK_DEBOUNCE);
     }
 }
 
-void RelayController::_handleRunCheckDebounce() {
-    if (millis() - _stateStartTime >= GPIO_DEBOUNCE_MS) {
-        _transitionTo(GpioValidationState::RUN_CHECK_VERIFY);
+void RelayController::_handleRunCheckDebounce(uint8_t channel) {
+    if (millis() - _runs[channel].state_start_ms >= GPIO_DEBOUNCE_MS) {
+        _transitionTo(channel, GpioValidationState::RUN_CHECK_VERIFY);
     }
 }
 
-void RelayController::_handleRunCheckVerify() {
-    _lastGpioReading = digitalRead(VALIDATE_PINS[_activeChannel]);
+void RelayController::_handleRunCheckVerify(uint8_t channel) {
+    int gpio = digitalRead(VALIDATE_PINS[channel]);
+    _runs[channel].last_gpio = gpio;
     
     Serial.printf("[GPIO_VAL] CH%d RUN-CHECK: GPIO=%d (expected %d)\n",
-                  _activeChannel, _lastGpioReading, GPIO_STATE_ACTIVE);
+                  channel, gpio, GPIO_STATE_ACTIVE);
     
-    if (_lastGpioReading == GPIO_STATE_ACTIVE) {
+    if (gpio == GPIO_STATE_ACTIVE) {
         // OK - przekaźnik zadziałał
-        Serial.printf("[GPIO_VAL] CH%d RUN-CHECK OK - pump running\n", _activeChannel);
-        _pumpStartTime = millis();
-        _transitionTo(GpioValidationState::RUNNING);
+        Serial.printf("[GPIO_VAL] CH%d RUN-CHECK OK - pump running\n", channel);
+        _runs[channel].pump_start_ms = millis();
+        _transitionTo(channel, GpioValidationState::RUNNING);
         
     } else {
         // FAIL - przekaźnik nie zadziałał
-        Serial.printf("[GPIO_VAL] CH%d RUN-CHECK FAILED! Relay not activated?\n", _activeChannel);
+        Serial.printf("[GPIO_VAL] CH%d RUN-CHECK FAILED! Relay not activated?\n", channel);
         
         // Wyłącz przekaźnik
-        _setRelay(_activeChannel, false);
+        _setRelay(channel, false);
         
         _validationFailed(
+            channel,
             GpioValidationState::VALIDATION_FAILED_RUN,
             ERROR_GPIO_RUN_CHECK_FAILED,
             PHASE_RUN
@@ -420,7 +449,7 @@ void RelayController::_handleRunCheckVerify() {
 // RUNNING: Pompa pracuje normalnie
 // ============================================================================
 
-void RelayController::_handleRunning() {
+void RelayController::_handleRunning(uint8_t channel) {
     // Timeout jest obsługiwany w _checkTimeout()
     // Tu można dodać dodatkowe sprawdzenia w trakcie pracy
 }
@@ -429,34 +458,36 @@ void RelayController::_handleRunning() {
 // POST-CHECK: Sprawdź LOW po wyłączeniu przekaźnika
 // ============================================================================
 
-void RelayController::_handlePostCheckDelay() {
-    if (millis() - _stateStartTime >= GPIO_POST_CHECK_DELAY_MS) {
-        Serial.printf("[GPIO_VAL] CH%d POST-CHECK starting debounce...\n", _activeChannel);
-        _transitionTo(GpioValidationState::POST_CHECK_DEBOUNCE);
+void RelayController::_handlePostCheckDelay(uint8_t channel) {
+    if (millis() - _runs[channel].state_start_ms >= GPIO_POST_CHECK_DELAY_MS) {
+        Serial.printf("[GPIO_VAL] CH%d POST-CHECK starting debounce...\n", channel);
+        _transitionTo(channel, GpioValidationState::POST_CHECK_DEBOUNCE);
     }
 }
 
-void RelayController::_handlePostCheckDebounce() {
-    if (millis() - _stateStartTime >= GPIO_DEBOUNCE_MS) {
-        _transitionTo(GpioValidationState::POST_CHECK_VERIFY);
+void RelayController::_handlePostCheckDebounce(uint8_t channel) {
+    if (millis() - _runs[channel].state_start_ms >= GPIO_DEBOUNCE_MS) {
+        _transitionTo(channel, GpioValidationState::POST_CHECK_VERIFY);
     }
 }
 
-void RelayController::_handlePostCheckVerify() {
-    _lastGpioReading = digitalRead(VALIDATE_PINS[_activeChannel]);
+void RelayController::_handlePostCheckVerify(uint8_t channel) {
+    int gpio = digitalRead(VALIDATE_PINS[channel]);
+    _runs[channel].last_gpio = gpio;
     
     Serial.printf("[GPIO_VAL] CH%d POST-CHECK: GPIO=%d (expected %d)\n",
-                  _activeChannel, _lastGpioReading, GPIO_STATE_IDLE);
+                  channel, gpio, GPIO_STATE_IDLE);
     
-    if (_lastGpioReading == GPIO_STATE_IDLE) {
+    if (gpio == GPIO_STATE_IDLE) {
         // OK - przekaźnik wyłączony prawidłowo
-        Serial.printf("[GPIO_VAL] CH%d POST-CHECK OK - cycle complete\n", _activeChannel);
-        _validationSuccess();
+        Serial.printf("[GPIO_VAL] CH%d POST-CHECK OK - cycle complete\n", channel);
+        _validationSuccess(channel);
         
     } else {
         // CRITICAL FAIL - przekaźnik zablokowany w stanie ON!
-        Serial.printf("[GPIO_VAL] CH%d POST-CHECK FAILED! RELAY STUCK ON!\n", _activeChannel);
+        Serial.printf("[GPIO_VAL] CH%d POST-CHECK FAILED! RELAY STUCK ON!\n", channel);
         _validationFailed(
+            channel,
             GpioValidationState::VALIDATION_FAILED_POST,
             ERROR_GPIO_POST_CHECK_FAILED,
             PHASE_POST
@@ -468,29 +499,31 @@ void RelayController::_handlePostCheckVerify() {
 // VALIDATION RESULTS
 // ============================================================================
 
-void RelayController::_validationSuccess() {
-    Serial.printf("[GPIO_VAL] CH%d validation complete - SUCCESS\n", _activeChannel);
+void RelayController::_validationSuccess(uint8_t channel) {
+    Serial.printf("[GPIO_VAL] CH%d validation complete - SUCCESS\n", channel);
     
     // Wyczyść stan
-    _channels[_activeChannel].is_on = false;
-    _activeChannel = 255;
-    _activeMaxDuration = 0;
-    _pumpStartTime = 0;
+    _channels[channel].is_on = false;
     
-    _transitionTo(GpioValidationState::VALIDATION_OK);
+    _transitionTo(channel, GpioValidationState::VALIDATION_OK);
     
     // Po krótkim czasie wróć do IDLE
-    _validationState = GpioValidationState::IDLE;
+    portENTER_CRITICAL(&_pumpMutex);
+    _release(channel);
+    _runs[channel].last_result = GpioValidationResult::OK;
+    _runs[channel].state = GpioValidationState::IDLE;
+    portEXIT_CRITICAL(&_pumpMutex);
 }
 
-void RelayController::_validationFailed(GpioValidationState failState,
+void RelayController::_validationFailed(uint8_t channel,
+                                         GpioValidationState failState,
                                          CriticalErrorType errorType,
                                          ValidationPhase phase) {
     // === SNAPSHOT FIRST - capture all state before any modifications ===
     // This prevents race conditions where scheduler state changes during error handling
-    uint8_t failedChannel = _activeChannel;
+    uint8_t failedChannel = channel;
     DosingEvent eventSnapshot = dosingScheduler.getCurrentEvent();  // Snapshot before state changes
-    int gpioReading = _lastGpioReading;
+    int gpioReading = _runs[channel].last_gpio;
 
     Serial.println();
     Serial.println(F("+==========================================================+"));
@@ -503,17 +536,33 @@ void RelayController::_validationFailed(GpioValidationState failState,
 
     // Wyczyść stan lokalny
     _channels[failedChannel].is_on = false;
-    _activeChannel = 255;
-    _activeMaxDuration = 0;
-    _pumpStartTime = 0;
 
-    _transitionTo(failState);
+    _transitionTo(failedChannel, failState);
+    portENTER_CRITICAL(&_pumpMutex);
+    _release(failedChannel);
+    _runs[failedChannel].last_result = getValidationResult(failedChannel);
+    portEXIT_CRITICAL(&_pumpMutex);
+    lifetimeCounters.add(COUNTER_VALIDATION_FAIL + failedChannel, 1);
 
     // === MARK EVENT AS FAILED using snapshot data ===
-    if (eventSnapshot.hour >= FIRST_EVENT_HOUR && eventSnapshot.hour <= LAST_EVENT_HOUR) {
+    // Only when the scheduler's event is on this channel (a calibration or
+    // CLI run on another channel must not fail the scheduled dose)
+    bool schedulerDosing = dosingScheduler.isDosingActive();
+    if (schedulerDosing && eventSnapshot.channel == failedChannel &&
+        eventSnapshot.hour >= FIRST_EVENT_HOUR && eventSnapshot.hour <= LAST_EVENT_HOUR) {
         channelManager.markEventFailed(failedChannel, eventSnapshot.hour);
     }
 
+    // The critical error cuts the master relay for every pump - stop the
+    // other running channels explicitly so none of them completes as a dose
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        if (i == failedChannel || !isChannelBusy(i)) continue;
+        if (schedulerDosing && eventSnapshot.channel == i) {
+            dosingScheduler.stopCurrentDose();
+        }
+        forceOffImmediate(i);
+    }
+
     // TRIGGER CRITICAL ERROR w SafetyManager
     safetyManager.triggerCriticalError(
         errorType,
@@ -527,22 +576,60 @@ void RelayController::_validationFailed(GpioValidationState failState,
 // HELPERS
 // ============================================================================
 
-void RelayController::_transitionTo(GpioValidationState newState) {
+void RelayController::_transitionTo(uint8_t channel, GpioValidationState newState) {
     // Atomic state transition (prevents FSM race between main loop and web handlers)
     portENTER_CRITICAL(&_pumpMutex);
-    _validationState = newState;
-    _stateStartTime = millis();
+    _runs[channel].state = newState;
+    _runs[channel].state_start_ms = millis();
     portEXIT_CRITICAL(&_pumpMutex);
 }
 
+RelayResult RelayController::_admission(uint8_t channel, uint8_t* activeCount,
+                                        uint16_t* activeCurrent) const {
+    *activeCount = 0;
+    *activeCurrent = 0;
+
+    if (_runs[channel].reserved || _channels[channel].is_on) {
+        return RelayResult::ERROR_ALREADY_ON;
+    }
+
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        if (!_runs[i].reserved) continue;
+        (*activeCount)++;
+        *activeCurrent += PUMP_CURRENT_MA[i];
+    }
+
+    if (*activeCount >= RELAY_MAX_CONCURRENT) {
+        return RelayResult::ERROR_MUTEX_LOCKED;
+    }
+
+    // The first pump is always admitted - the budget only limits additional ones
+    if (*activeCount > 0 && *activeCurrent + PUMP_CURRENT_MA[channel] > RELAY_CURRENT_BUDGET_MA) {
+        return RelayResult::ERROR_POWER_BUDGET;
+    }
+
+    return RelayResult::OK;
+}
+
+void RelayController::_release(uint8_t channel) {
+    _runs[channel].reserved = false;
+    _runs[channel].max_duration_ms = 0;
+    _runs[channel].pump_start_ms = 0;
+}
+
 void RelayController::_setRelay(uint8_t channel, bool state) {
     if (channel >= CHANNEL_COUNT) return;
     // Active LOW - LOW = ON, HIGH = OFF
     digitalWrite(RELAY_PINS[channel], state ? LOW : HIGH);
 }
 
-GpioValidationResult RelayController::getValidationResult() const {
-    switch (_validationState) {
+GpioValidationState RelayController::getValidationState(uint8_t channel) const {
+    if (channel >= CHANNEL_COUNT) return GpioValidationState::IDLE;
+    return _runs[channel].state;
+}
+
+GpioValidationResult RelayController::getValidationResult(uint8_t channel) const {
+    switch (getValidationState(channel)) {
         case GpioValidationState::VALIDATION_OK:
             return GpioValidationResult::OK;
         case GpioValidationState::VALIDATION_FAILED_PRE:
@@ -556,12 +643,34 @@ GpioValidationResult RelayController::getValidationResult() const {
     }
 }
 
+GpioValidationResult RelayController::getLastValidationResult(uint8_t channel) const {
+    if (channel >= CHANNEL_COUNT) return GpioValidationResult::PENDING;
+    return _runs[channel].last_result;
+}
+
+bool RelayController::isValidating(uint8_t channel) const {
+    GpioValidationState state = getValidationState(channel);
+    return state != GpioValidationState::IDLE &&
+           state != GpioValidationState::VALIDATION_OK &&
+           state != GpioValidationState::VALIDATION_FAILED_PRE &&
+           state != GpioValidationState::VALIDATION_FAILED_RUN &&
+           state != GpioValidationState::VALIDATION_FAILED_POST;
+}
+
 bool RelayController::isValidating() const {
-    return _validationState != GpioValidationState::IDLE &&
-           _validationState != GpioValidationState::VALIDATION_OK &&
-           _validationState != GpioValidationState::VALIDATION_FAILED_PRE &&
-           _validationState != GpioValidationState::VALIDATION_FAILED_RUN &&
-           _validationState != GpioValidationState::VALIDATION_FAILED_POST;
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        if (isValidating(i)) return true;
+    }
+    return false;
+}
+
+bool RelayController::isPumpRunning(uint8_t channel) const {
+    return getValidationState(channel) == GpioValidationState::RUNNING;
+}
+
+int RelayController::getLastGpioReading(uint8_t channel) const {
+    if (channel >= CHANNEL_COUNT) return -1;
+    return _runs[channel].last_gpio;
 }
 
 // ============================================================================
@@ -569,11 +678,46 @@ bool RelayController::isValidating() const {
 // ============================================================================
 
 bool RelayController::isAnyOn() const {
-    return _activeChannel < CHANNEL_COUNT;
+    return getActiveCount() > 0;
 }
 
 uint8_t RelayController::getActiveChannel() const {
-    return _activeChannel;
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        if (_runs[i].reserved) return i;
+    }
+    return 255;
+}
+
+uint8_t RelayController::getActiveCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        if (_runs[i].reserved) count++;
+    }
+    return count;
+}
+
+uint16_t RelayController::getActiveCurrentMa() const {
+    uint16_t current = 0;
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        if (_runs[i].reserved) current += PUMP_CURRENT_MA[i];
+    }
+    return current;
+}
+
+bool RelayController::isChannelBusy(uint8_t channel) const {
+    if (channel >= CHANNEL_COUNT) return false;
+    return _runs[channel].reserved;
+}
+
+RelayResult RelayController::canAdmit(uint8_t channel) const {
+    if (channel >= CHANNEL_COUNT) return RelayResult::ERROR_INVALID_CHANNEL;
+
+    uint8_t activeCount;
+    uint16_t activeCurrent;
+    portENTER_CRITICAL(&_pumpMutex);
+    RelayResult result = _admission(channel, &activeCount, &activeCurrent);
+    portEXIT_CRITICAL(&_pumpMutex);
+    return result;
 }
 
 bool RelayController::isChannelOn(uint8_t channel) const {
@@ -581,20 +725,21 @@ bool RelayController::isChannelOn(uint8_t channel) const {
     return _channels[channel].is_on;
 }
 
-uint32_t RelayController::getActiveRuntime() const {
-    if (_activeChannel >= CHANNEL_COUNT) return 0;
-    if (_pumpStartTime == 0) return 0;
-    return millis() - _pumpStartTime;
+uint32_t RelayController::getRuntime(uint8_t channel) const {
+    if (channel >= CHANNEL_COUNT) return 0;
+    if (_runs[channel].pump_start_ms == 0) return 0;
+    return millis() - _runs[channel].pump_start_ms;
 }
 
-uint32_t RelayController::getRemainingTime() const {
-    if (_activeChannel >= CHANNEL_COUNT) return 0;
-    if (_activeMaxDuration == 0) return 0;
-    if (_pumpStartTime == 0) return _activeMaxDuration;
+uint32_t RelayController::getRemainingTime(uint8_t channel) const {
+    if (channel >= CHANNEL_COUNT) return 0;
+    const RelayRun& run = _runs[channel];
+    if (run.max_duration_ms == 0) return 0;
+    if (run.pump_start_ms == 0) return run.max_duration_ms;
     
-    uint32_t runtime = millis() - _pumpStartTime;
-    if (runtime >= _activeMaxDuration) return 0;
-    return _activeMaxDuration - runtime;
+    uint32_t runtime = millis() - run.pump_start_ms;
+    if (runtime >= run.max_duration_ms) return 0;
+    return run.max_duration_ms - runtime;
 }
 
 const RelayState& RelayController::getChannelState(uint8_t channel) const {
@@ -607,8 +752,8 @@ uint32_t RelayController::getTotalRuntime() const {
     uint32_t total = 0;
     for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
         total += _channels[i].total_on_time_ms;
-        if (_channels[i].is_on && _pumpStartTime > 0) {
-            total += millis() - _pumpStartTime;
+        if (_channels[i].is_on) {
+            total += getRuntime(i);
         }
     }
     return total;
@@ -620,14 +765,16 @@ uint32_t RelayController::getTotalRuntime() const {
 
 void RelayController::printStatus() const {
     Serial.println(F("[RELAY] Status:"));
-    Serial.printf("        Active channel: %s\n", 
-                  _activeChannel < CHANNEL_COUNT ? String(_activeChannel).c_str() : "none");
-    Serial.printf("        Validation state: %s\n", validationStateToString(_validationState));
-    Serial.printf("        Validation enabled: %s\n", _validationEnabled ? "YES" : "NO");
+    Serial.printf("        Active: %d / %d pumps, %d / %d mA\n",
+                  getActiveCount(), RELAY_MAX_CONCURRENT,
+                  getActiveCurrentMa(), RELAY_CURRENT_BUDGET_MA);
     
-    if (_activeChannel < CHANNEL_COUNT) {
-        Serial.printf("        Runtime: %lu ms / %lu ms\n", getActiveRuntime(), _activeMaxDuration);
-        Serial.printf("        Last GPIO reading: %d\n", _lastGpioReading);
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        const RelayRun& run = _runs[i];
+        if (!run.reserved) continue;
+        Serial.printf("        CH%d: %s (validation %s), runtime %lu ms / %lu ms, GPIO=%d\n",
+                      i, validationStateToString(run.state), run.validate ? "ON" : "OFF",
+                      getRuntime(i), run.max_duration_ms, run.last_gpio);
     }
     
     Serial.println(F("        Channel stats:"));
@@ -652,6 +799,7 @@ const char* RelayController::resultToString(RelayResult result) {
         case RelayResult::ERROR_GPIO_PRE_CHECK:  return "GPIO_PRE_CHECK_FAILED";
         case RelayResult::ERROR_GPIO_RUN_CHECK:  return "GPIO_RUN_CHECK_FAILED";
         case RelayResult::ERROR_GPIO_POST_CHECK: return "GPIO_POST_CHECK_FAILED";
+        case RelayResult::ERROR_POWER_BUDGET:    return "POWER_BUDGET";
         default:                                 return "UNKNOWN";
     }
 }
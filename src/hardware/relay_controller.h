@@ -4,7 +4,11 @@
  * DOZOWNIK - Relay Controller
  * 
  * Bezpieczne sterowanie przekaźnikami pomp z walidacją GPIO.
- * Gwarantuje że tylko jedna pompa pracuje w danym momencie (mutex).
+ * Współbieżność ograniczona budżetem: najwyżej RELAY_MAX_CONCURRENT pomp
+ * naraz i suma PUMP_CURRENT_MA[] <= RELAY_CURRENT_BUDGET_MA (rezerwacja
+ * atomowa w turnOn(), zwalniana po POST-CHECK). RELAY_MAX_CONCURRENT = 1
+ * to dawny tryb jednej pompy (mutex).
+ * Każdy kanał ma własną maszynę walidacji (osobny pin VALIDATE_PINS[]).
  * 
  * Walidacja GPIO (3-fazowa):
  * - PRE-CHECK:  Sprawdź LOW przed włączeniem (wykrycie urwanego przewodu)
@@ -54,6 +58,17 @@ enum class GpioValidationState : uint8_t {
     VALIDATION_FAILED_POST      // Błąd POST-CHECK (krytyczny!)
 };
 
+/**
+ * Wynik walidacji GPIO (dla callbacka)
+ */
+enum class GpioValidationResult : uint8_t {
+    PENDING = 0,        // W trakcie walidacji
+    OK,                 // Walidacja OK
+    FAILED_PRE,         // Błąd pre-check
+    FAILED_RUN,         // Błąd run-check
+    FAILED_POST         // Błąd post-check
+};
+
 // ============================================================================
 // RELAY STATE
 // ============================================================================
@@ -65,7 +80,21 @@ struct RelayState {
     bool     is_on;             // Czy przekaźnik włączony
     uint32_t on_since_ms;       // millis() włączenia
     uint32_t total_on_time_ms;  // Suma czasu pracy (od boot)
-    uint32_t activation_count;  // Licznik aktywacji
+    uint32_t activation_count;  // Licznik aktywacji (od boot; trwałe: lifetimeCounters)
+};
+
+/**
+ * Przebieg kanału: maszyna walidacji i rezerwacja budżetu
+ */
+struct RelayRun {
+    GpioValidationState state;
+    bool     validate;          // Walidacja włączona dla tego cyklu
+    bool     reserved;          // Zajmuje budżet (turnOn -> koniec cyklu)
+    uint32_t state_start_ms;    // millis() wejścia w aktualny stan
+    uint32_t pump_start_ms;     // millis() rozpoczęcia właściwej pracy pompy (0 = jeszcze nie)
+    uint32_t max_duration_ms;   // Max czas pracy tego cyklu
+    int      last_gpio;         // Ostatni odczyt GPIO (dla debug)
+    GpioValidationResult last_result;   // Wynik zakończonego cyklu (PENDING = w toku / bez walidacji)
 };
 
 /**
@@ -81,18 +110,8 @@ enum class RelayResult : uint8_t {
     ERROR_TIMEOUT,
     ERROR_GPIO_PRE_CHECK,       // NOWE
     ERROR_GPIO_RUN_CHECK,       // NOWE
-    ERROR_GPIO_POST_CHECK       // NOWE
-};
-
-/**
- * Wynik walidacji GPIO (dla callbacka)
- */
-enum class GpioValidationResult : uint8_t {
-    PENDING = 0,        // W trakcie walidacji
-    OK,                 // Walidacja OK
-    FAILED_PRE,         // Błąd pre-check
-    FAILED_RUN,         // Błąd run-check
-    FAILED_POST         // Błąd post-check
+    ERROR_GPIO_POST_CHECK,      // NOWE
+    ERROR_POWER_BUDGET          // Brak prądu w budżecie dla kolejnej pompy
 };
 
 // ============================================================================
@@ -156,40 +175,75 @@ public:
     
     // --- Status ---
     
+    /**
+     * Czy jakikolwiek kanał zajęty (włączony lub w walidacji)
+     */
     bool isAnyOn() const;
+    
+    /**
+     * Pierwszy zajęty kanał (255 = żaden) - przy kilku pompach tylko jeden z nich
+     */
     uint8_t getActiveChannel() const;
+    
+    /**
+     * Liczba zajętych kanałów / zarezerwowany prąd
+     */
+    uint8_t getActiveCount() const;
+    uint16_t getActiveCurrentMa() const;
+    
+    /**
+     * Czy kanał zajęty (od turnOn do końca POST-CHECK)
+     */
+    bool isChannelBusy(uint8_t channel) const;
+    
+    /**
+     * Czy turnOn(channel) zostałby teraz przyjęty (wolne miejsce i budżet).
+     * Sprawdzenie bez rezerwacji - turnOn() powtarza je atomowo.
+     * @return OK, ERROR_ALREADY_ON, ERROR_MUTEX_LOCKED lub ERROR_POWER_BUDGET
+     */
+    RelayResult canAdmit(uint8_t channel) const;
+    
     bool isChannelOn(uint8_t channel) const;
-    uint32_t getActiveRuntime() const;
-    uint32_t getRemainingTime() const;
+    uint32_t getRuntime(uint8_t channel) const;
+    uint32_t getRemainingTime(uint8_t channel) const;
+    uint32_t getActiveRuntime() const { return getRuntime(getActiveChannel()); }
+    uint32_t getRemainingTime() const { return getRemainingTime(getActiveChannel()); }
     const RelayState& getChannelState(uint8_t channel) const;
     uint32_t getTotalRuntime() const;
     
-    // --- Walidacja GPIO ---
+    // --- Walidacja GPIO (osobno dla każdego kanału) ---
     
     /**
-     * Pobierz aktualny stan walidacji
+     * Pobierz aktualny stan walidacji kanału
      */
-    GpioValidationState getValidationState() const { return _validationState; }
+    GpioValidationState getValidationState(uint8_t channel) const;
     
     /**
-     * Pobierz wynik walidacji (dla odpytywania)
+     * Pobierz wynik walidacji kanału (dla odpytywania)
      */
-    GpioValidationResult getValidationResult() const;
+    GpioValidationResult getValidationResult(uint8_t channel) const;
     
     /**
-     * Czy walidacja jest w toku
+     * Wynik ostatniego zakończonego cyklu kanału - zostaje do następnego turnOn().
+     * getValidationResult() po sukcesie wraca od razu do PENDING (stan IDLE).
+     */
+    GpioValidationResult getLastValidationResult(uint8_t channel) const;
+    
+    /**
+     * Czy walidacja jest w toku (dowolny kanał / dany kanał)
      */
     bool isValidating() const;
+    bool isValidating(uint8_t channel) const;
     
     /**
-     * Czy pompa pracuje (po przejściu walidacji RUN)
+     * Czy pompa kanału pracuje (po przejściu walidacji RUN)
      */
-    bool isPumpRunning() const { return _validationState == GpioValidationState::RUNNING; }
+    bool isPumpRunning(uint8_t channel) const;
     
     /**
-     * Pobierz ostatni odczytany stan GPIO
+     * Pobierz ostatni odczytany stan GPIO kanału
      */
-    int getLastGpioReading() const { return _lastGpioReading; }
+    int getLastGpioReading(uint8_t channel) const;
     
     // --- Debug ---
     
@@ -199,39 +253,40 @@ public:
 
 private:
     RelayState _channels[CHANNEL_COUNT];
-    
-    uint8_t  _activeChannel;        // Aktywny kanał (255 = żaden)
-    uint32_t _activeMaxDuration;    // Max czas dla aktywnego kanału
-    bool     _initialized;
-    
-    // --- Walidacja GPIO ---
-    GpioValidationState _validationState;
-    bool     _validationEnabled;    // Czy walidacja włączona dla tego cyklu
-    uint32_t _stateStartTime;       // millis() wejścia w aktualny stan
-    int      _lastGpioReading;      // Ostatni odczyt GPIO (dla debug)
-    uint32_t _pumpStartTime;        // millis() rozpoczęcia właściwej pracy pompy
+    RelayRun   _runs[CHANNEL_COUNT];
+    bool       _initialized;
     
     // Metody prywatne
     void _setRelay(uint8_t channel, bool state);
-    void _checkTimeout();
-    
-    // Walidacja GPIO
-    void _updateValidation();
-    void _startPreCheck();
-    void _handlePreCheckDebounce();
-    void _handlePreCheckVerify();
-    void _handleRelayOnDelay();
-    void _handleRunCheckDebounce();
-    void _handleRunCheckVerify();
-    void _handleRunning();
-    void _handlePostCheckDelay();
-    void _handlePostCheckDebounce();
-    void _handlePostCheckVerify();
-    void _validationSuccess();
-    void _validationFailed(GpioValidationState failState, CriticalErrorType errorType, ValidationPhase phase);
-    
-    int _readGpioWithDebounce();
-    void _transitionTo(GpioValidationState newState);
+    void _checkTimeout(uint8_t channel);
+    
+    /**
+     * Reguły przyjęcia kanału (liczba pomp, budżet prądu) - wołaj pod _pumpMutex
+     */
+    RelayResult _admission(uint8_t channel, uint8_t* activeCount, uint16_t* activeCurrent) const;
+    
+    /**
+     * Zwolnij rezerwację kanału (koniec cyklu) - wołaj pod _pumpMutex
+     */
+    void _release(uint8_t channel);
+    
+    // Walidacja GPIO (maszyna kanału)
+    void _updateValidation(uint8_t channel);
+    void _startPreCheck(uint8_t channel);
+    void _handlePreCheckDebounce(uint8_t channel);
+    void _handlePreCheckVerify(uint8_t channel);
+    void _handleRelayOnDelay(uint8_t channel);
+    void _handleRunCheckDebounce(uint8_t channel);
+    void _handleRunCheckVerify(uint8_t channel);
+    void _handleRunning(uint8_t channel);
+    void _handlePostCheckDelay(uint8_t channel);
+    void _handlePostCheckDebounce(uint8_t channel);
+    void _handlePostCheckVerify(uint8_t channel);
+    void _validationSuccess(uint8_t channel);
+    void _validationFailed(uint8_t channel, GpioValidationState failState,
+                           CriticalErrorType errorType, ValidationPhase phase);
+    
+    void _transitionTo(uint8_t channel, GpioValidationState newState);
 };
 
 // ============================================================================
@@ -5,7 +5,10 @@
  */
 
 #include "rtc_controller.h"
+#include "../core/civil_date.h"
+#include "../core/loop_events.h"
 #include <WiFi.h>
+#include <AsyncUDP.h>
 #include <time.h>
 
 // Global instance
@@ -21,74 +24,69 @@ RtcController rtcController;
 #define DS3231_REG_YEAR       0x06
 #define DS3231_REG_CONTROL    0x0E
 #define DS3231_REG_STATUS     0x0F
+#define DS3231_REG_AGING      0x10
 #define DS3231_REG_TEMP_MSB   0x11
 #define DS3231_REG_TEMP_LSB   0x12
 
-// Days in month (non-leap year)
-static const uint8_t daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+// DS3231 control register bits
+#define DS3231_CTRL_INTCN     0x04    // 1 = alarm interrupt, 0 = square wave on INT/SQW
+#define DS3231_CTRL_RS1       0x08    // RS2:RS1 = 00 -> 1 Hz
+#define DS3231_CTRL_RS2       0x10
+#define DS3231_CTRL_CONV      0x20    // Start a temperature conversion (applies aging)
+#define DS3231_STATUS_BSY     0x04    // Conversion in progress
+
+// SQW edges closer than this are ringing on the open-drain line
+#define RTC_SQW_MIN_PERIOD_US 500000
+
+// 2000-01-01 00:00:00 UTC - DS3231 range start (fallback after a failed read)
+#define RTC_EPOCH_2000        946684800UL
+
+// NTP (RFC 4330 client, one request in flight)
+#define NTP_PORT              123
+#define NTP_PACKET_SIZE       48
+#define NTP_UNIX_OFFSET       2208988800ULL   // 1900-01-01 -> 1970-01-01 [s]
+#define NTP_SERVER_COUNT      3
+#define NTP_REQUEST_COUNT     (NTP_SAMPLES_PER_SERVER * NTP_SERVER_COUNT)
+
+static const char* const ntpServers[NTP_SERVER_COUNT] = {
+    NTP_SERVER_1, NTP_SERVER_2, NTP_SERVER_3
+};
+
+static AsyncUDP _ntpUdp;
+
+// Reply mailbox: filled in the AsyncUDP (lwIP) task together with the arrival
+// time, consumed by loop(). Stamping t4 there keeps the loop's poll period
+// out of the round trip (it would bias the offset fed to the drift discipline).
+static portMUX_TYPE _ntpRxMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t  _ntpRxPacket[NTP_PACKET_SIZE];
+static int64_t  _ntpRxUs;
+static uint64_t _ntpRxExpect;           // Originate of the reply we wait for (0 = none)
+static bool     _ntpRxReady;
+
+// Timebase writers (loop task) - keeps the odd-sequence window non-preemptible
+static portMUX_TYPE _timebaseMux = portMUX_INITIALIZER_UNLOCKED;
 
 // ============================================================================
 // TIME INFO METHODS
 // ============================================================================
 
 uint32_t TimeInfo::toUnixTime() const {
-    uint32_t days = 0;
-    
-    // Years since 1970
-    for (uint16_t y = 1970; y < year; y++) {
-        days += (y % 4 == 0 && (y % 100 != 0 || y % 400 == 0)) ? 366 : 365;
-    }
-    
-    // Months this year
-    for (uint8_t m = 1; m < month; m++) {
-        days += daysInMonth[m - 1];
-        if (m == 2 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))) {
-            days++; // Leap year February
-        }
-    }
-    
-    // Days this month
-    days += day - 1;
-    
-    return days * 86400UL + hour * 3600UL + minute * 60UL + second;
+    return daysFromCivil(year, month, day) * 86400UL + hour * 3600UL + minute * 60UL + second;
 }
 
 void TimeInfo::fromUnixTime(uint32_t timestamp) {
-    second = timestamp % 60;
-    timestamp /= 60;
-    minute = timestamp % 60;
-    timestamp /= 60;
-    hour = timestamp % 24;
-    timestamp /= 24;
-    
-    // timestamp is now days since 1970-01-01
-    uint32_t days = timestamp;
-    
-    // Calculate day of week (1970-01-01 was Thursday = 3)
-    dayOfWeek = (days + 3) % 7;
-    
-    // Find year
-    year = 1970;
-    while (true) {
-        uint16_t daysInYear = (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 366 : 365;
-        if (days < daysInYear) break;
-        days -= daysInYear;
-        year++;
-    }
-    
-    // Find month
-    month = 1;
-    while (true) {
-        uint8_t dim = daysInMonth[month - 1];
-        if (month == 2 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))) {
-            dim = 29;
-        }
-        if (days < dim) break;
-        days -= dim;
-        month++;
-    }
-    
-    day = days + 1;
+    uint32_t days = timestamp / 86400UL;
+    uint32_t secs = timestamp % 86400UL;
+    
+    hour = secs / 3600;
+    minute = (secs / 60) % 60;
+    second = secs % 60;
+    
+    CivilDate date = civilFromDays(days);
+    year = date.year;
+    month = date.month;
+    day = date.day;
+    dayOfWeek = weekdayFromDays(days);
 }
 
 void TimeInfo::toString(char* buffer, size_t size) const {
@@ -128,14 +126,39 @@ bool RtcController::begin() {
         _timeValid = true;
     }
     
-    // Read current time for midnight detection
-    TimeInfo now = getTime();
+    // Initial anchor - the only blocking read; later ones come from update()
+    memset(&_stats, 0, sizeof(_stats));
+    _queries = 0;
+    TimeInfo now;
+    int64_t readUs;
+    if (!_readTime(&now, &readUs)) {
+        Serial.println(F("[RTC] WARNING: Time read failed, starting from 2000-01-01"));
+        now.fromUnixTime(RTC_EPOCH_2000);
+        _timeValid = false;
+    }
+    _setAnchor(now.toUnixTime(), readUs);
+    _lastReadUs = readUs;
     _lastDay = now.day;
+    
+    // Edges take over from per-second reads once they arrive
+    _sqwEnabled = _beginSqw();
 
     // Initialize NTP tracking
     _ntpSynced = false;
     _lastNtpSyncTime = 0;
     _lastNtpSyncTimestamp = 0;
+    _ntpState = NtpSyncState::IDLE;
+    _ntpStepped = false;
+    memset(&_ntpStats, 0, sizeof(_ntpStats));
+    
+    // Aging offset survives on the backup battery - the discipline continues from it
+    memset(&_drift, 0, sizeof(_drift));
+    _drift.aging = (int8_t)_readRegister(DS3231_REG_AGING);
+    _driftRefUnix = 0;
+    _driftHistoryHead = 0;
+    _driftHistoryCount = 0;
+    _resyncIntervalMs = NTP_RESYNC_INTERVAL_MS;
+    _drift.resync_interval_s = _resyncIntervalMs / 1000;
     
     _initialized = true;
     
@@ -159,38 +182,55 @@ TimeInfo RtcController::getTime() {
         return t;
     }
     
-    Wire.beginTransmission(RTC_I2C_ADDRESS);
-    Wire.write(DS3231_REG_SECONDS);
-    Wire.endTransmission();
-    
-    Wire.requestFrom((uint8_t)RTC_I2C_ADDRESS, (uint8_t)7);
+    RtcTimebase tb;
+    _loadTimebase(&tb);
+    uint32_t now = _unixAt(tb, esp_timer_get_time());
+    _queries++;
     
-    t.second = _bcd2dec(Wire.read() & 0x7F);
-    t.minute = _bcd2dec(Wire.read());
-    t.hour = _bcd2dec(Wire.read() & 0x3F);  // 24h format
-    Wire.read();  // Skip day of week from RTC (we calculate it)
-    t.day = _bcd2dec(Wire.read());
-    t.month = _bcd2dec(Wire.read() & 0x1F);
-    t.year = 2000 + _bcd2dec(Wire.read());
+    uint32_t sinceMidnight = now - tb.day_start;
+    if (sinceMidnight >= 86400UL) {
+        // Anchor from an earlier day (update() not called) - full conversion
+        t.fromUnixTime(now);
+        return t;
+    }
     
-    // Calculate day of week (0=Mon, 6=Sun)
-    t.dayOfWeek = _calcDayOfWeek(t.year, t.month, t.day);
+    t.year = tb.year;
+    t.month = tb.month;
+    t.day = tb.day;
+    t.dayOfWeek = tb.dayOfWeek;
+    t.hour = sinceMidnight / 3600;
+    t.minute = (sinceMidnight / 60) % 60;
+    t.second = sinceMidnight % 60;
     
     return t;
 }
 
 uint32_t RtcController::getUnixTime() {
-    return getTime().toUnixTime();
+    if (!_initialized) return 0;
+    
+    RtcTimebase tb;
+    _loadTimebase(&tb);
+    _queries++;
+    return _unixAt(tb, esp_timer_get_time());
+}
+
+uint64_t RtcController::getUnixTimeUs() {
+    if (!_initialized) return 0;
+    
+    RtcTimebase tb;
+    _loadTimebase(&tb);
+    _queries++;
+    return _unixUsAt(tb, esp_timer_get_time());
 }
 
 uint8_t RtcController::getHour() {
     if (!_initialized) return 0;
-    return _bcd2dec(_readRegister(DS3231_REG_HOURS) & 0x3F);
+    return (getUnixTime() % 86400UL) / 3600;
 }
 
 uint8_t RtcController::getMinute() {
     if (!_initialized) return 0;
-    return _bcd2dec(_readRegister(DS3231_REG_MINUTES));
+    return (getUnixTime() / 60) % 60;
 }
 
 uint8_t RtcController::getDayOfWeek() {
@@ -202,13 +242,243 @@ uint32_t RtcController::getUTCDay() {
     return getUnixTime() / 86400UL;
 }
 
+// ============================================================================
+// TIMEBASE
+// ============================================================================
+
+void RtcController::update() {
+    if (!_initialized) return;
+    
+    if (_ntpState != NtpSyncState::IDLE) {
+        _updateNtp();
+    }
+    
+    int64_t nowUs = esp_timer_get_time();
+    
+    if (isSqwActive()) {
+        // Edges only move the anchor - the date of a new day is derived here
+        RtcTimebase tb;
+        _loadTimebase(&tb);
+        if (tb.anchor_unix - tb.day_start >= 86400UL) {
+            _setAnchor(tb.anchor_unix, tb.anchor_us, tb.edge_aligned);
+        }
+        
+        // Cross-check mid-second, away from the register update at the edge
+        int64_t phase = nowUs - tb.anchor_us;
+        if (nowUs - _lastReadUs >= (int64_t)RTC_SQW_VERIFY_MS * 1000 &&
+            phase > 200000 && phase < 800000) {
+            refresh();
+        }
+        return;
+    }
+    
+    if (nowUs - _lastReadUs < (int64_t)RTC_TIMEBASE_REFRESH_MS * 1000) return;
+    refresh();
+}
+
+bool RtcController::refresh() {
+    if (!_initialized) return false;
+    
+    TimeInfo t;
+    int64_t readUs;
+    bool ok = _readTime(&t, &readUs);
+    _lastReadUs = readUs;       // A failed read is retried after the same period
+    if (!ok) return false;
+    
+    RtcTimebase tb;
+    _loadTimebase(&tb);
+    uint32_t predicted = _unixAt(tb, readUs);
+    uint32_t rtcUnix = t.toUnixTime();
+    
+    if (rtcUnix == predicted) {
+        return true;
+    }
+    
+    if (isSqwActive()) {
+        // Edge-driven clock disagrees (missed edges / glitch) - take the RTC
+        // value; the next edge restores the phase
+        _setAnchor(rtcUnix, readUs);
+        _stats.steps++;
+    } else if (rtcUnix == predicted + 1) {
+        // RTC ticked before the interpolated boundary - its second began by now
+        _setAnchor(rtcUnix, readUs);
+        _stats.corrections++;
+    } else if (rtcUnix + 1 == predicted) {
+        // Interpolation ran ahead - hold the current second until the RTC
+        // has surely reached it instead of stepping back (anchor in the future)
+        _setAnchor(predicted, readUs + 1000000);
+        _stats.corrections++;
+    } else {
+        _setAnchor(rtcUnix, readUs);
+        _stats.steps++;
+    }
+    return true;
+}
+
+bool RtcController::isSqwActive() const {
+    if (!_sqwEnabled) return false;
+    
+    // 64-bit value written by the ISR - re-read on a torn copy
+    int64_t edgeUs;
+    do {
+        edgeUs = _lastEdgeUs;
+    } while (edgeUs != _lastEdgeUs);
+    
+    return edgeUs != 0 && esp_timer_get_time() - edgeUs < (int64_t)RTC_SQW_TIMEOUT_MS * 1000;
+}
+
+RtcTimebaseStats RtcController::getTimebaseStats() const {
+    RtcTimebaseStats stats = _stats;
+    stats.queries = _queries;
+    stats.sqw_edges = _sqwEdges;
+    stats.sqw_glitches = _sqwGlitches;
+    return stats;
+}
+
+bool RtcController::_beginSqw() {
+    _lastEdgeUs = 0;
+    _sqwEdges = 0;
+    _sqwGlitches = 0;
+    
+    // INTCN=0 routes the oscillator to INT/SQW, RS2:RS1=00 selects 1 Hz
+    uint8_t control = _readRegister(DS3231_REG_CONTROL);
+    _writeRegister(DS3231_REG_CONTROL,
+                   control & ~(DS3231_CTRL_INTCN | DS3231_CTRL_RS2 | DS3231_CTRL_RS1));
+    
+    // Open-drain output; the seconds register advances on the falling edge
+    pinMode(RTC_SQW_PIN, INPUT_PULLUP);
+    attachInterruptArg(digitalPinToInterrupt(RTC_SQW_PIN), _onSqwEdge, this, FALLING);
+    
+    Serial.printf("[RTC] SQW 1 Hz on GPIO%d\n", RTC_SQW_PIN);
+    return true;
+}
+
+void IRAM_ATTR RtcController::_onSqwEdge(void* arg) {
+    RtcController* self = static_cast<RtcController*>(arg);
+    int64_t nowUs = esp_timer_get_time();
+    
+    if (self->_lastEdgeUs != 0 && nowUs - self->_lastEdgeUs < RTC_SQW_MIN_PERIOD_US) {
+        self->_sqwGlitches++;
+        return;
+    }
+    self->_lastEdgeUs = nowUs;
+    self->_sqwEdges++;
+    
+    portENTER_CRITICAL_ISR(&_timebaseMux);
+    RtcTimebase& tb = self->_tb;
+    int64_t elapsed = nowUs - tb.anchor_us;
+    uint32_t second;
+    if (tb.edge_aligned) {
+        // Whole seconds since the previous edge (covers missed edges)
+        second = tb.anchor_unix + (uint32_t)((elapsed + 500000) / 1000000);
+    } else if (elapsed < 0) {
+        // Held second (refresh() anchored it in the future) starts here
+        second = tb.anchor_unix;
+    } else {
+        // Anchor from a register read - its second ends at the first edge after it
+        second = tb.anchor_unix + (uint32_t)(elapsed / 1000000) + 1;
+    }
+    self->_tbSeq++;
+    __sync_synchronize();
+    tb.anchor_unix = second;
+    tb.anchor_us = nowUs;
+    tb.edge_aligned = 1;
+    __sync_synchronize();
+    self->_tbSeq++;
+    portEXIT_CRITICAL_ISR(&_timebaseMux);
+}
+
+bool RtcController::_readTime(TimeInfo* t, int64_t* atUs) {
+    Wire.beginTransmission(RTC_I2C_ADDRESS);
+    Wire.write(DS3231_REG_SECONDS);
+    uint8_t err = Wire.endTransmission();
+    
+    // DS3231 latches the time registers at the start of the read
+    *atUs = esp_timer_get_time();
+    _stats.bus_reads++;
+    
+    if (err != 0 || Wire.requestFrom((uint8_t)RTC_I2C_ADDRESS, (uint8_t)7) != 7) {
+        _stats.bus_errors++;
+        return false;
+    }
+    
+    t->second = _bcd2dec(Wire.read() & 0x7F);
+    t->minute = _bcd2dec(Wire.read());
+    t->hour = _bcd2dec(Wire.read() & 0x3F);  // 24h format
+    Wire.read();  // Skip day of week from RTC (we calculate it)
+    t->day = _bcd2dec(Wire.read());
+    t->month = _bcd2dec(Wire.read() & 0x1F);
+    t->year = 2000 + _bcd2dec(Wire.read());
+    
+    if (t->second > 59 || t->minute > 59 || t->hour > 23 ||
+        t->month < 1 || t->month > 12 || t->day < 1 || t->day > daysInMonth(t->year, t->month)) {
+        _stats.bus_errors++;
+        return false;
+    }
+    
+    // Calculate day of week (0=Mon, 6=Sun)
+    t->dayOfWeek = weekdayFromDays(daysFromCivil(t->year, t->month, t->day));
+    return true;
+}
+
+void RtcController::_setAnchor(uint32_t unixTime, int64_t atUs, bool edgeAligned) {
+    TimeInfo t;
+    t.fromUnixTime(unixTime);
+    
+    RtcTimebase tb;
+    tb.anchor_us = atUs;
+    tb.anchor_unix = unixTime;
+    tb.day_start = unixTime - (unixTime % 86400UL);
+    tb.year = t.year;
+    tb.month = t.month;
+    tb.day = t.day;
+    tb.dayOfWeek = t.dayOfWeek;
+    tb.edge_aligned = edgeAligned ? 1 : 0;
+    
+    portENTER_CRITICAL(&_timebaseMux);
+    _tbSeq++;
+    __sync_synchronize();
+    _tb = tb;
+    __sync_synchronize();
+    _tbSeq++;
+    portEXIT_CRITICAL(&_timebaseMux);
+}
+
+void RtcController::_loadTimebase(RtcTimebase* tb) const {
+    uint32_t seq;
+    do {
+        seq = _tbSeq;
+        __sync_synchronize();
+        *tb = _tb;
+        __sync_synchronize();
+    } while ((seq & 1) || seq != _tbSeq);
+}
+
+uint32_t RtcController::_unixAt(const RtcTimebase& tb, int64_t atUs) {
+    int64_t elapsed = atUs - tb.anchor_us;
+    if (elapsed <= 0) return tb.anchor_unix;
+    return tb.anchor_unix + (uint32_t)(elapsed / 1000000);
+}
+
+uint64_t RtcController::_unixUsAt(const RtcTimebase& tb, int64_t atUs) {
+    int64_t elapsed = atUs - tb.anchor_us;
+    if (elapsed < 0) elapsed = 0;
+    return (uint64_t)tb.anchor_unix * 1000000ULL + (uint64_t)elapsed;
+}
+
 // ============================================================================
 // SET TIME
 // ============================================================================
 
 bool RtcController::setTime(const TimeInfo& time) {
-    if (!_initialized) return false;
+    if (!_initialized || !_writeTime(time)) return false;
     
+    // Manual step - not drift, the measurement starts over
+    _driftRefUnix = 0;
+    return true;
+}
+
+bool RtcController::_writeTime(const TimeInfo& time) {
     Wire.beginTransmission(RTC_I2C_ADDRESS);
     Wire.write(DS3231_REG_SECONDS);
     Wire.write(_dec2bcd(time.second));
@@ -223,6 +493,13 @@ bool RtcController::setTime(const TimeInfo& time) {
         return false;
     }
     
+    // Writing the seconds register resets the DS3231 countdown chain -
+    // the new second starts now, so the anchor needs no read-back
+    int64_t nowUs = esp_timer_get_time();
+    _setAnchor(time.toUnixTime(), nowUs, true);
+    _lastReadUs = nowUs;
+    _stats.steps++;
+    
     _timeValid = true;
     _lastDay = time.day;
     
@@ -239,39 +516,6 @@ bool RtcController::setUnixTime(uint32_t timestamp) {
     return setTime(t);
 }
 
-bool RtcController::syncNTP(const char* ntpServer, long gmtOffset) {
-    Serial.printf("[RTC] NTP sync from %s...\n", ntpServer);
-    
-    // Configure NTP
-    configTime(gmtOffset, 0, ntpServer);
-    
-    // Wait for time (max 10 seconds)
-    uint32_t start = millis();
-    struct tm timeinfo;
-    
-    while (!getLocalTime(&timeinfo)) {
-        if (millis() - start > 10000) {
-            Serial.println(F("[RTC] NTP sync timeout!"));
-            return false;
-        }
-        delay(500);
-        Serial.print(".");
-    }
-    Serial.println();
-    
-    // Convert to TimeInfo
-    TimeInfo t;
-    t.year = timeinfo.tm_year + 1900;
-    t.month = timeinfo.tm_mon + 1;
-    t.day = timeinfo.tm_mday;
-    t.hour = timeinfo.tm_hour;
-    t.minute = timeinfo.tm_min;
-    t.second = timeinfo.tm_sec;
-    t.dayOfWeek = (timeinfo.tm_wday + 6) % 7;  // Convert Sun=0 to Mon=0
-    
-    return setTime(t);
-}
-
 // ============================================================================
 // UTILITY
 // ============================================================================
@@ -310,6 +554,27 @@ void RtcController::printTime() {
     Serial.printf("[RTC] Unix: %lu, UTCDay: %lu\n", t.toUnixTime(), getUTCDay());
     Serial.printf("[RTC] Temperature: %.2f C\n", getTemperature());
     Serial.printf("[RTC] Time valid: %s\n", _timeValid ? "YES" : "NO");
+    
+    RtcTimebaseStats stats = getTimebaseStats();
+    Serial.printf("[RTC] Timebase: %lu queries, %lu bus reads (%lu errors), "
+                  "%lu corrections, %lu steps\n",
+                  (unsigned long)stats.queries, (unsigned long)stats.bus_reads,
+                  (unsigned long)stats.bus_errors, (unsigned long)stats.corrections,
+                  (unsigned long)stats.steps);
+    Serial.printf("[RTC] NTP: %lu syncs, %lu failures, last offset %+lld ms, "
+                  "delay %lu/%lu/%lu us (best/avg/max), max step %lu us\n",
+                  (unsigned long)_ntpStats.syncs, (unsigned long)_ntpStats.failures,
+                  (long long)(_ntpStats.offset_us / 1000), (unsigned long)_ntpStats.delay_us,
+                  (unsigned long)_ntpStats.delay_avg_us, (unsigned long)_ntpStats.delay_max_us,
+                  (unsigned long)_ntpStats.max_step_us);
+    Serial.printf("[RTC] Drift: %+.3f ppm (+/-%.3f, baseline %lu s), aging %d (%u changes), "
+                  "NTP every %lu min\n",
+                  _drift.drift_ppm, _drift.uncertainty_ppm, (unsigned long)_drift.baseline_s,
+                  _drift.aging, _drift.aging_changes,
+                  (unsigned long)(_drift.resync_interval_s / 60));
+    Serial.printf("[RTC] SQW: %s, %lu edges (%lu glitches)\n",
+                  !_sqwEnabled ? "OFF" : (isSqwActive() ? "ACTIVE" : "NO SIGNAL"),
+                  (unsigned long)stats.sqw_edges, (unsigned long)stats.sqw_glitches);
 }
 
 // ============================================================================
@@ -340,82 +605,385 @@ uint8_t RtcController::_dec2bcd(uint8_t dec) {
     return ((dec / 10) << 4) | (dec % 10);
 }
 
-uint8_t RtcController::_calcDayOfWeek(uint16_t year, uint8_t month, uint8_t day) {
-    // Zeller's congruence (modified for Monday=0)
-    if (month < 3) {
-        month += 12;
-        year--;
+// ============================================================================
+// NTP SYNC (incremental - one step per update())
+// ============================================================================
+
+// Unix microseconds <-> 64-bit NTP timestamp (32.32 fixed point since 1900)
+static uint64_t _unixUsToNtp(uint64_t unixUs) {
+    uint64_t sec = unixUs / 1000000ULL + NTP_UNIX_OFFSET;
+    uint64_t frac = ((unixUs % 1000000ULL) << 32) / 1000000ULL;
+    return (sec << 32) | frac;
+}
+
+static uint64_t _ntpToUnixUs(uint64_t ntp) {
+    uint64_t sec = ntp >> 32;
+    if (sec < NTP_UNIX_OFFSET) sec += 1ULL << 32;     // Era 1 (after 2036-02-07)
+    uint64_t frac = ((ntp & 0xFFFFFFFFULL) * 1000000ULL) >> 32;
+    return (sec - NTP_UNIX_OFFSET) * 1000000ULL + frac;
+}
+
+static uint64_t _readNtpStamp(const uint8_t* p) {
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+static void _writeNtpStamp(uint8_t* p, uint64_t v) {
+    for (int8_t i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
     }
+}
+
+static void _onNtpPacket(AsyncUDPPacket& packet) {
+    int64_t rxUs = esp_timer_get_time();
+    if (packet.length() < NTP_PACKET_SIZE) return;
     
-    int k = year % 100;
-    int j = year / 100;
+    // Late replies to earlier requests never occupy the mailbox
+    uint64_t originate = _readNtpStamp(packet.data() + 24);
+    bool accepted = false;
     
-    int h = (day + (13 * (month + 1)) / 5 + k + k / 4 + j / 4 - 2 * j) % 7;
+    portENTER_CRITICAL(&_ntpRxMux);
+    if (!_ntpRxReady && _ntpRxExpect != 0 && originate == _ntpRxExpect) {
+        memcpy(_ntpRxPacket, packet.data(), NTP_PACKET_SIZE);
+        _ntpRxUs = rxUs;
+        _ntpRxReady = true;
+        accepted = true;
+    }
+    portEXIT_CRITICAL(&_ntpRxMux);
     
-    // Convert from Zeller (Sat=0) to ISO (Mon=0)
-    return (h + 5) % 7;
+    if (accepted) loopEvents.signal(LOOP_EVENT_WAKE);
 }
 
-// ============================================================================
-// NTP SYNC WITH RETRY
-// ============================================================================
-
-bool RtcController::syncNTPWithRetry() {
+bool RtcController::startNtpSync() {
+    if (!_initialized || _ntpState != NtpSyncState::IDLE) return false;
+    
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println(F("[RTC] NTP sync skipped - WiFi not connected"));
         return false;
     }
     
-    Serial.println(F("[RTC] Starting NTP synchronization..."));
-    Serial.printf("[RTC] Servers: %s, %s, %s\n", NTP_SERVER_1, NTP_SERVER_2, NTP_SERVER_3);
+    portENTER_CRITICAL(&_ntpRxMux);
+    _ntpRxExpect = 0;
+    _ntpRxReady = false;
+    portEXIT_CRITICAL(&_ntpRxMux);
     
-    // Configure NTP with multiple servers
-    configTime(NTP_GMT_OFFSET_SEC, NTP_DAYLIGHT_OFFSET_SEC, 
-               NTP_SERVER_1, NTP_SERVER_2, NTP_SERVER_3);
+    if (!_ntpUdp.listen(NTP_LOCAL_PORT)) {
+        Serial.println(F("[RTC] NTP sync FAILED - UDP socket"));
+        _ntpStats.failures++;
+        return false;
+    }
+    _ntpUdp.onPacket(_onNtpPacket);
+    
+    Serial.printf("[RTC] NTP sync started (%s, %s, %s; best of %d)\n",
+                  NTP_SERVER_1, NTP_SERVER_2, NTP_SERVER_3, NTP_REQUEST_COUNT);
+    
+    _ntpRequest = 0;
+    _ntpBestDelayUs = UINT32_MAX;
+    _ntpBestOffsetUs = 0;
+    _ntpDelaySumUs = 0;
+    _ntpStartMs = millis();
+    _ntpStats.sent = 0;
+    _ntpStats.samples = 0;
+    _ntpStats.delay_max_us = 0;
+    _ntpState = NtpSyncState::SEND;
+    return true;
+}
+
+bool RtcController::consumeNtpStep() {
+    if (!_ntpStepped) return false;
+    _ntpStepped = false;
+    return true;
+}
+
+bool RtcController::syncNTPWithRetry() {
+    if (!startNtpSync()) return false;
     
-    // Wait for valid time with timeout
-    uint32_t startMs = millis();
-    time_t now = 0;
-    struct tm timeinfo;
-    int attempts = 0;
-    int maxAttempts = NTP_SYNC_TIMEOUT_MS / NTP_SYNC_RETRY_DELAY_MS;
+    uint32_t failures = _ntpStats.failures;
+    while (isNtpSyncing()) {
+        update();
+        delay(1);
+    }
+    return _ntpStats.failures == failures;
+}
+
+void RtcController::_updateNtp() {
+    int64_t stepStart = esp_timer_get_time();
+    
+    switch (_ntpState) {
+        case NtpSyncState::SEND:
+            _ntpSend();
+            break;
+        case NtpSyncState::WAIT:
+            _ntpReceive();
+            break;
+        case NtpSyncState::APPLY:
+            _ntpFinish();
+            break;
+        default:
+            break;
+    }
     
-    while (attempts < maxAttempts) {
-        time(&now);
-        
-        // Check if timestamp is valid (after 2024)
-        if (now > 1704067200) {  // 2024-01-01 00:00:00 UTC
-            localtime_r(&now, &timeinfo);
-            
-            // Additional sanity check
-            if (timeinfo.tm_year + 1900 >= NTP_MIN_VALID_YEAR) {
-                // Success! Set RTC
-                if (setUnixTime((uint32_t)now)) {
-                    _ntpSynced = true;
-                    _lastNtpSyncTime = millis();
-                    _lastNtpSyncTimestamp = (uint32_t)now;
-                    
-                    Serial.printf("[RTC] NTP sync OK in %lu ms\n", millis() - startMs);
-                    Serial.printf("[RTC] UTC: %04d-%02d-%02d %02d:%02d:%02d\n",
-                                  timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-                                  timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-
-                    return true;
-                }
-            }
+    uint32_t stepUs = (uint32_t)(esp_timer_get_time() - stepStart);
+    if (stepUs > _ntpStats.max_step_us) _ntpStats.max_step_us = stepUs;
+}
+
+void RtcController::_ntpSend() {
+    if (_ntpRequest >= NTP_REQUEST_COUNT) {
+        if (_ntpStats.samples == 0) {
+            _ntpUdp.close();
+            _ntpState = NtpSyncState::IDLE;
+            _ntpStats.failures++;
+            Serial.printf("[RTC] NTP sync FAILED - no valid response (%u requests, %lu ms)\n",
+                          _ntpStats.sent, millis() - _ntpStartMs);
+            return;
         }
+        _ntpApplyUs = esp_timer_get_time();
+        _ntpState = NtpSyncState::APPLY;
+        return;
+    }
+    
+    uint8_t packet[NTP_PACKET_SIZE];
+    memset(packet, 0, sizeof(packet));
+    packet[0] = 0x23;                   // LI=0, VN=4, Mode=3 (client)
+    
+    RtcTimebase tb;
+    _loadTimebase(&tb);
+    _ntpTxUs = esp_timer_get_time();
+    _ntpTxUnixUs = _unixUsAt(tb, _ntpTxUs);
+    _ntpTxStamp = _unixUsToNtp(_ntpTxUnixUs);
+    _writeNtpStamp(&packet[40], _ntpTxStamp);   // Echoed back as originate
+    
+    const char* server = ntpServers[_ntpRequest % NTP_SERVER_COUNT];
+    _ntpRequest++;
+    
+    // Arm the mailbox for this request only (drops any reply to an earlier one)
+    portENTER_CRITICAL(&_ntpRxMux);
+    _ntpRxExpect = _ntpTxStamp;
+    _ntpRxReady = false;
+    portEXIT_CRITICAL(&_ntpRxMux);
+    
+    IPAddress address;
+    if (!address.fromString(server) ||
+        _ntpUdp.writeTo(packet, sizeof(packet), address, NTP_PORT) != sizeof(packet)) {
+        return;                         // Next request on the next step
+    }
+    
+    _ntpStats.sent++;
+    _ntpState = NtpSyncState::WAIT;
+}
+
+void RtcController::_ntpReceive() {
+    uint8_t packet[NTP_PACKET_SIZE];
+    int64_t rxUs = 0;
+    
+    portENTER_CRITICAL(&_ntpRxMux);
+    bool ready = _ntpRxReady;
+    if (ready) {
+        memcpy(packet, _ntpRxPacket, NTP_PACKET_SIZE);
+        rxUs = _ntpRxUs;
+        _ntpRxReady = false;
+    }
+    portEXIT_CRITICAL(&_ntpRxMux);
+    
+    if (!ready) {
+        if (esp_timer_get_time() - _ntpTxUs >= (int64_t)NTP_REQUEST_TIMEOUT_MS * 1000) {
+            _ntpState = NtpSyncState::SEND;
+        }
+        return;
+    }
+    
+    // Server mode, synchronized (LI != 3, stratum 1-15), answer to this request
+    uint8_t stratum = packet[1];
+    if ((packet[0] & 0x07) != 4 || (packet[0] >> 6) == 3 ||
+        stratum == 0 || stratum > 15 ||
+        _readNtpStamp(&packet[24]) != _ntpTxStamp) {
+        return;                         // Keep waiting until the timeout
+    }
+    
+    // t4 from the local clock's own interval - immune to anchor moves mid-request.
+    // rxUs is the arrival time stamped in the receive callback
+    uint32_t rttUs = (uint32_t)(rxUs - _ntpTxUs);
+    int64_t t1 = (int64_t)_ntpTxUnixUs;
+    int64_t t2 = (int64_t)_ntpToUnixUs(_readNtpStamp(&packet[32]));
+    int64_t t3 = (int64_t)_ntpToUnixUs(_readNtpStamp(&packet[40]));
+    int64_t t4 = t1 + rttUs;
+    
+    TimeInfo check;
+    check.fromUnixTime((uint32_t)(t3 / 1000000));
+    int64_t serverUs = t3 - t2;
+    if (check.year < NTP_MIN_VALID_YEAR || serverUs < 0 || serverUs > (int64_t)rttUs) {
+        _ntpState = NtpSyncState::SEND;
+        return;
+    }
+    
+    int64_t offsetUs = ((t2 - t1) + (t3 - t4)) / 2;
+    uint32_t delayUs = rttUs - (uint32_t)serverUs;
+    
+    _ntpStats.samples++;
+    _ntpDelaySumUs += delayUs;
+    if (delayUs > _ntpStats.delay_max_us) _ntpStats.delay_max_us = delayUs;
+    
+    // Best of N: the shortest round trip has the smallest asymmetry error
+    if (delayUs < _ntpBestDelayUs) {
+        _ntpBestDelayUs = delayUs;
+        _ntpBestOffsetUs = offsetUs;
+        _ntpStats.server = (_ntpRequest - 1) % NTP_SERVER_COUNT;
+    }
+    
+    _ntpState = NtpSyncState::SEND;
+}
+
+void RtcController::_ntpFinish() {
+    RtcTimebase tb;
+    _loadTimebase(&tb);
+    int64_t nowUs = esp_timer_get_time();
+    uint64_t correctedUs = _unixUsAt(tb, nowUs) + _ntpBestOffsetUs;
+    uint32_t fracUs = (uint32_t)(correctedUs % 1000000ULL);
+    
+    int64_t absOffset = _ntpBestOffsetUs < 0 ? -_ntpBestOffsetUs : _ntpBestOffsetUs;
+    bool apply = !_timeValid || absOffset >= (int64_t)NTP_APPLY_THRESHOLD_MS * 1000;
+    
+    // The DS3231 only takes whole seconds - write just after a corrected
+    // boundary (it restarts its second on the write)
+    if (apply && fracUs >= NTP_APPLY_WINDOW_US &&
+        nowUs - _ntpApplyUs < 2000000) {
+        return;
+    }
+    
+    TimeInfo t;
+    t.fromUnixTime((uint32_t)(correctedUs / 1000000ULL));
+    if (apply && !_writeTime(t)) {
+        return;                         // I2C error - retried within the 2 s window
+    }
+    
+    _ntpUdp.close();
+    _ntpState = NtpSyncState::IDLE;
+    
+    _ntpSynced = true;
+    _lastNtpSyncTime = millis();
+    _lastNtpSyncTimestamp = (uint32_t)(correctedUs / 1000000ULL);
+    if (apply) _ntpStepped = true;
+    
+    _ntpStats.syncs++;
+    _ntpStats.applied = apply;
+    _ntpStats.offset_us = _ntpBestOffsetUs;
+    _ntpStats.delay_us = _ntpBestDelayUs;
+    _ntpStats.delay_avg_us = _ntpDelaySumUs / _ntpStats.samples;
+    _ntpStats.duration_ms = millis() - _ntpStartMs;
+    
+    // The write truncated the corrected time to whole seconds
+    _recordDrift(_lastNtpSyncTimestamp, _ntpBestOffsetUs, _ntpBestDelayUs,
+                 apply, apply ? (int64_t)fracUs : _ntpBestOffsetUs);
+    
+    Serial.printf("[RTC] NTP sync OK in %lu ms: offset %+lld ms, delay %lu us "
+                  "(best of %u/%u, server %s)%s\n",
+                  (unsigned long)_ntpStats.duration_ms,
+                  (long long)(_ntpBestOffsetUs / 1000), (unsigned long)_ntpBestDelayUs,
+                  _ntpStats.samples, _ntpStats.sent, ntpServers[_ntpStats.server],
+                  apply ? "" : " - RTC within threshold, not written");
+}
+
+// ============================================================================
+// DRIFT DISCIPLINE (aging offset)
+// ============================================================================
+
+void RtcController::_recordDrift(uint32_t unixTime, int64_t offsetUs, uint32_t delayUs,
+                                 bool applied, int64_t residualUs) {
+    RtcDriftSample& sample = _driftHistory[_driftHistoryHead];
+    sample.unix_time = unixTime;
+    sample.offset_us = (int32_t)constrain(offsetUs, (int64_t)INT32_MIN, (int64_t)INT32_MAX);
+    sample.delay_us = delayUs;
+    sample.aging = _drift.aging;
+    sample.applied = applied;
+    _driftHistoryHead = (_driftHistoryHead + 1) % RTC_DRIFT_HISTORY;
+    if (_driftHistoryCount < RTC_DRIFT_HISTORY) _driftHistoryCount++;
+    
+    // Without SQW the timebase phase follows esp_timer between register reads
+    // (up to 1 s off the DS3231) - such offsets say nothing about its rate
+    if (!isSqwActive()) {
+        _driftRefUnix = 0;
+        _resyncIntervalMs = NTP_RESYNC_INTERVAL_MS;
+        _drift.resync_interval_s = _resyncIntervalMs / 1000;
+        return;
+    }
+    
+    float expected = RTC_DRIFT_FLOOR_PPM;
+    
+    if (_driftRefUnix == 0 || unixTime <= _driftRefUnix) {
+        // First sync of a baseline - nothing to compare against yet
+        _driftRefUnix = unixTime;
+        _driftRefDelayUs = delayUs;
+        _driftAccumUs = 0;
+        _drift.baseline_s = 0;
+        expected = 0.0f;
+    } else {
+        // Lag gathered since the previous sync (what that sync left + new drift)
+        _driftAccumUs += offsetUs - _driftResidualUs;
+        
+        uint32_t baseline = unixTime - _driftRefUnix;
+        float drift = -(float)_driftAccumUs / baseline;     // us/s = ppm, + = RTC fast
+        float uncertainty = ((_driftRefDelayUs + delayUs) / 2.0f) / baseline;
+        _drift.drift_ppm = drift;
+        _drift.uncertainty_ppm = uncertainty;
+        _drift.baseline_s = baseline;
+        expected = max(fabsf(drift), uncertainty);
         
-        delay(NTP_SYNC_RETRY_DELAY_MS);
-        attempts++;
+        int32_t step = (int32_t)lroundf(drift / RTC_AGING_PPM_PER_LSB);
+        int32_t aging = constrain((int32_t)_drift.aging + step, -127, 127);
         
-        // Progress log every 5 seconds
-        if (attempts % 10 == 0) {
-            Serial.printf("[RTC] NTP waiting... (%d/%d)\n", attempts, maxAttempts);
+        if (baseline >= RTC_DRIFT_MIN_BASELINE_S && fabsf(drift) > 2.0f * uncertainty &&
+            aging != _drift.aging && _writeAging((int8_t)aging)) {
+            Serial.printf("[RTC] Drift %+.2f ppm (+/-%.2f over %lu h) - aging %d -> %ld\n",
+                          drift, uncertainty, (unsigned long)(baseline / 3600),
+                          _drift.aging, (long)aging);
+            
+            // Expect what rounding / saturation left; measure it on a fresh baseline
+            expected = fabsf(drift - (aging - _drift.aging) * RTC_AGING_PPM_PER_LSB);
+            _drift.aging = (int8_t)aging;
+            _drift.aging_changes++;
+            _driftRefUnix = unixTime;
+            _driftRefDelayUs = delayUs;
+            _driftAccumUs = 0;
         }
     }
+    _driftResidualUs = residualUs;
+    
+    // Next sync when the expected drift would reach the target
+    if (expected > 0.0f) {
+        float intervalS = RTC_DRIFT_TARGET_MS * 1000.0f / max(expected, RTC_DRIFT_FLOOR_PPM);
+        _resyncIntervalMs = (uint32_t)constrain(intervalS * 1000.0f,
+                                                (float)NTP_RESYNC_INTERVAL_MS,
+                                                (float)NTP_RESYNC_MAX_INTERVAL_MS);
+    } else {
+        _resyncIntervalMs = NTP_RESYNC_INTERVAL_MS;
+    }
+    _drift.expected_ppm = expected;
+    _drift.resync_interval_s = _resyncIntervalMs / 1000;
+}
+
+bool RtcController::_writeAging(int8_t aging) {
+    _writeRegister(DS3231_REG_AGING, (uint8_t)aging);
+    if ((int8_t)_readRegister(DS3231_REG_AGING) != aging) {
+        Serial.println(F("[RTC] ERROR: Aging offset write failed"));
+        return false;
+    }
     
-    Serial.printf("[RTC] NTP sync FAILED after %lu ms\n", millis() - startMs);
-    return false;
+    // The new offset takes effect with the next conversion - start one now
+    if (!(_readRegister(DS3231_REG_STATUS) & DS3231_STATUS_BSY)) {
+        uint8_t control = _readRegister(DS3231_REG_CONTROL);
+        _writeRegister(DS3231_REG_CONTROL, control | DS3231_CTRL_CONV);
+    }
+    return true;
+}
+
+uint8_t RtcController::getDriftHistory(RtcDriftSample* out, uint8_t maxCount) const {
+    uint8_t count = min(maxCount, _driftHistoryCount);
+    for (uint8_t i = 0; i < count; i++) {
+        out[i] = _driftHistory[(_driftHistoryHead + RTC_DRIFT_HISTORY - 1 - i) % RTC_DRIFT_HISTORY];
+    }
+    return count;
 }
 
 bool RtcController::needsResync() const {
@@ -424,8 +992,8 @@ bool RtcController::needsResync() const {
         return true;
     }
     
-    // Check if interval passed
-    if (millis() - _lastNtpSyncTime > NTP_RESYNC_INTERVAL_MS) {
+    // Check if interval passed (stretched by the drift discipline)
+    if (millis() - _lastNtpSyncTime > _resyncIntervalMs) {
         return true;
     }
     
@@ -3,7 +3,23 @@
  * DOZOWNIK - RTC Controller
  * 
  * Obsługa zegara czasu rzeczywistego DS3231M.
- * Synchronizacja NTP gdy dostępne WiFi.
+ * Synchronizacja NTP gdy dostępne WiFi (AsyncUDP - t4 stemplowany
+ * w callbacku odbioru, nie przy następnym obiegu loop()).
+ *
+ * Podstawa czasu: DS3231 czytany najwyżej co RTC_TIMEBASE_REFRESH_MS
+ * (update() z loop()) lub od razu po setTime()/NTP; między odczytami czas
+ * interpolowany z esp_timer_get_time(). getTime()/getUnixTime()/getHour()
+ * nie dotykają I2C i nie blokują - można je wołać z dowolnego taska.
+ *
+ * Z podłączonym SQW (1 Hz, RTC_SQW_PIN) zbocze w przerwaniu przesuwa
+ * kotwicę na dokładny początek sekundy (bez budzenia loop());
+ * DS3231 czytany wtedy tylko kontrolnie co RTC_SQW_VERIFY_MS.
+ *
+ * Dryf: offsety kolejnych synchronizacji NTP (łącznie z korektami skokiem)
+ * sumowane od początku bazy pomiaru dają szybkość DS3231 w ppm; po
+ * RTC_DRIFT_MIN_BASELINE_S wynik pewniejszy niż błąd pomiaru trafia do
+ * rejestru aging offset (podtrzymywany bateryjnie), a interwał NTP
+ * wydłuża się tak, by błąd między synchronizacjami < RTC_DRIFT_TARGET_MS.
  */
 
 #ifndef RTC_CONTROLLER_H
@@ -12,6 +28,7 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include "config.h"
+#include <esp_timer.h>
 
 // ============================================================================
 // TIME STRUCTURE (prostsza niż DateTime z RTClib)
@@ -47,6 +64,94 @@ struct TimeInfo {
     void toTimeString(char* buffer, size_t size) const;
 };
 
+// ============================================================================
+// TIMEBASE
+// ============================================================================
+
+/**
+ * Kotwica podstawy czasu: sekunda UTC + chwila esp_timer jej początku.
+ * Data dnia kotwicy zapisana obok - getTime() nie przelicza kalendarza.
+ */
+struct RtcTimebase {
+    int64_t  anchor_us;     // esp_timer_get_time() początku anchor_unix
+    uint32_t anchor_unix;   // Sekunda UTC kotwicy
+    uint32_t day_start;     // Północ dnia kotwicy (Unix)
+    uint16_t year;
+    uint8_t  month;
+    uint8_t  day;
+    uint8_t  dayOfWeek;
+    uint8_t  edge_aligned;  // anchor_us = zbocze SQW (nie chwila odczytu)
+};
+
+/**
+ * Ruch na szynie I2C vs zapytania o czas
+ */
+struct RtcTimebaseStats {
+    uint32_t queries;       // getTime/getUnixTime/getHour/... (bez blokady - przybliżone)
+    uint32_t bus_reads;     // Odczyty czasu z DS3231
+    uint32_t bus_errors;    // Nieudane / niepoprawne odczyty
+    uint32_t corrections;   // Korekty fazy o 1 s
+    uint32_t steps;         // Skoki (rozbieżność > 1 s, setTime, NTP)
+    uint32_t sqw_edges;     // Zbocza SQW przesuwające zegar
+    uint32_t sqw_glitches;  // Zbocza odrzucone (< 0.5 s od poprzedniego)
+};
+
+// ============================================================================
+// NTP
+// ============================================================================
+
+/**
+ * Stan synchronizacji NTP (krok w update(), bez czekania)
+ */
+enum class NtpSyncState : uint8_t {
+    IDLE = 0,
+    SEND,           // Wyślij żądanie do kolejnego serwera
+    WAIT,           // Odbiór odpowiedzi (skrzynka wypełniana w callbacku AsyncUDP)
+    APPLY           // Zapis DS3231 tuż po granicy sekundy skorygowanego czasu
+};
+
+/**
+ * Statystyki NTP (pola "ostatnia" = ostatnia zakończona synchronizacja)
+ */
+struct NtpSyncStats {
+    uint32_t syncs;             // Udane synchronizacje
+    uint32_t failures;          // Synchronizacje bez żadnej poprawnej odpowiedzi
+    uint8_t  sent;              // Ostatnia: wysłane żądania
+    uint8_t  samples;           // Ostatnia: poprawne odpowiedzi
+    uint8_t  server;            // Ostatnia: serwer najlepszej próbki (0-2)
+    bool     applied;           // Ostatnia: DS3231 przestawiony
+    int64_t  offset_us;         // Ostatnia: offset najlepszej próbki (NTP - lokalny)
+    uint32_t delay_us;          // Ostatnia: RTT najlepszej próbki
+    uint32_t delay_max_us;      // Ostatnia: najgorszy RTT
+    uint32_t delay_avg_us;      // Ostatnia: średni RTT
+    uint32_t duration_ms;       // Ostatnia: czas od startu do zapisu
+    uint32_t max_step_us;       // Najdłuższy pojedynczy krok w update() (od startu)
+};
+
+/**
+ * Jedna synchronizacja NTP w historii dryfu
+ */
+struct RtcDriftSample {
+    uint32_t unix_time;         // Czas synchronizacji (UTC)
+    int32_t  offset_us;         // NTP - RTC przed korektą (nasycony)
+    uint32_t delay_us;          // RTT najlepszej próbki
+    int8_t   aging;             // Aging offset w chwili pomiaru
+    bool     applied;           // Zegar przestawiony skokiem
+};
+
+/**
+ * Stan dyscypliny dryfu
+ */
+struct RtcDriftStats {
+    float    drift_ppm;         // Ostatni pomiar: + = RTC się spieszy (przy ówczesnym aging)
+    float    uncertainty_ppm;   // Błąd pomiaru (RTT / baza)
+    float    expected_ppm;      // Zakładany dryf po korekcie (wyznacza interwał NTP)
+    int8_t   aging;             // Bieżący aging offset DS3231
+    uint16_t aging_changes;     // Zapisy rejestru aging od startu
+    uint32_t baseline_s;        // Długość bieżącej bazy pomiaru
+    uint32_t resync_interval_s; // Bieżący interwał NTP
+};
+
 // ============================================================================
 // RTC CONTROLLER CLASS
 // ============================================================================
@@ -68,7 +173,24 @@ public:
      */
     bool isTimeValid() const { return _timeValid; }
     
-    // --- Odczyt czasu ---
+    /**
+     * Odśwież podstawę czasu z DS3231 jeśli minęło RTC_TIMEBASE_REFRESH_MS
+     * (wołaj w loop())
+     */
+    void update();
+    
+    /**
+     * Wymuś odczyt DS3231 i korektę podstawy czasu
+     * @return false jeśli odczyt nieudany (interpolacja trwa dalej)
+     */
+    bool refresh();
+    
+    /**
+     * Czy SQW 1 Hz przychodzi (zbocze w ostatnich RTC_SQW_TIMEOUT_MS)
+     */
+    bool isSqwActive() const;
+    
+    // --- Odczyt czasu (z podstawy czasu, bez I2C) ---
     
     /**
      * Pobierz aktualny czas UTC
@@ -80,6 +202,11 @@ public:
      */
     uint32_t getUnixTime();
     
+    /**
+     * Unix timestamp UTC w mikrosekundach (do uzbrajania timerów na granicę sekundy)
+     */
+    uint64_t getUnixTimeUs();
+    
     /**
      * Pobierz aktualną godzinę UTC (0-23)
      */
@@ -112,19 +239,45 @@ public:
      */
     bool setUnixTime(uint32_t timestamp);
     
+    // --- NTP (NTP_SERVER_1..3, best-of-N) ---
+    
     /**
-     * Synchronizuj z NTP (wymaga WiFi)
+     * Rozpocznij synchronizację - dalej prowadzi ją update() bez blokowania
+     * @return false jeśli brak WiFi lub synchronizacja już trwa
      */
-    bool syncNTP(const char* ntpServer = "pool.ntp.org", long gmtOffset = 0);
+    bool startNtpSync();
     
-    // --- Utility ---
-
-        /**
-     * Synchronizuj z NTP z retry i wieloma serwerami
+    /**
+     * Czy synchronizacja NTP w toku
+     */
+    bool isNtpSyncing() const { return _ntpState != NtpSyncState::IDLE; }
+    
+    /**
+     * Czy NTP przestawiło zegar od ostatniego wywołania (jednorazowo)
+     * - wtedy dosingScheduler.syncTimeState()
+     */
+    bool consumeNtpStep();
+    
+    /**
+     * Synchronizacja blokująca do zakończenia (tylko setup())
      * @return true jeśli synchronizacja udana
      */
     bool syncNTPWithRetry();
     
+    const NtpSyncStats& getNtpStats() const { return _ntpStats; }
+    
+    // --- Dryf ---
+    
+    const RtcDriftStats& getDriftStats() const { return _drift; }
+    
+    /**
+     * Historia synchronizacji (od najnowszej)
+     * @return liczba skopiowanych wpisów
+     */
+    uint8_t getDriftHistory(RtcDriftSample* out, uint8_t maxCount) const;
+    
+    // --- Utility ---
+    
     /**
      * Czy potrzebna resynchronizacja (minął interwał)
      */
@@ -150,6 +303,11 @@ public:
      */
     bool hasMidnightPassed();
     
+    /**
+     * Statystyki podstawy czasu (ruch I2C)
+     */
+    RtcTimebaseStats getTimebaseStats() const;
+    
     /**
      * Debug print
      */
@@ -164,6 +322,105 @@ private:
     uint32_t _lastNtpSyncTime;      // millis() ostatniej sync
     uint32_t _lastNtpSyncTimestamp; // Unix timestamp ostatniej sync
     
+    // NTP - maszyna stanów
+    NtpSyncState _ntpState;
+    uint8_t  _ntpRequest;           // Numer żądania (serwer = numer % 3)
+    uint64_t _ntpTxStamp;           // Nasz znacznik transmit (format NTP) - echo w originate
+    uint64_t _ntpTxUnixUs;          // t1 (lokalny czas Unix w us)
+    int64_t  _ntpTxUs;              // esp_timer wysłania
+    int64_t  _ntpBestOffsetUs;
+    uint32_t _ntpBestDelayUs;
+    uint32_t _ntpDelaySumUs;
+    uint32_t _ntpStartMs;
+    int64_t  _ntpApplyUs;           // esp_timer wejścia w APPLY
+    bool     _ntpStepped;           // Dla consumeNtpStep()
+    NtpSyncStats _ntpStats;
+    
+    // Dryf - baza pomiaru od ostatniej zmiany aging / ręcznego setTime()
+    uint32_t _driftRefUnix;         // Początek bazy (0 = brak)
+    uint32_t _driftRefDelayUs;      // RTT synchronizacji otwierającej bazę
+    int64_t  _driftAccumUs;         // Opóźnienie RTC narosłe od początku bazy
+    int64_t  _driftResidualUs;      // Offset pozostawiony przez poprzednią synchronizację
+    uint32_t _resyncIntervalMs;
+    RtcDriftStats  _drift;
+    RtcDriftSample _driftHistory[RTC_DRIFT_HISTORY];
+    uint8_t  _driftHistoryHead;
+    uint8_t  _driftHistoryCount;
+    
+    // Podstawa czasu - seqlock: pisze tylko loop(), czytelnicy bez blokady
+    RtcTimebase _tb;
+    volatile uint32_t _tbSeq;       // Nieparzysty = zapis w toku
+    int64_t  _lastReadUs;           // esp_timer ostatniego odczytu DS3231
+    volatile uint32_t _queries;     // Zapytania o czas (inkrementacja bez blokady)
+    RtcTimebaseStats _stats;
+    
+    // SQW 1 Hz
+    bool     _sqwEnabled;           // Przerwanie podpięte
+    volatile int64_t  _lastEdgeUs;  // esp_timer ostatniego przyjętego zbocza
+    volatile uint32_t _sqwEdges;
+    volatile uint32_t _sqwGlitches;
+    
+    /**
+     * Przerwanie SQW: kotwica na początek nowej sekundy
+     */
+    static void _onSqwEdge(void* arg);
+    
+    /**
+     * Konfiguracja DS3231 (INTCN=0, RS=1 Hz) i przerwania
+     */
+    bool _beginSqw();
+    
+    /**
+     * Odczyt 7 rejestrów czasu z DS3231 (jedyne miejsce czytające czas z I2C)
+     * @param atUs [out] esp_timer chwili odczytu
+     */
+    bool _readTime(TimeInfo* t, int64_t* atUs);
+    
+    /**
+     * Opublikuj nową kotwicę (widoczna atomowo dla wszystkich tasków)
+     */
+    void _setAnchor(uint32_t unixTime, int64_t atUs, bool edgeAligned = false);
+    
+    /**
+     * Spójna kopia kotwicy (bez blokady - ponawia przy równoległym zapisie)
+     */
+    void _loadTimebase(RtcTimebase* tb) const;
+    
+    /**
+     * Sekunda UTC w chwili atUs wg kotwicy
+     */
+    static uint32_t _unixAt(const RtcTimebase& tb, int64_t atUs);
+    
+    /**
+     * Czas Unix w us w chwili atUs wg kotwicy
+     */
+    static uint64_t _unixUsAt(const RtcTimebase& tb, int64_t atUs);
+    
+    /**
+     * Jeden krok maszyny stanów NTP
+     */
+    void _updateNtp();
+    void _ntpSend();
+    void _ntpReceive();
+    void _ntpFinish();
+    
+    /**
+     * Zapis czasu do DS3231 + kotwica (setTime() i NTP)
+     */
+    bool _writeTime(const TimeInfo& time);
+    
+    /**
+     * Rozlicz synchronizację NTP w bazie dryfu, ew. skoryguj aging
+     * @param residualUs offset pozostały po synchronizacji
+     */
+    void _recordDrift(uint32_t unixTime, int64_t offsetUs, uint32_t delayUs,
+                      bool applied, int64_t residualUs);
+    
+    /**
+     * Zapis rejestru aging offset + wymuszenie konwersji temperatury
+     */
+    bool _writeAging(int8_t aging);
+    
     /**
      * Odczyt rejestru RTC
      */
@@ -183,11 +440,6 @@ private:
      * Decimal to BCD
      */
     static uint8_t _dec2bcd(uint8_t dec);
-    
-    /**
-     * Oblicz dzień tygodnia
-     */
-    static uint8_t _calcDayOfWeek(uint16_t year, uint8_t month, uint8_t day);
 };
 
 // ============================================================================
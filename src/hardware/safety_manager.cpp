@@ -6,6 +6,8 @@
 #include "fram_layout.h"
 #include "rtc_controller.h"
 #include "fram_controller.h"
+#include "fram_io_worker.h"
+#include "../core/loop_events.h"
 
 // Global instance
 SafetyManager safetyManager;
@@ -30,8 +32,9 @@ void SafetyManager::begin() {
     digitalWrite(BUZZER_PIN, BUZZER_INACTIVE);
     _buzzerState = false;
     
-    // Reset button - input z pull-up
+    // Reset button - input z pull-up; an edge wakes loop() (polled while held)
     pinMode(RESET_BUTTON_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(RESET_BUTTON_PIN), _onButtonEdge, CHANGE);
     
     // Inicjalizuj strukturę błędu
     memset(&_currentError, 0, sizeof(_currentError));
@@ -213,6 +216,10 @@ void SafetyManager::_updateBuzzerPattern() {
     }
 }
 
+void IRAM_ATTR SafetyManager::_onButtonEdge() {
+    loopEvents.signalFromISR(LOOP_EVENT_WAKE);
+}
+
 void SafetyManager::_handleResetButton() {
     bool buttonPressed = (digitalRead(RESET_BUTTON_PIN) == RESET_BUTTON_ACTIVE);
     unsigned long now = millis();
@@ -277,25 +284,31 @@ void SafetyManager::_takeGpioSnapshot() {
 
 void SafetyManager::_saveErrorToFRAM() {
     // Oblicz CRC
-    _currentError.crc32 = FramController::calculateCRC32(&_currentError, 
-                                          sizeof(CriticalErrorState) - sizeof(uint32_t));
+    FramController::sealRecord<FramSectionId::CRITICAL_ERROR>(&_currentError);
     
-    // Zapisz do FRAM
-    framController.writeBytes(FRAM_ADDR_CRITICAL_ERROR, &_currentError, sizeof(CriticalErrorState));
+    // Zapisz do FRAM - kolejka SAFETY wyprzedza zapisy konfiguracji
+    framIoWorker.submitWrite(FRAM_ADDR_CRITICAL_ERROR, &_currentError, sizeof(CriticalErrorState),
+                             FramIoPriority::SAFETY, _onErrorWritten, nullptr);
+}
+
+void SafetyManager::_onErrorWritten(bool success, void* context) {
+    (void)context;
+    if (!success) {
+        Serial.println(F("[SAFETY] ERROR: Failed to persist error state to FRAM!"));
+    }
 }
 
 void SafetyManager::_loadErrorFromFRAM() {
     CriticalErrorState loaded;
     
-    if (!framController.readBytes(FRAM_ADDR_CRITICAL_ERROR, &loaded, sizeof(CriticalErrorState))) {
+    if (!framController.readRecord<FramSectionId::CRITICAL_ERROR>(0, &loaded)) {
         Serial.println(F("[SAFETY] Failed to read error state from FRAM"));
         memset(&_currentError, 0, sizeof(_currentError));
         return;
     }
     
     // Walidacja CRC
-    uint32_t expectedCrc = FramController::calculateCRC32(&loaded, sizeof(CriticalErrorState) - sizeof(uint32_t));
-    if (loaded.crc32 != expectedCrc) {
+    if (!FramController::verifyRecord<FramSectionId::CRITICAL_ERROR>(loaded)) {
         Serial.println(F("[SAFETY] Error state CRC mismatch - treating as no error"));
         memset(&_currentError, 0, sizeof(_currentError));
         return;
@@ -307,10 +320,10 @@ void SafetyManager::_loadErrorFromFRAM() {
 void SafetyManager::_clearErrorInFRAM() {
     // Zachowaj statystyki, wyczyść tylko flagę aktywnego błędu
     _currentError.active_flag = 0;
-    _currentError.crc32 = FramController::calculateCRC32(&_currentError,
-                                          sizeof(CriticalErrorState) - sizeof(uint32_t));
+    FramController::sealRecord<FramSectionId::CRITICAL_ERROR>(&_currentError);
     
-    framController.writeBytes(FRAM_ADDR_CRITICAL_ERROR, &_currentError, sizeof(CriticalErrorState));
+    framIoWorker.submitWrite(FRAM_ADDR_CRITICAL_ERROR, &_currentError, sizeof(CriticalErrorState),
+                             FramIoPriority::SAFETY, _onErrorWritten, nullptr);
 }
 
 void SafetyManager::_confirmResetBeep() {
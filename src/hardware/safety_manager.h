@@ -63,6 +63,11 @@ public:
     uint8_t getErrorChannel() const { return _currentError.channel; }
     const CriticalErrorState& getErrorState() const { return _currentError; }
     
+    /**
+     * Czy przycisk reset jest trzymany (loop() odpytuje go wtedy często)
+     */
+    bool isButtonPressed() const { return _buttonWasPressed; }
+    
     // --- Status ---
     
     void printStatus() const;
@@ -88,9 +93,11 @@ private:
     void _setBuzzer(bool on);
     void _updateBuzzerPattern();
     void _handleResetButton();
+    static void _onButtonEdge();
     void _saveErrorToFRAM();
     void _loadErrorFromFRAM();
     void _clearErrorInFRAM();
+    static void _onErrorWritten(bool success, void* context);
     void _takeGpioSnapshot();
     void _confirmResetBeep();
 };
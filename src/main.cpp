@@ -13,7 +13,14 @@
 #include "fram_layout.h"
 #include "relay_controller.h"
 #include "fram_controller.h"
+#include "fram_io_worker.h"
+#include "fram_scrubber.h"
 #include "algorithm/channel_manager.h"
+#include "algorithm/system_state_manager.h"
+#include "algorithm/dose_journal.h"
+#include "algorithm/dose_rollup.h"
+#include "algorithm/lifetime_counters.h"
+#include "core/loop_events.h"
 #include "rtc_controller.h"
 #include "dosing_scheduler.h"
 #include "esp_system.h"
@@ -21,6 +28,7 @@
 #include "web_server.h"
 #include <WiFi.h>
 #include <esp_task_wdt.h>
+#include <esp_idf_version.h>
 
 #include "provisioning/prov_detector.h"
 #include "provisioning/ap_core.h"
@@ -42,11 +50,33 @@ volatile bool systemHalted = false;  // volatile: accessed from multiple context
 bool pumpGlobalEnabled = true;
 bool gpioValidationEnabled = GPIO_VALIDATION_DEFAULT;
 InitStatus initStatus;
+static uint32_t loopWakeEvents = 0;  // LOOP_EVENT_* returned by the last loopEvents.wait()
+
+// loop() feeds the task WDT once per pass - the idle sleep must fit well inside it
+static_assert(LOOP_IDLE_PERIOD_MS * 2 <= WDT_TIMEOUT_SECONDS * 1000UL,
+              "LOOP_IDLE_PERIOD_MS must be at most half of WDT_TIMEOUT_SECONDS");
 
 // ============================================================================
 // INITIALIZATION FUNCTIONS
 // ============================================================================
 
+#if !ENABLE_CLI
+/**
+ * Ustaw timeout task WDT na WDT_TIMEOUT_SECONDS (domyślny z SDK to 5 s)
+ */
+static bool configureTaskWdt() {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_task_wdt_config_t config = {};
+    config.timeout_ms = WDT_TIMEOUT_SECONDS * 1000;
+    config.trigger_panic = true;
+    return esp_task_wdt_reconfigure(&config) == ESP_OK;
+#else
+    // IDF 4.x: re-init of the running TWDT updates timeout and panic
+    return esp_task_wdt_init(WDT_TIMEOUT_SECONDS, true) == ESP_OK;
+#endif
+}
+#endif
+
 /**
  * Inicjalizacja hardware: I2C, FRAM, RTC, Relay
  */
@@ -70,6 +100,12 @@ void initHardware() {
         Serial.println(F("FAILED!"));
     }
     
+    // --- FRAM I/O task (zapisy w tle) ---
+    if (initStatus.fram_ok) {
+        Serial.print(F("[INIT] FRAM I/O... "));
+        Serial.println(framIoWorker.begin() ? F("OK") : F("FAILED (sync mode)"));
+    }
+    
         // --- Credentials ---
     Serial.print(F("[INIT] Credentials... "));
     if (initStatus.fram_ok) {
@@ -200,6 +236,14 @@ void initNetwork() {
 void initApplication() {
     Serial.println(F("\n[INIT] === APPLICATION INIT ==="));
     
+    // --- System State (wymaga FRAM, bez FRAM - domyślne w RAM) ---
+    Serial.print(F("[INIT] System State... "));
+    if (systemStateManager.begin()) {
+        Serial.println(F("OK"));
+    } else {
+        Serial.println(F("DEFAULTS"));
+    }
+    
     // --- Channel Manager (wymaga FRAM) ---
     Serial.print(F("[INIT] Channel Manager... "));
     if (initStatus.fram_ok) {
@@ -215,6 +259,35 @@ void initApplication() {
         Serial.println(F("SKIPPED (no FRAM)"));
     }
     
+    // --- Dose Journal (wymaga FRAM) ---
+    Serial.print(F("[INIT] Dose Journal... "));
+    if (initStatus.fram_ok && doseJournal.begin()) {
+        Serial.printf("OK (%d records)\n", doseJournal.getCount());
+    } else {
+        Serial.println(F("DISABLED"));
+    }
+    
+    // --- Dose Rollups (wymaga FRAM, RTC opcjonalnie) ---
+    Serial.print(F("[INIT] Dose Rollups... "));
+    uint32_t rollupTime = initStatus.rtc_ok ? rtcController.getUnixTime() : 0;
+    Serial.println(doseRollup.begin(rollupTime) ? F("OK") : F("DISABLED"));
+    
+    // --- Lifetime Counters (wymaga FRAM) ---
+    Serial.print(F("[INIT] Lifetime Counters... "));
+    if (initStatus.fram_ok && lifetimeCounters.begin()) {
+        Serial.println(F("OK"));
+    } else {
+        Serial.println(F("DISABLED"));
+    }
+    
+    // --- FRAM Scrubber (po ChannelManager - naprawa z kopii RAM) ---
+    Serial.print(F("[INIT] FRAM Scrubber... "));
+    if (initStatus.fram_ok && framScrubber.begin()) {
+        Serial.println(F("OK"));
+    } else {
+        Serial.println(F("DISABLED"));
+    }
+    
     // --- Dosing Scheduler (wymaga RTC + ChannelManager) ---
     Serial.print(F("[INIT] Scheduler... "));
     if (initStatus.rtc_ok && initStatus.channel_manager_ok) {
@@ -341,6 +414,7 @@ void setup() {
     Serial.println(F("╚══════════════════════════════════════════════════════════╝"));
     
     // === INITIALIZATION SEQUENCE ===
+    loopEvents.begin();     // Before the scheduler timer / button interrupt signal loop()
     initHardware();
     initNetwork();
     initApplication();
@@ -360,6 +434,8 @@ void setup() {
         
         // Po resecie - restart systemu
         Serial.println(F("[MAIN] Error cleared - restarting..."));
+        lifetimeCounters.flush();
+        framIoWorker.flush(1000);
         delay(1000);
         ESP.restart();
     }
@@ -373,8 +449,11 @@ void setup() {
 // === WATCHDOG TIMER (production only) ===
     #if !ENABLE_CLI
     Serial.print(F("[INIT] Watchdog Timer... "));
-    if (esp_task_wdt_add(NULL) == ESP_OK) {
-        Serial.println(F("OK (subscribed to default WDT)"));
+    if (!configureTaskWdt()) {
+        // Not subscribed: the idle sleep would overrun the SDK default timeout
+        Serial.println(F("SKIPPED (timeout not set)"));
+    } else if (esp_task_wdt_add(NULL) == ESP_OK) {
+        Serial.printf("OK (%d s)\n", WDT_TIMEOUT_SECONDS);
     } else {
         Serial.println(F("SKIPPED"));
     }
@@ -424,10 +503,29 @@ if (framController.writeContainerVolume(0, &testVol)) {
 // ============================================================================
 
 void loop() {
+    // Events that ended the previous sleep
+    uint32_t events = loopWakeEvents;
+    loopWakeEvents = 0;
+
     // === CRITICAL: Always update relay (safety) ===
     safetyManager.update();
     relayController.update();
 
+    // === Lifetime counters (also while halted - failures must persist) ===
+    lifetimeCounters.update();
+
+    // === RTC timebase (one DS3231 read per second; timestamps also while halted) ===
+    rtcController.update();
+
+    // === Deferred restart requested by the web API (FRAM restore) ===
+    if (isWebRestartDue()) {
+        Serial.println(F("[REBOOT] Restart requested by web API"));
+        relayController.allOff();
+        lifetimeCounters.flush();
+        framIoWorker.flush(1000);
+        ESP.restart();
+    }
+
     if (safetyManager.isCriticalErrorActive()) {
         // Zatrzymaj wszelkie operacje
         // (relay_controller powinien już być zatrzymany przez triggerCriticalError)
@@ -467,24 +565,32 @@ void loop() {
         // Update GPIO validator
     // gpioValidator.update();
     
-    // === NTP Resync (hourly) ===
+    // === NTP Resync (hourly, advanced step by step in rtcController.update()) ===
     static uint32_t lastNtpCheck = 0;
     if (millis() - lastNtpCheck > 60000) {  // Check every minute
         lastNtpCheck = millis();
 
-        if (initStatus.wifi_ok && initStatus.rtc_ok && rtcController.needsResync()) {
+        if (initStatus.wifi_ok && initStatus.rtc_ok &&
+            !rtcController.isNtpSyncing() && rtcController.needsResync()) {
             Serial.println(F("[MAIN] NTP resync due..."));
-            if (rtcController.syncNTPWithRetry()) {
-                // CRITICAL: Sync scheduler state BEFORE update() to prevent
-                // false daily reset detection due to time jump
-                dosingScheduler.syncTimeState();
-            }
+            rtcController.startNtpSync();
         }
     }
 
+    if (rtcController.consumeNtpStep()) {
+        // CRITICAL: Sync scheduler state BEFORE update() to prevent
+        // false daily reset detection due to time jump
+        dosingScheduler.syncTimeState();
+    }
+
     // Update scheduler (main dosing logic)
     if (initStatus.scheduler_ok) {
-        dosingScheduler.update();
+        dosingScheduler.update(events & LOOP_EVENT_SCHEDULE);
+    }
+    
+    // === FRAM CRC scrub (bounded slice per loop pass) ===
+    if (initStatus.fram_ok) {
+        framScrubber.update();
     }
     
     // === CLI (debug only) ===
@@ -497,11 +603,11 @@ void loop() {
     static uint32_t lastStatusPrint = 0;
     if (relayController.isAnyOn() && (millis() - lastStatusPrint > 1000)) {
         lastStatusPrint = millis();
-        uint8_t ch = relayController.getActiveChannel();
-        uint32_t runtime = relayController.getActiveRuntime();
-        uint32_t remaining = relayController.getRemainingTime();
-        Serial.printf("[STATUS] CH%d running: %lu ms (remaining: %lu ms)\n",
-                      ch, runtime, remaining);
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+            if (!relayController.isChannelBusy(ch)) continue;
+            Serial.printf("[STATUS] CH%d running: %lu ms (remaining: %lu ms)\n",
+                          ch, relayController.getRuntime(ch), relayController.getRemainingTime(ch));
+        }
     }
     #endif
 
@@ -510,13 +616,19 @@ void loop() {
     static uint32_t lastHeartbeat = 0;
     if (millis() - lastHeartbeat > 60000) {  // Co 1 minutę
         lastHeartbeat = millis();
-        Serial.printf("[HEARTBEAT] Uptime: %lu min, Scheduler: %s\n",
+        Serial.printf("[HEARTBEAT] Uptime: %lu min, Scheduler: %s, Loop: %lu wakeups/h, CPU %.3f%%\n",
                       millis() / 60000,
-                      dosingScheduler.isEnabled() ? "ON" : "OFF");
+                      dosingScheduler.isEnabled() ? "ON" : "OFF",
+                      loopEvents.getWakeupsPerHour(), loopEvents.getLoadPercent());
     }
     #endif
     
-    delay(10);
+    // === Sleep until the next event or period (no wakeups just to read the clock) ===
+    bool busy = relayController.isAnyOn() || relayController.isValidating() ||
+                dosingScheduler.isDosingActive() || framScrubber.isScrubbing() ||
+                rtcController.isNtpSyncing() || safetyManager.isButtonPressed() ||
+                isWebRestartPending();
+    loopWakeEvents = loopEvents.wait(busy ? LOOP_ACTIVE_PERIOD_MS : LOOP_IDLE_PERIOD_MS);
 }
 
 // ============================================================================
@@ -9,8 +9,15 @@
 #include "../security/session_manager.h"
 #include "../security/auth_manager.h"
 #include "../algorithm/channel_manager.h"
+#include "../algorithm/dose_journal.h"
+#include "../algorithm/dose_rollup.h"
+#include "../algorithm/lifetime_counters.h"
 #include "../hardware/dosing_scheduler.h"
 #include "../hardware/rtc_controller.h"
+#include "../hardware/fram_controller.h"
+#include "../hardware/fram_backup.h"
+#include "../hardware/fram_scrubber.h"
+#include "../core/loop_events.h"
 
 // ============================================================================
 // SERVER INSTANCE
@@ -18,6 +25,10 @@
 AsyncWebServer server(80);
 bool serverRunning = false;
 
+// Restart requested by an API call (0 = none), delayed so the response goes out
+#define WEB_RESTART_DELAY_MS    1000
+static uint32_t restartRequestedAt = 0;
+
 // ============================================================================
 // SESSION HELPERS
 // ============================================================================
@@ -121,10 +132,12 @@ void handleApiDosingStatus(AsyncWebServerRequest* request) {
         doc["activeChannel"] = relayController.getActiveChannel();
         doc["activeEventHour"] = dosingScheduler.getCurrentEvent().hour;
         doc["activeRemainingMs"] = relayController.getRemainingTime();
+        doc["activePumps"] = relayController.getActiveCount();
     } else {
         doc["activeChannel"] = -1;
         doc["activeEventHour"] = -1;
         doc["activeRemainingMs"] = 0;
+        doc["activePumps"] = 0;
     }
     
     // Time
@@ -335,8 +348,8 @@ void handleApiCalibrate(AsyncWebServerRequest* request) {
     
     Serial.printf("[WEB] Calibration request CH%d\n", channel);
     
-    // Check if any pump already running
-    if (relayController.isAnyOn()) {
+    // Check if this pump already running (others may run within the power budget)
+    if (relayController.isChannelBusy(channel)) {
         request->send(409, "application/json", "{\"success\":false,\"error\":\"Pump busy\"}");
         return;
     }
@@ -350,7 +363,10 @@ void handleApiCalibrate(AsyncWebServerRequest* request) {
         String errJson = "{\"success\":false,\"error\":\"";
         errJson += RelayController::resultToString(res);
         errJson += "\"}";
-        request->send(500, "application/json", errJson);
+        // No free slot / current budget is a conflict, not a device failure
+        bool conflict = (res == RelayResult::ERROR_MUTEX_LOCKED ||
+                         res == RelayResult::ERROR_POWER_BUDGET);
+        request->send(conflict ? 409 : 500, "application/json", errJson);
         return;
     }
     
@@ -439,8 +455,8 @@ void handleApiManualDose(AsyncWebServerRequest* request) {
         return;
     }
     
-    // Check if pump busy
-    if (relayController.isAnyOn()) {
+    // Check if pump busy (the scheduler tracks one dose at a time)
+    if (relayController.isChannelBusy(channel) || dosingScheduler.isDosingActive()) {
         request->send(409, "application/json", "{\"success\":false,\"error\":\"Pump busy\"}");
         return;
     }
@@ -492,6 +508,380 @@ void handleApiDailyReset(AsyncWebServerRequest* request) {
     Serial.printf("[WEB] Daily reset: %s\n", success ? "OK" : "FAILED");
 }
 
+// ============================================================================
+// API: DOSE JOURNAL (GET) - Dosing history
+// /api/dose-journal?last=20  - ostatnie N eventów (od najnowszego)
+// /api/dose-journal?day=N    - eventy z dnia UTC N (dni od epoch)
+// ============================================================================
+
+#define JOURNAL_API_MAX_RECORDS     32
+
+void handleApiDoseJournal(AsyncWebServerRequest* request) {
+    if (!isAuthenticated(request)) {
+        request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    if (!doseJournal.isReady()) {
+        request->send(503, "application/json", "{\"error\":\"Journal not available\"}");
+        return;
+    }
+    
+    DoseJournalRecord records[JOURNAL_API_MAX_RECORDS];
+    uint16_t count;
+    bool byDay = request->hasParam("day");
+    
+    if (byDay) {
+        uint32_t day = request->getParam("day")->value().toInt();
+        count = doseJournal.readDay(day, records, JOURNAL_API_MAX_RECORDS);
+    } else {
+        int last = request->hasParam("last") ? request->getParam("last")->value().toInt() : 20;
+        if (last < 1) last = 1;
+        if (last > JOURNAL_API_MAX_RECORDS) last = JOURNAL_API_MAX_RECORDS;
+        count = doseJournal.readLast(last, records);
+    }
+    
+    JsonDocument doc;
+    doc["total"] = doseJournal.getCount();
+    doc["capacity"] = JOURNAL_CAPACITY;
+    
+    JsonArray list = doc["records"].to<JsonArray>();
+    
+    for (uint16_t i = 0; i < count; i++) {
+        const DoseJournalRecord& rec = records[i];
+        if (!DoseJournal::isValid(rec)) continue;
+        
+        JsonObject e = list.add<JsonObject>();
+        e["ts"] = rec.timestamp;
+        e["channel"] = rec.channel;
+        e["hour"] = rec.hour;
+        e["ok"] = (rec.status == EVENT_COMPLETED);
+        e["validation"] = rec.validation;
+        e["targetMl"] = rec.getTargetMl();
+        e["runMs"] = rec.getRunTimeMs();
+        e["remainingMl"] = rec.getRemainingMl();
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+// ============================================================================
+// API: DOSE HISTORY (GET) - Totals over last N days from rollups
+// /api/dose-history?channel=2&days=90
+// ============================================================================
+
+void handleApiDoseHistory(AsyncWebServerRequest* request) {
+    if (!isAuthenticated(request)) {
+        request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    if (!request->hasParam("channel")) {
+        request->send(400, "application/json", "{\"error\":\"Missing channel\"}");
+        return;
+    }
+    
+    uint8_t channel = request->getParam("channel")->value().toInt();
+    int days = request->hasParam("days") ? request->getParam("days")->value().toInt() : 30;
+    
+    if (channel >= CHANNEL_COUNT || days < 1 || days > 3650) {
+        request->send(400, "application/json", "{\"error\":\"Invalid parameters\"}");
+        return;
+    }
+    
+    RollupTotals totals;
+    if (!doseRollup.getTotals(channel, days, rtcController.getUnixTime(), &totals)) {
+        request->send(503, "application/json", "{\"error\":\"History not available\"}");
+        return;
+    }
+    
+    static const char* const TABLES[] = { "daily", "weekly", "monthly" };
+    
+    JsonDocument doc;
+    doc["channel"] = channel;
+    doc["days"] = days;
+    doc["coveredDays"] = totals.covered_days;
+    doc["resolution"] = TABLES[totals.table];
+    doc["totalMl"] = totals.total_ml;
+    doc["ok"] = totals.ok_count;
+    doc["failed"] = totals.fail_count;
+    doc["pumpSeconds"] = totals.pump_seconds;
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+// ============================================================================
+// API: FRAM STATS (GET) - Per-section I/O counters + latency histograms
+// ============================================================================
+
+void handleApiFramStats(AsyncWebServerRequest* request) {
+    if (!isAuthenticated(request)) {
+        request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    JsonDocument doc;
+    
+    const FramIoStats& io = framController.getIoStats();
+    doc["transactions"] = io.transactions;
+    doc["bytesRead"] = io.bytes_read;
+    doc["bytesWritten"] = io.bytes_written;
+    doc["mirrorReads"] = io.mirror_reads;
+    doc["mirrorBytes"] = io.mirror_bytes;
+    
+    FramMirrorStats ms;
+    if (framController.getMirrorStats(&ms)) {
+        JsonObject mirror = doc["mirror"].to<JsonObject>();
+        mirror["active"] = ms.active;
+        mirror["pageSize"] = FRAM_MIRROR_PAGE_SIZE;
+        mirror["dirtyPages"] = ms.dirty_pages;
+        mirror["loadUs"] = ms.load_us;
+        mirror["checks"] = ms.checks;
+        mirror["pagesChecked"] = ms.pages_checked;
+        mirror["divergentPages"] = ms.divergent_pages;
+        mirror["writeFailures"] = ms.write_failures;
+    }
+    
+    const FramScrubStats& scrub = framScrubber.getStats();
+    JsonObject sc = doc["scrub"].to<JsonObject>();
+    sc["scrubbing"] = framScrubber.isScrubbing();
+    sc["passes"] = scrub.passes;
+    sc["lastPassMs"] = scrub.last_pass_ms;
+    sc["passRecords"] = scrub.pass_records;
+    sc["totalRecords"] = scrub.total_records;
+    sc["recordsChecked"] = scrub.records_checked;
+    sc["crcErrors"] = scrub.crc_errors;
+    sc["repaired"] = scrub.repaired;
+    sc["unrepaired"] = scrub.unrepaired;
+    sc["mirrorFixes"] = scrub.mirror_fixes;
+    sc["deferred"] = scrub.deferred;
+    sc["overBudget"] = scrub.over_budget;
+    sc["maxSliceUs"] = scrub.max_slice_us;
+    sc["budgetUs"] = FRAM_SCRUB_BUDGET_US;
+    
+    // Upper bound of each bucket in us, 0 = open-ended last bucket
+    JsonArray limits = doc["bucketLimitsUs"].to<JsonArray>();
+    for (uint8_t b = 0; b < FRAM_LATENCY_BUCKETS; b++) {
+        limits.add(FramController::latencyBucketLimit(b));
+    }
+    
+    JsonArray sections = doc["sections"].to<JsonArray>();
+    
+    for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+        FramSectionStats st;
+        if (!framController.getSectionStats(i, &st)) {
+            request->send(503, "application/json", "{\"error\":\"FRAM busy\"}");
+            return;
+        }
+        
+        JsonObject e = sections.add<JsonObject>();
+        e["name"] = FRAM_SECTION_INFO[i].name;
+        e["address"] = FRAM_SECTION_INFO[i].address;
+        e["reads"] = st.reads;
+        e["writes"] = st.writes;
+        e["bytesRead"] = st.bytes_read;
+        e["bytesWritten"] = st.bytes_written;
+        e["mirrorReads"] = st.mirror_reads;
+        e["failures"] = st.failures;
+        e["retries"] = st.retries;
+        e["scrubErrors"] = framScrubber.getSectionErrors(i);
+        e["maxUs"] = st.max_us;
+        e["totalUs"] = st.total_us;
+        
+        JsonArray rh = e["readHist"].to<JsonArray>();
+        JsonArray wh = e["writeHist"].to<JsonArray>();
+        for (uint8_t b = 0; b < FRAM_LATENCY_BUCKETS; b++) {
+            rh.add(st.read_hist[b]);
+            wh.add(st.write_hist[b]);
+        }
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+// ============================================================================
+// API: LIFETIME COUNTERS (GET) - Persistent per-channel and request totals
+// ============================================================================
+
+void handleApiCounters(AsyncWebServerRequest* request) {
+    if (!isAuthenticated(request)) {
+        request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    JsonDocument doc;
+    doc["ready"] = lifetimeCounters.isReady();
+    doc["webRequests"] = (uint32_t)lifetimeCounters.get(COUNTER_WEB_REQUESTS);
+    doc["generation"] = lifetimeCounters.getGeneration();
+    doc["logUsed"] = lifetimeCounters.getLogUsed();
+    doc["logSize"] = LIFETIME_COUNTER_LOG_SIZE;
+    
+    JsonArray channels = doc["channels"].to<JsonArray>();
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+        JsonObject c = channels.add<JsonObject>();
+        c["activations"] = (uint32_t)lifetimeCounters.get(COUNTER_ACTIVATIONS + ch);
+        c["pumpSeconds"] = (uint32_t)(lifetimeCounters.get(COUNTER_PUMP_MS + ch) / 1000);
+        c["validationFailures"] = (uint32_t)lifetimeCounters.get(COUNTER_VALIDATION_FAIL + ch);
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+// ============================================================================
+// API: TIME STATS (GET) - Timebase, NTP and DS3231 drift discipline
+// ============================================================================
+
+void handleApiTimeStats(AsyncWebServerRequest* request) {
+    if (!isAuthenticated(request)) {
+        request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    JsonDocument doc;
+    doc["unixTime"] = rtcController.getUnixTime();
+    doc["sqwActive"] = rtcController.isSqwActive();
+    
+    RtcTimebaseStats tb = rtcController.getTimebaseStats();
+    JsonObject t = doc["timebase"].to<JsonObject>();
+    t["queries"] = tb.queries;
+    t["busReads"] = tb.bus_reads;
+    t["busErrors"] = tb.bus_errors;
+    t["corrections"] = tb.corrections;
+    t["steps"] = tb.steps;
+    t["sqwEdges"] = tb.sqw_edges;
+    t["sqwGlitches"] = tb.sqw_glitches;
+    
+    const NtpSyncStats& ns = rtcController.getNtpStats();
+    JsonObject n = doc["ntp"].to<JsonObject>();
+    n["syncs"] = ns.syncs;
+    n["failures"] = ns.failures;
+    n["offsetUs"] = (int32_t)constrain(ns.offset_us, (int64_t)INT32_MIN, (int64_t)INT32_MAX);
+    n["delayUs"] = ns.delay_us;
+    n["applied"] = ns.applied;
+    
+    const RtcDriftStats& ds = rtcController.getDriftStats();
+    JsonObject d = doc["drift"].to<JsonObject>();
+    d["ppm"] = ds.drift_ppm;
+    d["uncertaintyPpm"] = ds.uncertainty_ppm;
+    d["expectedPpm"] = ds.expected_ppm;
+    d["aging"] = ds.aging;
+    d["agingChanges"] = ds.aging_changes;
+    d["baselineS"] = ds.baseline_s;
+    d["resyncIntervalS"] = ds.resync_interval_s;
+    
+    RtcDriftSample history[RTC_DRIFT_HISTORY];
+    uint8_t count = rtcController.getDriftHistory(history, RTC_DRIFT_HISTORY);
+    JsonArray h = d["history"].to<JsonArray>();
+    for (uint8_t i = 0; i < count; i++) {
+        JsonObject s = h.add<JsonObject>();
+        s["time"] = history[i].unix_time;
+        s["offsetUs"] = history[i].offset_us;
+        s["delayUs"] = history[i].delay_us;
+        s["aging"] = history[i].aging;
+        s["applied"] = history[i].applied;
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+// ============================================================================
+// API: FRAM BACKUP (GET) - Binary download, streamed from FRAM
+// /api/fram-backup?sections=config | all | CONFIG_A,CONFIG_B,...
+// ============================================================================
+
+void handleApiFramBackup(AsyncWebServerRequest* request) {
+    if (!isAuthenticated(request)) {
+        request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    String list = request->hasParam("sections") ? request->getParam("sections")->value() : "";
+    uint32_t mask = FramBackup::parseSections(list.c_str());
+    if (mask == 0) {
+        request->send(400, "application/json", "{\"error\":\"Unknown or private section\"}");
+        return;
+    }
+    
+    // Generator state travels with the response - a few dozen bytes, no file buffer
+    FramBackupStream stream(mask, rtcController.getUnixTime());
+    size_t length = stream.length();
+    
+    AsyncWebServerResponse* response = request->beginResponse("application/octet-stream", length,
+        [stream](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+            return stream.read(buffer, maxLen, index);
+        });
+    response->addHeader("Content-Disposition", "attachment; filename=\"dozownik-fram.bin\"");
+    request->send(response);
+    
+    Serial.printf("[WEB] FRAM backup: %u B (sections 0x%06lX)\n", (unsigned)length, (unsigned long)mask);
+}
+
+// ============================================================================
+// API: FRAM RESTORE (POST) - Binary upload, staged in FRAM, applied on reboot
+// ============================================================================
+
+void handleApiFramRestore(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+    // Nothing touches FRAM before the session is checked
+    if (index == 0 && isAuthenticated(request)) {
+        framBackup.beginRestore(request, total);
+    }
+    
+    // Each chunk goes straight to the staging area
+    framBackup.writeRestore(request, data, len, index);
+    
+    if (index + len < total) {
+        return;
+    }
+    
+    if (!isAuthenticated(request)) {
+        request->send(401, "application/json", "{\"success\":false,\"error\":\"Unauthorized\"}");
+        return;
+    }
+    
+    FramRestoreResult result = framBackup.finishRestore(request, rtcController.getUnixTime());
+    
+    JsonDocument doc;
+    doc["success"] = (result == RESTORE_OK);
+    
+    if (result != RESTORE_OK) {
+        doc["error"] = FramBackup::resultToString(result);
+        if (framBackup.getErrorSection() < FRAM_SECTION_COUNT) {
+            doc["section"] = FRAM_SECTION_INFO[framBackup.getErrorSection()].name;
+        }
+        
+        int code = 400;
+        if (result == RESTORE_BUSY) code = 409;
+        else if (result == RESTORE_TOO_LARGE) code = 413;
+        else if (result == RESTORE_IO_ERROR) code = 500;
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(code, "application/json", response);
+        return;
+    }
+    
+    doc["restarting"] = true;
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+    
+    // Sections are copied into place on the next boot, before anything loads them
+    restartRequestedAt = millis() | 1;
+    loopEvents.signal(LOOP_EVENT_WAKE);
+    Serial.println(F("[WEB] FRAM restore staged - restarting"));
+}
+
 // ============================================================================
 // API: CONTAINER VOLUME - Get container status
 // ============================================================================
@@ -699,6 +1089,12 @@ void initWebServer() {
     initSessionManager();
     initAuthManager();
     
+    // === REQUEST COUNTER (every request, before routing) ===
+    server.addMiddleware([](AsyncWebServerRequest* request, ArMiddlewareNext next) {
+        lifetimeCounters.add(COUNTER_WEB_REQUESTS, 1, false);
+        next();
+    });
+    
     // === PAGE ROUTES ===
     server.on("/", HTTP_GET, handleRoot);
     server.on("/login", HTTP_GET, handleLogin);
@@ -718,6 +1114,17 @@ void initWebServer() {
     server.on("/api/container-volume", HTTP_POST, [](AsyncWebServerRequest* request){}, NULL, handleApiContainerVolumeSet);
     server.on("/api/refill", HTTP_POST, handleApiRefill);
     server.on("/api/reset-dosed", HTTP_POST, handleApiResetDosed);
+    server.on("/api/dose-journal", HTTP_GET, handleApiDoseJournal);
+    server.on("/api/dose-history", HTTP_GET, handleApiDoseHistory);
+    server.on("/api/fram-stats", HTTP_GET, handleApiFramStats);
+    server.on("/api/counters", HTTP_GET, handleApiCounters);
+    server.on("/api/time-stats", HTTP_GET, handleApiTimeStats);
+    server.on("/api/fram-backup", HTTP_GET, handleApiFramBackup);
+    server.on("/api/fram-restore", HTTP_POST, [](AsyncWebServerRequest* request){
+        if (request->contentLength() == 0) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"Empty body\"}");
+        }
+    }, NULL, handleApiFramRestore);
 
     // === 404 HANDLER ===
     server.onNotFound(handleNotFound);
@@ -732,4 +1139,12 @@ void initWebServer() {
 
 bool isWebServerRunning() {
     return serverRunning;
-}
\ No newline at end of file
+}
+
+bool isWebRestartDue() {
+    return restartRequestedAt != 0 && millis() - restartRequestedAt >= WEB_RESTART_DELAY_MS;
+}
+
+bool isWebRestartPending() {
+    return restartRequestedAt != 0;
+}
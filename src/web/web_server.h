@@ -22,4 +22,15 @@ void initWebServer();
  */
 bool isWebServerRunning();
 
+/**
+ * Czy API zażądało restartu (np. po przywróceniu FRAM) i odpowiedź już wyszła
+ * Wołane z loop() - restart wykonuje main.cpp.
+ */
+bool isWebRestartDue();
+
+/**
+ * Czy restart czeka na wysłanie odpowiedzi (loop() nie zasypia na długo)
+ */
+bool isWebRestartPending();
+
 #endif // WEB_SERVER_H
\ No newline at end of file
@@ -0,0 +1,782 @@
+/**
+ * DOZOWNIK - FRAM Image Tool (host)
+ *
+ * Offline decoding of 32 kB FRAM images. Built from the firmware's own
+ * fram_layout.h / dosing_types.h / crc32.cpp, so section addresses, record
+ * types and CRC rules always match the firmware it is compiled with.
+ *
+ *   fram_image info   IMAGE              header, section map, CRC summary
+ *   fram_image verify [-q] IMAGE...      batch CRC check, one line per image
+ *   fram_image dump   [--json] IMAGE...  decoded records (JSON: one object per line)
+ *   fram_image diff   IMAGE_A IMAGE_B    field-level differences
+ *
+ * IMAGE is either a raw 32768-byte binary or a serial log containing
+ * FramController::dumpSection() output. Bytes missing from a log are
+ * reported as "missing" and never counted as CRC errors.
+ *
+ * Exit code: 0 = ok / identical, 1 = CRC errors / differences, 2 = usage or I/O error
+ */
+
+#include <string>
+#include <vector>
+#include "fram_layout.h"
+#include "crc32.h"
+
+HostSerial Serial;
+
+// Same table as the firmware (fram_controller.cpp)
+const FramSectionInfo FRAM_SECTION_INFO[FRAM_SECTION_COUNT] = {
+    FRAM_SECTIONS(FRAM_SECTION_INFO_ENTRY, FRAM_SECTION_INFO_ENTRY)
+};
+
+#define EXIT_OK             0
+#define EXIT_FAILED         1
+#define EXIT_USAGE          2
+
+#define VERIFY_MAX_LISTED   4       // Bad records named per image in verify
+
+// ============================================================================
+// IMAGE LOADING
+// ============================================================================
+
+struct FramImage {
+    std::string path;
+    uint8_t bytes[FRAM_SIZE_BYTES];
+    uint8_t present[FRAM_SIZE_BYTES];       // 0 = not in the serial log
+    bool    partial;
+};
+
+static bool isHex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
+}
+
+static uint8_t hexValue(char c) {
+    if (c <= '9') return c - '0';
+    return (c | 0x20) - 'a' + 10;
+}
+
+// "  0420: 01 00 FF ...  |...|" lines from dumpSection(), anything else is skipped
+static void parseDumpLine(const char* line, FramImage* image) {
+    while (*line == ' ' || *line == '\t') line++;
+
+    for (int i = 0; i < 4; i++) {
+        if (!isHex(line[i])) return;
+    }
+    if (line[4] != ':') return;
+
+    uint32_t address = 0;
+    for (int i = 0; i < 4; i++) address = (address << 4) | hexValue(line[i]);
+
+    const char* p = line + 5;
+    for (int i = 0; i < 16 && address < FRAM_SIZE_BYTES; i++) {
+        if (p[0] != ' ' || !isHex(p[1]) || !isHex(p[2])) break;
+        image->bytes[address] = (hexValue(p[1]) << 4) | hexValue(p[2]);
+        image->present[address] = 1;
+        address++;
+        p += 3;
+    }
+}
+
+static bool loadImage(const char* path, FramImage* image) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    std::string data;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.append(buf, n);
+    fclose(f);
+
+    image->path = path;
+
+    if (data.size() == FRAM_SIZE_BYTES) {
+        memcpy(image->bytes, data.data(), FRAM_SIZE_BYTES);
+        memset(image->present, 1, FRAM_SIZE_BYTES);
+        image->partial = false;
+        return true;
+    }
+
+    memset(image->bytes, 0xFF, FRAM_SIZE_BYTES);
+    memset(image->present, 0, FRAM_SIZE_BYTES);
+
+    size_t start = 0;
+    while (start < data.size()) {
+        size_t end = data.find('\n', start);
+        if (end == std::string::npos) end = data.size();
+        parseDumpLine(data.substr(start, end - start).c_str(), image);
+        start = end + 1;
+    }
+
+    size_t found = 0;
+    for (size_t i = 0; i < FRAM_SIZE_BYTES; i++) found += image->present[i];
+    if (found == 0) {
+        fprintf(stderr, "%s: not a %u-byte image and no dump lines found\n",
+                path, (unsigned)FRAM_SIZE_BYTES);
+        return false;
+    }
+
+    image->partial = (found != FRAM_SIZE_BYTES);
+    return true;
+}
+
+static bool isPresent(const FramImage& image, uint32_t address, uint32_t length) {
+    if (!image.partial) return true;
+    for (uint32_t i = 0; i < length; i++) {
+        if (!image.present[address + i]) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// RECORD CRC (same rules as FramController::_verifyRecord)
+// ============================================================================
+
+enum RecordStatus : uint8_t {
+    REC_OK      = 0,    // CRC over all bytes except the CRC field
+    REC_PREFIX  = 1,    // CRC over bytes in front of the field (pre-section-table records)
+    REC_LEGACY  = 2,    // Prefix CRC from the old table with the bad entry 245
+    REC_EMPTY   = 3,    // All 0x00 / 0xFF - never written or cleared
+    REC_BAD     = 4,
+    REC_NO_CRC  = 5,    // Section without a CRC field
+    REC_MISSING = 6,    // Not covered by the serial log
+    REC_STATUS_COUNT
+};
+
+static const char* const STATUS_NAMES[REC_STATUS_COUNT] = {
+    "ok", "prefix", "legacy", "empty", "BAD", "-", "missing"
+};
+
+static bool isValidStatus(RecordStatus status) {
+    return status == REC_OK || status == REC_PREFIX || status == REC_LEGACY;
+}
+
+static uint32_t recordAddress(const FramSectionInfo& s, uint16_t index) {
+    return s.address + (uint32_t)index * s.recordSize;
+}
+
+static RecordStatus recordStatus(const FramImage& image, const FramSectionInfo& s, uint16_t index) {
+    uint32_t address = recordAddress(s, index);
+    if (!isPresent(image, address, s.recordSize)) return REC_MISSING;
+    if (s.crcOffset == FRAM_NO_CRC) return REC_NO_CRC;
+
+    const uint8_t* rec = image.bytes + address;
+
+    bool zeros = true;
+    bool ones = true;
+    for (uint16_t i = 0; i < s.recordSize; i++) {
+        zeros &= (rec[i] == 0x00);
+        ones &= (rec[i] == 0xFF);
+    }
+    if (zeros || ones) return REC_EMPTY;
+
+    uint32_t stored = 0;
+    memcpy(&stored, rec + s.crcOffset, s.crcSize);
+    uint32_t mask = (s.crcSize >= 4) ? 0xFFFFFFFFUL : ((1UL << (s.crcSize * 8)) - 1);
+
+    Crc32 crc;
+    crc.update(rec, s.crcOffset);
+    crc.update(rec + s.crcOffset + s.crcSize, s.recordSize - s.crcOffset - s.crcSize);
+    if (((crc.value() ^ stored) & mask) == 0) return REC_OK;
+
+    if (((Crc32::compute(rec, s.crcOffset) ^ stored) & mask) == 0) return REC_PREFIX;
+    if (((Crc32::computeLegacy(rec, s.crcOffset) ^ stored) & mask) == 0) return REC_LEGACY;
+
+    return REC_BAD;
+}
+
+struct SectionSummary {
+    uint32_t counts[REC_STATUS_COUNT];
+};
+
+static void summarizeSection(const FramImage& image, uint8_t section, SectionSummary* summary) {
+    const FramSectionInfo& s = FRAM_SECTION_INFO[section];
+    memset(summary, 0, sizeof(*summary));
+    for (uint16_t i = 0; i < s.count; i++) {
+        summary->counts[recordStatus(image, s, i)]++;
+    }
+}
+
+// ============================================================================
+// FIELD DECODING
+// ============================================================================
+
+struct Field {
+    std::string name;
+    std::string value;
+    bool quoted;            // JSON string (hex, enum names)
+};
+
+typedef std::vector<Field> Fields;
+
+static void addField(Fields& fields, const char* name, const char* value, bool quoted) {
+    Field f;
+    f.name = name;
+    f.value = value;
+    f.quoted = quoted;
+    fields.push_back(f);
+}
+
+static void addUint(Fields& fields, const char* name, uint32_t value) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%lu", (unsigned long)value);
+    addField(fields, name, buf, false);
+}
+
+static void addUint64(Fields& fields, const char* name, uint64_t value) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%llu", (unsigned long long)value);
+    addField(fields, name, buf, false);
+}
+
+static void addHex(Fields& fields, const char* name, uint32_t value, int digits) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "0x%0*lX", digits, (unsigned long)value);
+    addField(fields, name, buf, true);
+}
+
+static void addFloat(Fields& fields, const char* name, float value) {
+    char buf[32];
+    if (isfinite(value)) {
+        snprintf(buf, sizeof(buf), "%.6g", value);
+        addField(fields, name, buf, false);
+    } else {
+        addField(fields, name, "null", false);     // Corrupt float - JSON has no NaN
+    }
+}
+
+static void addText(Fields& fields, const char* name, const char* value) {
+    addField(fields, name, value, true);
+}
+
+static void describe(const FramHeader& h, Fields& f) {
+    addHex(f, "magic", h.magic, 8);
+    addUint(f, "layout_version", h.layout_version);
+    addUint(f, "channel_count", h.channel_count);
+    addUint(f, "init_timestamp", h.init_timestamp);
+    addUint(f, "last_write", h.last_write);
+    addHex(f, "flags", h.flags, 2);
+    addHex(f, "header_crc", h.header_crc, 8);
+}
+
+static void describe(const SystemState& s, Fields& f) {
+    addUint(f, "system_enabled", s.system_enabled);
+    addUint(f, "system_halted", s.system_halted);
+    addUint(f, "active_channel", s.active_channel);
+    addUint(f, "active_pump_state", s.active_pump_state);
+    addUint(f, "last_daily_reset_day", s.last_daily_reset_day);
+    addUint(f, "boot_count", s.boot_count);
+    addHex(f, "pending_changes_mask", s.pending_changes_mask, 2);
+    addUint(f, "last_event_timestamp", s.last_event_timestamp);
+    addUint(f, "seq", s.seq);
+    addHex(f, "crc32", s.crc32, 8);
+}
+
+static void describe(const ChannelConfig& c, Fields& f) {
+    addHex(f, "events_bitmask", c.events_bitmask, 8);
+    addHex(f, "days_bitmask", c.days_bitmask, 2);
+    addFloat(f, "daily_dose_ml", c.daily_dose_ml);
+    addFloat(f, "dosing_rate", c.dosing_rate);
+    addUint(f, "enabled", c.enabled);
+    addUint(f, "has_pending", c.has_pending);
+    addUint(f, "seq", c.seq);
+    addHex(f, "crc32", c.crc32, 8);
+}
+
+static void describe(const ChannelDailyState& d, Fields& f) {
+    addHex(f, "events_completed", d.events_completed, 8);
+    addHex(f, "events_failed", d.events_failed, 8);
+    addFloat(f, "today_added_ml", d.today_added_ml);
+    addUint(f, "last_reset_day", d.last_reset_day);
+    addUint(f, "failed_count", d.failed_count);
+    addUint(f, "seq", d.seq);
+    addHex(f, "crc32", d.crc32, 8);
+}
+
+static void describe(const CriticalErrorState& e, Fields& f) {
+    addUint(f, "active_flag", e.active_flag);
+    addText(f, "error_type", errorTypeToString(e.error_type));
+    addUint(f, "channel", e.channel);
+    addUint(f, "phase", e.phase);
+    addUint(f, "timestamp", e.timestamp);
+    addHex(f, "error_data", e.error_data, 8);
+    addHex(f, "gpio_state_snapshot", e.gpio_state_snapshot, 2);
+    addHex(f, "relay_state_snapshot", e.relay_state_snapshot, 2);
+    addUint(f, "pump_was_running", e.pump_was_running);
+    addUint(f, "total_critical_errors", e.total_critical_errors);
+    addUint(f, "reset_count", e.reset_count);
+    addUint(f, "last_reset_timestamp", e.last_reset_timestamp);
+    addUint(f, "write_count", e.write_count);
+    addHex(f, "crc32", e.crc32, 8);
+}
+
+static void describe(const ContainerVolume& v, Fields& f) {
+    addFloat(f, "container_ml", v.getContainerMl());
+    addFloat(f, "remaining_ml", v.getRemainingMl());
+    addHex(f, "crc32", v.crc32, 8);
+}
+
+static void describe(const DosedTracker& t, Fields& f) {
+    addFloat(f, "total_dosed_ml", t.getTotalDosedMl());
+    addHex(f, "crc32", t.crc32, 8);
+}
+
+static void describe(const CounterBase& b, Fields& f) {
+    addUint(f, "seq", b.seq);
+    addUint(f, "log_head", b.log_head);
+    for (uint8_t i = 0; i < LIFETIME_COUNTER_SLOTS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "values[%u]", i);
+        addUint64(f, name, b.values[i]);
+    }
+    addHex(f, "crc32", b.crc32, 8);
+}
+
+// ============================================================================
+// DECODED RECORDS
+// ============================================================================
+
+struct DecodedRecord {
+    uint8_t  section;
+    uint16_t index;
+    RecordStatus status;
+    Fields   fields;        // Empty when the record is missing
+};
+
+template <FramSectionId Id>
+static void decodeSection(const FramImage& image, std::vector<DecodedRecord>& out) {
+    typedef FramSection<Id> S;
+    const FramSectionInfo& info = FRAM_SECTION_INFO[(uint8_t)Id];
+
+    for (uint16_t i = 0; i < S::count(); i++) {
+        DecodedRecord d;
+        d.section = (uint8_t)Id;
+        d.index = i;
+        d.status = recordStatus(image, info, i);
+
+        if (d.status != REC_MISSING) {
+            typename S::Record rec;
+            memcpy(&rec, image.bytes + S::recordAddress(i), sizeof(rec));
+            describe(rec, d.fields);
+        }
+        out.push_back(d);
+    }
+}
+
+// Sections with a structured decoder, in layout order
+static void decodeImage(const FramImage& image, std::vector<DecodedRecord>& out) {
+    decodeSection<FramSectionId::HEADER>(image, out);
+    decodeSection<FramSectionId::SYSTEM_STATE_A>(image, out);
+    decodeSection<FramSectionId::CONFIG_A>(image, out);
+    decodeSection<FramSectionId::CONFIG_B>(image, out);
+    decodeSection<FramSectionId::DAILY_STATE_A>(image, out);
+    decodeSection<FramSectionId::CRITICAL_ERROR>(image, out);
+    decodeSection<FramSectionId::CONTAINER_VOLUME>(image, out);
+    decodeSection<FramSectionId::DOSED_TRACKER>(image, out);
+    decodeSection<FramSectionId::SYSTEM_STATE_B>(image, out);
+    decodeSection<FramSectionId::DAILY_STATE_B>(image, out);
+    decodeSection<FramSectionId::COUNTER_BASE>(image, out);
+}
+
+static bool isDecoded(uint8_t section) {
+    switch ((FramSectionId)section) {
+        case FramSectionId::HEADER:
+        case FramSectionId::SYSTEM_STATE_A:
+        case FramSectionId::CONFIG_A:
+        case FramSectionId::CONFIG_B:
+        case FramSectionId::DAILY_STATE_A:
+        case FramSectionId::CRITICAL_ERROR:
+        case FramSectionId::CONTAINER_VOLUME:
+        case FramSectionId::DOSED_TRACKER:
+        case FramSectionId::SYSTEM_STATE_B:
+        case FramSectionId::DAILY_STATE_B:
+        case FramSectionId::COUNTER_BASE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Header must be valid and match the layout this tool was built for,
+ * otherwise section addresses mean nothing.
+ */
+static bool checkLayout(const FramImage& image, std::string* reason) {
+    const FramSectionInfo& s = FRAM_SECTION_INFO[(uint8_t)FramSectionId::HEADER];
+    RecordStatus status = recordStatus(image, s, 0);
+    if (!isValidStatus(status)) {
+        *reason = std::string("header ") + STATUS_NAMES[status];
+        return false;
+    }
+
+    FramHeader header;
+    memcpy(&header, image.bytes + FRAM_ADDR_HEADER, sizeof(header));
+    if (header.magic != FRAM_MAGIC_NUMBER) {
+        *reason = "bad magic";
+        return false;
+    }
+    if (header.layout_version != FRAM_LAYOUT_VERSION) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "layout v%u (tool decodes v%u)",
+                 header.layout_version, FRAM_LAYOUT_VERSION);
+        *reason = buf;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// COMMAND: INFO
+// ============================================================================
+
+static int cmdInfo(const FramImage& image) {
+    FramHeader header;
+    memcpy(&header, image.bytes + FRAM_ADDR_HEADER, sizeof(header));
+
+    printf("%s%s\n", image.path.c_str(), image.partial ? " (partial serial dump)" : "");
+    printf("  magic 0x%08lX, layout v%u (tool v%u), %u channels, initialized %lu, last write %lu\n",
+           (unsigned long)header.magic, header.layout_version, FRAM_LAYOUT_VERSION,
+           header.channel_count, (unsigned long)header.init_timestamp,
+           (unsigned long)header.last_write);
+
+    std::string reason;
+    bool layoutOk = checkLayout(image, &reason);
+    if (!layoutOk) printf("  WARNING: %s - section map below may not apply\n", reason.c_str());
+
+    printf("\n  %-17s  %-6s  %6s  %7s  %3s  %6s  %6s  %5s  %3s  %7s\n", "Section", "Addr",
+           "Size", "Records", "ok", "prefix", "legacy", "empty", "BAD", "missing");
+
+    uint32_t bad = 0;
+    for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+        const FramSectionInfo& s = FRAM_SECTION_INFO[i];
+        SectionSummary sum;
+        summarizeSection(image, i, &sum);
+        bad += sum.counts[REC_BAD];
+
+        printf("  %-17s  0x%04X  %6lu  %7u", s.name, s.address, (unsigned long)s.size, s.count);
+        if (s.crcOffset == FRAM_NO_CRC) {
+            printf("  (no CRC)%*s%7lu\n", 25, "", (unsigned long)sum.counts[REC_MISSING]);
+        } else {
+            printf("  %3lu  %6lu  %6lu  %5lu  %3lu  %7lu\n",
+                   (unsigned long)sum.counts[REC_OK], (unsigned long)sum.counts[REC_PREFIX],
+                   (unsigned long)sum.counts[REC_LEGACY], (unsigned long)sum.counts[REC_EMPTY],
+                   (unsigned long)sum.counts[REC_BAD], (unsigned long)sum.counts[REC_MISSING]);
+        }
+    }
+
+    return (layoutOk && bad == 0) ? EXIT_OK : EXIT_FAILED;
+}
+
+// ============================================================================
+// COMMAND: VERIFY
+// ============================================================================
+
+static int cmdVerify(const std::vector<const char*>& paths, bool quiet) {
+    // One buffer for the whole batch - images are processed one at a time
+    static FramImage image;
+    uint32_t passed = 0, failed = 0, unreadable = 0;
+
+    for (size_t n = 0; n < paths.size(); n++) {
+        if (!loadImage(paths[n], &image)) {
+            unreadable++;
+            continue;
+        }
+
+        std::string reason;
+        if (!checkLayout(image, &reason)) {
+            printf("FAIL  %s  %s\n", image.path.c_str(), reason.c_str());
+            failed++;
+            continue;
+        }
+
+        uint32_t totals[REC_STATUS_COUNT] = { 0 };
+        std::string badList;
+        uint32_t listed = 0;
+
+        for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+            const FramSectionInfo& s = FRAM_SECTION_INFO[i];
+            for (uint16_t r = 0; r < s.count; r++) {
+                RecordStatus status = recordStatus(image, s, r);
+                totals[status]++;
+                if (status == REC_BAD && listed++ < VERIFY_MAX_LISTED) {
+                    char buf[48];
+                    snprintf(buf, sizeof(buf), " %s[%u]", s.name, r);
+                    badList += buf;
+                }
+            }
+        }
+
+        bool ok = (totals[REC_BAD] == 0);
+        if (ok) passed++; else failed++;
+        if (ok && quiet) continue;
+
+        printf("%s  %s  ok=%lu prefix=%lu legacy=%lu empty=%lu bad=%lu",
+               ok ? "OK  " : "FAIL", image.path.c_str(),
+               (unsigned long)totals[REC_OK], (unsigned long)totals[REC_PREFIX],
+               (unsigned long)totals[REC_LEGACY], (unsigned long)totals[REC_EMPTY],
+               (unsigned long)totals[REC_BAD]);
+        if (totals[REC_MISSING]) printf(" missing=%lu", (unsigned long)totals[REC_MISSING]);
+        if (!ok) printf("  [%s%s ]", badList.c_str(), listed > VERIFY_MAX_LISTED ? " ..." : "");
+        printf("\n");
+    }
+
+    fprintf(stderr, "%lu images: %lu ok, %lu failed, %lu unreadable\n",
+            (unsigned long)paths.size(), (unsigned long)passed,
+            (unsigned long)failed, (unsigned long)unreadable);
+
+    if (unreadable) return EXIT_USAGE;
+    return failed ? EXIT_FAILED : EXIT_OK;
+}
+
+// ============================================================================
+// COMMAND: DUMP
+// ============================================================================
+
+static void printJsonString(const std::string& s) {
+    putchar('"');
+    for (size_t i = 0; i < s.size(); i++) {
+        char c = s[i];
+        if (c == '"' || c == '\\') putchar('\\');
+        if ((unsigned char)c < 0x20) {
+            printf("\\u%04x", c);
+        } else {
+            putchar(c);
+        }
+    }
+    putchar('"');
+}
+
+static void dumpJson(const FramImage& image, const std::vector<DecodedRecord>& records) {
+    printf("{\"file\":");
+    printJsonString(image.path);
+    printf(",\"partial\":%s,\"sections\":{", image.partial ? "true" : "false");
+
+    for (size_t i = 0; i < records.size(); i++) {
+        const DecodedRecord& d = records[i];
+        bool first = (i == 0 || records[i - 1].section != d.section);
+        bool last = (i + 1 == records.size() || records[i + 1].section != d.section);
+
+        if (first) {
+            if (i) putchar(',');
+            printf("\"%s\":[", FRAM_SECTION_INFO[d.section].name);
+        } else {
+            putchar(',');
+        }
+
+        printf("{\"status\":\"%s\"", STATUS_NAMES[d.status]);
+        for (size_t f = 0; f < d.fields.size(); f++) {
+            printf(",\"%s\":", d.fields[f].name.c_str());
+            if (d.fields[f].quoted) {
+                printJsonString(d.fields[f].value);
+            } else {
+                fputs(d.fields[f].value.c_str(), stdout);
+            }
+        }
+        putchar('}');
+
+        if (last) putchar(']');
+    }
+
+    printf("}}\n");
+}
+
+static void dumpText(const FramImage& image, const std::vector<DecodedRecord>& records) {
+    printf("== %s%s ==\n", image.path.c_str(), image.partial ? " (partial)" : "");
+
+    for (size_t i = 0; i < records.size(); i++) {
+        const DecodedRecord& d = records[i];
+        const FramSectionInfo& s = FRAM_SECTION_INFO[d.section];
+
+        if (i == 0 || records[i - 1].section != d.section) {
+            printf("%s @ 0x%04X\n", s.name, s.address);
+        }
+
+        printf("  [%u] %-7s", d.index, STATUS_NAMES[d.status]);
+        for (size_t f = 0; f < d.fields.size(); f++) {
+            printf(" %s=%s", d.fields[f].name.c_str(), d.fields[f].value.c_str());
+        }
+        printf("\n");
+    }
+}
+
+static int cmdDump(const std::vector<const char*>& paths, bool json) {
+    static FramImage image;
+    int result = EXIT_OK;
+
+    for (size_t n = 0; n < paths.size(); n++) {
+        if (!loadImage(paths[n], &image)) {
+            result = EXIT_USAGE;
+            continue;
+        }
+
+        std::string reason;
+        if (!checkLayout(image, &reason)) {
+            fprintf(stderr, "%s: WARNING: %s\n", image.path.c_str(), reason.c_str());
+        }
+
+        std::vector<DecodedRecord> records;
+        decodeImage(image, records);
+
+        if (json) {
+            dumpJson(image, records);
+        } else {
+            dumpText(image, records);
+        }
+    }
+
+    return result;
+}
+
+// ============================================================================
+// COMMAND: DIFF
+// ============================================================================
+
+// Differing byte ranges of one raw record, e.g. "0x0C30-0x0C3F"
+static uint32_t diffBytes(const FramImage& a, const FramImage& b, uint32_t address,
+                          uint32_t length, const char* label) {
+    uint32_t differences = 0;
+    uint32_t i = 0;
+
+    while (i < length) {
+        uint32_t addr = address + i;
+        bool differs = (a.present[addr] != b.present[addr]) ||
+                       (a.present[addr] && a.bytes[addr] != b.bytes[addr]);
+        if (!differs) {
+            i++;
+            continue;
+        }
+
+        uint32_t start = i;
+        while (i < length) {
+            addr = address + i;
+            if (a.present[addr] == b.present[addr] &&
+                (!a.present[addr] || a.bytes[addr] == b.bytes[addr])) break;
+            i++;
+        }
+
+        printf("%s: 0x%04lX-0x%04lX differ (%lu B)\n", label,
+               (unsigned long)(address + start), (unsigned long)(address + i - 1),
+               (unsigned long)(i - start));
+        differences++;
+    }
+
+    return differences;
+}
+
+static int cmdDiff(const char* pathA, const char* pathB) {
+    static FramImage a, b;
+    if (!loadImage(pathA, &a) || !loadImage(pathB, &b)) return EXIT_USAGE;
+
+    std::string reason;
+    if (!checkLayout(a, &reason)) fprintf(stderr, "%s: WARNING: %s\n", pathA, reason.c_str());
+    if (!checkLayout(b, &reason)) fprintf(stderr, "%s: WARNING: %s\n", pathB, reason.c_str());
+
+    std::vector<DecodedRecord> ra, rb;
+    decodeImage(a, ra);
+    decodeImage(b, rb);
+
+    uint32_t differences = 0;
+
+    // Decoded sections: field by field (same record types on both sides)
+    for (size_t i = 0; i < ra.size(); i++) {
+        const DecodedRecord& da = ra[i];
+        const DecodedRecord& db = rb[i];
+        char label[48];
+        snprintf(label, sizeof(label), "%s[%u]", FRAM_SECTION_INFO[da.section].name, da.index);
+
+        if (da.status != db.status) {
+            printf("%s.status: %s -> %s\n", label, STATUS_NAMES[da.status], STATUS_NAMES[db.status]);
+            differences++;
+        }
+
+        if (da.fields.size() != db.fields.size()) continue;     // One side missing
+        uint32_t fieldDifferences = 0;
+        for (size_t f = 0; f < da.fields.size(); f++) {
+            if (da.fields[f].value == db.fields[f].value) continue;
+            printf("%s.%s: %s -> %s\n", label, da.fields[f].name.c_str(),
+                   da.fields[f].value.c_str(), db.fields[f].value.c_str());
+            fieldDifferences++;
+        }
+
+        // Padding, reserved bytes or float digits below the printed precision
+        if (fieldDifferences == 0) {
+            const FramSectionInfo& s = FRAM_SECTION_INFO[da.section];
+            fieldDifferences = diffBytes(a, b, recordAddress(s, da.index), s.recordSize, label);
+        }
+        differences += fieldDifferences;
+    }
+
+    // Everything else: differing byte ranges per record
+    for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+        if (isDecoded(i)) continue;
+        const FramSectionInfo& s = FRAM_SECTION_INFO[i];
+
+        for (uint16_t r = 0; r < s.count; r++) {
+            char label[48];
+            if (s.count > 1) {
+                snprintf(label, sizeof(label), "%s[%u]", s.name, r);
+            } else {
+                snprintf(label, sizeof(label), "%s", s.name);
+            }
+            differences += diffBytes(a, b, recordAddress(s, r), s.recordSize, label);
+        }
+    }
+
+    fprintf(stderr, "%lu differences\n", (unsigned long)differences);
+    return differences ? EXIT_FAILED : EXIT_OK;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static int usage() {
+    fprintf(stderr,
+            "Usage:\n"
+            "  fram_image info   IMAGE\n"
+            "  fram_image verify [-q] IMAGE...\n"
+            "  fram_image dump   [--json] IMAGE...\n"
+            "  fram_image diff   IMAGE_A IMAGE_B\n"
+            "\n"
+            "IMAGE: raw %u-byte FRAM image or serial log with dumpSection() output\n",
+            (unsigned)FRAM_SIZE_BYTES);
+    return EXIT_USAGE;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage();
+
+    Crc32::begin();
+
+    std::string cmd = argv[1];
+    bool quiet = false;
+    bool json = false;
+    std::vector<const char*> paths;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-q" && cmd == "verify") {
+            quiet = true;
+        } else if (arg == "--json" && cmd == "dump") {
+            json = true;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            return usage();
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    if (cmd == "verify" && !paths.empty()) return cmdVerify(paths, quiet);
+    if (cmd == "dump" && !paths.empty()) return cmdDump(paths, json);
+    if (cmd == "diff" && paths.size() == 2) return cmdDiff(paths[0], paths[1]);
+
+    if (cmd == "info" && paths.size() == 1) {
+        static FramImage image;
+        if (!loadImage(paths[0], &image)) return EXIT_USAGE;
+        return cmdInfo(image);
+    }
+
+    return usage();
+}
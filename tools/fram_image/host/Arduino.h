@@ -0,0 +1,105 @@
+/**
+ * DOZOWNIK - Host build of the firmware headers
+ *
+ * Minimalny zamiennik Arduino.h dla narzędzi uruchamianych na PC.
+ * Pokrywa to, czego używają config.h, dosing_types.h, fram_layout.h
+ * i crc32.cpp, a dla testów (tests/) także FramController, FramMigration
+ * i FramBackup - zegar, PSRAM i mutex FreeRTOS w wersji jednowątkowej.
+ * Magistrala I2C: host/Wire.h.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define F(x)                x
+#define PROGMEM
+#define DRAM_ATTR
+#define IRAM_ATTR
+#define pgm_read_byte(p)    (*(const uint8_t*)(p))
+#define pgm_read_dword(p)   (*(const uint32_t*)(p))
+
+#define HIGH                1
+#define LOW                 0
+
+typedef uint8_t byte;
+
+/**
+ * Serial -> stderr (stdout zostaje dla wyniku narzędzia)
+ */
+class HostSerial {
+public:
+    size_t print(const char* s) { return fputs(s, stderr) < 0 ? 0 : strlen(s); }
+    size_t print(char c) { return fputc(c, stderr) < 0 ? 0 : 1; }
+    size_t println(const char* s = "") { size_t n = print(s); fputc('\n', stderr); return n + 1; }
+
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vfprintf(stderr, fmt, args);
+        va_end(args);
+        return n < 0 ? 0 : (size_t)n;
+    }
+};
+
+extern HostSerial Serial;     // Definicja w narzędziu
+
+// ============================================================================
+// TIMING / MEMORY (testy z prawdziwym FramController)
+// ============================================================================
+
+#include <time.h>
+
+static inline uint32_t micros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+static inline uint32_t millis() { return micros() / 1000; }
+static inline void delay(uint32_t ms) { (void)ms; }
+
+// Brak PSRAM - FramController czyta i pisze po (symulowanej) magistrali
+static inline bool psramFound() { return false; }
+static inline void* ps_malloc(size_t size) { return malloc(size); }
+
+// ============================================================================
+// FREERTOS (jeden wątek - mutex rekurencyjny to tylko licznik)
+// ============================================================================
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+typedef struct HostMutex { uint32_t depth; }* SemaphoreHandle_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+
+static inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    return (SemaphoreHandle_t)calloc(1, sizeof(HostMutex));
+}
+
+static inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t m, TickType_t ticks) {
+    (void)ticks;
+    m->depth++;
+    return pdTRUE;
+}
+
+static inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t m) {
+    if (m->depth == 0) return pdFALSE;
+    m->depth--;
+    return pdTRUE;
+}
+
+#endif // HOST_ARDUINO_H
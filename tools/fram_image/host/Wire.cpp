@@ -0,0 +1,169 @@
+/**
+ * DOZOWNIK - Host build: Wire z symulowaną FRAM - Implementation
+ */
+
+#include "Wire.h"
+#include <string.h>
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+    : failNext(0)
+    , powerCut(-1)
+    , _clock(100000)
+    , _txAddress(0)
+    , _txLength(0)
+    , _txOverflow(false)
+    , _rxLength(0)
+    , _rxIndex(0)
+    , _latch(0)
+    , _powerLost(false)
+{
+    memset(memory, 0, sizeof(memory));
+    resetStats();
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    if (frequency) _clock = frequency;
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+    _clock = frequency;
+    return true;
+}
+
+void TwoWire::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void TwoWire::powerOn() {
+    _powerLost = false;
+    powerCut = -1;
+    _latch = 0;
+}
+
+bool TwoWire::_nack() {
+    if (_powerLost) {
+        stats.nacks++;
+        return true;
+    }
+    if (failNext == 0) return false;
+    failNext--;
+    stats.nacks++;
+    return true;
+}
+
+// ============================================================================
+// WRITE
+// ============================================================================
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _txAddress = address;
+    _txLength = 0;
+    _txOverflow = false;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (_txLength >= I2C_BUFFER_LENGTH) {
+        _txOverflow = true;
+        return 0;
+    }
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+    size_t written = 0;
+    while (written < length && write(data[written])) {
+        written++;
+    }
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    stats.transactions++;
+
+    if (_txOverflow) {
+        stats.overflows++;
+        return 1;                       // Data too long
+    }
+    if (_txAddress != HOST_FRAM_I2C_ADDRESS) {
+        stats.nacks++;
+        return 2;                       // NACK on address
+    }
+    if (_nack()) return 2;
+    if (_txLength == 0) return 0;       // Probe
+
+    stats.writes++;
+    if (_txLength < 2) return 0;        // Incomplete address - chip ignores it
+
+    // MB85RC256V: 15-bit address, sequential access wraps at the end
+    _latch = (uint16_t)(((_txBuffer[0] << 8) | _txBuffer[1]) & (HOST_FRAM_SIZE - 1));
+    stats.address_bytes += 2;
+
+    size_t length = _txLength - 2;
+    if (length == 0) return 0;          // Address set for a following read
+
+    stats.data_writes++;
+    bool cut = (powerCut == 0);
+    if (powerCut > 0) powerCut--;
+    if (cut) length /= 2;               // Torn write
+
+    for (size_t i = 0; i < length; i++) {
+        memory[_latch] = _txBuffer[2 + i];
+        _latch = (uint16_t)((_latch + 1) & (HOST_FRAM_SIZE - 1));
+    }
+    stats.bytes_written += length;
+
+    if (cut) {
+        _powerLost = true;
+        powerCut = -1;
+        stats.nacks++;
+        return 2;
+    }
+    return 0;
+}
+
+// ============================================================================
+// READ
+// ============================================================================
+
+size_t TwoWire::requestFrom(uint8_t address, size_t length, bool sendStop) {
+    (void)sendStop;
+    stats.transactions++;
+    stats.reads++;
+    _rxLength = 0;
+    _rxIndex = 0;
+
+    if (length > I2C_BUFFER_LENGTH) {
+        stats.overflows++;
+        return 0;
+    }
+    if (address != HOST_FRAM_I2C_ADDRESS) {
+        stats.nacks++;
+        return 0;
+    }
+    if (_nack()) return 0;
+
+    // Current-address read continues from the latch
+    for (size_t i = 0; i < length; i++) {
+        _rxBuffer[i] = memory[_latch];
+        _latch = (uint16_t)((_latch + 1) & (HOST_FRAM_SIZE - 1));
+    }
+    _rxLength = length;
+    stats.bytes_read += length;
+    return length;
+}
+
+int TwoWire::available() {
+    return (int)(_rxLength - _rxIndex);
+}
+
+int TwoWire::read() {
+    if (_rxIndex >= _rxLength) return -1;
+    return _rxBuffer[_rxIndex++];
+}
@@ -0,0 +1,87 @@
+/**
+ * DOZOWNIK - Host build: Wire z symulowaną FRAM
+ *
+ * Zamiennik TwoWire dla testów na PC. Pod adresem FRAM_I2C_ADDRESS odpowiada
+ * symulowany MB85RC256V (32 kB, zatrzask adresu trzymany między
+ * transakcjami), inne adresy dają NACK. Każda transakcja i każdy bajt danych
+ * trafia do liczników, a przepełnienie bufora sterownika jest błędem -
+ * tak jak w rdzeniu ESP32 (I2C_BUFFER_LENGTH = 128).
+ *
+ * Zanik zasilania (powerCut): transakcja, w której następuje, zapisuje
+ * tylko pierwszą połowę danych (MB85RC256V zapisuje każdy bajt po ACK),
+ * potem magistrala milczy do powerOn().
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define I2C_BUFFER_LENGTH       128
+
+#define HOST_FRAM_I2C_ADDRESS   0x50
+#define HOST_FRAM_SIZE          32768
+
+/**
+ * Ruch na symulowanej magistrali (bajty adresu FRAM liczone osobno)
+ */
+struct HostI2cStats {
+    uint32_t transactions;      // endTransmission() + requestFrom()
+    uint32_t writes;            // Transakcje zapisu (z adresem lub danymi)
+    uint32_t data_writes;       // Transakcje zapisu z danymi
+    uint32_t reads;             // requestFrom()
+    uint32_t address_bytes;     // Bajty adresu pamięci (2 na zapis)
+    uint32_t bytes_written;     // Bajty danych zapisane do pamięci
+    uint32_t bytes_read;        // Bajty odczytane z pamięci
+    uint32_t overflows;         // Transfery ponad I2C_BUFFER_LENGTH
+    uint32_t nacks;             // Transakcje zakończone NACK
+};
+
+class TwoWire {
+public:
+    TwoWire();
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool setClock(uint32_t frequency);
+    uint32_t getClock() const { return _clock; }
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t length);
+    uint8_t endTransmission(bool sendStop = true);
+
+    size_t requestFrom(uint8_t address, size_t length, bool sendStop = true);
+    int available();
+    int read();
+
+    // --- Symulacja (testy) ---
+
+    uint8_t memory[HOST_FRAM_SIZE];     // Zawartość układu
+    HostI2cStats stats;
+    uint32_t failNext;                  // Tyle kolejnych transakcji dostanie NACK
+    int32_t powerCut;                   // Zapisy danych do zaniku zasilania (-1 = brak)
+
+    void resetStats();
+    void powerOn();
+    bool powered() const { return !_powerLost; }
+    uint16_t latch() const { return _latch; }
+
+private:
+    uint32_t _clock;
+    uint8_t _txAddress;
+    uint8_t _txBuffer[I2C_BUFFER_LENGTH];
+    size_t _txLength;
+    bool _txOverflow;
+    uint8_t _rxBuffer[I2C_BUFFER_LENGTH];
+    size_t _rxLength;
+    size_t _rxIndex;
+    uint16_t _latch;
+    bool _powerLost;
+
+    bool _nack();
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,89 @@
+/**
+ * DOZOWNIK - CRC32 backend benchmark (host)
+ *
+ *   make bench
+ *
+ * Throughput of each backend available on this machine for a record, a
+ * 1 KB block and the whole 32 kB FRAM image, plus the legacy table used
+ * to verify old records. ROM (crc32_le) exists only on the ESP32 - on the
+ * device the same comparison runs from the CLI (CRC32 test).
+ */
+
+#include <time.h>
+#include "crc32.h"
+
+HostSerial Serial;
+
+#define BENCH_MIN_NS    50000000ULL     // Per size: repeat until 50 ms elapsed
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static const size_t SIZES[] = { 32, 1024, 32768 };
+#define SIZE_COUNT      (sizeof(SIZES) / sizeof(SIZES[0]))
+
+static uint8_t block[32768];
+
+/**
+ * Średni czas wywołania [ns]; backend < 0 = tablica legacy
+ */
+static double measure(int backend, size_t length) {
+    volatile uint32_t sink = 0;
+    uint64_t rounds = 0;
+    uint64_t start = nowNs();
+    uint64_t elapsed;
+
+    do {
+        for (uint8_t r = 0; r < 16; r++) {
+            sink = (backend < 0) ? Crc32::computeLegacy(block, length) ^ sink
+                                 : Crc32::extendWith((Crc32Backend)backend, sink, block, length);
+        }
+        rounds += 16;
+        elapsed = nowNs() - start;
+    } while (elapsed < BENCH_MIN_NS);
+
+    (void)sink;
+    return (double)elapsed / rounds;
+}
+
+static void printRow(const char* name, int backend) {
+    printf("%-10s", name);
+    for (uint8_t s = 0; s < SIZE_COUNT; s++) {
+        double ns = measure(backend, SIZES[s]);
+        printf("  %9.1f ns %8.1f MB/s", ns, SIZES[s] * 1000.0 / ns);
+    }
+    printf("\n");
+}
+
+int main() {
+    for (size_t i = 0; i < sizeof(block); i++) {
+        block[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    Crc32::begin();
+    if (!Crc32::selfTest()) {
+        fprintf(stderr, "CRC32 self-test FAILED\n");
+        return 1;
+    }
+
+    printf("%-10s", "backend");
+    for (uint8_t s = 0; s < SIZE_COUNT; s++) {
+        printf("  %24zu B", SIZES[s]);
+    }
+    printf("\n");
+
+    for (uint8_t b = 0; b < CRC32_BACKEND_COUNT; b++) {
+        Crc32Backend backend = (Crc32Backend)b;
+        if (!Crc32::isAvailable(backend)) {
+            printf("%-10s  not available on this host\n", Crc32::backendName(backend));
+            continue;
+        }
+        printRow(Crc32::backendName(backend), b);
+    }
+    printRow("legacy", -1);
+
+    return 0;
+}
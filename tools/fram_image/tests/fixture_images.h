@@ -0,0 +1,277 @@
+/**
+ * DOZOWNIK - Old-layout FRAM images for the migration test
+ *
+ * Odtworzenie obrazów FRAM zapisanych przez firmware v5-v8, z ich własnym
+ * układem adresów i sposobem liczenia CRC:
+ *
+ *   v5, v6  sekcje do 0x0790, RESERVED od 0x0800 (v5 = v6 z inną wersją),
+ *           v6 bez DosedTracker
+ *   v7      jak v6 + DosedTracker (0x0760), dziennik/rollupy, RESERVED od 0x6C60
+ *   v8      sloty A/B (seq), RESERVED od 0x6D10
+ *
+ * Do v7 CRC liczony był starą tablicą (wpis 245 = 0xCDD706B3) po
+ * sizeof(rekord) - 4 bajtach, z wyzerowanym polem CRC - dla config,
+ * daily i system state obejmuje to samo pole, takie rekordy nie przechodzą
+ * dziś weryfikacji (migracja ich nie sprawdza, tylko pieczętuje na nowo).
+ * v8 pieczętuje jak bieżący firmware.
+ *
+ * Self-test CLI zostawiał 8 bajtów 0xDEADBEEF12345678 na początku RESERVED.
+ *
+ * Wartości pól są jawne (fixture*()), test migracji porównuje z nimi wynik.
+ * Obrazy w tests/fixtures/ generuje make_fixtures (make fixtures).
+ */
+
+#ifndef FIXTURE_IMAGES_H
+#define FIXTURE_IMAGES_H
+
+#include "fram_controller.h"
+#include "crc32.h"
+
+// Frozen old-layout addresses (match fram_migration.cpp)
+#define FX_ADDR_HEADER              0x0000
+#define FX_ADDR_CREDENTIALS         0x0020
+#define FX_ADDR_SYSTEM_STATE        0x0420
+#define FX_ADDR_ACTIVE_CONFIG       0x0440
+#define FX_ADDR_PENDING_CONFIG      0x0500
+#define FX_ADDR_DAILY_STATE         0x05C0
+#define FX_ADDR_CRITICAL_ERROR      0x0650
+#define FX_ADDR_AUTH_DATA           0x0670
+#define FX_ADDR_SESSION_DATA        0x06B0
+#define FX_ADDR_CONTAINER_VOLUME    0x0730
+#define FX_ADDR_DOSED_TRACKER       0x0760
+#define FX_ADDR_SYSTEM_STATE_B      0x6C60      // v8
+#define FX_ADDR_DAILY_STATE_B       0x6C80      // v8
+
+#define FX_RESERVED_V6              0x0800
+#define FX_RESERVED_V7              0x6C60
+#define FX_RESERVED_V8              0x6D10
+
+#define FX_INIT_TIMESTAMP           1700000000UL
+#define FX_LAST_WRITE               1729000000UL
+
+static const uint8_t FX_CLI_SCRATCH[8] = { 0xDE, 0xAD, 0xBE, 0xEF, 0x12, 0x34, 0x56, 0x78 };
+
+// ============================================================================
+// RECORD VALUES
+// ============================================================================
+
+/** Kanał ze zmianami czekającymi na zatwierdzenie (v7: has_pending w PENDING_CONFIG) */
+static inline bool fixtureHasPending(uint8_t ch) {
+    return ch == 1 || ch == 3;
+}
+
+/**
+ * Konfiguracja kanału bez CRC i seq. pending = wersja edytowana
+ * (w v7 leży w PENDING_CONFIG także po zatwierdzeniu, z has_pending = 0).
+ * Kanały ponad CHANNEL_COUNT nie były nigdy zapisywane.
+ */
+static inline ChannelConfig fixtureConfig(uint8_t ch, bool pending) {
+    ChannelConfig c;
+    memset(&c, 0, sizeof(c));
+    if (ch >= CHANNEL_COUNT) return c;
+
+    c.events_bitmask = (0x00555554UL << (ch & 1)) & 0x00FFFFFEUL;
+    c.days_bitmask = (uint8_t)(0x7F >> ch);
+    c.daily_dose_ml = 5.0f * (ch + 1) + (pending ? 2.5f : 0.0f);
+    c.dosing_rate = 0.30f + 0.02f * ch;
+    c.enabled = (ch != 2);
+    c.has_pending = pending && fixtureHasPending(ch);
+    return c;
+}
+
+static inline ChannelDailyState fixtureDaily(uint8_t ch) {
+    ChannelDailyState d;
+    memset(&d, 0, sizeof(d));
+    if (ch >= CHANNEL_COUNT) return d;
+
+    d.events_completed = 0x00000E0EUL << ch;
+    d.events_failed = (ch == 2) ? (1UL << 9) : 0;
+    d.today_added_ml = 1.25f * (ch + 1);
+    d.last_reset_day = 0x47;
+    d.failed_count = (ch == 2) ? 1 : 0;
+    return d;
+}
+
+static inline SystemState fixtureSystem() {
+    SystemState s;
+    memset(&s, 0, sizeof(s));
+    s.system_enabled = 1;
+    s.system_halted = 0;
+    s.active_channel = 255;
+    s.active_pump_state = 0;
+    s.last_daily_reset_day = 20007;
+    s.boot_count = 1234;
+    s.pending_changes_mask = 0x0A;     // Channels 1 and 3
+    s.last_event_timestamp = FX_LAST_WRITE;
+    return s;
+}
+
+static inline ContainerVolume fixtureVolume(uint8_t ch) {
+    ContainerVolume v;
+    memset(&v, 0, sizeof(v));
+    if (ch >= CHANNEL_COUNT) return v;
+
+    v.container_ml = 10000;
+    v.remaining_ml = (uint16_t)(10000 - 1111 * ch);
+    return v;
+}
+
+static inline DosedTracker fixtureTracker(uint8_t ch) {
+    DosedTracker t;
+    memset(&t, 0, sizeof(t));
+    t.total_dosed_ml = (ch < CHANNEL_COUNT) ? (uint16_t)(100 * (ch + 1) + 7) : 0;
+    return t;
+}
+
+static inline CriticalErrorState fixtureCriticalError() {
+    CriticalErrorState e;
+    memset(&e, 0, sizeof(e));
+    e.active_flag = 0;
+    e.channel = 255;
+    e.total_critical_errors = 3;
+    e.reset_count = 3;
+    e.last_reset_timestamp = FX_LAST_WRITE - 86400;
+    e.write_count = 9;
+    return e;
+}
+
+static inline AuthData fixtureAuth() {
+    AuthData a;
+    memset(&a, 0, sizeof(a));
+    for (uint8_t i = 0; i < sizeof(a.password_hash); i++) a.password_hash[i] = (uint8_t)(i * 37 + 11);
+    for (uint8_t i = 0; i < sizeof(a.salt); i++) a.salt[i] = (uint8_t)(i * 53 + 5);
+    a.hash_iterations = 10;
+    a.password_set = 1;
+    return a;
+}
+
+static inline FramHeader fixtureHeader(uint16_t version) {
+    FramHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = FRAM_MAGIC_NUMBER;
+    h.layout_version = version;
+    h.channel_count = CHANNEL_COUNT;
+    h.init_timestamp = FX_INIT_TIMESTAMP;
+    h.last_write = FX_LAST_WRITE;
+    return h;
+}
+
+// v8 generations: odd channels have the newer copy in slot B
+static inline uint32_t fixtureSeqV8(uint8_t ch, uint8_t slot) {
+    uint32_t base = 4 + 2 * ch;
+    return (ch & 1) ? base + slot : base + 1 - slot;
+}
+
+// ============================================================================
+// IMAGE BUILDER
+// ============================================================================
+
+/** Pieczęć sprzed tablicy sekcji: stara tablica, sizeof - 4 bajty, pole CRC = 0 */
+template <typename T>
+static inline void fixtureSealLegacy(T* record, uint32_t* crc) {
+    *crc = 0;
+    *crc = Crc32::computeLegacy(record, sizeof(T) - sizeof(uint32_t));
+}
+
+template <typename T>
+static inline void fixturePut(uint8_t* image, uint32_t address, const T& record) {
+    memcpy(image + address, &record, sizeof(T));
+}
+
+static inline uint32_t fixtureReserved(uint16_t version) {
+    return version >= 8 ? FX_RESERVED_V8 : version == 7 ? FX_RESERVED_V7 : FX_RESERVED_V6;
+}
+
+/**
+ * Zbuduj obraz FRAM_SIZE_BYTES w układzie danej wersji (5-8)
+ */
+static inline void buildFixture(uint16_t version, uint8_t* image) {
+    memset(image, 0, FRAM_SIZE_BYTES);
+
+    for (uint32_t i = 0; i < 1024; i++) image[FX_ADDR_CREDENTIALS + i] = (uint8_t)(i * 13 + 1);
+    for (uint32_t i = 0; i < 128; i++) image[FX_ADDR_SESSION_DATA + i] = (uint8_t)(i * 5 + 2);
+
+    CriticalErrorState error = fixtureCriticalError();
+    fixtureSealLegacy(&error, &error.crc32);
+    fixturePut(image, FX_ADDR_CRITICAL_ERROR, error);
+
+    AuthData auth = fixtureAuth();
+    fixtureSealLegacy(&auth, &auth.crc32);
+    fixturePut(image, FX_ADDR_AUTH_DATA, auth);
+
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+        ContainerVolume volume = fixtureVolume(ch);
+        fixtureSealLegacy(&volume, &volume.crc32);
+        fixturePut(image, FX_ADDR_CONTAINER_VOLUME + ch * sizeof(ContainerVolume), volume);
+
+        if (version >= 7) {
+            DosedTracker tracker = fixtureTracker(ch);
+            fixtureSealLegacy(&tracker, &tracker.crc32);
+            fixturePut(image, FX_ADDR_DOSED_TRACKER + ch * sizeof(DosedTracker), tracker);
+        }
+    }
+
+    if (version <= 7) {
+        // Single copies, written for the configured channels only
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+            ChannelConfig active = fixtureConfig(ch, false);
+            ChannelConfig pending = fixtureConfig(ch, true);
+            fixtureSealLegacy(&active, &active.crc32);
+            fixtureSealLegacy(&pending, &pending.crc32);
+            fixturePut(image, FX_ADDR_ACTIVE_CONFIG + ch * sizeof(ChannelConfig), active);
+            fixturePut(image, FX_ADDR_PENDING_CONFIG + ch * sizeof(ChannelConfig), pending);
+
+            ChannelDailyState daily = fixtureDaily(ch);
+            fixtureSealLegacy(&daily, &daily.crc32);
+            fixturePut(image, FX_ADDR_DAILY_STATE + ch * sizeof(ChannelDailyState), daily);
+        }
+
+        SystemState state = fixtureSystem();
+        fixtureSealLegacy(&state, &state.crc32);
+        fixturePut(image, FX_ADDR_SYSTEM_STATE, state);
+    } else {
+        // A/B slots: both copies of every channel valid, newer one per fixtureSeqV8()
+        for (uint8_t ch = 0; ch < FRAM_MAX_CHANNELS; ch++) {
+            ChannelConfig a = fixtureConfig(ch, false);
+            ChannelConfig b = fixtureConfig(ch, true);
+            a.seq = fixtureSeqV8(ch, FRAM_SLOT_A);
+            b.seq = fixtureSeqV8(ch, FRAM_SLOT_B);
+            FramController::sealRecord<FramSectionId::CONFIG_A>(&a);
+            FramController::sealRecord<FramSectionId::CONFIG_B>(&b);
+            fixturePut(image, FX_ADDR_ACTIVE_CONFIG + ch * sizeof(ChannelConfig), a);
+            fixturePut(image, FX_ADDR_PENDING_CONFIG + ch * sizeof(ChannelConfig), b);
+
+            ChannelDailyState da = fixtureDaily(ch);
+            ChannelDailyState db = fixtureDaily(ch);
+            da.seq = fixtureSeqV8(ch, FRAM_SLOT_A);
+            db.seq = fixtureSeqV8(ch, FRAM_SLOT_B);
+            db.today_added_ml += 0.5f;
+            FramController::sealRecord<FramSectionId::DAILY_STATE_A>(&da);
+            FramController::sealRecord<FramSectionId::DAILY_STATE_B>(&db);
+            fixturePut(image, FX_ADDR_DAILY_STATE + ch * sizeof(ChannelDailyState), da);
+            fixturePut(image, FX_ADDR_DAILY_STATE_B + ch * sizeof(ChannelDailyState), db);
+        }
+
+        SystemState a = fixtureSystem();
+        SystemState b = fixtureSystem();
+        a.seq = 20;
+        b.seq = 21;
+        b.boot_count++;
+        FramController::sealRecord<FramSectionId::SYSTEM_STATE_A>(&a);
+        FramController::sealRecord<FramSectionId::SYSTEM_STATE_B>(&b);
+        fixturePut(image, FX_ADDR_SYSTEM_STATE, a);
+        fixturePut(image, FX_ADDR_SYSTEM_STATE_B, b);
+    }
+
+    memcpy(image + fixtureReserved(version), FX_CLI_SCRATCH, sizeof(FX_CLI_SCRATCH));
+
+    FramHeader header = fixtureHeader(version);
+    if (version >= 8) {
+        FramController::sealRecord<FramSectionId::HEADER>(&header);
+    } else {
+        fixtureSealLegacy(&header, &header.header_crc);
+    }
+    fixturePut(image, FX_ADDR_HEADER, header);
+}
+
+#endif // FIXTURE_IMAGES_H
@@ -0,0 +1,52 @@
+/**
+ * DOZOWNIK - Host test helpers
+ *
+ * Minimalne asercje dla testów uruchamianych na PC (make test).
+ * Błąd nie przerywa testu - wypisywane jest najwyżej HOST_TEST_MAX_REPORTS
+ * pierwszych niezgodności, wynik zwraca testResult() jako kod wyjścia.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define HOST_TEST_MAX_REPORTS   10
+
+static unsigned long _testChecks = 0;
+static unsigned long _testFailures = 0;
+
+static inline bool _testReport(bool ok, const char* file, int line, const char* expr) {
+    _testChecks++;
+    if (ok) return true;
+    if (_testFailures++ < HOST_TEST_MAX_REPORTS) {
+        fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, expr);
+    }
+    return false;
+}
+
+static inline bool _testReportEq(long long a, long long b, const char* file, int line,
+                                 const char* ea, const char* eb) {
+    _testChecks++;
+    if (a == b) return true;
+    if (_testFailures++ < HOST_TEST_MAX_REPORTS) {
+        fprintf(stderr, "%s:%d: CHECK_EQ failed: %s = %lld, %s = %lld\n",
+                file, line, ea, a, eb, b);
+    }
+    return false;
+}
+
+#define CHECK(cond)         _testReport((cond), __FILE__, __LINE__, #cond)
+#define CHECK_EQ(a, b)      _testReportEq((long long)(a), (long long)(b), __FILE__, __LINE__, #a, #b)
+
+/**
+ * Podsumowanie testu - kod wyjścia programu (0 = wszystko OK)
+ */
+static inline int testResult(const char* name) {
+    printf("%-20s %s (%lu checks, %lu failed)\n", name,
+           _testFailures ? "FAIL" : "OK", _testChecks, _testFailures);
+    return _testFailures ? 1 : 0;
+}
+
+#endif // HOST_TEST_H
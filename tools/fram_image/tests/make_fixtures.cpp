@@ -0,0 +1,35 @@
+/**
+ * DOZOWNIK - Writes the old-layout images used by test_migration
+ *
+ *   make fixtures       -> tests/fixtures/fram_v5.bin .. fram_v8.bin
+ *
+ * The images are committed; regenerate only when fixture_images.h changes.
+ */
+
+#include "fixture_images.h"
+
+HostSerial Serial;
+
+int main(int argc, char** argv) {
+    const char* dir = (argc > 1) ? argv[1] : "tests/fixtures";
+    static uint8_t image[FRAM_SIZE_BYTES];
+
+    Crc32::begin();
+
+    for (uint16_t version = 5; version <= 8; version++) {
+        buildFixture(version, image);
+
+        char path[256];
+        snprintf(path, sizeof(path), "%s/fram_v%u.bin", dir, (unsigned)version);
+
+        FILE* f = fopen(path, "wb");
+        if (!f || fwrite(image, 1, sizeof(image), f) != sizeof(image)) {
+            fprintf(stderr, "%s: write failed\n", path);
+            if (f) fclose(f);
+            return 2;
+        }
+        fclose(f);
+        printf("%s\n", path);
+    }
+    return 0;
+}
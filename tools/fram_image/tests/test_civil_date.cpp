@@ -0,0 +1,73 @@
+/**
+ * DOZOWNIK - civil_date.h host test
+ *
+ * Exhaustive check of the epoch-day kernel against the C library calendar
+ * (gmtime on a 64-bit time_t) for every day 1970-01-01 .. 2105-12-31,
+ * which covers the required 2000-2099 range. Daily-reset detection
+ * compares these epoch days, so any off-by-one here skips or repeats a day.
+ */
+
+#include <time.h>
+#include "civil_date.h"
+#include "host_test.h"
+
+static_assert(sizeof(time_t) >= 8, "Host test needs a 64-bit time_t");
+
+int main() {
+    const uint32_t first = daysFromCivil(1970, 1, 1);
+    const uint32_t last = daysFromCivil(2105, 12, 31);
+    CHECK_EQ(first, 0);
+
+    uint32_t days2000 = 0;
+
+    for (uint32_t days = first; days <= last; days++) {
+        time_t t = (time_t)days * 86400;
+        struct tm tm;
+        if (!CHECK(gmtime_r(&t, &tm) != nullptr)) break;
+
+        uint16_t year = (uint16_t)(tm.tm_year + 1900);
+        uint8_t month = (uint8_t)(tm.tm_mon + 1);
+        uint8_t day = (uint8_t)tm.tm_mday;
+
+        // civil -> days and back
+        CHECK_EQ(daysFromCivil(year, month, day), days);
+
+        CivilDate c = civilFromDays(days);
+        CHECK_EQ(c.year, year);
+        CHECK_EQ(c.month, month);
+        CHECK_EQ(c.day, day);
+
+        // 0 = Monday (ISO), tm_wday 0 = Sunday
+        CHECK_EQ(weekdayFromDays(days), (tm.tm_wday + 6) % 7);
+
+        // Month length: the next day starts a new month exactly after daysInMonth()
+        time_t next = t + 86400;
+        struct tm tn;
+        gmtime_r(&next, &tn);
+        if (tn.tm_mon != tm.tm_mon) {
+            CHECK_EQ(daysInMonth(year, month), day);
+        }
+
+        if (month == 12 && day == 31) {
+            CHECK_EQ(isLeapYear(year), tm.tm_yday == 365);
+        }
+
+        if (year >= 2000 && year <= 2099) days2000++;
+    }
+
+    // Whole 2000-2099 range visited
+    CHECK_EQ(days2000, daysFromCivil(2100, 1, 1) - daysFromCivil(2000, 1, 1));
+
+    // Month boundaries: the last day of a month is followed by day 1 of the next
+    for (uint16_t year = 2000; year <= 2099; year++) {
+        for (uint8_t month = 1; month <= 12; month++) {
+            uint8_t length = daysInMonth(year, month);
+            uint32_t lastDay = daysFromCivil(year, month, length);
+            uint32_t nextFirst = (month == 12) ? daysFromCivil(year + 1, 1, 1)
+                                               : daysFromCivil(year, month + 1, 1);
+            CHECK_EQ(nextFirst, lastDay + 1);
+        }
+    }
+
+    return testResult("civil_date");
+}
@@ -0,0 +1,180 @@
+/**
+ * DOZOWNIK - CRC32 engine host test
+ *
+ * Checks every backend available on the host against the golden vectors in
+ * tests/golden/crc32.txt: standard check values, pattern and fill blocks,
+ * and the CRCs stored in the old-layout FRAM images (tests/fixtures/).
+ * The vectors were computed independently of crc32.cpp (zlib and the
+ * pre-engine table), so a match proves the engine is bit-identical to what
+ * is already stored in FRAM - the legacy table included.
+ *
+ * Current-table vectors also go through compute(), the incremental API
+ * split at several points, and matches(). Legacy vectors go through
+ * computeLegacy() and must still be accepted by matches().
+ */
+
+#include "crc32.h"
+#include "host_test.h"
+
+HostSerial Serial;
+
+#ifndef GOLDEN_FILE
+#define GOLDEN_FILE     "tests/golden/crc32.txt"
+#endif
+#ifndef FIXTURE_DIR
+#define FIXTURE_DIR     "tests/fixtures/"
+#endif
+
+#define MAX_DATA        4096
+
+// ============================================================================
+// DATA SPECS
+// ============================================================================
+
+static bool readImage(const char* file, uint32_t address, uint32_t length, uint8_t* out) {
+    char path[256];
+    snprintf(path, sizeof(path), FIXTURE_DIR "%s", file);
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    bool ok = fseek(f, address, SEEK_SET) == 0 && fread(out, 1, length, f) == length;
+    fclose(f);
+    return ok;
+}
+
+/**
+ * Zbuduj dane wektora. record: pole CRC wycięte (crcOffset, 4 bajty).
+ */
+static bool buildData(const char* spec, uint8_t* out, size_t* length) {
+    char kind[16];
+    char file[64];
+    unsigned long a = 0, b = 0, c = 0;
+
+    if (strncmp(spec, "ascii:", 6) == 0) {
+        *length = strlen(spec + 6);
+        memcpy(out, spec + 6, *length);
+        return true;
+    }
+
+    const char* colon = strchr(spec, ':');
+    if (!colon || (size_t)(colon - spec) >= sizeof(kind)) return false;
+    memcpy(kind, spec, colon - spec);
+    kind[colon - spec] = '\0';
+
+    if (strcmp(kind, "pattern") == 0) {
+        if (sscanf(colon + 1, "%lu", &a) != 1 || a > MAX_DATA) return false;
+        for (unsigned long i = 0; i < a; i++) out[i] = (uint8_t)(i * 31 + 7);
+        *length = a;
+        return true;
+    }
+
+    if (strcmp(kind, "fill") == 0) {
+        if (sscanf(colon + 1, "%lu:%lu", &a, &b) != 2 || a > MAX_DATA) return false;
+        memset(out, (uint8_t)b, a);
+        *length = a;
+        return true;
+    }
+
+    if (strcmp(kind, "image") == 0) {
+        if (sscanf(colon + 1, "%63[^:]:%lx:%lu", file, &a, &b) != 3 || b > MAX_DATA) return false;
+        *length = b;
+        return readImage(file, a, b, out);
+    }
+
+    if (strcmp(kind, "record") == 0) {
+        if (sscanf(colon + 1, "%63[^:]:%lx:%lu:%lu", file, &a, &b, &c) != 4 ||
+            b > MAX_DATA || c + 4 > b) {
+            return false;
+        }
+        if (!readImage(file, a, b, out)) return false;
+        memmove(out + c, out + c + 4, b - c - 4);
+        *length = b - 4;
+        return true;
+    }
+
+    return false;
+}
+
+// ============================================================================
+// CHECKS
+// ============================================================================
+
+static void checkCurrent(const uint8_t* data, size_t length, uint32_t expected) {
+    for (uint8_t i = 0; i < CRC32_BACKEND_COUNT; i++) {
+        Crc32Backend backend = (Crc32Backend)i;
+        if (!Crc32::isAvailable(backend)) continue;
+
+        CHECK_EQ(Crc32::extendWith(backend, 0, data, length), expected);
+
+        // Incremental API on this backend
+        Crc32::setBackend(backend);
+        static const size_t SPLITS[] = { 1, 3, 8, 17, 64 };
+        for (uint8_t s = 0; s < sizeof(SPLITS) / sizeof(SPLITS[0]); s++) {
+            Crc32 crc;
+            for (size_t pos = 0; pos < length; pos += SPLITS[s]) {
+                crc.update(data + pos, min(SPLITS[s], length - pos));
+            }
+            CHECK_EQ(crc.value(), expected);
+        }
+    }
+
+    Crc32::begin();
+    CHECK_EQ(Crc32::compute(data, length), expected);
+    CHECK(Crc32::matches(data, length, expected));
+}
+
+static void checkLegacy(const uint8_t* data, size_t length, uint32_t expected) {
+    CHECK_EQ(Crc32::computeLegacy(data, length), expected);
+    CHECK(Crc32::matches(data, length, expected));
+}
+
+int main() {
+    Crc32::begin();
+    CHECK(Crc32::isAvailable(Crc32Backend::SLICE8));
+    CHECK(Crc32::isAvailable(Crc32Backend::BYTEWISE));
+    CHECK(Crc32::selfTest());
+
+    FILE* f = fopen(GOLDEN_FILE, "r");
+    if (!CHECK(f != nullptr)) return testResult("crc32");
+
+    static uint8_t data[MAX_DATA];
+    char line[256];
+    unsigned lineNo = 0;
+    unsigned vectors = 0;
+    unsigned legacyOnly = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        char table[16];
+        char spec[128];
+        unsigned long expected;
+        size_t length = 0;
+
+        if (!CHECK(sscanf(line, "%15s %127s %lx", table, spec, &expected) == 3) ||
+            !CHECK(buildData(spec, data, &length))) {
+            fprintf(stderr, "  %s:%u: %s", GOLDEN_FILE, lineNo, line);
+            continue;
+        }
+
+        unsigned long before = _testFailures;
+        if (strcmp(table, "current") == 0) {
+            checkCurrent(data, length, (uint32_t)expected);
+        } else if (CHECK(strcmp(table, "legacy") == 0)) {
+            checkLegacy(data, length, (uint32_t)expected);
+            if (Crc32::compute(data, length) != expected) legacyOnly++;
+        }
+        if (_testFailures != before) {
+            fprintf(stderr, "  %s:%u: %s", GOLDEN_FILE, lineNo, line);
+        }
+        vectors++;
+    }
+    fclose(f);
+
+    // Golden file must exercise the bad entry on stored records
+    CHECK(vectors > 0);
+    CHECK(legacyOnly > 0);
+
+    return testResult("crc32");
+}
@@ -0,0 +1,179 @@
+/**
+ * DOZOWNIK - FramController I2C transfer host test
+ *
+ * Runs the real FramController against host/Wire.h (a simulated MB85RC256V
+ * behind the ESP32 128-byte Wire buffer) and checks the transaction and byte
+ * counts of writeBytes(), readBytes() and fillArea() for lengths around the
+ * chunk boundaries, on both the controller and the bus side:
+ *
+ *   write / fill   ceil(len / FRAM_I2C_WRITE_CHUNK) transactions, 2 address bytes each
+ *   read           1 address transaction + ceil(len / FRAM_I2C_READ_CHUNK) reads
+ *
+ * Data must round-trip, no transfer may overflow the Wire buffer, and a NACK
+ * must cost exactly one retry of the whole transfer.
+ */
+
+#include "fram_controller.h"
+#include "host_test.h"
+
+HostSerial Serial;
+
+static const size_t LENGTHS[] = {
+    0, 1, 2, FRAM_I2C_WRITE_CHUNK - 1, FRAM_I2C_WRITE_CHUNK, FRAM_I2C_WRITE_CHUNK + 1,
+    FRAM_I2C_READ_CHUNK, FRAM_I2C_READ_CHUNK + 1, 2 * FRAM_I2C_WRITE_CHUNK,
+    2 * FRAM_I2C_READ_CHUNK + 1, 1000, 4096
+};
+
+static const uint16_t TEST_ADDR = 0x2000;
+
+static uint32_t chunks(size_t length, size_t chunk) {
+    return (uint32_t)((length + chunk - 1) / chunk);
+}
+
+static void resetCounters() {
+    framController.resetIoStats();
+    Wire.resetStats();
+}
+
+static void fillPattern(uint8_t* buf, size_t length, uint8_t seed) {
+    for (size_t i = 0; i < length; i++) {
+        buf[i] = (uint8_t)(i * 31 + seed);
+    }
+}
+
+static void testWrite(size_t length) {
+    static uint8_t data[4096];
+    fillPattern(data, length, (uint8_t)length);
+
+    resetCounters();
+    CHECK(framController.writeBytes(TEST_ADDR, data, length));
+
+    uint32_t expected = chunks(length, FRAM_I2C_WRITE_CHUNK);
+    const FramIoStats& io = framController.getIoStats();
+    CHECK_EQ(io.transactions, expected);
+    CHECK_EQ(io.bytes_written, length);
+    CHECK_EQ(io.bytes_read, 0);
+
+    CHECK_EQ(Wire.stats.transactions, expected);
+    CHECK_EQ(Wire.stats.writes, expected);
+    CHECK_EQ(Wire.stats.reads, 0);
+    CHECK_EQ(Wire.stats.address_bytes, 2 * expected);
+    CHECK_EQ(Wire.stats.bytes_written, length);
+    CHECK_EQ(Wire.stats.overflows, 0);
+
+    CHECK(memcmp(Wire.memory + TEST_ADDR, data, length) == 0);
+}
+
+static void testRead(size_t length) {
+    static uint8_t data[4096];
+    static uint8_t back[4096];
+    fillPattern(data, length, (uint8_t)(length + 1));
+    memcpy(Wire.memory + TEST_ADDR, data, length);
+    memset(back, 0, sizeof(back));
+
+    resetCounters();
+    CHECK(framController.readBytes(TEST_ADDR, back, length));
+
+    uint32_t reads = chunks(length, FRAM_I2C_READ_CHUNK);
+    const FramIoStats& io = framController.getIoStats();
+    CHECK_EQ(io.transactions, 1 + reads);
+    CHECK_EQ(io.bytes_read, length);
+    CHECK_EQ(io.bytes_written, 0);
+    CHECK_EQ(io.mirror_reads, 0);
+
+    CHECK_EQ(Wire.stats.transactions, 1 + reads);
+    CHECK_EQ(Wire.stats.writes, 1);
+    CHECK_EQ(Wire.stats.reads, reads);
+    CHECK_EQ(Wire.stats.address_bytes, 2);
+    CHECK_EQ(Wire.stats.bytes_read, length);
+    CHECK_EQ(Wire.stats.overflows, 0);
+
+    CHECK(memcmp(back, data, length) == 0);
+
+    // readBytesDirect takes the same bus path
+    resetCounters();
+    CHECK(framController.readBytesDirect(TEST_ADDR, back, length));
+    CHECK_EQ(framController.getIoStats().transactions, 1 + reads);
+    CHECK_EQ(Wire.stats.bytes_read, length);
+}
+
+static void testFill(size_t length) {
+    memset(Wire.memory + TEST_ADDR - 1, 0x5A, length + 2);
+
+    resetCounters();
+    CHECK(framController.fillArea(TEST_ADDR, 0xA5, length));
+
+    uint32_t expected = chunks(length, FRAM_I2C_WRITE_CHUNK);
+    CHECK_EQ(framController.getIoStats().transactions, expected);
+    CHECK_EQ(framController.getIoStats().bytes_written, length);
+    CHECK_EQ(Wire.stats.transactions, expected);
+    CHECK_EQ(Wire.stats.address_bytes, 2 * expected);
+    CHECK_EQ(Wire.stats.bytes_written, length);
+    CHECK_EQ(Wire.stats.overflows, 0);
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (Wire.memory[TEST_ADDR + i] != 0xA5) wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+
+    // Neighbours untouched
+    CHECK_EQ(Wire.memory[TEST_ADDR - 1], 0x5A);
+    CHECK_EQ(Wire.memory[TEST_ADDR + length], 0x5A);
+}
+
+static void testRetry() {
+    const size_t length = 300;
+    uint8_t data[length];
+    uint8_t back[length];
+    fillPattern(data, length, 7);
+
+    // NACK on the first chunk: the whole transfer is repeated once
+    resetCounters();
+    Wire.failNext = 1;
+    CHECK(framController.writeBytes(TEST_ADDR, data, length));
+    CHECK_EQ(Wire.stats.nacks, 1);
+    CHECK_EQ(framController.getIoStats().transactions, 1 + chunks(length, FRAM_I2C_WRITE_CHUNK));
+    CHECK_EQ(framController.getIoStats().bytes_written, length);
+
+    // NACK on the address phase of a read
+    resetCounters();
+    Wire.failNext = 1;
+    CHECK(framController.readBytes(TEST_ADDR, back, length));
+    CHECK_EQ(Wire.stats.nacks, 1);
+    CHECK_EQ(framController.getIoStats().transactions, 2 + chunks(length, FRAM_I2C_READ_CHUNK));
+    CHECK(memcmp(back, data, length) == 0);
+
+    // Persistent NACK: 1 + FRAM_IO_MAX_RETRIES attempts, then failure
+    resetCounters();
+    Wire.failNext = 1000;
+    CHECK(!framController.writeBytes(TEST_ADDR, data, length));
+    CHECK_EQ(Wire.stats.nacks, 1 + FRAM_IO_MAX_RETRIES);
+    Wire.failNext = 0;
+}
+
+static void testBounds() {
+    uint8_t byte = 0;
+    resetCounters();
+    CHECK(!framController.writeBytes(FRAM_SIZE_BYTES - 1, &byte, 2));
+    CHECK(!framController.readBytes(FRAM_SIZE_BYTES - 1, &byte, 2));
+    CHECK(!framController.fillArea(FRAM_SIZE_BYTES - 1, 0, 2));
+    CHECK_EQ(Wire.stats.transactions, 0);
+}
+
+int main() {
+    // Blank chip: begin() formats it, counters start after that
+    CHECK(framController.begin());
+    CHECK(framController.validateHeader());
+
+    for (size_t i = 0; i < sizeof(LENGTHS) / sizeof(LENGTHS[0]); i++) {
+        testWrite(LENGTHS[i]);
+        testRead(LENGTHS[i]);
+        testFill(LENGTHS[i]);
+    }
+
+    testRetry();
+    testBounds();
+
+    return testResult("fram_io");
+}
@@ -0,0 +1,363 @@
+/**
+ * DOZOWNIK - FramMigration host test
+ *
+ * Loads the old-layout images from tests/fixtures/ (v5..v8, see
+ * fixture_images.h) into the simulated FRAM and runs the real migration
+ * chain. After migration every section is checked:
+ *
+ * - header at FRAM_LAYOUT_VERSION, CRC valid, identity fields kept
+ * - rewritten slot records valid, with the expected seq, and carrying the
+ *   calibration, schedule, daily state and system state of the old image
+ * - new sections initialized (DosedTracker) or empty (B slots, counters)
+ * - every other section byte-identical to the old image
+ * - no CRC section left with a bad record (except v6 CLI scratch in the
+ *   journal header, which the journal module reformats)
+ *
+ * v5 has no migration path: run() must refuse it without writing.
+ *
+ * Power loss: the migration is cut at every data write (the cut write is
+ * torn), then at every write of the resumed run. After the final boot the
+ * image must equal the uninterrupted result - including a header torn while
+ * a finished step rewrote it.
+ */
+
+#include "fram_migration.h"
+#include "fixture_images.h"
+#include "host_test.h"
+
+HostSerial Serial;
+
+#ifndef FIXTURE_DIR
+#define FIXTURE_DIR     "tests/fixtures/"
+#endif
+
+#define FIRST_FIXTURE   5
+#define LAST_FIXTURE    8
+
+static uint8_t fixtures[LAST_FIXTURE + 1][FRAM_SIZE_BYTES];
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+static bool readFixture(uint16_t version) {
+    char path[256];
+    snprintf(path, sizeof(path), FIXTURE_DIR "fram_v%u.bin", (unsigned)version);
+
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    size_t n = fread(fixtures[version], 1, FRAM_SIZE_BYTES, f);
+    fclose(f);
+    return n == FRAM_SIZE_BYTES;
+}
+
+static void loadFixture(uint16_t version) {
+    memcpy(Wire.memory, fixtures[version], FRAM_SIZE_BYTES);
+    Wire.powerOn();
+    Wire.resetStats();
+}
+
+template <typename T>
+static T recordAt(uint32_t address) {
+    T record;
+    memcpy(&record, Wire.memory + address, sizeof(T));
+    return record;
+}
+
+static bool isEmpty(const void* data, size_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+    bool zeros = true, ones = true;
+    for (size_t i = 0; i < length; i++) {
+        zeros &= (p[i] == 0x00);
+        ones &= (p[i] == 0xFF);
+    }
+    return zeros || ones;
+}
+
+struct RecordCounts {
+    uint16_t valid;
+    uint16_t empty;
+    uint16_t bad;
+};
+
+template <FramSectionId Id>
+static RecordCounts countRecords() {
+    typedef typename FramSection<Id>::Record Record;
+    RecordCounts c = { 0, 0, 0 };
+    for (uint16_t i = 0; i < FramSection<Id>::count(); i++) {
+        Record r = recordAt<Record>(FramSection<Id>::recordAddress(i));
+        if (isEmpty(&r, sizeof(r))) c.empty++;
+        else if (FramController::verifyRecord<Id>(r)) c.valid++;
+        else c.bad++;
+    }
+    return c;
+}
+
+#define COUNT_CRC_SECTION(id, ...)  case FramSectionId::id: return countRecords<FramSectionId::id>();
+#define SKIP_PLAIN_SECTION(...)
+
+static RecordCounts sectionCounts(FramSectionId id) {
+    switch (id) {
+        FRAM_SECTIONS(COUNT_CRC_SECTION, SKIP_PLAIN_SECTION)
+        default: break;
+    }
+    RecordCounts none = { 0, 0, 0 };
+    return none;
+}
+
+/** Sekcje przepisywane przez łańcuch migracji startujący z danej wersji */
+static bool rewritten(FramSectionId id, uint16_t from) {
+    switch (id) {
+        case FramSectionId::HEADER:
+        case FramSectionId::COUNTER_BASE:
+        case FramSectionId::COUNTER_LOG:
+        case FramSectionId::RESERVED:           // Migration scratch at the end
+            return true;
+        case FramSectionId::DOSED_TRACKER:
+            return from <= 6;
+        case FramSectionId::SYSTEM_STATE_A:
+        case FramSectionId::CONFIG_A:
+        case FramSectionId::CONFIG_B:
+        case FramSectionId::DAILY_STATE_A:
+        case FramSectionId::SYSTEM_STATE_B:
+        case FramSectionId::DAILY_STATE_B:
+            return from <= 7;
+        default:
+            return false;
+    }
+}
+
+static void checkSettings(const ChannelConfig& actual, const ChannelConfig& expected) {
+    CHECK_EQ(actual.events_bitmask, expected.events_bitmask);
+    CHECK_EQ(actual.days_bitmask, expected.days_bitmask);
+    CHECK(actual.daily_dose_ml == expected.daily_dose_ml);
+    CHECK(actual.dosing_rate == expected.dosing_rate);
+    CHECK_EQ(actual.enabled, expected.enabled);
+}
+
+// ============================================================================
+// CHECKS
+// ============================================================================
+
+static void checkHeader() {
+    FramHeader header = recordAt<FramHeader>(FRAM_ADDR_HEADER);
+    FramHeader old = fixtureHeader(0);
+    CHECK_EQ(header.magic, FRAM_MAGIC_NUMBER);
+    CHECK_EQ(header.layout_version, FRAM_LAYOUT_VERSION);
+    CHECK(FramController::verifyRecord<FramSectionId::HEADER>(header));
+    CHECK_EQ(header.channel_count, old.channel_count);
+    CHECK_EQ(header.init_timestamp, old.init_timestamp);
+    CHECK_EQ(header.last_write, old.last_write);
+
+    // Scratch state left idle after the last step
+    FramMigrationState state = recordAt<FramMigrationState>(FRAM_ADDR_MIGRATION_STATE);
+    CHECK_EQ(state.magic, FRAM_MIGRATION_MAGIC);
+    CHECK_EQ(state.phase, MIGRATION_PHASE_IDLE);
+    CHECK_EQ(state.to_version, FRAM_LAYOUT_VERSION);
+}
+
+static void checkSections(uint16_t from) {
+    const uint8_t* old = fixtures[from];
+
+    for (uint8_t i = 0; i < FRAM_SECTION_COUNT; i++) {
+        FramSectionId id = (FramSectionId)i;
+        const FramSectionInfo& s = FRAM_SECTION_INFO[i];
+
+        if (id == FramSectionId::RESERVED) {
+            uint32_t free = FRAM_ADDR_MIGRATION_STATE - s.address;
+            CHECK(memcmp(Wire.memory + s.address, old + s.address, free) == 0);
+        } else if (!rewritten(id, from)) {
+            if (!CHECK(memcmp(Wire.memory + s.address, old + s.address, s.size) == 0)) {
+                fprintf(stderr, "  section %s changed\n", s.name);
+            }
+        }
+
+        if (s.crcOffset == FRAM_NO_CRC) continue;
+
+        // v6 CLI self-test left its bytes where the journal header is now
+        bool scratch = (from <= 6 && id == FramSectionId::JOURNAL_HEADER);
+        RecordCounts c = sectionCounts(id);
+        if (!CHECK_EQ(c.bad, scratch ? 1 : 0)) {
+            fprintf(stderr, "  section %s: %u bad records\n", s.name, c.bad);
+        }
+    }
+
+    // Counter sections were CLI scratch before v9
+    CHECK_EQ(sectionCounts(FramSectionId::COUNTER_BASE).empty, FramSection<FramSectionId::COUNTER_BASE>::count());
+    CHECK_EQ(sectionCounts(FramSectionId::COUNTER_LOG).empty, FramSection<FramSectionId::COUNTER_LOG>::count());
+}
+
+/** v6/v7 single copies -> generation 1 in slot A, staged edit or older copy in slot B */
+static void checkSlotsFromV7() {
+    for (uint8_t ch = 0; ch < FRAM_MAX_CHANNELS; ch++) {
+        ChannelConfig a = recordAt<ChannelConfig>(FRAM_ADDR_CONFIG_CH(FRAM_SLOT_A, ch));
+        ChannelConfig b = recordAt<ChannelConfig>(FRAM_ADDR_CONFIG_CH(FRAM_SLOT_B, ch));
+
+        CHECK(FramController::verifyRecord<FramSectionId::CONFIG_A>(a));
+        CHECK(FramController::verifyRecord<FramSectionId::CONFIG_B>(b));
+        CHECK_EQ(a.seq, 1);
+        CHECK_EQ(a.has_pending, 0);
+        checkSettings(a, fixtureConfig(ch, false));
+
+        if (ch < CHANNEL_COUNT && fixtureHasPending(ch)) {
+            CHECK_EQ(b.seq, 2);
+            CHECK_EQ(b.has_pending, 1);
+            checkSettings(b, fixtureConfig(ch, true));
+        } else {
+            // Stale edit with has_pending = 0 is replaced by the active copy
+            CHECK_EQ(b.seq, 0);
+            CHECK_EQ(b.has_pending, 0);
+            checkSettings(b, fixtureConfig(ch, false));
+        }
+
+        ChannelDailyState daily = recordAt<ChannelDailyState>(FRAM_ADDR_DAILY_CH(FRAM_SLOT_A, ch));
+        ChannelDailyState expected = fixtureDaily(ch);
+        CHECK(FramController::verifyRecord<FramSectionId::DAILY_STATE_A>(daily));
+        CHECK_EQ(daily.seq, 1);
+        CHECK_EQ(daily.events_completed, expected.events_completed);
+        CHECK_EQ(daily.events_failed, expected.events_failed);
+        CHECK(daily.today_added_ml == expected.today_added_ml);
+        CHECK_EQ(daily.last_reset_day, expected.last_reset_day);
+        CHECK_EQ(daily.failed_count, expected.failed_count);
+    }
+
+    SystemState state = recordAt<SystemState>(FRAM_ADDR_SYSTEM_STATE_A);
+    SystemState expected = fixtureSystem();
+    CHECK(FramController::verifyRecord<FramSectionId::SYSTEM_STATE_A>(state));
+    CHECK_EQ(state.seq, 1);
+    CHECK_EQ(state.system_enabled, expected.system_enabled);
+    CHECK_EQ(state.system_halted, expected.system_halted);
+    CHECK_EQ(state.active_channel, expected.active_channel);
+    CHECK_EQ(state.last_daily_reset_day, expected.last_daily_reset_day);
+    CHECK_EQ(state.boot_count, expected.boot_count);
+    CHECK_EQ(state.pending_changes_mask, expected.pending_changes_mask);
+    CHECK_EQ(state.last_event_timestamp, expected.last_event_timestamp);
+
+    // B slots held CLI scratch in v7 - they must not win on boot
+    CHECK_EQ(sectionCounts(FramSectionId::SYSTEM_STATE_B).empty, 1);
+    CHECK_EQ(sectionCounts(FramSectionId::DAILY_STATE_B).empty, FRAM_MAX_CHANNELS);
+}
+
+static void checkTrackersFromV6() {
+    for (uint8_t ch = 0; ch < FRAM_MAX_CHANNELS; ch++) {
+        DosedTracker tracker = recordAt<DosedTracker>(FRAM_ADDR_DOSED_TRACKER_CH(ch));
+        CHECK(FramController::verifyRecord<FramSectionId::DOSED_TRACKER>(tracker));
+        CHECK_EQ(tracker.total_dosed_ml, 0);
+    }
+}
+
+static void checkMigrated(uint16_t from) {
+    checkHeader();
+    checkSections(from);
+    if (from <= 6) checkTrackersFromV6();
+    if (from <= 7) checkSlotsFromV7();
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+static void testFixturesCurrent() {
+    // Expected values come from fixture_images.h - the committed images must match
+    static uint8_t built[FRAM_SIZE_BYTES];
+    for (uint16_t v = FIRST_FIXTURE; v <= LAST_FIXTURE; v++) {
+        buildFixture(v, built);
+        if (!CHECK(memcmp(built, fixtures[v], FRAM_SIZE_BYTES) == 0)) {
+            fprintf(stderr, "  fram_v%u.bin differs from fixture_images.h (make fixtures)\n", v);
+        }
+    }
+}
+
+static void testNoPath() {
+    loadFixture(5);
+    CHECK(!FramMigration::canMigrate(5));
+    CHECK(!framMigration.run());
+    CHECK_EQ(Wire.stats.data_writes, 0);
+    CHECK(memcmp(Wire.memory, fixtures[5], FRAM_SIZE_BYTES) == 0);
+}
+
+static void testMigrate(uint16_t from, uint8_t* reference, uint32_t* writes) {
+    loadFixture(from);
+    CHECK(FramMigration::canMigrate(from));
+    CHECK(framMigration.run());
+    *writes = Wire.stats.data_writes;
+    checkMigrated(from);
+    memcpy(reference, Wire.memory, FRAM_SIZE_BYTES);
+
+    // Current image: nothing left to do
+    Wire.resetStats();
+    CHECK(framMigration.run());
+    CHECK_EQ(Wire.stats.data_writes, 0);
+}
+
+/**
+ * Zanik zasilania przy każdym zapisie, potem przy każdym zapisie wznowienia
+ */
+static void testPowerLoss(uint16_t from, const uint8_t* reference, uint32_t writes) {
+    for (uint32_t first = 0; first < writes; first++) {
+        for (int32_t second = 0; ; second++) {
+            loadFixture(from);
+            Wire.powerCut = first;
+            framMigration.run();
+            CHECK(!Wire.powered());
+            Wire.powerOn();
+
+            Wire.powerCut = second;
+            bool ok = framMigration.run();
+            bool cut = !Wire.powered();
+            Wire.powerOn();
+
+            if (cut) ok = framMigration.run();
+
+            // Scratch area is the engine's business - data must match exactly
+            if (!CHECK(ok) ||
+                !CHECK(memcmp(Wire.memory, reference, FRAM_ADDR_MIGRATION_STATE) == 0)) {
+                fprintf(stderr, "  v%u: power cut at write %u, then %d\n",
+                        from, (unsigned)first, (int)second);
+                return;
+            }
+            if (!cut) break;
+        }
+    }
+}
+
+static void testBoot() {
+    // Boot path migrates instead of formatting
+    loadFixture(7);
+    CHECK(framController.begin());
+    CHECK(framController.validateHeader());
+    CHECK_EQ(recordAt<FramHeader>(FRAM_ADDR_HEADER).init_timestamp, FX_INIT_TIMESTAMP);
+    checkSlotsFromV7();
+
+    // No path: formatted
+    loadFixture(5);
+    CHECK(framController.begin());
+    CHECK(framController.validateHeader());
+    CHECK(memcmp(Wire.memory + FX_ADDR_ACTIVE_CONFIG, fixtures[5] + FX_ADDR_ACTIVE_CONFIG,
+                 sizeof(ChannelConfig)) != 0);
+}
+
+int main() {
+    Crc32::begin();
+
+    for (uint16_t v = FIRST_FIXTURE; v <= LAST_FIXTURE; v++) {
+        if (!CHECK(readFixture(v))) return testResult("migration");
+    }
+
+    testFixturesCurrent();
+    testNoPath();
+
+    static uint8_t reference[FRAM_SIZE_BYTES];
+    for (uint16_t from = FRAM_MIGRATION_MIN_VERSION; from <= LAST_FIXTURE; from++) {
+        uint32_t writes = 0;
+        testMigrate(from, reference, &writes);
+        testPowerLoss(from, reference, writes);
+    }
+
+    testBoot();
+
+    return testResult("migration");
+}